@@ -105,6 +105,9 @@ endif ()
 if (OGRE_BUILD_RENDERSYSTEM_GLES2)
 	set(_rendersystems "${_rendersystems}  + OpenGL ES 2.x\n")
 endif ()
+if (OGRE_BUILD_RENDERSYSTEM_NULL)
+	set(_rendersystems "${_rendersystems}  + Null (headless)\n")
+endif ()
 
 if (DEFINED _rendersystems)
 	set(_features "${_features}Building rendersystems:\n${_rendersystems}")
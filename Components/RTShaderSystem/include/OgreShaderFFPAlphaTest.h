@@ -90,6 +90,11 @@ public:
     @see SubRenderState::copyFrom.
     */
     virtual void copyFrom(const SubRenderState& rhs);
+
+    /** 
+    @see SubRenderState::writeProgramSignature.
+    */
+    virtual bool writeProgramSignature(String& signature) const;
     
     /** 
     @see SubRenderState::updateGpuProgramsParams.
@@ -77,6 +77,11 @@ public:
     */
     virtual void copyFrom(const SubRenderState& rhs);
 
+    /** 
+    @see SubRenderState::writeProgramSignature.
+    */
+    virtual bool writeProgramSignature(String& signature) const;
+
     /** 
     @see SubRenderState::preAddToRenderState.
     */
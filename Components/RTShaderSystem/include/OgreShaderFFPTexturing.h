@@ -79,6 +79,11 @@ public:
     */
     virtual void copyFrom(const SubRenderState& rhs);
 
+    /** 
+    @see SubRenderState::writeProgramSignature.
+    */
+    virtual bool writeProgramSignature(String& signature) const;
+
     /** 
     @see SubRenderState::preAddToRenderState.
     */
@@ -213,7 +218,7 @@ protected:
     /** 
     Determines if the given texture unit state need to use texture transformation matrix.
     */
-    bool needsTextureMatrix(TextureUnitState* textureUnitState);
+    bool needsTextureMatrix(TextureUnitState* textureUnitState) const;
 
     /** 
     Determines whether a given texture unit needs to be processed by this srs
@@ -174,6 +174,10 @@ public:
     /** 
     Set the output shader cache path. Generated shader code will be written to this path.
     In case of empty cache path shaders will be generated directly from system memory.
+    @remarks
+    An index of the generated programs by render state signature is kept in this path as well,
+    so later runs read the code of known render states instead of generating it.
+    @see ProgramManager::saveShaderCacheIndex
     @param cachePath The cache path of the shader.  
     The default is empty cache path.
     */
@@ -553,6 +557,11 @@ protected:
         /** Acquire the CPU/GPU programs for this pass. */
         void acquirePrograms();
 
+        /** Acquire the CPU/GPU programs for several passes, generating their code in parallel.
+        @see ProgramManager::acquirePrograms
+        */
+        static void acquirePrograms(const SGPassList& passEntries);
+
         /** Release the CPU/GPU programs of this pass. */
         void releasePrograms();
 
@@ -628,6 +637,9 @@ protected:
         /** Acquire the CPU/GPU programs for this technique. */
         void acquirePrograms();
 
+        /** Append the entries of the passes acquirePrograms acquires the programs for to the given list. */
+        void getPassEntries(SGPassList& passEntries);
+
 		/** Build the render state for illumination passes. */
 		void buildIlluminationTargetRenderState();
 
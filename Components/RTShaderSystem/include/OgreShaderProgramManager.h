@@ -84,6 +84,19 @@ public:
     */
     void acquirePrograms(Pass* pass, TargetRenderState* renderState);
 
+    /// A pass and the render state describing the programs to bind to it.
+    typedef std::pair<Pass*, TargetRenderState*>        PassRenderState;
+    typedef vector<PassRenderState>::type               PassRenderStateList;
+
+    /** Acquire CPU/GPU programs sets for several render states and bind them to their passes.
+    @remarks
+    The CPU programs and the source code of the render states are generated in parallel on the
+    threads of the TaskScheduler. The GPU programs are created on the calling thread in the
+    order of the list, so the result is the same as calling acquirePrograms for each entry.
+    @param passRenderStates The passes and the render states to acquire the programs for.
+    */
+    void acquirePrograms(const PassRenderStateList& passRenderStates);
+
     /** Release CPU/GPU programs set associated with the given render state and pass.
     @param pass The pass to release the programs from.
     @param renderState The render state holds the programs.
@@ -94,11 +107,57 @@ public:
     */
     void flushGpuProgramsCache();
 
+    /** How acquirePrograms found the GPU programs of render states.
+    @see SubRenderState::writeProgramSignature
+    */
+    struct ProgramCacheStatistics
+    {
+        /// Render states whose signature matched, no source was generated
+        size_t numHits;
+        /// Render states with a new signature, their source was generated
+        size_t numMisses;
+        /// Render states with a new signature, their source was read from the shader cache
+        size_t numShaderCacheHits;
+        /// Render states holding sub render states without a signature
+        size_t numUncacheable;
+
+        ProgramCacheStatistics() : numHits(0), numMisses(0), numShaderCacheHits(0), numUncacheable(0) {}
+    };
+
+    /** Return the program cache statistics since the creation of this manager or the last
+    call to resetProgramCacheStatistics.
+    */
+    const ProgramCacheStatistics& getProgramCacheStatistics() const { return mProgramCacheStats; }
+
+    /** Reset the program cache statistics. */
+    void resetProgramCacheStatistics() { mProgramCacheStats = ProgramCacheStatistics(); }
+
+    /** Write the shader cache index to the shader cache path if it changed.
+    @remarks
+    The index maps render state signatures to the names of the program source files in the
+    shader cache, so the source of known render states is read instead of generated. Since the
+    program names stay the same, the render system finds their microcode in the microcode cache
+    of the GpuProgramManager as well, if enabled. The index is written when the shader cache
+    path changes and when this manager is destroyed.
+    @see ShaderGenerator::setShaderCachePath
+    */
+    void saveShaderCacheIndex();
+
+    /** The revision of the generated code, part of the stamp of the shader cache index.
+    @remarks
+    Increase it whenever a sub render state, a program writer or a shader library file changes
+    the code generated for an unchanged signature, so that shader caches written before are
+    ignored instead of feeding outdated source to the render system.
+    */
+    static const uint32 SHADER_CACHE_REVISION = 1;
+
 protected:
 
     //-----------------------------------------------------------------------------
     typedef map<String, GpuProgramPtr>::type            GpuProgramsMap;
     typedef map<String, String>::type                   ProgramSourceToNameMap;
+    // The vertex and fragment program names generated for a render state signature.
+    typedef map<String, std::pair<String, String> >::type ProgramSignatureMap;
     typedef GpuProgramsMap::iterator                    GpuProgramsMapIterator;
     typedef GpuProgramsMap::const_iterator              GpuProgramsMapConstIterator;
 
@@ -115,6 +174,33 @@ protected:
     typedef ProgramProcessorMap::const_iterator         ProgramProcessorConstIterator;
     typedef vector<ProgramProcessor*>::type             ProgramProcessorList;
 
+    //-----------------------------------------------------------------------------
+    // The state of a render state while acquiring its programs.
+    struct AcquireRequest
+    {
+        Pass* pass;
+        TargetRenderState* renderState;
+        // The render state signature, empty if it has none.
+        String signature;
+        String vsSource;
+        String fsSource;
+        String vsName;
+        String fsName;
+        // Whether the CPU programs have been created.
+        bool prepared;
+        // Whether the source code has been written or read from the shader cache.
+        bool sourceWritten;
+        // Whether the source code has been read from the shader cache.
+        bool sourceCached;
+
+        AcquireRequest() : pass(NULL), renderState(NULL), prepared(false), sourceWritten(false), sourceCached(false) {}
+    };
+    typedef vector<AcquireRequest>::type                AcquireRequestList;
+
+    // Loop bodies of the parallel stages of acquirePrograms.
+    class PrepareProgramsBody;
+    class WriteSourceBody;
+
     
 protected:
     /** Create default program processors. */
@@ -142,10 +228,54 @@ protected:
     */
     void destroyCpuProgram(Program* shaderProgram);
 
-    /** Create GPU programs for the given program set based on the CPU programs it contains.
-    @param programSet The program set container.
+    /** Return the program writer of the given language, creating it if needed. */
+    ProgramWriter* getProgramWriter(const String& language);
+
+    /** Return the program processor of the given language. */
+    ProgramProcessor* getProgramProcessor(const String& language);
+
+    /** Create the CPU programs of a request, build its signature and run the pre creation
+    step of the processor. Safe to call for different requests from several threads.
+    */
+    void prepareCpuPrograms(AcquireRequest& request, ProgramProcessor* programProcessor);
+
+    /** Write the source code of the CPU programs of a prepared request and name the programs.
+    Safe to call for different requests from several threads if each uses its own writer.
+    */
+    void writeSourceCode(AcquireRequest& request, ProgramWriter* programWriter);
+
+    /** Read the source code of a prepared request from the shader cache.
+    Safe to call for different requests from several threads.
+    @return False if the shader cache holds no source for the request signature.
+    */
+    bool readShaderCache(AcquireRequest& request) const;
+
+    /** Load the shader cache index of the current shader cache path and stamp unless already done. */
+    void loadShaderCacheIndex();
+
+    /** Return the stamp identifying the shader cache index format, the code revision and the
+    target language, profiles and render system the cached source has been generated for.
+    @see SHADER_CACHE_REVISION
+    */
+    static String getShaderCacheStamp();
+
+    /** Create the GPU programs of a request and bind them to its pass. Steps done before
+    for the request are skipped.
+    */
+    void acquirePrograms(AcquireRequest& request, ProgramWriter* programWriter, ProgramProcessor* programProcessor);
+
+    /** Build the signature of the code generated for a render state.
+    @param renderState The render state, its CPU programs have to be created.
+    @param signature The signature to append to.
+    @return False if a sub render state of the render state has no signature.
+    @see SubRenderState::writeProgramSignature
+    */
+    bool writeProgramSignature(TargetRenderState* renderState, String& signature) const;
+
+    /** Find the GPU programs generated for a render state signature before.
+    @return False if there are none or they have been destroyed since.
     */
-    bool createGpuPrograms(ProgramSet* programSet);
+    bool findProgramsBySignature(const String& signature, GpuProgramPtr& vsGpuProgram, GpuProgramPtr& psGpuProgram);
         
     /** 
     Generates a unique hash from a string
@@ -156,14 +286,16 @@ protected:
 
     /** Create GPU program based on the give CPU program.
     @param shaderProgram The CPU program instance.
-    @param programWriter The program writer instance.
+    @param programName The name of the program.
+    @param source The source code written for the CPU program.
     @param language The target shader language.
     @param profiles The profiles string for program compilation.
     @param profilesList The profiles string for program compilation as string list.
     @param cachePath The output path to write the program into.
     */
     GpuProgramPtr createGpuProgram(Program* shaderProgram, 
-        ProgramWriter* programWriter,
+        const String& programName,
+        const String& source,
         const String& language,
         const String& profiles,
         const StringVector& profilesList,
@@ -210,6 +342,8 @@ protected:
 protected:
     // CPU programs list.                   
     ProgramList mCpuProgramsList;
+    // Guards the CPU programs list, render states create their programs in parallel.
+    OGRE_WQ_MUTEX(mCpuProgramsMutex);
     // Map between target language and shader program writer.                   
     ProgramWriterMap mProgramWritersMap;
     // Map between target language and shader program processor.    
@@ -224,6 +358,18 @@ protected:
     ProgramProcessorList mDefaultProgramProcessors;
     // map the source code of the shaders to a name for them
     ProgramSourceToNameMap mProgramSourceToNameMap;
+    // The generated programs by render state signature.
+    ProgramSignatureMap mProgramSignatureMap;
+    // The program cache statistics.
+    ProgramCacheStatistics mProgramCacheStats;
+    // The generated programs by render state signature, kept in the shader cache.
+    ProgramSignatureMap mShaderCacheIndex;
+    // The shader cache path the index belongs to.
+    String mShaderCacheIndexPath;
+    // The stamp of the index.
+    String mShaderCacheIndexStamp;
+    // Whether the index changed since it has been loaded.
+    bool mShaderCacheIndexDirty;
 
 private:
     friend class ProgramSet;
@@ -114,6 +114,25 @@ public:
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) { return true; }
 
+    /** Write what the code generated by this sub render state depends on into a program signature.
+    @remarks
+    The ProgramManager reuses the GPU programs generated for an earlier render state with the same
+    signature instead of writing their source again. So everything that changes the generated code
+    has to be written, values passed as uniform parameters do not need to be.
+    @param signature The signature to append to.
+    @return False if the code cannot be described by a signature, which disables the reuse for
+    the render states holding this sub render state. This is the default.
+    */
+    virtual bool writeProgramSignature(String& signature) const { return false; }
+
+    /** Append a value to a program signature.
+    @see writeProgramSignature.
+    */
+    static void appendSignature(String& signature, uint32 value);
+
+    /** @copydoc appendSignature(String&, uint32) */
+    static void appendSignature(String& signature, float value);
+
     /** Return the accessor object to this sub render state.
     @see SubRenderStateAccessor.
     */
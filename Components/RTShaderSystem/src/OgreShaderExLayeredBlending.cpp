@@ -164,6 +164,22 @@ void LayeredBlending::copyFrom(const SubRenderState& rhs)
     mTextureBlends = rhsTexture.mTextureBlends; 
 }
 
+//-----------------------------------------------------------------------
+bool LayeredBlending::writeProgramSignature(String& signature) const
+{
+    if (!FFPTexturing::writeProgramSignature(signature))
+        return false;
+
+    appendSignature(signature, static_cast<uint32>(mTextureBlends.size()));
+    for (size_t i=0; i < mTextureBlends.size(); ++i)
+    {
+        appendSignature(signature, static_cast<uint32>(mTextureBlends[i].blendMode));
+        appendSignature(signature, static_cast<uint32>(mTextureBlends[i].sourceModifier));
+        appendSignature(signature, static_cast<uint32>(mTextureBlends[i].customNum));
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void LayeredBlending::addPSBlendInvocations(Function* psMain, 
                                          ParameterPtr arg1,
@@ -79,6 +79,13 @@ namespace Ogre {
 
 		}
 
+		//-----------------------------------------------------------------------
+		bool FFPAlphaTest::writeProgramSignature( String& signature ) const
+		{
+			// The reject function and value are uniforms
+			return true;
+		}
+
 		bool FFPAlphaTest::addFunctionInvocations( ProgramSet* programSet )
 		{
 			Program* psProgram = programSet->getCpuFragmentProgram();
@@ -273,6 +273,13 @@ void FFPColour::copyFrom(const SubRenderState& rhs)
     setResolveStageFlags(rhsColour.mResolveStageFlags);
 }
 
+//-----------------------------------------------------------------------
+bool FFPColour::writeProgramSignature(String& signature) const
+{
+    appendSignature(signature, static_cast<uint32>(mResolveStageFlags));
+    return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPColour::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {
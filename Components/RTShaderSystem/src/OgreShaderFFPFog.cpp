@@ -300,6 +300,15 @@ void FFPFog::copyFrom(const SubRenderState& rhs)
     setCalcMode(rhsFog.mCalcMode);
 }
 
+//-----------------------------------------------------------------------
+bool FFPFog::writeProgramSignature(String& signature) const
+{
+    // The fog colour and parameters are uniforms
+    appendSignature(signature, static_cast<uint32>(mCalcMode));
+    appendSignature(signature, static_cast<uint32>(mFogMode));
+    return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPFog::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {   
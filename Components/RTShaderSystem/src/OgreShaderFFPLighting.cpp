@@ -617,6 +617,19 @@ void FFPLighting::copyFrom(const SubRenderState& rhs)
 	setLightCount(lightCount);
 }
 
+//-----------------------------------------------------------------------
+bool FFPLighting::writeProgramSignature(String& signature) const
+{
+	appendSignature(signature, static_cast<uint32>(mTrackVertexColourType));
+	appendSignature(signature, static_cast<uint32>(mSpecularEnable));
+	appendSignature(signature, static_cast<uint32>(mLightParamsList.size()));
+	for (unsigned int i=0; i < mLightParamsList.size(); ++i)
+	{
+		appendSignature(signature, static_cast<uint32>(mLightParamsList[i].mType));
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPLighting::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {
@@ -830,7 +830,7 @@ TexCoordCalcMethod FFPTexturing::getTexCalcMethod(TextureUnitState* textureUnitS
 }
 
 //-----------------------------------------------------------------------
-bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState)
+bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState) const
 {
     const TextureUnitState::EffectMap&      effectMap = textureUnitState->getEffects(); 
     TextureUnitState::EffectMap::const_iterator effi;
@@ -874,6 +874,48 @@ void FFPTexturing::copyFrom(const SubRenderState& rhs)
     }       
 }
 
+//-----------------------------------------------------------------------
+bool FFPTexturing::writeProgramSignature(String& signature) const
+{
+    appendSignature(signature, static_cast<uint32>(mTextureUnitParamsList.size()));
+
+    for (unsigned int i=0; i < mTextureUnitParamsList.size(); ++i)
+    {
+        const TextureUnitParams& curParams = mTextureUnitParamsList[i];
+        TextureUnitState* textureUnitState = curParams.mTextureUnitState;
+
+        if (textureUnitState == NULL)
+            return false;
+
+        appendSignature(signature, static_cast<uint32>(curParams.mTextureSamplerIndex));
+        appendSignature(signature, static_cast<uint32>(curParams.mTextureSamplerType));
+        appendSignature(signature, static_cast<uint32>(curParams.mTexCoordCalcMethod));
+        appendSignature(signature, static_cast<uint32>(textureUnitState->getTextureCoordSet()));
+        appendSignature(signature, static_cast<uint32>(needsTextureMatrix(textureUnitState)));
+
+        // Manual blend sources and factors are written into the code as constants
+        const LayerBlendModeEx* blendModes[2] = { &textureUnitState->getColourBlendMode(), &textureUnitState->getAlphaBlendMode() };
+        for (int j=0; j < 2; ++j)
+        {
+            const LayerBlendModeEx& blend = *blendModes[j];
+
+            appendSignature(signature, static_cast<uint32>(blend.operation));
+            appendSignature(signature, static_cast<uint32>(blend.source1));
+            appendSignature(signature, static_cast<uint32>(blend.source2));
+            appendSignature(signature, static_cast<float>(blend.factor));
+            appendSignature(signature, static_cast<float>(blend.alphaArg1));
+            appendSignature(signature, static_cast<float>(blend.alphaArg2));
+            for (int c=0; c < 4; ++c)
+            {
+                appendSignature(signature, blend.colourArg1[c]);
+                appendSignature(signature, blend.colourArg2[c]);
+            }
+        }
+    }
+
+    return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPTexturing::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {
@@ -97,6 +97,12 @@ void FFPTransform::copyFrom(const SubRenderState& rhs)
 
 }
 
+//-----------------------------------------------------------------------
+bool FFPTransform::writeProgramSignature(String& signature) const
+{
+    return true;
+}
+
 //-----------------------------------------------------------------------
 const String& FFPTransformFactory::getType() const
 {
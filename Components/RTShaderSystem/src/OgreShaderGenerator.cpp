@@ -74,7 +74,7 @@ ShaderGenerator& ShaderGenerator::getSingleton()
 //-----------------------------------------------------------------------------
 ShaderGenerator::ShaderGenerator() :
     mActiveSceneMgr(NULL), mRenderObjectListener(NULL), mSceneManagerListener(NULL), mScriptTranslatorManager(NULL),
-    mMaterialSerializerListener(NULL), mShaderLanguage(""), mProgramManager(NULL), mProgramWriterManager(NULL),
+    mMaterialSerializerListener(NULL), mShaderLanguage(""), mShaderLanguageVersion(1.0f), mProgramManager(NULL), mProgramWriterManager(NULL),
     mFSLayer(0), mFFPRenderStateBuilder(NULL),mActiveViewportValid(false), mVSOutputCompactPolicy(VSOCP_LOW),
     mCreateShaderOverProgrammablePass(false), mIsFinalizing(false)
 {
@@ -1452,6 +1452,10 @@ void ShaderGenerator::setShaderCachePath( const String& cachePath )
             outFile.close();
             remove(outTestFileName.c_str());
         }
+
+        // Load the index of the programs generated for this path before.
+        if (ProgramManager::getSingletonPtr() != NULL)
+            ProgramManager::getSingleton().loadShaderCacheIndex();
     }
 }
 
@@ -1607,6 +1611,20 @@ void ShaderGenerator::SGPass::acquirePrograms()
     ProgramManager::getSingleton().acquirePrograms(mDstPass, mTargetRenderState);
 }
 
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::acquirePrograms(const SGPassList& passEntries)
+{
+    ProgramManager::PassRenderStateList passRenderStates;
+
+    passRenderStates.reserve(passEntries.size());
+    for (SGPassConstIterator itPass = passEntries.begin(); itPass != passEntries.end(); ++itPass)
+    {
+        passRenderStates.push_back(ProgramManager::PassRenderState((*itPass)->mDstPass, (*itPass)->mTargetRenderState));
+    }
+
+    ProgramManager::getSingleton().acquirePrograms(passRenderStates);
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGPass::releasePrograms()
 {
@@ -1835,10 +1853,19 @@ void ShaderGenerator::SGTechnique::buildTargetRenderState()
 
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::acquirePrograms()
+{
+	SGPassList passEntries;
+
+	getPassEntries(passEntries);
+	SGPass::acquirePrograms(passEntries);
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::getPassEntries(SGPassList& passEntries)
 {
 	for(SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
 		if(!(*itPass)->isIlluminationPass())
-			(*itPass)->acquirePrograms();
+			passEntries.push_back(*itPass);
 }
 
 //-----------------------------------------------------------------------------
@@ -2017,15 +2044,19 @@ void ShaderGenerator::SGScheme::validate()
             curTechEntry->buildTargetRenderState();     
     }
 
-    // Acquire GPU programs for each technique.
+    // Acquire GPU programs for all techniques at once, so their code is generated in parallel.
+    SGPassList passEntries;
+
     for (itTech = mTechniqueEntries.begin(); itTech != mTechniqueEntries.end(); ++itTech)
     {
         SGTechnique* curTechEntry = *itTech;
         
         if (curTechEntry->getBuildDestinationTechnique())
-            curTechEntry->acquirePrograms();        
+            curTechEntry->getPassEntries(passEntries);
     }
 
+    SGPass::acquirePrograms(passEntries);
+
     // Turn off the build destination technique flag.
     for (itTech = mTechniqueEntries.begin(); itTech != mTechniqueEntries.end(); ++itTech)
     {
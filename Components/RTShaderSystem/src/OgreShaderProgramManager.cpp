@@ -48,6 +48,9 @@ THE SOFTWARE.
 #endif
 #include "OgreShaderGLSLESProgramProcessor.h"
 #include "OgreGpuProgramManager.h"
+#include "OgreTaskScheduler.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
 
 
 namespace Ogre {
@@ -58,6 +61,44 @@ RTShader::ProgramManager* Singleton<RTShader::ProgramManager>::msSingleton = 0;
 
 namespace RTShader {
 
+// The name of the shader cache index file in the shader cache path.
+static const char* const SHADER_CACHE_INDEX_FILE_NAME = "RTShaderCache.idx";
+
+//-----------------------------------------------------------------------------
+static void writeIndexString(std::ostream& os, const String& str)
+{
+    uint32 length = static_cast<uint32>(str.size());
+
+    os.write(reinterpret_cast<const char*>(&length), sizeof(uint32));
+    os.write(str.data(), length);
+}
+
+//-----------------------------------------------------------------------------
+static bool readIndexString(std::istream& is, String& str)
+{
+    uint32 length = 0;
+
+    if (!is.read(reinterpret_cast<char*>(&length), sizeof(uint32)))
+        return false;
+
+    str.resize(length);
+    return length == 0 || is.read(&str[0], length);
+}
+
+//-----------------------------------------------------------------------------
+static bool readSourceFile(const String& fileName, String& source)
+{
+    std::ifstream programFile(fileName.c_str());
+
+    if (!programFile)
+        return false;
+
+    StringStream buffer;
+    programFile >> buffer.rdbuf();
+    source = buffer.str();
+    return true;
+}
+
 
 //-----------------------------------------------------------------------
 ProgramManager* ProgramManager::getSingletonPtr()
@@ -73,7 +114,7 @@ ProgramManager& ProgramManager::getSingleton()
 }
 
 //-----------------------------------------------------------------------------
-ProgramManager::ProgramManager()
+ProgramManager::ProgramManager() : mShaderCacheIndexDirty(false)
 {
     createDefaultProgramProcessors();
     createDefaultProgramWriterFactories();
@@ -82,40 +123,259 @@ ProgramManager::ProgramManager()
 //-----------------------------------------------------------------------------
 ProgramManager::~ProgramManager()
 {
+    saveShaderCacheIndex();
     flushGpuProgramsCache();
     destroyDefaultProgramWriterFactories();
     destroyDefaultProgramProcessors();  
     destroyProgramWriters();
 }
 
+//-----------------------------------------------------------------------------
+class ProgramManager::PrepareProgramsBody : public ParallelForBody
+{
+public:
+    PrepareProgramsBody(ProgramManager* manager, ProgramProcessor* programProcessor, AcquireRequestList& requests)
+        : mManager(manager), mProgramProcessor(programProcessor), mRequests(requests)
+    {
+    }
+
+    void execute(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            try
+            {
+                mManager->prepareCpuPrograms(mRequests[i], mProgramProcessor);
+            }
+            catch (...)
+            {
+                // The request is prepared again by the calling thread, which reports the error.
+                // Nothing may escape to the worker thread running this.
+                mRequests[i].prepared = false;
+            }
+        }
+    }
+
+private:
+    ProgramManager* mManager;
+    ProgramProcessor* mProgramProcessor;
+    AcquireRequestList& mRequests;
+};
+
+//-----------------------------------------------------------------------------
+class ProgramManager::WriteSourceBody : public ParallelForBody
+{
+public:
+    WriteSourceBody(ProgramManager* manager, const String& language, AcquireRequestList& requests,
+        const vector<size_t>::type& indices)
+        : mManager(manager), mLanguage(language), mRequests(requests), mIndices(indices)
+    {
+    }
+
+    void execute(size_t begin, size_t end)
+    {
+        // Writers keep state while writing, each chunk uses its own one.
+        ProgramWriter* programWriter = ProgramWriterManager::getSingleton().createProgramWriter(mLanguage);
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            try
+            {
+                if (false == mManager->readShaderCache(mRequests[mIndices[i]]))
+                    mManager->writeSourceCode(mRequests[mIndices[i]], programWriter);
+            }
+            catch (...)
+            {
+                // The source is written again by the calling thread, which reports the error.
+                // Nothing may escape to the worker thread running this.
+                mRequests[mIndices[i]].sourceWritten = false;
+                mRequests[mIndices[i]].sourceCached = false;
+            }
+        }
+
+        OGRE_DELETE programWriter;
+    }
+
+private:
+    ProgramManager* mManager;
+    const String& mLanguage;
+    AcquireRequestList& mRequests;
+    const vector<size_t>::type& mIndices;
+};
+
 //-----------------------------------------------------------------------------
 void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState)
 {
-    // Create the CPU programs.
-    if (false == renderState->createCpuPrograms())
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+    AcquireRequest request;
+
+    loadShaderCacheIndex();
+
+    request.pass = pass;
+    request.renderState = renderState;
+
+    acquirePrograms(request, getProgramWriter(language), getProgramProcessor(language));
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::acquirePrograms(const PassRenderStateList& passRenderStates)
+{
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+    ProgramWriter* programWriter = getProgramWriter(language);
+    ProgramProcessor* programProcessor = getProgramProcessor(language);
+    AcquireRequestList requests(passRenderStates.size());
+
+    loadShaderCacheIndex();
+
+    for (size_t i = 0; i < passRenderStates.size(); ++i)
+    {
+        requests[i].pass = passRenderStates[i].first;
+        requests[i].renderState = passRenderStates[i].second;
+    }
+
+    TaskScheduler* scheduler = TaskScheduler::getSingletonPtr();
+
+    if (requests.size() > 1 && scheduler != NULL && scheduler->getNumThreads() > 1)
+    {
+        // Create the CPU programs in parallel.
+        PrepareProgramsBody prepareBody(this, programProcessor, requests);
+        scheduler->parallelFor(0, requests.size(), 0, prepareBody);
+
+        // Only write the source of the first render state of each signature that has no programs yet.
+        set<String>::type signatures;
+        vector<size_t>::type sourceIndices;
+        GpuProgramPtr vsGpuProgram;
+        GpuProgramPtr psGpuProgram;
+
+        for (size_t i = 0; i < requests.size(); ++i)
+        {
+            const AcquireRequest& request = requests[i];
+
+            if (request.prepared && (request.signature.empty() ||
+                (signatures.insert(request.signature).second &&
+                 false == findProgramsBySignature(request.signature, vsGpuProgram, psGpuProgram))))
+            {
+                sourceIndices.push_back(i);
+            }
+        }
+
+        // Write the source code in parallel.
+        WriteSourceBody writeBody(this, language, requests, sourceIndices);
+        scheduler->parallelFor(0, sourceIndices.size(), 0, writeBody);
+    }
+
+    // Create the GPU programs in order, completing what has not been done above.
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        acquirePrograms(requests[i], programWriter, programProcessor);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::acquirePrograms(AcquireRequest& request, ProgramWriter* programWriter, ProgramProcessor* programProcessor)
+{
+    if (false == request.prepared)
+    {
+        prepareCpuPrograms(request, programProcessor);
+    }
+
+    ProgramSet* programSet = request.renderState->getProgramSet();
+
+    // Programs generated for the same signature before are reused without writing their source.
+    GpuProgramPtr vsGpuProgram;
+    GpuProgramPtr psGpuProgram;
+    bool cached = !request.signature.empty() && findProgramsBySignature(request.signature, vsGpuProgram, psGpuProgram);
+
+    if (!cached)
+    {
+        if (false == request.sourceWritten && false == readShaderCache(request))
+        {
+            writeSourceCode(request, programWriter);
+        }
+
+        const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+
+        // Create the vertex shader program.
+        vsGpuProgram = createGpuProgram(programSet->getCpuVertexProgram(), 
+            request.vsName,
+            request.vsSource,
+            language, 
+            ShaderGenerator::getSingleton().getVertexShaderProfiles(),
+            ShaderGenerator::getSingleton().getVertexShaderProfilesList(),
+            ShaderGenerator::getSingleton().getShaderCachePath());
+
+        // Create the fragment shader program.
+        if (vsGpuProgram)
+        {
+            psGpuProgram = createGpuProgram(programSet->getCpuFragmentProgram(), 
+                request.fsName,
+                request.fsSource,
+                language, 
+                ShaderGenerator::getSingleton().getFragmentShaderProfiles(),
+                ShaderGenerator::getSingleton().getFragmentShaderProfilesList(),
+                ShaderGenerator::getSingleton().getShaderCachePath());
+        }
+    }
+
+    if (!vsGpuProgram || !psGpuProgram)
     {
         OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
-            "Could not apply render state ", 
-            "ProgramManager::acquireGpuPrograms" ); 
-    }   
+            "Could not create gpu programs from render state ", 
+                        "ProgramManager::acquireGpuPrograms" );
+    }
 
-    ProgramSet* programSet = renderState->getProgramSet();
+    programSet->setGpuVertexProgram(vsGpuProgram);
 
-    // Create the GPU programs.
-    if (false == createGpuPrograms(programSet))
+    //update flags
+    programSet->getGpuVertexProgram()->setSkeletalAnimationIncluded(
+        programSet->getCpuVertexProgram()->getSkeletalAnimationIncluded());
+
+    programSet->setGpuFragmentProgram(psGpuProgram);
+
+    if (request.signature.empty())
+    {
+        ++mProgramCacheStats.numUncacheable;
+    }
+    else if (cached)
+    {
+        ++mProgramCacheStats.numHits;
+    }
+    else
+    {
+        mProgramSignatureMap[request.signature] = std::make_pair(request.vsName, request.fsName);
+
+        if (request.sourceCached)
+        {
+            ++mProgramCacheStats.numShaderCacheHits;
+        }
+        else
+        {
+            ++mProgramCacheStats.numMisses;
+
+            // Remember the programs for the next run.
+            if (!mShaderCacheIndexPath.empty())
+            {
+                mShaderCacheIndex[request.signature] = std::make_pair(request.vsName, request.fsName);
+                mShaderCacheIndexDirty = true;
+            }
+        }
+    }
+
+    // Call the post creation of GPU programs method.
+    if (false == programProcessor->postCreateGpuPrograms(programSet))
     {
         OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
             "Could not create gpu programs from render state ", 
                         "ProgramManager::acquireGpuPrograms" );
-    }   
+    }
 
     // Bind the created GPU programs to the target pass.
-    pass->setVertexProgram(programSet->getGpuVertexProgram()->getName());
-    pass->setFragmentProgram(programSet->getGpuFragmentProgram()->getName());
+    request.pass->setVertexProgram(programSet->getGpuVertexProgram()->getName());
+    request.pass->setFragmentProgram(programSet->getGpuFragmentProgram()->getName());
 
     // Bind uniform parameters to pass parameters.
-    bindUniformParameters(programSet->getCpuVertexProgram(), pass->getVertexProgramParameters());
-    bindUniformParameters(programSet->getCpuFragmentProgram(), pass->getFragmentProgramParameters());
+    bindUniformParameters(programSet->getCpuVertexProgram(), request.pass->getVertexProgramParameters());
+    bindUniformParameters(programSet->getCpuFragmentProgram(), request.pass->getFragmentProgramParameters());
 
 }
 
@@ -137,6 +397,10 @@ void ProgramManager::releasePrograms(Pass* pass, TargetRenderState* renderState)
 
         renderState->destroyProgramSet();
 
+        // Drop the local references, the programs are unused once only the cache holds them.
+        vsProgram.reset();
+        psProgram.reset();
+
         if (itVsGpuProgram != mVertexShaderMap.end())
         {
             if (itVsGpuProgram->second.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS + 1)
@@ -161,6 +425,7 @@ void ProgramManager::flushGpuProgramsCache()
 {
     flushGpuProgramsCache(mVertexShaderMap);
     flushGpuProgramsCache(mFragmentShaderMap);
+    mProgramSignatureMap.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -253,6 +518,7 @@ Program* ProgramManager::createCpuProgram(GpuProgramType type)
 {
     Program* shaderProgram = OGRE_NEW Program(type);
 
+    OGRE_WQ_LOCK_MUTEX(mCpuProgramsMutex);
     mCpuProgramsList.insert(shaderProgram);
 
     return shaderProgram;
@@ -262,6 +528,7 @@ Program* ProgramManager::createCpuProgram(GpuProgramType type)
 //-----------------------------------------------------------------------------
 void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 {
+    OGRE_WQ_LOCK_MUTEX(mCpuProgramsMutex);
     ProgramListIterator it    = mCpuProgramsList.find(shaderProgram);
     
     if (it != mCpuProgramsList.end())
@@ -272,21 +539,9 @@ void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 }
 
 //-----------------------------------------------------------------------------
-bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
+ProgramWriter* ProgramManager::getProgramWriter(const String& language)
 {
-    // Before we start we need to make sure that the pixel shader input
-    //  parameters are the same as the vertex output, this required by 
-    //  shader models 4 and 5.
-    // This change may incrase the number of register used in older shader
-    //  models - this is why the check is present here.
-    bool isVs4 = GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0_level_9_1");
-    if (isVs4)
-    {
-        synchronizePixelnToBeVertexOut(programSet);
-    }
-
     // Grab the matching writer.
-    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
     ProgramWriterIterator itWriter = mProgramWritersMap.find(language);
     ProgramWriter* programWriter = NULL;
 
@@ -301,68 +556,237 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
         programWriter = itWriter->second;
     }
 
+    return programWriter;
+}
+
+//-----------------------------------------------------------------------------
+ProgramProcessor* ProgramManager::getProgramProcessor(const String& language)
+{
     ProgramProcessorIterator itProcessor = mProgramProcessorsMap.find(language);
-    ProgramProcessor* programProcessor = NULL;
 
     if (itProcessor == mProgramProcessorsMap.end())
     {
         OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
             "Could not find processor for language '" + language,
-            "ProgramManager::createGpuPrograms");       
+            "ProgramManager::getProgramProcessor");       
     }
 
-    programProcessor = itProcessor->second;
+    return itProcessor->second;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::prepareCpuPrograms(AcquireRequest& request, ProgramProcessor* programProcessor)
+{
+    // Create the CPU programs.
+    if (false == request.renderState->createCpuPrograms())
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
+            "Could not apply render state ", 
+            "ProgramManager::acquireGpuPrograms" ); 
+    }   
+
+    ProgramSet* programSet = request.renderState->getProgramSet();
+
+    // Render states with equal signatures generate the same code.
+    request.signature.clear();
+    if (false == writeProgramSignature(request.renderState, request.signature))
+    {
+        request.signature.clear();
+    }
+
+    // Before we start we need to make sure that the pixel shader input
+    //  parameters are the same as the vertex output, this required by 
+    //  shader models 4 and 5.
+    // This change may incrase the number of register used in older shader
+    //  models - this is why the check is present here.
+    bool isVs4 = GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0_level_9_1");
+    if (isVs4)
+    {
+        synchronizePixelnToBeVertexOut(programSet);
+    }
 
-    bool success;
-    
     // Call the pre creation of GPU programs method.
-    success = programProcessor->preCreateGpuPrograms(programSet);
-    if (success == false)   
-        return false;   
-    
-    // Create the vertex shader program.
-    GpuProgramPtr vsGpuProgram;
-    
-    vsGpuProgram = createGpuProgram(programSet->getCpuVertexProgram(), 
-        programWriter,
-        language, 
-        ShaderGenerator::getSingleton().getVertexShaderProfiles(),
-        ShaderGenerator::getSingleton().getVertexShaderProfilesList(),
-        ShaderGenerator::getSingleton().getShaderCachePath());
-
-    if (!vsGpuProgram)
-        return false;
+    if (false == programProcessor->preCreateGpuPrograms(programSet))
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
+            "Could not create gpu programs from render state ", 
+                        "ProgramManager::acquireGpuPrograms" );
+    }
 
-    programSet->setGpuVertexProgram(vsGpuProgram);
+    request.prepared = true;
+}
 
-    //update flags
-    programSet->getGpuVertexProgram()->setSkeletalAnimationIncluded(
-        programSet->getCpuVertexProgram()->getSkeletalAnimationIncluded());
-    // Create the fragment shader program.
-    GpuProgramPtr psGpuProgram;
+//-----------------------------------------------------------------------------
+void ProgramManager::writeSourceCode(AcquireRequest& request, ProgramWriter* programWriter)
+{
+    ProgramSet* programSet = request.renderState->getProgramSet();
+    stringstream vsSourceStream;
+    stringstream fsSourceStream;
+
+    programWriter->writeSourceCode(vsSourceStream, programSet->getCpuVertexProgram());
+    programWriter->writeSourceCode(fsSourceStream, programSet->getCpuFragmentProgram());
 
-    psGpuProgram = createGpuProgram(programSet->getCpuFragmentProgram(), 
-        programWriter,
-        language, 
-        ShaderGenerator::getSingleton().getFragmentShaderProfiles(),
-        ShaderGenerator::getSingleton().getFragmentShaderProfilesList(),
-        ShaderGenerator::getSingleton().getShaderCachePath());
+    request.vsSource = vsSourceStream.str();
+    request.fsSource = fsSourceStream.str();
+
+    // Generate program names.
+    request.vsName = generateHash(request.vsSource) + "_VS";
+    request.fsName = generateHash(request.fsSource) + "_FS";
+    request.sourceWritten = true;
+}
 
-    if (!psGpuProgram)
+//-----------------------------------------------------------------------------
+bool ProgramManager::readShaderCache(AcquireRequest& request) const
+{
+    if (mShaderCacheIndexPath.empty() || request.signature.empty())
         return false;
 
-    programSet->setGpuFragmentProgram(psGpuProgram);
+    ProgramSignatureMap::const_iterator it = mShaderCacheIndex.find(request.signature);
 
-    // Call the post creation of GPU programs method.
-    success = programProcessor->postCreateGpuPrograms(programSet);
-    if (success == false)   
-        return false;   
+    if (it == mShaderCacheIndex.end())
+        return false;
 
-    
+    // The source files are written by createGpuProgram.
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+
+    if (false == readSourceFile(mShaderCacheIndexPath + it->second.first + "." + language, request.vsSource) ||
+        false == readSourceFile(mShaderCacheIndexPath + it->second.second + "." + language, request.fsSource))
+    {
+        return false;
+    }
+
+    // Program names are the hash of their source, edited or mixed up files are not used.
+    if (generateHash(request.vsSource) + "_VS" != it->second.first ||
+        generateHash(request.fsSource) + "_FS" != it->second.second)
+    {
+        return false;
+    }
+
+    request.vsName = it->second.first;
+    request.fsName = it->second.second;
+    request.sourceWritten = true;
+    request.sourceCached = true;
     return true;
-    
 }
 
+//-----------------------------------------------------------------------------
+String ProgramManager::getShaderCacheStamp()
+{
+    // Increase the format version whenever the index layout or the naming of programs changes.
+    StringStream stamp;
+    stamp << "RTShaderCache 1 " << SHADER_CACHE_REVISION << " " << OGRE_VERSION;
+
+    // The generated code and the way it is compiled depend on the target settings.
+    const ShaderGenerator& shaderGenerator = ShaderGenerator::getSingleton();
+    stamp << " " << shaderGenerator.getTargetLanguage() << " " << shaderGenerator.getTargetLanguageVersion()
+        << " " << shaderGenerator.getVertexShaderProfiles() << " " << shaderGenerator.getFragmentShaderProfiles();
+
+    // The generated code depends on the shading language version of the render system.
+    RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
+    if (renderSystem != NULL)
+    {
+        stamp << " " << renderSystem->getName() << " " << renderSystem->getNativeShadingLanguageVersion();
+    }
+
+    return stamp.str();
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::loadShaderCacheIndex()
+{
+    const String& cachePath = ShaderGenerator::getSingleton().getShaderCachePath();
+    const String stamp = getShaderCacheStamp();
+
+    if (cachePath == mShaderCacheIndexPath && stamp == mShaderCacheIndexStamp)
+        return;
+
+    // Keep the programs generated for the previous path or stamp.
+    saveShaderCacheIndex();
+
+    mShaderCacheIndex.clear();
+    mShaderCacheIndexPath = cachePath;
+    mShaderCacheIndexStamp = stamp;
+    mShaderCacheIndexDirty = false;
+
+    if (mShaderCacheIndexPath.empty())
+        return;
+
+    const String fileName = mShaderCacheIndexPath + SHADER_CACHE_INDEX_FILE_NAME;
+    std::ifstream inFile(fileName.c_str(), std::ios::binary);
+
+    if (!inFile)
+        return;
+
+    String fileStamp;
+
+    if (false == readIndexString(inFile, fileStamp) || fileStamp != mShaderCacheIndexStamp)
+    {
+        LogManager::getSingleton().logMessage(
+            "RTShader::ProgramManager: Ignoring out of date shader cache index " + fileName);
+        return;
+    }
+
+    uint32 numEntries = 0;
+    inFile.read(reinterpret_cast<char*>(&numEntries), sizeof(uint32));
+
+    for (uint32 i = 0; i < numEntries && inFile; ++i)
+    {
+        String signature;
+        std::pair<String, String> programNames;
+
+        if (readIndexString(inFile, signature) &&
+            readIndexString(inFile, programNames.first) &&
+            readIndexString(inFile, programNames.second))
+        {
+            mShaderCacheIndex[signature] = programNames;
+        }
+    }
+
+    if (!inFile)
+    {
+        LogManager::getSingleton().logMessage(
+            "RTShader::ProgramManager: Ignoring damaged shader cache index " + fileName);
+        mShaderCacheIndex.clear();
+        return;
+    }
+
+    LogManager::getSingleton().logMessage("RTShader::ProgramManager: Loaded " +
+        StringConverter::toString(mShaderCacheIndex.size()) + " entries from shader cache index " + fileName);
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::saveShaderCacheIndex()
+{
+    if (false == mShaderCacheIndexDirty || mShaderCacheIndexPath.empty())
+        return;
+
+    const String fileName = mShaderCacheIndexPath + SHADER_CACHE_INDEX_FILE_NAME;
+    std::ofstream outFile(fileName.c_str(), std::ios::binary | std::ios::trunc);
+
+    if (!outFile)
+    {
+        LogManager::getSingleton().logMessage(
+            "RTShader::ProgramManager: Could not write shader cache index " + fileName);
+        return;
+    }
+
+    writeIndexString(outFile, mShaderCacheIndexStamp);
+
+    uint32 numEntries = static_cast<uint32>(mShaderCacheIndex.size());
+    outFile.write(reinterpret_cast<const char*>(&numEntries), sizeof(uint32));
+
+    ProgramSignatureMap::const_iterator it = mShaderCacheIndex.begin();
+    ProgramSignatureMap::const_iterator itEnd = mShaderCacheIndex.end();
+
+    for (; it != itEnd; ++it)
+    {
+        writeIndexString(outFile, it->first);
+        writeIndexString(outFile, it->second.first);
+        writeIndexString(outFile, it->second.second);
+    }
+
+    mShaderCacheIndexDirty = false;
+}
 
 //-----------------------------------------------------------------------------
 void ProgramManager::bindUniformParameters(Program* pCpuProgram, const GpuProgramParametersSharedPtr& passParams)
@@ -380,29 +804,14 @@ void ProgramManager::bindUniformParameters(Program* pCpuProgram, const GpuProgra
 
 //-----------------------------------------------------------------------------
 GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram, 
-                                               ProgramWriter* programWriter,
+                                               const String& programName,
+                                               const String& generatedSource,
                                                const String& language,
                                                const String& profiles,
                                                const StringVector& profilesList,
                                                const String& cachePath)
 {
-    stringstream sourceCodeStringStream;
-
-    // Generate source code.
-    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
-
-    // Generate program name.
-    String programName = generateHash(source);
-
-    if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
-    {
-        programName += "_VS";
-    }
-    else if (shaderProgram->getType() == GPT_FRAGMENT_PROGRAM)
-    {
-        programName += "_FS";
-    }
+    String source = generatedSource;
 
     // Try to get program by name.
     HighLevelGpuProgramPtr pGpuProgram =
@@ -497,6 +906,54 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
 }
 
 
+//-----------------------------------------------------------------------------
+bool ProgramManager::writeProgramSignature(TargetRenderState* renderState, String& signature) const
+{
+    // The code depends on the target language as well.
+    signature.append(ShaderGenerator::getSingleton().getTargetLanguage());
+    signature.push_back('\0');
+    SubRenderState::appendSignature(signature, ShaderGenerator::getSingleton().getTargetLanguageVersion());
+
+    // The sub render states have been sorted when creating the CPU programs.
+    const SubRenderStateList& subRenderStates = renderState->getTemplateSubRenderStateList();
+    SubRenderStateListConstIterator it = subRenderStates.begin();
+    SubRenderStateListConstIterator itEnd = subRenderStates.end();
+
+    for (; it != itEnd; ++it)
+    {
+        signature.append((*it)->getType());
+        signature.push_back('\0');
+
+        if (false == (*it)->writeProgramSignature(signature))
+            return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::findProgramsBySignature(const String& signature, GpuProgramPtr& vsGpuProgram, GpuProgramPtr& psGpuProgram)
+{
+    ProgramSignatureMap::iterator it = mProgramSignatureMap.find(signature);
+
+    if (it == mProgramSignatureMap.end())
+        return false;
+
+    // Programs are destroyed once all passes using them are released.
+    GpuProgramsMapIterator itVsGpuProgram = mVertexShaderMap.find(it->second.first);
+    GpuProgramsMapIterator itFsGpuProgram = mFragmentShaderMap.find(it->second.second);
+
+    if (itVsGpuProgram == mVertexShaderMap.end() || itFsGpuProgram == mFragmentShaderMap.end())
+    {
+        mProgramSignatureMap.erase(it);
+        return false;
+    }
+
+    vsGpuProgram = itVsGpuProgram->second;
+    psGpuProgram = itFsGpuProgram->second;
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 String ProgramManager::generateHash(const String& programString)
 {
@@ -40,7 +40,9 @@ ProgramProcessor::ProgramProcessor()
 {
     mMaxTexCoordSlots = 16;
     mMaxTexCoordFloats = mMaxTexCoordSlots * 4;
-    
+
+    // Built up front since programs of several render states are processed in parallel.
+    buildMergeCombinations();
 }
 
 //-----------------------------------------------------------------------------
@@ -291,12 +293,6 @@ void ProgramProcessor::mergeParametersByPredefinedCombinations(ShaderParameterLi
                                                                MergeParameterList& mergedParams)
 {
 
-    // Make sure the merge combinations are ready.
-    if (mParamMergeCombinations.empty())
-    {
-        buildMergeCombinations();
-    }
-
     // Create the full used merged params - means FLOAT4 params that all of their components are used.
     for (unsigned int i=0; i < mParamMergeCombinations.size(); ++i)
     {
@@ -164,6 +164,18 @@ bool SubRenderState::addFunctionInvocations( ProgramSet* programSet )
     return true;
 }
 
+//-----------------------------------------------------------------------
+void SubRenderState::appendSignature(String& signature, uint32 value)
+{
+    signature.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+//-----------------------------------------------------------------------
+void SubRenderState::appendSignature(String& signature, float value)
+{
+    signature.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
 //-----------------------------------------------------------------------
 SubRenderStateAccessorPtr SubRenderState::getAccessor()
 {
@@ -122,6 +122,7 @@ THE SOFTWARE.
 #include "OgreStringVector.h"
 #include "OgreSubEntity.h"
 #include "OgreSubMesh.h"
+#include "OgreTaskScheduler.h"
 #include "OgreTechnique.h"
 #include "OgreTextureManager.h"
 #include "OgreTextureUnitState.h"
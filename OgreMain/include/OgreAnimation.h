@@ -423,6 +423,33 @@ namespace Ogre {
         */
         void optimise(bool discardIdentityNodeTracks = true);
 
+        /** Replaces the node tracks by a compact, quantized copy of them.
+        @remarks
+            Keys are stored in contiguous arrays, with 48 bit rotations and
+            16 bit translation and scale components, and keys which can be
+            interpolated from their neighbours within the given tolerances
+            are dropped (@see CompressedNodeTracks). The compressed tracks
+            are applied to skeletons by the apply methods taking a Skeleton,
+            and saved by SkeletonSerializer.
+        @par
+            The node tracks are destroyed, so this is only suitable for
+            skeletal animations which are not edited afterwards. Any base
+            keyframe is applied first, and interpolation is always linear
+            whatever the interpolation mode. Animations using this one as
+            their base keyframe animation must be compressed before it.
+        @param translateTolerance Largest error allowed on translations
+        @param rotationTolerance Largest error allowed on rotations
+        @param scaleTolerance Largest error allowed on scales
+        */
+        void compressNodeTracks(Real translateTolerance = 0.001f,
+            const Radian& rotationTolerance = Radian(0.001f), Real scaleTolerance = 0.001f);
+
+        /// The compressed node tracks, null unless compressNodeTracks was called
+        const CompressedNodeTracks* getCompressedNodeTracks(void) const { return mCompressedNodeTracks; }
+
+        /// Internal method to set the compressed node tracks, which the animation then owns
+        void _setCompressedNodeTracks(CompressedNodeTracks* tracks);
+
         /// A list of track handles
         typedef set<ushort>::type TrackHandleList;
 
@@ -462,6 +489,14 @@ namespace Ogre {
             global keyframe time list.
         */
         TimeIndex _getTimeIndex(Real timePos) const;
+
+        /** Internal method to get the time of the last key frame at or before a time position.
+        @remarks
+            The time position is wrapped like in _getTimeIndex first. Applying the
+            animation at the returned time needs no interpolation between key frames
+            for tracks which are keyed at that time.
+        */
+        Real _getPrecedingKeyFrameTime(Real timePos) const;
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -500,6 +535,15 @@ namespace Ogre {
         
         /// Internal method to adjust keyframes relative to a base keyframe (@see setUseBaseKeyFrame) */
         void _applyBaseKeyFrame();
+
+        /** Internal method to perform all lazy updates of the animation ahead of time.
+        @remarks
+            Applies the base keyframe, builds the keyframe time list and the
+            interpolation splines of the node tracks. After this, applying the
+            animation to different skeletons from several threads at once is safe
+            as long as the animation is not modified.
+        */
+        void _prepareForApply(void);
         
         void _notifyContainer(AnimationContainer* c);
         /** Retrieve the container of this animation. */
@@ -512,6 +556,8 @@ namespace Ogre {
         NumericTrackList mNumericTrackList;
         /// Vertex tracks, indexed by handle
         VertexTrackList mVertexTrackList;
+        /// Compressed replacement of the node tracks, if any
+        CompressedNodeTracks* mCompressedNodeTracks;
         String mName;
 
         Real mLength;
@@ -384,6 +384,10 @@ namespace Ogre
         NodeAnimationTrack* _clone(Animation* newParent) const;
         
         void _applyBaseKeyFrame(const KeyFrame* base);
+
+        /** Internal method to build the interpolation splines now rather than on the
+            first spline interpolation, so the track can be applied from several threads. */
+        void _buildInterpolationSplines(void) const;
         
     protected:
         /// Specialised keyframe creation
@@ -58,6 +58,14 @@ namespace Ogre {
         BillboardParticleRenderer();
         ~BillboardParticleRenderer();
 
+        /** Number of particles whose billboards are generated by one task when
+            ParticleSystemManager::setParallelUpdate is enabled.
+        */
+        static const size_t PARALLEL_CHUNK_SIZE = 4096;
+
+        /// Internal method to copy the particle properties used by its billboard
+        static void _particleToBillboard(Billboard& bb, const Particle* p, bool selfOriented);
+
         /** Command object for billboard type (see ParamCommand).*/
         class _OgrePrivate CmdBillboardType : public ParamCommand
         {
@@ -202,7 +210,9 @@ namespace Ogre {
         const String& getType(void) const;
         /// @copydoc ParticleSystemRenderer::_updateRenderQueue
         void _updateRenderQueue(RenderQueue* queue, 
-            list<Particle*>::type& currentParticles, bool cullIndividually);
+            vector<Particle*>::type& currentParticles, bool cullIndividually);
+        /// @copydoc ParticleSystemRenderer::_isParallelUpdateSupported
+        bool _isParallelUpdateSupported(void) const { return true; }
         /// @copydoc ParticleSystemRenderer::visitRenderables
         void visitRenderables(Renderable::Visitor* visitor, 
             bool debugRenderables = false);
@@ -247,6 +247,18 @@ namespace Ogre {
         @param pBillboard Reference to billboard
         */
         void genVertices(const Vector3* const offsets, const Billboard& pBillboard);
+        /** Internal method for generating vertex data at pDest, advancing it
+            past the vertices written.
+        */
+        void genVertices(float*& pDest, const Vector3* const offsets, const Billboard& pBillboard);
+
+        /** Internal method for generating the vertices of a billboard at pDest.
+        @remarks
+            camX, camY and vOffset are the axes and offsets computed in beginBillboards,
+            they are overwritten for billboard types which need them per billboard.
+        */
+        void genBillboard(float*& pDest, Vector3& camX, Vector3& camY,
+            Vector3* vOffset, const Billboard& bb);
 
         /** Internal method generates vertex offsets.
         @remarks
@@ -548,6 +560,18 @@ namespace Ogre {
         void beginBillboards(size_t numBillboards = 0);
         /** Define a billboard. */
         void injectBillboard(const Billboard& bb);
+        /** Define a range of billboards at a fixed position.
+        @remarks
+            Unlike injectBillboard, the billboards are written to the vertex buffer
+            starting at index @a first rather than after the last one injected, and
+            the number of billboards to render is not updated, use
+            _setNumVisibleBillboards once all ranges are injected. Ranges which don't
+            overlap may be injected from several threads at the same time, as long as
+            accurate facing is disabled. Billboards can't be culled individually this way.
+        */
+        void injectBillboards(size_t first, const Billboard* billboards, size_t count);
+        /// Set the number of billboards to render after using injectBillboards
+        void _setNumVisibleBillboards(size_t num);
         /** Finish defining billboards. */
         void endBillboards(void);
         /** Set the bounds of the BillboardSet.
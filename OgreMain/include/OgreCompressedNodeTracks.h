@@ -0,0 +1,178 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __CompressedNodeTracks_H__
+#define __CompressedNodeTracks_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAnimationState.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Quantized copy of the node tracks of a skeletal animation.
+    @remarks
+        The keys of all tracks are stored in a few contiguous arrays instead
+        of one TransformKeyFrame object per key. Rotations take 48 bits,
+        the three smallest components of the quaternion being kept with 15
+        bits of precision, translations and scales are quantized to 16 bits
+        per component over the range of values of their track. Keys which
+        can be interpolated from their neighbours within a tolerance are
+        dropped, as are channels which never leave the identity.
+    @par
+        Tracks are sampled in batches of TRACKS_PER_BATCH: the keys around
+        the time position are gathered first, then the keys of the whole
+        batch are interpolated in flat loops the compiler can vectorise.
+        Interpolation is always linear, using the shortest path for
+        rotations, whatever the interpolation modes of the Animation.
+    @par
+        Created by Animation::compressNodeTracks, and saved and loaded by
+        SkeletonSerializer.
+    */
+    class _OgreExport CompressedNodeTracks : public AnimationAlloc
+    {
+    public:
+        /// Number of tracks sampled together
+        static const size_t TRACKS_PER_BATCH = 64;
+
+        /** Compresses the node tracks of an animation.
+        @param parent The animation, its node tracks are left untouched
+        @param translateTolerance The largest distance between a translation
+            key which is dropped and the value interpolated from the keys kept
+        @param rotationTolerance The largest angle between a rotation key
+            which is dropped and the interpolated rotation
+        @param scaleTolerance The largest difference between a scale key
+            which is dropped and the interpolated scale
+        */
+        CompressedNodeTracks(Animation* parent, Real translateTolerance,
+            const Radian& rotationTolerance, Real scaleTolerance);
+        /// Creates empty tracks, used by SkeletonSerializer
+        CompressedNodeTracks(Animation* parent);
+
+        /// Copies the tracks for another animation
+        CompressedNodeTracks* _clone(Animation* newParent) const;
+
+        /// Number of tracks
+        size_t getNumTracks(void) const { return mTracks.size(); }
+        /// Handle of the bone animated by a track
+        unsigned short getTrackHandle(size_t index) const { return mTracks[index].handle; }
+
+        /** Samples all tracks.
+        @param timePos The time position in the animation, wrapped like in
+            AnimationTrack::getInterpolatedKeyFrame
+        @param rotations, translates, scales Arrays of getNumTracks elements
+            receiving the value of each track
+        */
+        void sample(Real timePos, Quaternion* rotations, Vector3* translates, Vector3* scales) const;
+
+        /** Get the time of the last key at or before a time position, which is
+            wrapped like in sample first.
+        */
+        Real getPrecedingKeyTime(Real timePos) const;
+
+        /** Applies the tracks to the bones of a skeleton.
+        @remarks
+            The parameters and the blending are the same as for
+            Animation::apply(Skeleton*, Real, float, const AnimationState::BoneBlendMask*, Real).
+        */
+        void apply(Skeleton* skeleton, Real timePos, Real weight,
+            const AnimationState::BoneBlendMask* blendMask, Real scale) const;
+
+        /// Changes the bone handles of the tracks, used when merging skeletons
+        void _remapHandles(const vector<ushort>::type& handleMap);
+
+        /// Size in bytes of the compressed keys
+        size_t getMemoryUsage(void) const;
+
+    protected:
+        friend class SkeletonSerializer;
+
+        enum Channel
+        {
+            CH_ROTATION,
+            CH_TRANSLATE,
+            CH_SCALE,
+            CH_COUNT
+        };
+
+        /// Keys of one channel of a track
+        struct KeyRange
+        {
+            /// Index of the first key in mKeyTimes and mKeyValues
+            uint32 first;
+            uint32 count;
+        };
+
+        struct Track
+        {
+            unsigned short handle;
+            KeyRange keys[CH_COUNT];
+            /// Decoding of the translation and scale keys, value = offset + key * step
+            Vector3 offset[2];
+            Vector3 step[2];
+        };
+        typedef vector<Track>::type TrackList;
+
+        /** Samples the tracks [first, first + count).
+        @param timeIndex Index in mTimes of the first time not before timePos
+        */
+        void sampleBatch(Real timePos, uint16 timeIndex, size_t first, size_t count,
+            Quaternion* rotations, Vector3* translates, Vector3* scales) const;
+        /** Finds the keys of a channel around a time position.
+        @returns The interpolation factor between key1 and key2
+        */
+        Real findKeys(Real timePos, uint16 timeIndex, const KeyRange& range,
+            Channel channel, uint32& key1, uint32& key2) const;
+        /// Wraps the time position and looks up its index in mTimes
+        uint16 findTime(Real& timePos) const;
+
+        static void encodeRotation(const Quaternion& q, uint16* data);
+        static Quaternion decodeRotation(const uint16* data);
+
+        Animation* mParent;
+        TrackList mTracks;
+        /// The times of the keys of all tracks
+        vector<float>::type mTimes;
+        /// Per channel, the index in mTimes of each key
+        vector<uint16>::type mKeyTimes[CH_COUNT];
+        /// Per channel, the three quantized components of each key
+        vector<uint16>::type mKeyValues[CH_COUNT];
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __CompressedNodeTracks_H__
@@ -87,6 +87,42 @@ namespace Ogre {
         typedef set<Entity*>::type EntitySet;
         typedef map<unsigned short, bool>::type SchemeHardwareAnimMap;
         typedef vector<SubEntity*>::type SubEntityList;
+
+        /** Reduced skeletal animation detail for entities far away or small on screen,
+            see setAnimationLodLevels.
+        */
+        struct AnimationLodLevel
+        {
+            /// LOD value from which this level is used, in the terms of the LOD strategy
+            /// of the mesh, e.g. a distance
+            Real userValue;
+            /// Number of frames between evaluations of the skeleton
+            unsigned short updateInterval;
+            /// Bones deeper in the hierarchy are not animated, the root bones have a depth of 0
+            unsigned short maxBoneDepth;
+            /// Whether animations are applied at their preceding key frame rather than interpolated
+            bool snapToKeyFrames;
+
+            AnimationLodLevel(Real value, unsigned short interval = 1,
+                unsigned short maxDepth = std::numeric_limits<unsigned short>::max(), bool snap = false)
+                : userValue(value), updateInterval(interval), maxBoneDepth(maxDepth), snapToKeyFrames(snap) {}
+        };
+        typedef vector<AnimationLodLevel>::type AnimationLodLevelList;
+
+        /// Outcome of the last update of the bone matrices
+        enum SkeletonUpdateResult
+        {
+            /// The bone matrices were already up to date for this frame
+            SUR_UP_TO_DATE,
+            /// The skeleton was evaluated in full detail
+            SUR_EVALUATED,
+            /// The skeleton was evaluated at a reduced animation LOD level
+            SUR_REDUCED,
+            /// Evaluation was skipped since nothing animating the skeleton had changed
+            SUR_UNCHANGED,
+            /// Evaluation was skipped due to the update interval of the animation LOD level
+            SUR_THROTTLED
+        };
     protected:
 
         /** Private constructor (instances cannot be created directly).
@@ -187,6 +223,23 @@ namespace Ogre {
         /// It's a pointer because it can be shared between different entities with
         /// a shared skeleton.
         unsigned long *mFrameBonesLastUpdated;
+        /// Dirty frame number of the animation state the bone matrices were last evaluated for.
+        unsigned long mBoneMatricesAnimationDirtyFrame;
+        /// Animation LOD index the bone matrices were last evaluated at.
+        ushort mBoneMatricesAnimationLodIndex;
+        /// Records the last frame in which the animation states were applied to the skeleton.
+        unsigned long mFrameSkeletonLastEvaluated;
+        /// Outcome of the last update of the bone matrices.
+        SkeletonUpdateResult mLastSkeletonUpdate;
+
+        /// Animation LOD levels, in order of decreasing detail.
+        AnimationLodLevelList mAnimationLodLevels;
+        /// LOD values of the levels transformed by the mesh LOD strategy, preceded by its base value.
+        vector<Real>::type mAnimationLodValues;
+        /// Current animation LOD, 0 for full detail.
+        ushort mAnimationLodIndex;
+        /// Frame in which mAnimationLodIndex was calculated.
+        unsigned long mAnimationLodFrame;
 
         /** A set of all the entities which shares a single SkeletonInstance.
             This is only created if the entity is in fact sharing it's SkeletonInstance with
@@ -196,9 +249,12 @@ namespace Ogre {
 
         /** Private method to cache bone matrices from skeleton.
         @return
-            True if the bone matrices cache has been updated. False if note.
+            SUR_EVALUATED or SUR_REDUCED if the bone matrices cache has been updated.
         */
-        bool cacheBoneMatrices(void);
+        SkeletonUpdateResult cacheBoneMatrices(void);
+
+        /// Record the outcome of a bone matrices update and count it in the statistics of the SceneManager.
+        void notifySkeletonUpdate(SkeletonUpdateResult result);
 
         /// Flag determines whether or not to display skeleton.
         bool mDisplaySkeleton;
@@ -742,6 +798,56 @@ namespace Ogre {
         */
         void _updateAnimation(void);
 
+        /** Advanced method to evaluate the skeleton of the entity and cache its bone matrices.
+        @remarks
+            This is used by SceneManager::setParallelSkeletalAnimation to evaluate the
+            skeletons of many entities on worker threads ahead of the render queue update.
+            Like _updateAnimation, the skeleton is evaluated at most once a frame. In
+            addition, evaluation is skipped if neither the animation states nor the manual
+            bones have changed since the last time.
+            The outcome is recorded for _getLastSkeletonUpdate, but not counted
+            in the SceneManager statistics, since this may run on a worker thread.
+        @return
+            The outcome of the update.
+        */
+        SkeletonUpdateResult _updateSkeletonAnimation(void);
+
+        /** Get the outcome of the last update of the bone matrices.
+        */
+        SkeletonUpdateResult _getLastSkeletonUpdate(void) const { return mLastSkeletonUpdate; }
+
+        /** Set levels of reduced skeletal animation detail.
+        @remarks
+            Like mesh LOD levels, the levels apply from a LOD value of the LOD strategy
+            of the mesh on, and are in order of decreasing detail. The mesh LOD bias
+            is taken into account. Below the value of the first level, the skeleton
+            is evaluated in full detail every frame.
+        @par
+            The most detailed level needed by any camera rendering the entity in a
+            frame is used. With SceneManager::setParallelSkeletalAnimation, skeletons
+            are evaluated ahead of culling, using the level for the first camera
+            rendering the scene in a frame.
+        @param levels The levels, an empty list disables animation LOD.
+        */
+        void setAnimationLodLevels(const AnimationLodLevelList& levels);
+
+        /** Get the levels of reduced skeletal animation detail, see setAnimationLodLevels.
+        */
+        const AnimationLodLevelList& getAnimationLodLevels(void) const { return mAnimationLodLevels; }
+
+        /** Pick the animation LOD for a camera rendering the entity this frame.
+        @remarks
+            Keeps the most detailed level picked in the current frame. Called by
+            _notifyCurrentCamera, and by the SceneManager before evaluating skeletons
+            ahead of culling.
+        */
+        void _updateAnimationLod(Camera* cam);
+
+        /** Get the current animation LOD, 0 for full detail or the index into
+            getAnimationLodLevels plus 1.
+        */
+        ushort getAnimationLodIndex(void) const { return mAnimationLodIndex; }
+
         /** Tests if any animation applied to this entity.
         @remarks
             An entity is animated if any animation state is enabled, or any manual bone
@@ -120,7 +120,29 @@ namespace Ogre {
             return msIgnoreHidden;
         }
 
+        /** Set whether files opened read-only are memory mapped.
+        @remarks
+            Mapped files are returned as MemoryDataStream, so their contents can be
+            used in place without being read into a separate buffer first. Meshes
+            use this to fill their hardware buffers straight from the file. Files
+            which can not be mapped, or platforms without support, use the usual
+            file streams. The default is false.
+        @note
+            The file must not be modified while a stream on it is open.
+        */
+        static void setMemoryMappingEnabled(bool enabled)
+        {
+            msMemoryMapping = enabled;
+        }
+
+        /// Get whether files opened read-only are memory mapped.
+        static bool getMemoryMappingEnabled()
+        {
+            return msMemoryMapping;
+        }
+
         static bool msIgnoreHidden;
+        static bool msMemoryMapping;
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
@@ -302,8 +302,8 @@ namespace Ogre {
             Saving and loading are implemented by back end (sometimes third 
             party) codecs.  Implemented saving functionality is more limited
             than loading in some cases. Particularly DDS file format support 
-            is currently limited to true colour or single channel float32, 
-            square, power of two textures with no mipmaps.  Volumetric support
+            is currently limited to true colour, single channel float32 or
+            DXT1, DXT5, BC4 and BC5 compressed power of two textures.  Volumetric support
             is currently limited to DDS files.
         */
         void save(const String& filename);
@@ -418,13 +418,41 @@ namespace Ogre {
             @param  dst         PixelBox containing the destination pointer, dimensions and format
             @param  filter      Which filter to use
             @remarks    This function can do pixel format conversion in the process.
+            @remarks    FILTER_BOX, FILTER_TRIANGLE and FILTER_BICUBIC (Catmull-Rom) filter
+                2D images with a kernel which is widened to cover all source pixels
+                when shrinking, 3D images are filtered bilinearly.
             @note   dst and src can point to the same PixelBox object without any problem
         */
         static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR);
         
         /** Resize a 2D image, applying the appropriate filter. */
         void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
-        
+
+        /** Generate the mipmap chain down to 1x1 from the top level.
+            @remarks
+                Any existing mipmaps are replaced. Each level is filtered from the
+                previous one, the faces of cubemaps are processed in parallel and
+                large levels are split by rows between the TaskScheduler threads.
+            @param filter Which filter to use, see scale
+            @param gammaCorrect Whether the colours are sRGB encoded, they are
+                filtered in linear space then
+            @param maxMipmaps The maximum number of levels below the top one
+        */
+        void generateMipmaps(Filter filter = FILTER_BILINEAR, bool gammaCorrect = false,
+            uint32 maxMipmaps = 0x7FFFFFFF);
+
+        /** Compress all faces and mipmaps of the image into a block compressed format.
+            @remarks
+                Useful to store textures in a GPU format offline, e.g. by saving
+                the result as DDS, so they do not need to be compressed or
+                decompressed at load time. Generate the mipmaps first if required.
+                The block rows of large levels are encoded in parallel.
+            @param format PF_DXT1 (alpha is discarded), PF_DXT5, PF_BC4_UNORM
+                (red channel), PF_BC5_UNORM (red and green channels), PF_ETC1_RGB8,
+                PF_ETC2_RGB8 (both alpha is discarded) or PF_ETC2_RGBA8
+        */
+        void compress(PixelFormat format);
+
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
 
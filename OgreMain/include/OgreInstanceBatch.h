@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreRenderable.h"
 #include "OgreMovableObject.h"
 #include "OgreMesh.h"
+#include "OgreAtomicScalar.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre
@@ -118,6 +119,8 @@ namespace Ogre
         Real                mBoundingRadius;
         bool                mBoundsDirty;
         bool                mBoundsUpdated; //Set to false by derived classes that need it
+        /// Set by _boundsDirtyDeferred, may be written by several threads at once
+        AtomicScalar<uint32> mBoundsDirtyDeferred;
         Camera              *mCurrentCamera;
 
         unsigned short      mMaterialLodIndex;
@@ -281,6 +284,16 @@ namespace Ogre
         */
         virtual void _boundsDirty(void);
 
+        /** Like _boundsDirty, but safe to call from several threads at once.
+        @remarks
+            Used while the scene graph is updated in parallel. The batch is only
+            flagged, _applyDeferredBoundsDirty calls _boundsDirty afterwards.
+        */
+        void _boundsDirtyDeferred(void) { mBoundsDirtyDeferred.store(1); }
+
+        /// Calls _boundsDirty if _boundsDirtyDeferred was called since the last time
+        void _applyDeferredBoundsDirty(void);
+
         /** Tells this batch to stop updating animations, positions, rotations, and display
             all it's active instances. Currently only InstanceBatchHW & InstanceBatchHW_VTF support it.
             This option makes the batch behave pretty much like Static Geometry, but with the GPU RAM
@@ -293,6 +293,11 @@ namespace Ogre
         /** Called by SceneManager when we told it we have at least one dirty batch */
         void _updateDirtyBatches(void);
 
+        /** Called by SceneManager after a parallel scene graph update, tells the
+            batches whose instances moved meanwhile that their bounds are dirty
+        */
+        void _applyDeferredBoundsDirty(void);
+
         typedef ConstMapIterator<InstanceBatchMap> InstanceBatchMapIterator;
         typedef ConstVectorIterator<InstanceBatchVec> InstanceBatchIterator;
 
@@ -0,0 +1,120 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __LightGrid_H__
+#define __LightGrid_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreCommon.h"
+#include "OgreVector3.h"
+#include "OgreMemoryFrameAlloc.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** A uniform grid over the range spheres of a list of lights.
+    @remarks
+        Used by SceneManager::_populateLightList to find the lights which
+        may affect an object without testing every light affecting the
+        frustum. The grid is built once per change of that list, each light
+        being registered in every cell its range overlaps, so a query only
+        needs to look at the cells overlapped by the object.
+    @par
+        Directional lights, and lights whose range covers much of the grid,
+        are not put into cells but returned by every query.
+    @par
+        Queries don't modify the grid, so they may run on several threads at
+        once, as long as the grid is not rebuilt meanwhile.
+    */
+    class _OgreExport LightGrid : public SceneMgtAlloc
+    {
+    public:
+        /// Below this number of lights a linear search is faster
+        static const size_t MIN_LIGHTS = 16;
+        /// Maximum number of cells along each axis
+        static const size_t MAX_CELLS_PER_AXIS = 32;
+
+        /// Result of a query, short lived so it uses the frame allocator
+        typedef std::vector<Light*, STLAllocator<Light*, FrameAllocPolicy> > FoundLightList;
+
+        LightGrid();
+
+        /** Builds the grid for the given lights.
+        @remarks
+            The derived positions and attenuation ranges are read once,
+            so the grid has to be rebuilt whenever lights were moved.
+        */
+        void build(const LightList& lights);
+
+        /** Finds the lights which may affect a sphere.
+        @remarks
+            The result contains every light whose range intersects the
+            sphere, but may contain others too. It is in the same order as
+            the list the grid was built from.
+        */
+        void findLights(const Sphere& sphere, FoundLightList& destList) const;
+
+        /// Number of lights the grid was built from
+        size_t getNumLights(void) const { return mLights.size(); }
+
+    protected:
+        typedef vector<uint32>::type IndexList;
+        typedef std::vector<uint32, STLAllocator<uint32, FrameAllocPolicy> > FoundIndexList;
+
+        /// Cell index along an axis, clamped to the grid
+        size_t getCell(Real pos, int axis) const;
+        /// Cell ranges overlapped by a box, returns the number of cells
+        size_t getCellRange(const Vector3& min, const Vector3& max,
+            size_t* first, size_t* last) const;
+
+        /// The lights the grid was built from
+        LightList mLights;
+        /// Lights returned by every query
+        IndexList mGlobalLights;
+        /// Start of each cell in mCellLights, plus the end of the last
+        IndexList mCellStart;
+        /// Light indices of all cells
+        IndexList mCellLights;
+
+        Vector3 mOrigin;
+        Vector3 mInvCellSize;
+        size_t mNumCells[3];
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __LightGrid_H__
@@ -112,6 +112,29 @@ namespace Ogre {
 
         typedef vector<LogListener*>::type mtLogListener;
         mtLogListener mListeners;
+
+        /// Queue and thread used in asynchronous mode
+        class AsyncWriter;
+        AsyncWriter* mAsyncWriter;
+
+        /// Time stamp of the last written message and its formatted form
+        time_t mLastTime;
+        String mLastTimeStamp;
+
+        /** Guards the listeners, settings and outputs against the writer thread.
+        @remarks
+            OGRE_AUTO_MUTEX is only a real mutex with full thread support, the
+            writer thread of the asynchronous mode exists in every threading mode.
+        */
+        OGRE_WQ_MUTEX(mOutputMutex);
+
+        /** Calls the listeners and writes the message out, mOutputMutex has to be held.
+        @param flush Whether to flush the outputs after writing.
+        */
+        void writeMessage(const String& message, LogMessageLevel lml, bool maskDebug, time_t time, bool flush);
+
+        /// Flushes the file and console outputs, mOutputMutex has to be held
+        void flushOutput();
     public:
 
         class Stream;
@@ -146,6 +169,32 @@ namespace Ogre {
         /** Get a stream object targeting this log. */
         Stream stream(LogMessageLevel lml = LML_NORMAL, bool maskDebug = false);
 
+        /** Enable or disable asynchronous logging.
+        @remarks
+            In asynchronous mode logMessage only puts the message into a lock
+            free queue. A background thread takes the messages from there, calls
+            the listeners and writes them out in batches, so the listeners are
+            called from that thread. Critical messages are only returned from
+            once they and all messages before them have been written.
+        @par
+            Must not be called while other threads log to this log. Without
+            thread support the log stays synchronous.
+        @param async Whether to log asynchronously.
+        @param queueSize The number of messages the queue holds, rounded up
+            to a power of two. Callers wait for the background thread while
+            it is full.
+        */
+        void setAsynchronous(bool async, size_t queueSize = 4096);
+
+        /// Get whether messages are logged asynchronously
+        bool isAsynchronous() const { return mAsyncWriter != 0; }
+
+        /** Block until all messages logged so far have been written.
+        @remarks
+            Does nothing unless the log is asynchronous.
+        */
+        void flush();
+
         /**
         @remarks
             Enable or disable outputting log messages to the debugger.
@@ -174,10 +174,12 @@ namespace Ogre
         MEMCATEGORY_SCRIPTING = 6,
         /// Rendersystem structures
         MEMCATEGORY_RENDERSYS = 7,
+        /// Temporaries released before the end of the frame, see FrameAllocPolicy
+        MEMCATEGORY_FRAME = 8,
 
         
         // sentinel value, do not use 
-        MEMCATEGORY_COUNT = 8
+        MEMCATEGORY_COUNT = 9
     };
     /** @} */
     /** @} */
@@ -186,6 +188,7 @@ namespace Ogre
 
 #include "OgreMemoryAllocatedObject.h"
 #include "OgreMemorySTLAllocator.h"
+#include "OgreMemoryFrameAlloc.h"
 
 #if OGRE_MEMORY_ALLOCATOR == OGRE_MEMORY_ALLOCATOR_NEDPOOLING
 
@@ -246,6 +249,9 @@ namespace Ogre
 
 namespace Ogre
 {
+    // Temporaries of a frame come from per thread blocks, whatever the allocator
+    template <> class CategorisedAllocPolicy<MEMCATEGORY_FRAME> : public FrameAllocPolicy{};
+
     // Useful shortcuts
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_GENERAL> GeneralAllocPolicy;
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_GEOMETRY> GeometryAllocPolicy;
@@ -0,0 +1,175 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MemoryFrameAlloc_H__
+#define __MemoryFrameAlloc_H__
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Memory
+    *  @{
+    */
+    /** An allocation policy for short lived data, like the temporaries built
+        and thrown away while rendering a frame. This is the policy of
+        MEMCATEGORY_FRAME, use it with STLAllocator for such containers.
+    @remarks
+        Every thread allocates linearly from blocks of its own, deallocating
+        only counts the live allocations of the thread down. As soon as none
+        of them is alive any more, the thread allocates from the start of its
+        blocks again. As long as nothing allocated here is kept beyond the
+        frame this happens at the end of every frame at the latest.
+    @par
+        Allocations are aligned to 16 bytes. Large allocations, and any
+        allocation of a thread which already holds too many blocks, are passed
+        on to the heap, so the policy stays correct when misused and just gets
+        slower.
+    */
+    class _OgreExport FrameAllocPolicy
+    {
+    public:
+        /// Allocation counts of a frame, summed over all threads
+        struct Statistics
+        {
+            /// Number of allocations served by the per thread blocks
+            size_t numAllocations;
+            /// Number of bytes allocated from the per thread blocks
+            size_t numBytes;
+            /// Number of allocations which were passed on to the heap
+            size_t numHeapAllocations;
+
+            Statistics() : numAllocations(0), numBytes(0), numHeapAllocations(0) {}
+        };
+
+        static DECL_MALLOC void* allocateBytes(size_t count,
+            const char* file = 0, int line = 0, const char* func = 0);
+
+        static void deallocateBytes(void* ptr);
+
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize()
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+
+        /** Completes the statistics of the current frame.
+        @note Called by Root at the end of every frame.
+        */
+        static void _frameEnded(void);
+
+        /** Lets another thread take over the blocks of the calling thread.
+        @note Done automatically when a thread exits, the work queues call
+            it before their threads exit.
+        */
+        static void _threadEnded(void);
+
+        /** Frees the blocks no thread uses anymore.
+        @note Called by Root when it is destroyed, after its threads ended.
+        */
+        static void _shutdown(void);
+
+        /// Get the allocation counts of the last completed frame
+        static Statistics getLastFrameStatistics(void);
+
+        /// Get the number of bytes held in blocks by all threads
+        static size_t getReservedBytes(void);
+
+    private:
+        // no instantiation
+        FrameAllocPolicy()
+        { }
+    };
+
+    /** Sorts like std::stable_sort, but takes the temporary buffer from
+        MEMCATEGORY_FRAME instead of the heap.
+    @remarks
+        Ranges of up to 16 elements are sorted in place without any buffer.
+    */
+    template <typename RandomIt, typename Compare>
+    void frameStableSort(RandomIt first, RandomIt last, Compare comp)
+    {
+        typedef typename std::iterator_traits<RandomIt>::value_type T;
+        const size_t RUN_SIZE = 16;
+        const size_t size = last - first;
+        if (size < 2)
+            return;
+
+        // Insertion sort runs of RUN_SIZE elements
+        for (size_t begin = 0; begin < size; begin += RUN_SIZE)
+        {
+            RandomIt runBegin = first + begin;
+            RandomIt runEnd = first + std::min(begin + RUN_SIZE, size);
+            for (RandomIt i = runBegin + 1; i < runEnd; ++i)
+            {
+                T value = *i;
+                RandomIt j = i;
+                for (; j != runBegin && comp(value, *(j - 1)); --j)
+                    *j = *(j - 1);
+                *j = value;
+            }
+        }
+        if (size <= RUN_SIZE)
+            return;
+
+        // Merge the runs, going back and forth between the range and the buffer
+        std::vector<T, STLAllocator<T, FrameAllocPolicy> > buffer(first, last);
+        bool inBuffer = false;
+        for (size_t width = RUN_SIZE; width < size; width *= 2)
+        {
+            for (size_t begin = 0; begin < size; begin += 2 * width)
+            {
+                size_t mid = std::min(begin + width, size);
+                size_t end = std::min(begin + 2 * width, size);
+                if (inBuffer)
+                    std::merge(buffer.begin() + begin, buffer.begin() + mid,
+                        buffer.begin() + mid, buffer.begin() + end, first + begin, comp);
+                else
+                    std::merge(first + begin, first + mid,
+                        first + mid, first + end, buffer.begin() + begin, comp);
+            }
+            inBuffer = !inBuffer;
+        }
+        if (inBuffer)
+            std::copy(buffer.begin(), buffer.end(), first);
+    }
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __MemoryFrameAlloc_H__
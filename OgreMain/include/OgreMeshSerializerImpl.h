@@ -174,6 +174,14 @@ namespace Ogre {
         virtual void readPoseKeyFrame(DataStreamPtr& stream, VertexAnimationTrack* track);
         virtual void readExtremes(DataStreamPtr& stream, Mesh *pMesh);
 
+        /** Fill a whole buffer straight from the memory of the stream.
+        @remarks
+            Only possible if the stream is memory based (e.g. a memory mapped
+            file) and no endian flip is needed. This saves copying the data
+            through a locked region, the buffer gets it in a single write.
+        @return false if the buffer was not filled, it has to be read as usual
+        */
+        bool readBufferDirect(DataStreamPtr& stream, HardwareBuffer* buf);
 
         /// Flip an entire vertex buffer from little endian
         virtual void flipFromLittleEndian(void* pData, size_t vertexCount, size_t vertexSize, const VertexDeclaration::VertexElementList& elems);
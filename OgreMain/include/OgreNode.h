@@ -207,6 +207,19 @@ namespace Ogre {
         */
         virtual void updateFromParentImpl(void) const;
 
+        /** Class-specific implementation of applying a derived transform
+            which was calculated elsewhere.
+        @remarks
+            NodeTransformStorage calculates the derived transforms of many
+            nodes at once and uses this instead of updateFromParentImpl.
+            Subclasses reacting to transform changes in updateFromParentImpl
+            should do the same here.
+        */
+        virtual void setDerivedTransformImpl(const Vector3& position,
+            const Quaternion& orientation, const Vector3& scale) const;
+
+        friend class NodeTransformStorage;
+
 
         /** Internal method for creating a new child node - must be overridden per subclass. */
         virtual Node* createChildImpl(void) = 0;
@@ -585,6 +598,24 @@ namespace Ogre {
         */
         virtual void _update(bool updateChildren, bool parentHasChanged);
 
+        /// List of children to update, paired with the 'parentHasChanged' flag to pass on
+        typedef vector<std::pair<Node*, bool> >::type ChildUpdateList;
+
+        /** Internal method to update this Node only, leaving the children to the caller.
+        @note
+            Performs the same work as _update(true, parentHasChanged) would on this node,
+            but instead of recursing appends the children that need updating to the given
+            list. The caller must call _update(true, flag) on every appended child. This
+            is used to split the scene graph update across several threads; any work a
+            subclass does after its children are updated (e.g. SceneNode::_updateBounds)
+            is also left to the caller.
+        @param parentHasChanged
+            This flag indicates that the parent transform has changed.
+        @param children
+            List the children which need updating are appended to.
+        */
+        void _updateSelf(bool parentHasChanged, ChildUpdateList& children);
+
         /** Sets a listener for this Node.
         @remarks
             Note for size and performance reasons only one listener per node is
@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _NodeTransformStorage_H__
+#define _NodeTransformStorage_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Packs the transforms of a node hierarchy into structure of arrays blocks.
+    @remarks
+        The nodes below a root are laid out breadth first, so all nodes of one
+        depth are contiguous and every parent is stored before its children.
+        Local and derived positions, orientations and scales are kept in
+        separate component arrays, which allows calculating the derived
+        transforms of a whole depth level with a single call to
+        OptimisedUtil::concatenateNodeTransforms instead of walking the
+        hierarchy node by node.
+    @par
+        The nodes themselves remain the owners of their transforms, the
+        storage only gathers the local transforms before and writes the derived
+        transforms back after each sweep. The same nodes are updated as with
+        Node::_update, and the results are identical. The layout is rebuilt
+        lazily after _notifyHierarchyChanged was called.
+    @note
+        Only nodes which rely on the default Node::_update are supported.
+        Node::Listener::nodeUpdated is raised per depth level rather than
+        depth first.
+    */
+    class _OgreExport NodeTransformStorage : public NodeAlloc
+    {
+    public:
+        typedef vector<Node*>::type NodeList;
+
+        NodeTransformStorage();
+        ~NodeTransformStorage();
+
+        /** Updates the derived transforms of a node and its descendants.
+        @remarks
+            Equivalent to calling <tt>root->Node::_update(true, false)</tt>. Any
+            work which subclasses do after updating their children, like
+            SceneNode::_updateBounds, is left to the caller, see getUpdatedNodes.
+        */
+        void update(Node* root);
+
+        /** Nodes which were visited by the last update, ordered by depth.
+        @remarks
+            Iterating this list backwards processes children before their
+            parents.
+        */
+        const NodeList& getUpdatedNodes(void) const { return mUpdatedNodes; }
+
+        /// Number of nodes in the current layout
+        size_t getNumNodes(void) const { return mNumNodes; }
+
+        /// Tell the storage that nodes were attached or detached
+        void _notifyHierarchyChanged(void) { mLayoutOutOfDate = true; }
+
+    protected:
+        /// Flags kept per slot for the current update
+        enum SlotFlags
+        {
+            /// Node was reached by the update
+            SF_VISITED = 0x1,
+            /// Node derived transform must be recalculated
+            SF_RECALCULATE = 0x2,
+            /// All children must be recalculated
+            SF_CHILDREN_CHANGED = 0x4
+        };
+
+        /// Range of slots holding one depth level
+        struct Level
+        {
+            size_t begin;
+            size_t end;
+        };
+        typedef vector<Level>::type LevelList;
+        typedef vector<size_t>::type IndexList;
+        typedef vector<uint8>::type FlagList;
+
+        /// Number of components per transform, position, orientation and scale
+        static const size_t NUM_COMPONENTS = 10;
+
+        /// Rebuild the layout for the given root
+        void buildLayout(Node* root);
+        /// (Re)allocate the component arrays for the current stride
+        void allocateBuffers(void);
+        void freeBuffers(void);
+
+        /// Nodes per slot, padding slots are null
+        NodeList mNodes;
+        /// Slot of the parent node per slot
+        IndexList mParents;
+        LevelList mLevels;
+        FlagList mFlags;
+        NodeList mUpdatedNodes;
+
+        /// Derived transforms of the parents, gathered per slot
+        Real* mParentTransforms;
+        /// Local transforms
+        Real* mLocalTransforms;
+        /// Derived transforms
+        Real* mDerivedTransforms;
+        /// Number of slots, the size of each component array
+        size_t mStride;
+        size_t mNumNodes;
+
+        Node* mRoot;
+        bool mLayoutOutOfDate;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // _NodeTransformStorage_H__
@@ -203,6 +203,52 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Combine parent and local node transforms stored as structure of arrays.
+        @remarks
+            Computes the same derived position, orientation and scale as
+            Node::_updateFromParent does with orientation and scale inheritance
+            enabled. Each buffer holds ten components per node, stored as
+            separate arrays of @c stride elements each: position x, y, z,
+            orientation w, x, y, z and scale x, y, z. So component c of
+            node i is found at <tt>buffer[c * stride + i]</tt>.
+        @param parent Derived transforms of the parent nodes.
+        @param local Local transforms of the nodes.
+        @param derived Buffer to store the derived transforms, must not
+            overlap the input buffers.
+        @param stride Number of elements in each component array, must be
+            a multiple of 4. All buffers must be aligned to SIMD alignment.
+        @param numNodes Number of nodes to process.
+        */
+        virtual void concatenateNodeTransforms(
+            const Real* parent,
+            const Real* local,
+            Real* derived,
+            size_t stride,
+            size_t numNodes) = 0;
+
+        /** Test axis aligned boxes stored as structure of arrays against planes.
+        @remarks
+            A box is visible unless it lies entirely on the negative side of one
+            of the planes, which is the test Frustum::isVisible does for finite
+            boxes, with identical results. Each buffer component is an array of
+            @c stride elements: centre x, y, z and half size x, y, z, so component
+            c of box i is found at <tt>boxes[c * stride + i]</tt>.
+        @param planes Planes to test against, normals pointing inside.
+        @param numPlanes Number of planes.
+        @param boxes Centres and half sizes of the boxes, aligned to SIMD alignment.
+        @param stride Number of elements in each component array, must be a
+            multiple of 4.
+        @param numBoxes Number of boxes to test.
+        @param visible Receives 1 for each visible box and 0 for the others.
+        */
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* boxes,
+            size_t stride,
+            size_t numBoxes,
+            uint8* visible) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
@@ -107,8 +107,40 @@ namespace Ogre {
             pSystem Pointer to a ParticleSystem to affect.
         @param
             timeElapsed The number of seconds which have elapsed since the last call.
+        @note
+            The default implementation passes all active particles to _affectParticleRange,
+            so an affector needs to implement only one of the two methods. An exception is
+            thrown when it implements neither.
         */
-        virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
+        virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+
+        /** Method called to apply the affector to a contiguous range of active particles.
+        @remarks
+            Affectors which change every particle on its own, without looking at the other
+            particles, should implement this and return true from _isParticleRangeSupported.
+            When all affectors of a system do so, the system updates its particles in small
+            blocks, expiring, affecting and moving each block in one go while it is in the
+            cache, instead of calling _affectParticles for the whole system.
+        @param
+            particles Pointer to the first particle of the range.
+        @param
+            count The number of particles in the range.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        */
+        virtual void _affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed);
+
+        /** Returns whether this affector implements _affectParticleRange. */
+        virtual bool _isParticleRangeSupported(void) const { return false; }
+
+        /** Whether this affector may be used while other systems are updated.
+        @remarks
+            When ParticleSystemManager::setParallelUpdate is enabled, a system is only
+            updated on a worker thread if all its affectors return true. Only do so if
+            the affector touches nothing but the particles and its own settings, shared
+            state such as Math::UnitRandom is not safe to use.
+        */
+        virtual bool _isParallelUpdateSupported(void) const { return false; }
 
         /** Returns the name of the type of affector. 
         @remarks
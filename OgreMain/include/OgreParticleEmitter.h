@@ -169,6 +169,11 @@ namespace Ogre {
         */
         virtual void genEmissionDirection( const Vector3 &particlePos, Vector3& destVector );
 
+        /** Internal utility method deviating a direction by the given angle, see
+            Vector3::randomDeviant.
+        */
+        Vector3 randomDeviant(const Vector3& direction, const Radian& angle, const Vector3& up);
+
         /** Internal utility method to apply velocity to a particle direction.
         @param destVector The vector to scale by a randomly generated scale between min and max speed.
             Assumed normalised already, and likely already oriented in the right direction.
@@ -184,6 +189,20 @@ namespace Ogre {
         /** Internal utility method for generating an emission count based on a constant emission rate. */
         virtual unsigned short genConstantEmissionCount(Real timeElapsed);
 
+        /** Internal utility method for generating a random value in the range [0,1].
+        @remarks
+            Uses the generator of the parent system, see ParticleSystem::_getRandomUnit,
+            so that systems can be updated in parallel. Use this rather than
+            Math::UnitRandom in subclasses.
+        */
+        Real genRandomUnit(void);
+
+        /** Internal utility method for generating a random value in the range [low,high]. */
+        Real genRandomRange(Real low, Real high) { return (high - low) * genRandomUnit() + low; }
+
+        /** Internal utility method for generating a random value in the range [-1,1]. */
+        Real genRandomSymmetric(void) { return 2 * genRandomUnit() - 1; }
+
         /** Internal method for setting up the basic parameter definitions for a subclass. 
         @remarks
             Because StringInterface holds a dictionary of parameters per class, subclasses need to
@@ -539,6 +558,15 @@ namespace Ogre {
         /** Set the indication (true/false) to indicate that the emitter is emitted by another emitter */
         virtual void setEmitted(bool emitted);
 
+        /** Whether this emitter may be used while other systems are updated.
+        @remarks
+            See ParticleAffector::_isParallelUpdateSupported. The helpers of this
+            class generate random values with the generator of the parent system,
+            so subclasses which only use them, genRandomUnit and their own data
+            may return true.
+        */
+        virtual bool _isParallelUpdateSupported(void) const { return false; }
+
 
     };
     /** @} */
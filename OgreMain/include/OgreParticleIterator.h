@@ -46,12 +46,12 @@ namespace Ogre {
     {
         friend class ParticleSystem;
     protected:
-        list<Particle*>::type::iterator mPos;
-        list<Particle*>::type::iterator mStart;
-        list<Particle*>::type::iterator mEnd;
+        vector<Particle*>::type::iterator mPos;
+        vector<Particle*>::type::iterator mStart;
+        vector<Particle*>::type::iterator mEnd;
 
         /// Protected constructor, only available from ParticleSystem::getIterator
-        ParticleIterator(list<Particle*>::type::iterator start, list<Particle*>::type::iterator end);
+        ParticleIterator(vector<Particle*>::type::iterator start, vector<Particle*>::type::iterator end);
 
     public:
         /// Returns true when at the end of the particle list
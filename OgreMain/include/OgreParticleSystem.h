@@ -347,6 +347,51 @@ namespace Ogre {
         */
         void _update(Real timeElapsed);
 
+        /** Does the part of _update which has to be done on the main thread.
+        @remarks
+            Used by ParticleSystemManager to update several systems concurrently,
+            _update is equivalent to calling _prepareUpdate, _performUpdate and
+            _finishUpdate in turn.
+        @param timeElapsed
+            The time since the last frame, scaled by the speed factor on return.
+        @return
+            false if the system does not need updating this time.
+        */
+        bool _prepareUpdate(Real& timeElapsed);
+
+        /** Updates the particles, emitting new ones and updating the bounds.
+        @remarks
+            Only touches data owned by this system, so it may be called from a
+            worker thread after _prepareUpdate, provided the affectors, emitters
+            and renderer (see ParticleSystemRenderer::_isParallelUpdateSupported)
+            don't touch shared data either.
+        */
+        void _performUpdate(Real timeElapsed);
+
+        /** Notifies the parent node about changed bounds, on the main thread. */
+        void _finishUpdate(void);
+
+        /** Whether _performUpdate may run on a worker thread while other systems
+            are updated, i.e. the renderer, all emitters and all affectors support it.
+        */
+        bool _isParallelUpdateSupported(void) const;
+
+        /** Returns a random value in the range [0,1] from the generator of this system.
+        @remarks
+            Emitters and affectors use this rather than Math::UnitRandom, which
+            shares its state between all systems, so that they can be updated in
+            parallel. The generator is seeded through Math::UnitRandom when the
+            system is created.
+        */
+        Real _getRandomUnit(void)
+        {
+            // xorshift, the top 24 bits fill the mantissa of a float
+            mRandomState ^= mRandomState << 13;
+            mRandomState ^= mRandomState >> 17;
+            mRandomState ^= mRandomState << 5;
+            return Real(mRandomState >> 8) * (Real(1) / Real(0xFFFFFF));
+        }
+
         /** Returns an iterator for stepping through all particles in this system.
         @remarks
             This method is designed to be used by people providing new ParticleAffector subclasses,
@@ -355,6 +400,17 @@ namespace Ogre {
         */
         ParticleIterator _getIterator(void);
 
+        /// The active particles of a system, in no particular order
+        typedef vector<Particle*>::type ActiveParticleList;
+
+        /** Returns the active particles of this system.
+        @remarks
+            The particles are stored contiguously, which allows affectors to process
+            them as a range, see ParticleAffector::_affectParticleRange. The list must
+            not be resized, particles are added and removed by the system only.
+        */
+        ActiveParticleList& _getActiveParticles(void) { return mActiveParticles; }
+
         /** Sets the name of the material to be used for this billboard set.
             @param
                 name The new name of the material to use for this set.
@@ -704,9 +760,14 @@ namespace Ogre {
         /// Used to control if the particle system should emit particles or not.
         bool mIsEmitting;
 
-        typedef list<Particle*>::type ActiveParticleList;
-        typedef list<Particle*>::type FreeParticleList;
+        typedef vector<Particle*>::type FreeParticleList;
         typedef vector<Particle*>::type ParticlePool;
+        /// A block of particles allocated at once, with the number of particles in it
+        typedef std::pair<Particle*, size_t> ParticleBlock;
+        typedef vector<ParticleBlock>::type ParticleBlockList;
+
+        /// Number of particles expired, affected and moved together by _updateParticles
+        static const size_t PARTICLE_UPDATE_BLOCK_SIZE = 256;
 
         /** Sort by direction functor */
         struct SortByDirectionFunctor
@@ -732,23 +793,24 @@ namespace Ogre {
 
         /** Active particle list.
             @remarks
-                This is a linked list of pointers to particles in the particle pool.
+                This is a contiguous array of pointers to particles in the particle pool.
             @par
-                This allows very fast insertions and deletions from anywhere in 
-                the list to activate / deactivate particles as well as reuse of 
-                Particle instances in the pool without construction & destruction 
-                which avoids memory thrashing.
+                Particles are activated by appending them and deactivated by moving
+                the last particle into their place, so both are constant time and
+                the particles can be processed as a range without chasing list links.
+                Particle instances in the pool are reused without construction & 
+                destruction which avoids memory thrashing.
         */
         ActiveParticleList mActiveParticles;
 
-        /** Free particle queue.
+        /** Free particle stack.
             @remarks
-                This contains a list of the particles free for use as new instances
+                This contains the particles free for use as new instances
                 as required by the set. Particle instances are preconstructed up 
                 to the estimated size in the mParticlePool vector and are 
-                referenced on this deque at startup. As they get used this list
+                referenced on this stack at startup. As they get used this stack
                 reduces, as they get released back to to the set they get added
-                back to the list.
+                back to the stack.
         */
         FreeParticleList mFreeParticles;
 
@@ -758,6 +820,9 @@ namespace Ogre {
         */
         ParticlePool mParticlePool;
 
+        /// The memory of the particles in mParticlePool, each pool increase is one block
+        ParticleBlockList mParticleBlocks;
+
         typedef list<ParticleEmitter*>::type FreeEmittedEmitterList;
         typedef list<ParticleEmitter*>::type ActiveEmittedEmitterList;
         typedef vector<ParticleEmitter*>::type EmittedEmitterList;
@@ -818,9 +883,39 @@ namespace Ogre {
         /// Default nonvisible update timeout
         static Real msDefaultNonvisibleTimeout;
 
+        /// Number of particles requested by each emitter, in _triggerEmitters
+        vector<unsigned>::type mRequestedEmissions;
+        /// Number of particles requested by each emitted emitter, in _triggerEmitters
+        vector<unsigned>::type mEmittedRequestedEmissions;
+
+        /// Whether the bounds were recalculated by the last _performUpdate
+        bool mBoundsUpdated;
+
+        /// State of the random generator of this system, never 0
+        uint32 mRandomState;
+
+        /** Recalculates the bounds, returns false if they are not updated any more. */
+        bool calculateBounds(void);
+
         /** Internal method used to expire dead particles. */
         void _expire(Real timeElapsed);
 
+        /** Expire dead particles in the range [begin, end) of the active particles.
+        @remarks
+            The survivors are moved down to start at index dest, keeping their order,
+            dest must not be greater than begin. Returns the end of the survivors.
+            The caller shrinks the active particles once all ranges are done.
+        */
+        size_t _expire(size_t begin, size_t end, size_t dest, Real timeElapsed);
+
+        /** Expires, affects and moves the existing particles.
+        @remarks
+            If all affectors support ParticleAffector::_affectParticleRange this is
+            done in a single pass over blocks of particles, otherwise in separate
+            passes by _expire, _triggerAffectors and _applyMotion.
+        */
+        void _updateParticles(Real timeElapsed);
+
         /** Spawn new particles based on free quota and emitter requirements. */
         void _triggerEmitters(Real timeElapsed);
 
@@ -831,6 +926,9 @@ namespace Ogre {
         /** Updates existing particle based on their momentum. */
         void _applyMotion(Real timeElapsed);
 
+        /** Moves the particles in the range [begin, end) of the active particles. */
+        void _applyMotion(size_t begin, size_t end, Real timeElapsed);
+
         /** Applies the effects of affectors. */
         void _triggerAffectors(Real timeElapsed);
 
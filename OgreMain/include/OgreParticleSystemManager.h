@@ -99,6 +99,12 @@ namespace Ogre {
         // Factory instance
         ParticleSystemFactory* mFactory;
 
+        /// Whether systems are updated concurrently
+        bool mParallelUpdate;
+        typedef vector<std::pair<ParticleSystem*, Real> >::type QueuedUpdateList;
+        /// Systems waiting for _updateQueuedSystems, along with the time elapsed
+        QueuedUpdateList mQueuedUpdates;
+
         /** Internal script parsing method. */
         void parseNewEmitter(const String& type, DataStreamPtr& chunk, ParticleSystem* sys);
         /** Internal script parsing method. */
@@ -341,6 +347,29 @@ namespace Ogre {
                 mSystemTemplates.begin(), mSystemTemplates.end());
         } 
 
+        /** Sets whether particle systems are updated concurrently.
+        @remarks
+            By default each particle system is updated by its frame time controller
+            as soon as the controller runs. When this is enabled, the updates are
+            queued instead and carried out by _updateQueuedSystems, which spreads the
+            systems over the threads of the TaskScheduler. The billboards of large
+            systems are generated in parallel chunks as well.
+        @par
+            Systems whose renderer, emitters or affectors don't support it (see
+            ParticleSystem::_isParallelUpdateSupported) are still updated on the
+            main thread. Disabled by default.
+        */
+        void setParallelUpdate(bool enabled);
+        /** Gets whether particle systems are updated concurrently. */
+        bool getParallelUpdate(void) const { return mParallelUpdate; }
+
+        /** Internal method to defer the update of a system to _updateQueuedSystems. */
+        void _queueUpdate(ParticleSystem* sys, Real timeElapsed);
+        /** Internal method to drop the queued update of a system being detached. */
+        void _cancelUpdate(ParticleSystem* sys);
+        /** Updates all queued systems, called by SceneManager after the controllers. */
+        void _updateQueuedSystems(void);
+
         /** Get an instance of ParticleSystemFactory (internal use). */
         ParticleSystemFactory* _getFactory(void) { return mFactory; }
         
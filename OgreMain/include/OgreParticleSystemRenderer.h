@@ -50,7 +50,7 @@ namespace Ogre {
     {
     public:
         /// Constructor
-        ParticleSystemRenderer() {}
+        ParticleSystemRenderer() : mForwardMovedToList(true), mForwardClearedToList(true) {}
         /// Destructor
         virtual ~ParticleSystemRenderer() {}
 
@@ -63,7 +63,7 @@ namespace Ogre {
             instance(s) it wishes.
         */
         virtual void _updateRenderQueue(RenderQueue* queue, 
-            list<Particle*>::type& currentParticles, bool cullIndividually) = 0;
+            vector<Particle*>::type& currentParticles, bool cullIndividually) = 0;
 
         /** Sets the material this renderer must use; called by ParticleSystem. */
         virtual void _setMaterial(MaterialPtr& mat) = 0;
@@ -83,10 +83,51 @@ namespace Ogre {
         virtual void _notifyParticleEmitted(Particle* particle) {}
         /** Optional callback notified when particle expired */
         virtual void _notifyParticleExpired(Particle* particle) {}
-        /** Optional callback notified when particles moved */
-        virtual void _notifyParticleMoved(list<Particle*>::type& currentParticles) {}
-        /** Optional callback notified when particles cleared */
-        virtual void _notifyParticleCleared(list<Particle*>::type& currentParticles) {}
+        /** Optional callback notified when particles moved
+        @remarks
+            The default implementation forwards to the list overload, which renderers
+            written before the particles were kept in a vector override. The particles
+            are only copied to a list while that overload is overridden.
+        */
+        virtual void _notifyParticleMoved(vector<Particle*>::type& currentParticles)
+        {
+            if (mForwardMovedToList)
+            {
+                list<Particle*>::type particles(currentParticles.begin(), currentParticles.end());
+                _notifyParticleMoved(particles);
+            }
+        }
+        /** Optional callback notified when particles cleared
+        @remarks
+            Forwards to the list overload like _notifyParticleMoved.
+        */
+        virtual void _notifyParticleCleared(vector<Particle*>::type& currentParticles)
+        {
+            if (mForwardClearedToList)
+            {
+                list<Particle*>::type particles(currentParticles.begin(), currentParticles.end());
+                _notifyParticleCleared(particles);
+            }
+        }
+        /** @deprecated override the vector overload instead */
+        virtual void _notifyParticleMoved(list<Particle*>::type& currentParticles)
+        {
+            // not overridden, no need to copy the particles again
+            mForwardMovedToList = false;
+        }
+        /** @deprecated override the vector overload instead */
+        virtual void _notifyParticleCleared(list<Particle*>::type& currentParticles)
+        {
+            mForwardClearedToList = false;
+        }
+        /** Whether the particle callbacks above may be called from a worker thread.
+        @remarks
+            When ParticleSystemManager::setParallelUpdate is enabled, systems using
+            this renderer are only updated concurrently with other systems if this
+            returns true. Renderers which e.g. move scene nodes from the callbacks
+            must keep the default.
+        */
+        virtual bool _isParallelUpdateSupported(void) const { return false; }
         /** Create a new ParticleVisualData instance for attachment to a particle.
         @remarks
             If this renderer needs additional data in each particle, then this should
@@ -127,6 +168,10 @@ namespace Ogre {
         virtual void visitRenderables(Renderable::Visitor* visitor, 
             bool debugRenderables = false) = 0;
 
+    private:
+        /// Whether the list overloads of the particle callbacks may be overridden
+        bool mForwardMovedToList;
+        bool mForwardClearedToList;
     };
 
     /** Abstract class definition of a factory object for ParticleSystemRenderer. */
@@ -116,10 +116,23 @@ namespace Ogre {
 #   define __OGRE_HAVE_MSA  1
 #endif
 
+/* Define whether or not Ogre compiled with SSE2 support. Every x86-64 CPU has
+   it, 32 bit builds need a compiler which provides the intrinsics without
+   enabling them for the whole build.
+*/
+#if __OGRE_HAVE_SSE && (OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64 || \
+    OGRE_COMPILER == OGRE_COMPILER_MSVC || defined(__SSE2__))
+#   define __OGRE_HAVE_SSE2  1
+#endif
+
 #ifndef __OGRE_HAVE_SSE
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+#ifndef __OGRE_HAVE_SSE2
+#   define __OGRE_HAVE_SSE2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -207,6 +220,15 @@ namespace Ogre {
         */
         static bool hasCpuFeature(CpuFeatures feature);
 
+        /** Internal method to hide CPU features from getCpuFeatures and hasCpuFeature.
+        @remarks
+            Code checking for features at run-time then takes its fallback
+            paths, which lets them be compared with the SIMD ones. Code which
+            has chosen its implementation already, like OptimisedUtil, is not
+            affected.
+        @param mask The features which may be reported, e.g. ~0u for all
+        */
+        static void _setCpuFeatureMask(uint mask);
 
         /** Write the CPU information to the passed in Log */
         static void log(Log* pLog);
@@ -156,6 +156,7 @@ namespace Ogre {
     class Camera;
     class Codec;
     class ColourValue;
+    class CompressedNodeTracks;
     class ConfigDialog;
     template <typename T> class Controller;
     template <typename T> class ControllerFunction;
@@ -205,6 +206,7 @@ namespace Ogre {
     class Image;
     class KeyFrame;
     class Light;
+    class LightGrid;
     class Log;
     class LogManager;
     class LodStrategy;
@@ -227,6 +229,7 @@ namespace Ogre {
     class Node;
     class NodeAnimationTrack;
     class NodeKeyFrame;
+    class NodeTransformStorage;
     class NumericAnimationTrack;
     class NumericKeyFrame;
     class Particle;
@@ -281,6 +284,7 @@ namespace Ogre {
     class SceneManager;
     class SceneManagerEnumerator;
     class SceneNode;
+    class SceneNodeCuller;
     class SceneQuery;
     class SceneQueryListener;
     class ScriptCompiler;
@@ -295,6 +299,7 @@ namespace Ogre {
     class SimpleSpline;
     class Skeleton;
     class SkeletonInstance;
+    class SkinningBatch;
     class SkeletonManager;
     class Sphere;
     class SphereSceneQuery;
@@ -305,6 +310,8 @@ namespace Ogre {
     class SubEntity;
     class SubMesh;
     class TagPoint;
+    class TaskGraph;
+    class TaskScheduler;
     class Technique;
     class TempBlendedBufferInfo;
     class ExternalTextureSource;
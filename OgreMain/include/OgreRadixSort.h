@@ -322,6 +322,86 @@ namespace Ogre {
 
     };
 
+    /** Stable radix sort of values by 64 bit keys.
+    @remarks
+        Unlike RadixSort this sorts on a single precomputed key, so several
+        sort criteria can be combined by packing them into one key, with the
+        most significant criterion in the high bits. Only byte positions
+        where the keys differ are sorted on, and already sorted input is
+        detected up front.
+    @par
+        The class has no state, all storage is supplied by the caller. It is
+        therefore safe to sort several lists in parallel, and no allocation
+        takes place once the scratch list has grown to the size required.
+    */
+    template <typename TValue>
+    class KeyedRadixSort
+    {
+    public:
+        struct Entry
+        {
+            uint64 key;
+            TValue value;
+        };
+        typedef typename vector<Entry>::type EntryList;
+
+        /** Sorts the entries ascending by key.
+        @param entries The entries to sort
+        @param scratch Temporary storage, its contents are undefined afterwards
+        */
+        static void sort(EntryList& entries, EntryList& scratch)
+        {
+            const size_t size = entries.size();
+            if (size < 2)
+                return;
+
+            // Histograms of all bytes in a single pass
+            uint32 counters[8][256];
+            memset(counters, 0, sizeof(counters));
+            bool needsSorting = false;
+            uint64 prevKey = entries[0].key;
+            for (size_t i = 0; i < size; ++i)
+            {
+                uint64 key = entries[i].key;
+                needsSorting |= key < prevKey;
+                prevKey = key;
+                for (int p = 0; p < 8; ++p)
+                    ++counters[p][(key >> (p * 8)) & 0xFF];
+            }
+
+            // early exit if already sorted
+            if (!needsSorting)
+                return;
+
+            scratch.resize(size);
+            EntryList* src = &entries;
+            EntryList* dest = &scratch;
+            for (int p = 0; p < 8; ++p)
+            {
+                const int shift = p * 8;
+                // Skip bytes which are the same in all keys
+                if (counters[p][(entries[0].key >> shift) & 0xFF] == size)
+                    continue;
+
+                size_t offsets[256];
+                offsets[0] = 0;
+                for (int b = 1; b < 256; ++b)
+                    offsets[b] = offsets[b-1] + counters[p][b-1];
+
+                for (size_t i = 0; i < size; ++i)
+                {
+                    const Entry& e = (*src)[i];
+                    (*dest)[offsets[(e.key >> shift) & 0xFF]++] = e;
+                }
+                std::swap(src, dest);
+            }
+
+            // Result is in src, swap the storage rather than copying
+            if (src != &entries)
+                entries.swap(scratch);
+        }
+    };
+
     /** @} */
     /** @} */
 
@@ -53,6 +53,7 @@ namespace Ogre {
         /// Pointer to the Pass
         Pass* pass;
 
+        RenderablePass() : renderable(0), pass(0) {}
         RenderablePass(Renderable* rend, Pass* p) :renderable(rend), pass(p) {}
     };
 
@@ -196,38 +197,11 @@ namespace Ogre {
         /** Map of pass to renderable lists, this is a grouping by pass. */
         typedef map<Pass*, RenderableList, PassGroupLess>::type PassGroupRenderableMap;
 
-        /// Functor for accessing sort value 1 for radix sort (Pass)
-        struct RadixSortFunctorPass
-        {
-            uint32 operator()(const RenderablePass& p) const
-            {
-                return p.pass->getHash();
-            }
-        };
-
-        /// Radix sorter for accessing sort value 1 (Pass)
-        static RadixSort<RenderablePassList, RenderablePass, uint32> msRadixSorter1;
-
-        /// Functor for descending sort value 2 for radix sort (distance)
-        struct RadixSortFunctorDistance
-        {
-            const Camera* camera;
-
-            RadixSortFunctorDistance(const Camera* cam)
-                : camera(cam)
-            {
-            }
-
-            float operator()(const RenderablePass& p) const
-            {
-                // Sort DESCENDING by depth (ie far objects first), use negative distance
-                // here because radix sorter always dealing with accessing sort
-                return static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
-            }
-        };
-
-        /// Radix sorter for sort value 2 (distance)
-        static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
+        typedef KeyedRadixSort<RenderablePass> RenderablePassSort;
+        /// Keyed items for the radix sort of mSortedDescending
+        RenderablePassSort::EntryList mSortEntries;
+        /// Scratch space of the radix sort
+        RenderablePassSort::EntryList mSortScratch;
 
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
@@ -247,6 +221,21 @@ namespace Ogre {
     public:
         QueuedRenderableCollection();
 
+        /** Calculates the radix sort key of a renderable pass.
+        @remarks
+            The key orders by descending depth first and by pass hash second,
+            which groups passes with equal depth.
+        */
+        static uint64 _getSortKey(Real squaredViewDepth, uint32 passHash)
+        {
+            // Map the float to an unsigned int with the same order, then
+            // invert it to sort descending
+            union { float f; uint32 u; } depth;
+            depth.f = static_cast<float>(squaredViewDepth);
+            uint32 depthKey = (depth.u & 0x80000000) ? depth.u : ~(depth.u | 0x80000000);
+            return (static_cast<uint64>(depthKey) << 32) | passHash;
+        }
+
         /// Empty the collection
         void clear(void);
 
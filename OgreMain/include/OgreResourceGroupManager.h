@@ -433,6 +433,17 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+
+        /// Whether resources of a group are prepared on several threads
+        bool mParallelPrepare;
+        /// Whether scripts are tokenized and parsed on several threads
+        bool mParallelScriptParsing;
+        /** Prepares the resources of a group in parallel, one loading order at a time.
+        @remarks
+            Must be called without holding the locks of the group or this class,
+            since the resources open their files through it from other threads.
+        */
+        void prepareResourcesParallel(ResourceGroup* grp);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -523,6 +534,30 @@ namespace Ogre {
         */
         void initialiseAllResourceGroups(void);
 
+        /** Sets whether the scripts of a group are parsed in parallel when
+            it is initialised.
+        @remarks
+            When enabled, the scripts handled by the ScriptCompilerManager
+            (.material, .program, .compositor, .particle etc.) are read,
+            tokenized and parsed on the threads of the TaskScheduler before
+            they are compiled. Everything which depends on other scripts or
+            creates resources, i.e. the conversion to the abstract syntax tree,
+            imports, object inheritance and the translation, still runs on the
+            calling thread with the scripts in their usual order, so the
+            results are the same as without this option.
+        @par
+            Only scripts in FileSystem archives are parsed ahead, and none if a
+            ResourceLoadingListener is set, since it may replace the streams,
+            or if the script cache of the ScriptCompilerManager is enabled,
+            since it skips parsing unchanged scripts altogether.
+            A script which fails to parse is parsed again at its usual place,
+            which reports the error. Default is false.
+        */
+        void setParallelScriptParsing(bool enabled) { mParallelScriptParsing = enabled; }
+
+        /// Gets whether scripts are parsed in parallel
+        bool getParallelScriptParsing(void) const { return mParallelScriptParsing; }
+
         /** Prepares a resource group.
         @remarks
             Prepares any created resources which are part of the named group.
@@ -563,6 +598,30 @@ namespace Ogre {
         void loadResourceGroup(const String& name, bool loadMainResources = true, 
             bool loadWorldGeom = true);
 
+        /** Sets whether prepareResourceGroup and loadResourceGroup prepare
+            resources in parallel.
+        @remarks
+            When enabled, Resource::prepare (which does the file I/O and decoding,
+            e.g. of meshes and textures) is run for all resources of a group on
+            the threads of the TaskScheduler before the group is processed as
+            usual. Resources are prepared one loading order at a time, so e.g.
+            all materials are prepared before any mesh is. Loading, which may talk
+            to the render system, still happens on the calling thread, in order.
+        @par
+            Listeners receive the same callbacks as usual, but only after the
+            parallel preparation is done. A resource which fails to prepare is
+            tried again at its usual place, so the exception is thrown from the
+            same point as without this option.
+        @note
+            This requires a resource system which is thread safe, i.e.
+            OGRE_THREAD_SUPPORT 1 or 2. Otherwise the option has no effect.
+            Default is false.
+        */
+        void setParallelPrepare(bool enabled) { mParallelPrepare = enabled; }
+
+        /// Gets whether resources are prepared in parallel
+        bool getParallelPrepare(void) const { return mParallelPrepare; }
+
         /** Unloads a resource group.
         @remarks
             This method unloads all the resources that have been declared as
@@ -49,6 +49,8 @@ namespace Ogre
     *  @{
     */
 
+    class DefaultWorkQueueBase;
+
     typedef vector<RenderSystem*>::type RenderSystemList;
     
     /** The root class of the Ogre system.
@@ -145,6 +147,7 @@ namespace Ogre
         bool mIsInitialised;
 
         WorkQueue* mWorkQueue;
+        TaskScheduler* mTaskScheduler;
 
         ///Tells whether blend indices information needs to be passed to the GPU
         bool mIsBlendIndicesGpuRedundant;
@@ -175,6 +178,9 @@ namespace Ogre
         /// Internal method for one-time tasks after first window creation
         void oneTimePostWindowInit(void);
 
+        /// Apply the default settings of Root's work queue
+        void configureDefaultWorkQueue(DefaultWorkQueueBase* queue);
+
         /** Set of registered frame listeners */
         set<FrameListener*>::type mFrameListeners;
 
@@ -1033,6 +1039,28 @@ namespace Ogre
             at shutdown, so do not destroy it yourself.
         */
         void setWorkQueue(WorkQueue* queue);
+
+        /** Get the TaskScheduler for parallel loops and task graphs.
+        @remarks
+            The scheduler shares the threads of the WorkQueue and follows it
+            when the queue is replaced by setWorkQueue.
+        */
+        TaskScheduler* getTaskScheduler() const { return mTaskScheduler; }
+
+        /** Replace the work queue with one that uses work stealing, or with
+            the default one.
+        @remarks
+            WorkStealingWorkQueue keeps a request deque per worker thread, which
+            scales better than the single request queue of DefaultWorkQueue when
+            many small requests are added. The new queue uses the same settings
+            as the default queue Root creates. With the TBB thread provider the
+            default queue already steals work, so it is kept.
+        @note
+            Nothing happens if the current queue is already of the requested
+            kind. Otherwise handlers registered with the current queue are
+            lost, so call this before Root::initialise.
+        */
+        void setUseWorkStealingQueue(bool enable);
             
         /** Sets whether blend indices information needs to be passed to the GPU.
             When entities use software animation they remove blend information such as
@@ -210,6 +210,24 @@ namespace Ogre {
             Real skyBoxDistance;
         };
 
+        /** What was done to the skeletons of animated entities in a frame.
+        @see Entity::SkeletonUpdateResult
+        */
+        struct SkeletalAnimationStatistics
+        {
+            /// Skeletons evaluated with full detail
+            size_t numEvaluated;
+            /// Skeletons evaluated with a reduced animation LOD level
+            size_t numReduced;
+            /// Skeletons skipped since nothing animating them had changed
+            size_t numUnchanged;
+            /// Skeletons skipped due to the update interval of their animation LOD level
+            size_t numThrottled;
+
+            SkeletalAnimationStatistics()
+                : numEvaluated(0), numReduced(0), numUnchanged(0), numThrottled(0) {}
+        };
+
         /** Class that allows listening in on the various stages of SceneManager
             processing, so that custom behaviour can be implemented from outside.
         */
@@ -532,6 +550,16 @@ namespace Ogre {
         LightInfoList mCachedLightInfos;
         LightInfoList mTestLightInfos; // potentially new list
         ulong mLightsDirtyCounter;
+        /// Spatial index of mLightsAffectingFrustum, used by _populateLightList
+        LightGrid* mLightGrid;
+        /// Value of mLightsDirtyCounter when mLightGrid was built
+        ulong mLightGridDirtyCounter;
+        /** Rebuilds mLightGrid if the lights affecting the frustum changed.
+        @remarks
+            Called by _renderScene once these lights are found, so that objects
+            querying their lights afterwards only read the grid.
+        */
+        void updateLightGrid(void);
         LightList mShadowTextureCurrentCasterLightList;
 
         typedef map<String, MovableObject*>::type MovableObjectMap;
@@ -632,6 +660,29 @@ namespace Ogre {
         /// Flag indicating whether SceneNodes will be rendered as a set of 3 axes
         bool mDisplayNodes;
 
+        /// Whether the scene graph update is split across the TaskScheduler threads
+        bool mParallelNodeUpdate;
+        /// Minimum number of nodes in a subtree before it is updated as a separate task
+        size_t mParallelNodeUpdateThreshold;
+        /// Splits the scene graph update into tasks, only present while parallel update is on
+        class ParallelNodeUpdater;
+        ParallelNodeUpdater* mParallelNodeUpdater;
+        /// Whether worker threads are updating the scene graph right now
+        bool mUpdatingNodesInParallel;
+        /// Structure of arrays copy of the node transforms, only present while packed update is on
+        NodeTransformStorage* mNodeTransformStorage;
+        /// Flattened node bounds for batched culling, only present while it's on
+        SceneNodeCuller* mSceneNodeCuller;
+        /// Collects the software skinning of entities, only present while batched skinning is on
+        SkinningBatch* mSkinningBatch;
+        /// Whether blends are added to mSkinningBatch, only while visible objects are found
+        bool mSkinningBatchActive;
+        /// Evaluates entity skeletons in parallel, only present while parallel skeletal animation is on
+        class SkeletalAnimationUpdater;
+        SkeletalAnimationUpdater* mSkeletalAnimationUpdater;
+        /// What was done to the skeletons of entities in the current frame
+        SkeletalAnimationStatistics mSkeletalAnimationStats;
+
         /// Storage of animations, lookup by name
         AnimationList mAnimationsList;
         OGRE_MUTEX(mAnimationsListMutex);
@@ -1219,6 +1270,13 @@ namespace Ogre {
             those lights which are out of range or could not be affecting the frustum (i.e.
             only the lights returned by SceneManager::_getLightsAffectingFrustum are take into
             account).
+        @par
+            When there are many lights affecting the frustum, they are looked up in a
+            LightGrid which is rebuilt whenever the lights dirty counter changes.
+        @par
+            Apart from Light::_notifyIndexInFrame, this only reads shared data once the
+            grid is up to date, so the default implementation may be called from several
+            threads after _renderScene found the lights affecting the frustum.
         @par
             The number of items in the list max exceed the maximum number of lights supported
             by the renderer, but the extraneous ones will never be used. In fact the limit will
@@ -1789,6 +1847,15 @@ namespace Ogre {
         */
         virtual void _applySceneAnimations(void);
 
+        /** Internal method for evaluating the skeletons of animated entities ahead of culling.
+        @remarks
+            Does nothing unless parallel skeletal animation is enabled, see
+            setParallelSkeletalAnimation.
+        @param camera The camera the animation LOD of the entities is picked for
+            before their skeletons are evaluated, none to keep their current LOD.
+        */
+        virtual void _updateSkeletalAnimation(Camera* camera = 0);
+
         /** Sends visible objects found in _findVisibleObjects to the rendering engine.
         */
         virtual void _renderVisibleObjects(void);
@@ -2431,6 +2498,10 @@ namespace Ogre {
         /** Internal method for notifying the manager that a SceneNode is autotracking. */
         virtual void _notifyAutotrackingSceneNode(SceneNode* node, bool autoTrack);
 
+        /** Internal method for notifying the manager that SceneNodes were attached
+            to or detached from the scene graph. */
+        void _notifySceneGraphChanged(void);
+
         
         /** Creates an AxisAlignedBoxSceneQuery for this scene manager. 
         @remarks
@@ -3244,6 +3315,144 @@ namespace Ogre {
         */
         virtual bool getFlipCullingOnNegativeScale() const { return mFlipCullingOnNegativeScale; }
 
+        /** Set whether the scene graph transform update is split across worker threads.
+        @remarks
+            When enabled, _updateSceneGraph expands the top of the scene graph on the
+            calling thread until it has found enough independent subtrees, groups those
+            into tasks of at least getParallelNodeUpdateThreshold nodes and updates them
+            in parallel through the TaskScheduler.
+            Derived transforms and bounds are identical to the serial update, but
+            Node::Listener::nodeUpdated may be called from worker threads and in a 
+            different order, so such listeners must be thread safe. The same goes
+            for MovableObject::Listener::objectMoved.
+        @par
+            Scene managers whose nodes touch shared state in _update or _updateBounds,
+            like the octree, BSP and PCZ scene managers, do not support this, see
+            isParallelNodeUpdateSupported. Enabling it for them is ignored. The default
+            is false.
+        */
+        virtual void setParallelNodeUpdate(bool enabled);
+
+        /** Get whether the nodes of this scene manager may be updated in parallel,
+            see setParallelNodeUpdate.
+        */
+        virtual bool isParallelNodeUpdateSupported() const { return true; }
+
+        /** Get whether worker threads are updating the scene graph right now.
+        @remarks
+            Objects notified of moves must not touch shared state meanwhile.
+        */
+        bool _isUpdatingNodesInParallel() const { return mUpdatingNodesInParallel; }
+
+        /** Get whether the scene graph transform update is split across worker threads.
+        */
+        virtual bool getParallelNodeUpdate() const { return mParallelNodeUpdate; }
+
+        /** Set the minimum number of nodes a subtree must have to be updated as a separate
+            task when parallel node update is enabled, see setParallelNodeUpdate.
+        @remarks
+            Smaller sibling subtrees are batched together until they reach this size, and
+            scene graphs smaller than this are always updated on the calling thread.
+            The default is 1024.
+        */
+        virtual void setParallelNodeUpdateThreshold(size_t nodes) { mParallelNodeUpdateThreshold = std::max(nodes, (size_t)1); }
+
+        /** Get the minimum number of nodes a subtree must have to be updated as a separate
+            task, see setParallelNodeUpdateThreshold.
+        */
+        virtual size_t getParallelNodeUpdateThreshold() const { return mParallelNodeUpdateThreshold; }
+
+        /** Set whether the scene graph transform update works on packed transforms.
+        @remarks
+            When enabled, the node transforms are mirrored in a NodeTransformStorage,
+            which lays the nodes out by depth and calculates the derived transforms
+            of each depth level in one SIMD sweep. Derived transforms and bounds are
+            identical to the recursive update, but Node::Listener::nodeUpdated is
+            called level by level rather than depth first.
+        @par
+            Like setParallelNodeUpdate this bypasses SceneNode::_update, so it is not
+            suitable for the octree, BSP and PCZ scene managers. It takes precedence
+            over parallel node update. The default is false.
+        */
+        virtual void setPackedNodeTransforms(bool enabled);
+
+        /** Get whether the scene graph transform update works on packed transforms.
+        */
+        virtual bool getPackedNodeTransforms() const { return mNodeTransformStorage != 0; }
+
+        /** Set whether visible objects are found by culling node bounds in batches.
+        @remarks
+            When enabled, the default _findVisibleObjects uses a SceneNodeCuller,
+            which keeps a flattened copy of the scene graph and tests the world
+            bounds of all nodes against the camera frustum in SIMD batches, spread
+            over the TaskScheduler threads. The objects are queued in the same
+            order as by the recursive SceneNode::_findVisibleObjects.
+        @par
+            Scene managers which override _findVisibleObjects are not affected.
+            The camera must use the default Frustum::isVisible box test. The
+            default is false.
+        */
+        virtual void setBatchedCulling(bool enabled);
+
+        /** Get whether visible objects are found by culling node bounds in batches.
+        */
+        virtual bool getBatchedCulling() const { return mSceneNodeCuller != 0; }
+
+        /** Set whether software skinning of entities is done in batches.
+        @remarks
+            When enabled, entities which are updated while the visible objects
+            are found add their software vertex blends to a SkinningBatch rather
+            than performing them right away. The batch is flushed once all
+            objects are queued, skinning the vertices of all entities in
+            parallel on the TaskScheduler threads. Blends outside of that, e.g.
+            for shadow volumes, are still done immediately. The default is false.
+        */
+        virtual void setBatchedSkinning(bool enabled);
+
+        /** Get whether software skinning of entities is done in batches.
+        */
+        virtual bool getBatchedSkinning() const { return mSkinningBatch != 0; }
+
+        /** Internal method returning the batch software blends should be added to.
+        @return The batch, or null if blends must be performed immediately
+        */
+        SkinningBatch* _getSkinningBatch(void) const
+        { return mSkinningBatchActive ? mSkinningBatch : 0; }
+
+        /** Set whether the skeletons of animated entities are evaluated in parallel.
+        @remarks
+            When enabled, the skeletons of all visible entities in the scene with an
+            enabled animation state or manual bones are evaluated once a frame before
+            the scene graph is culled. This is spread over the TaskScheduler threads,
+            and the resulting bone matrices are cached for the rest of the frame.
+            Skeletons whose animation time positions, weights and manual bones have
+            not changed since they were last evaluated are skipped altogether.
+        @par
+            Entities with objects attached to their bones, and entities which are
+            not visible or not in the scene, are still animated when they are
+            rendered. Animation track listeners and bone Node::Listeners may be
+            called from worker threads. The default is false.
+        */
+        virtual void setParallelSkeletalAnimation(bool enabled);
+
+        /** Get whether the skeletons of animated entities are evaluated in parallel.
+        */
+        virtual bool getParallelSkeletalAnimation() const { return mSkeletalAnimationUpdater != 0; }
+
+        /** Get what was done to the skeletons of animated entities in the current frame.
+        @remarks
+            Counts each skeleton instance once, whether it was updated by the parallel
+            skeletal animation stage or while its entity was rendered. The statistics
+            are reset at the start of each frame's scene update.
+        */
+        const SkeletalAnimationStatistics& getSkeletalAnimationStatistics(void) const
+        { return mSkeletalAnimationStats; }
+
+        /** Internal method for recording the skeleton update of an entity.
+        @see Entity::_getLastSkeletonUpdate
+        */
+        void _notifySkeletonUpdated(const Entity* entity);
+
         /** Render something as if it came from the current queue.
             @param pass     Material pass to use for setting up this quad.
             @param rend     Renderable to render
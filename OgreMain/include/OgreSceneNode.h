@@ -84,6 +84,10 @@ namespace Ogre {
 
         void updateFromParentImpl(void) const;
 
+        /** See Node. */
+        void setDerivedTransformImpl(const Vector3& position,
+            const Quaternion& orientation, const Vector3& scale) const;
+
         /** See Node. */
         Node* createChildImpl(void);
 
@@ -310,6 +314,11 @@ namespace Ogre {
         */
         void _addBoundingBoxToQueue(RenderQueue* queue);
 
+        /** Add the node axes and bounding box to the rendering queue if they are
+            to be displayed, as _findVisibleObjects does after the children.
+        */
+        void _addDebugRenderablesToQueue(RenderQueue* queue, bool displayNodes);
+
         /** This allows scene managers to determine if the node's bounding box
             should be added to the rendering queue.
         @remarks
@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneNodeCuller_H__
+#define __SceneNodeCuller_H__
+
+#include "OgrePrerequisites.h"
+#include "OgrePlane.h"
+#include "OgreTaskScheduler.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    struct VisibleObjectsBoundsInfo;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Finds the visible objects of a scene graph by culling node bounds in batches.
+    @remarks
+        The nodes below a root are flattened depth first, with the end of each
+        subtree recorded so that culled subtrees can be skipped. Every frame
+        the world bounds of all nodes are gathered into structure of arrays
+        blocks and tested against the frustum planes by
+        OptimisedUtil::cullAxisAlignedBoxes, four boxes at a time with SSE.
+        Blocks are culled in parallel by the TaskScheduler.
+    @par
+        The visible objects are then queued on the calling thread, in the
+        same order and with the same results as SceneNode::_findVisibleObjects,
+        since MovableObject::_notifyCurrentCamera and _updateRenderQueue are
+        not safe to call concurrently. The flattened layout is kept between
+        frames and rebuilt lazily after _notifyHierarchyChanged was called.
+    @note
+        Cameras and culling frustums are expected to use the default
+        Frustum::isVisible test for bounding boxes.
+    */
+    class _OgreExport SceneNodeCuller : public ParallelForBody, public SceneMgtAlloc
+    {
+    public:
+        typedef vector<SceneNode*>::type NodeList;
+
+        /// Number of nodes culled by one task
+        static const size_t NODES_PER_TASK = 2048;
+
+        SceneNodeCuller();
+        ~SceneNodeCuller();
+
+        /** Finds the visible objects below a node and adds them to the queue.
+        @remarks
+            Equivalent to <tt>root->_findVisibleObjects(cam, queue, visibleBounds,
+            true, displayNodes, onlyShadowCasters)</tt>. The world bounds of the
+            nodes must be up to date.
+        */
+        void findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes, bool onlyShadowCasters);
+
+        /// Number of nodes in the current layout
+        size_t getNumNodes(void) const { return mNodes.size(); }
+
+        /// Tell the culler that nodes were attached or detached
+        void _notifyHierarchyChanged(void) { mLayoutOutOfDate = true; }
+
+        /// Culls the nodes of tasks [begin, end), called by the TaskScheduler
+        void execute(size_t begin, size_t end);
+
+    protected:
+        typedef vector<size_t>::type IndexList;
+        typedef vector<uint8>::type FlagList;
+
+        /// Number of components per box, centre and half size
+        static const size_t NUM_COMPONENTS = 6;
+
+        /// Rebuild the layout for the given root
+        void buildLayout(SceneNode* root);
+        /// Append a node and its descendants to the layout
+        void addSubtree(SceneNode* node);
+        void freeBuffers(void);
+
+        /// Nodes in depth first order
+        NodeList mNodes;
+        /// Index after the last descendant per node
+        IndexList mSubtreeEnds;
+        /// Result of the frustum test per node, ignoring its ancestors
+        FlagList mVisible;
+        /// Centres and half sizes of the node bounds
+        Real* mBoxes;
+        /// Size of each component array, a multiple of 4
+        size_t mStride;
+
+        /// Frustum planes used by the current cull
+        Plane mPlanes[6];
+        size_t mNumPlanes;
+
+        /// Nodes whose objects are being queued, to add their debug renderables afterwards
+        IndexList mOpenNodes;
+
+        SceneNode* mRoot;
+        bool mLayoutOutOfDate;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __SceneNodeCuller_H__
@@ -235,6 +235,18 @@ namespace Ogre
         AbstractNodeListPtr _generateAST(const String &str, const String &source, bool doImports = false, bool doObjects = false, bool doVariables = false);
         /// Compiles the given abstract syntax tree
         bool _compile(AbstractNodeListPtr nodes, const String &group, bool doImports = true, bool doObjects = true, bool doVariables = true);
+        /** Converts parsed nodes to an AST and processes imports, object inheritance
+            and variables, i.e. does everything compile does before the translation.
+        @param nodes The parsed script
+        @param group The resource group to look up imported scripts in
+        @param ast Receives the AST, which can be translated with _compile
+        @param imports Receives the names of all scripts the script imported
+        @return true if there were no errors
+        */
+        bool _generateProcessedAST(const ConcreteNodeListPtr &nodes, const String &group,
+            AbstractNodeListPtr &ast, StringVector &imports);
+        /// Returns the id of a word, or 0 if it has none
+        uint32 _getWordId(const String &word) const;
         /// Adds the given error to the compiler's list of errors
         void addError(uint32 code, const String &file, int line, const String &msg = "");
         /// Sets the listener used by the compiler
@@ -418,6 +430,33 @@ namespace Ogre
 
         // A pointer to the specific compiler instance used
         OGRE_THREAD_POINTER(ScriptCompiler, mScriptCompiler);
+
+        /// The compiler of the calling thread, with the current listener set
+        ScriptCompiler* getThreadCompiler(void);
+
+        /// A script in the cache
+        struct CachedScript
+        {
+            /// Hash of the source of the script
+            uint32 hash;
+            /// The imported scripts and the hashes of their sources
+            vector<std::pair<String, uint32> >::type imports;
+            /// The serialised AST
+            String ast;
+        };
+        typedef map<String, CachedScript>::type ScriptCache;
+        ScriptCache mScriptCache;
+        bool mScriptCacheEnabled;
+        bool mScriptCacheDirty;
+        size_t mScriptCacheHits;
+        size_t mScriptCacheMisses;
+
+        /// Returns the AST of a script from the cache, null if it is not up to date
+        AbstractNodeListPtr findCachedScript(const String& name, uint32 hash,
+            const String& groupName, ScriptCompiler* compiler);
+        /// Adds or replaces the AST of a script in the cache
+        void addCachedScript(const String& name, uint32 hash, const String& groupName,
+            const StringVector& imports, const AbstractNodeListPtr& ast);
     public:
         ScriptCompilerManager();
         virtual ~ScriptCompilerManager();
@@ -455,9 +494,59 @@ namespace Ogre
         const StringVector& getScriptPatterns(void) const;
         /// @copydoc ScriptLoader::parseScript
         void parseScript(DataStreamPtr& stream, const String& groupName);
+        /** Compiles a script which has been tokenized and parsed already.
+        @remarks
+            ScriptLexer and ScriptParser only look at the text of a script, so
+            they may run ahead of time, e.g. for many scripts in parallel. The
+            rest of the work, from the conversion to the abstract syntax tree
+            to the translation, is done here as in parseScript.
+        @param nodes The result of ScriptParser::parse for the script
+        @param groupName The resource group to create resources in
+        */
+        void compileScript(const ConcreteNodeListPtr& nodes, const String& groupName);
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const;
 
+        /** Sets whether parseScript caches the processed AST of scripts.
+        @remarks
+            The cache holds the AST of a script as it is before the translation,
+            i.e. with imports, object inheritance and variables resolved. A script
+            whose source and imported scripts did not change since it was cached
+            is translated right away, skipping lexing, parsing and processing.
+            Use saveScriptCache and loadScriptCache to keep it across runs.
+        @par
+            Scripts are compared by a hash of their contents, so touching a file
+            does not invalidate its entry while any change to the text does.
+            The cache is not used while a ScriptCompilerListener is set, since it
+            may change the scripts as they are compiled. Default is false.
+        */
+        void setScriptCacheEnabled(bool enabled);
+        /// Gets whether the processed AST of scripts is cached
+        bool getScriptCacheEnabled(void) const { return mScriptCacheEnabled; }
+
+        /// Returns true if the script cache changed since it was loaded
+        bool isScriptCacheDirty(void) const { return mScriptCacheDirty; }
+
+        /** Saves the script cache.
+        @param stream The destination stream
+        */
+        void saveScriptCache(DataStreamPtr stream) const;
+        /** Loads the script cache, replacing the current contents.
+        @remarks
+            A cache written by another version of the format is ignored.
+        @param stream The source stream
+        */
+        void loadScriptCache(DataStreamPtr stream);
+        /// Removes all scripts from the cache
+        void clearScriptCache(void);
+
+        /// Number of scripts which were compiled from the cache
+        size_t getScriptCacheHits(void) const { return mScriptCacheHits; }
+        /// Number of scripts which had to be parsed while the cache was enabled
+        size_t getScriptCacheMisses(void) const { return mScriptCacheMisses; }
+        /// Resets the hit and miss counts
+        void resetScriptCacheStatistics(void);
+
         /// @copydoc Singleton::getSingleton()
         static ScriptCompilerManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
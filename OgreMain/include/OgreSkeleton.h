@@ -267,6 +267,19 @@ namespace Ogre {
         */
         virtual void setAnimationState(const AnimationStateSet& animSet);
 
+        /** Changes the state of the skeleton like setAnimationState, with reduced detail.
+        @remarks
+            This is used for animation level of detail, see Entity::setAnimationLodLevels.
+        @param animSet The animations to apply
+        @param maxBoneDepth Bones deeper in the hierarchy than this are not animated,
+            they keep their initial state relative to their parent. The root bones
+            have a depth of 0.
+        @param snapToKeyFrames Whether the animations are applied at the key frame
+            preceding their time position, rather than interpolated.
+        */
+        virtual void setAnimationState(const AnimationStateSet& animSet,
+            unsigned short maxBoneDepth, bool snapToKeyFrames);
+
 
         /** Initialise an animation set suitable for use with this skeleton. 
         @remarks
@@ -443,6 +456,19 @@ namespace Ogre {
         /// Manual bones dirty?
         bool mManualBonesDirty;
 
+        /// Weights which leave out the bones deeper than mBoneDepthMaskDepth
+        AnimationState::BoneBlendMask mBoneDepthMask;
+        unsigned short mBoneDepthMaskDepth;
+        /// Whether mBoneDepthMask leaves out any bones
+        bool mBoneDepthMaskUsed;
+        /// Product of the depth mask and the blend mask of an animation state
+        AnimationState::BoneBlendMask mCombinedBlendMask;
+
+        /** Get weights which leave out the bones deeper than maxBoneDepth.
+        @return The weights, or null if there are no such bones
+        */
+        const AnimationState::BoneBlendMask* getBoneDepthMask(unsigned short maxBoneDepth);
+
 
         /// Storage of animations, lookup by name
         typedef map<String, Animation*>::type AnimationList;
@@ -101,6 +101,21 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+            SKELETON_ANIMATION_COMPRESSED = 0x4200,
+            // [Optional, v1.100+] compressed node tracks, see CompressedNodeTracks
+                // unsigned int numTimes
+                // float times[numTimes]            : Key times of all tracks
+                // unsigned short numTracks
+                // Repeating section, one per track
+                    // unsigned short boneIndex     : Index of bone to apply to
+                    // unsigned int first, count    : Keys of the rotation, translation and scale channels
+                    // Vector3 offset, step         : Decoding of translation keys
+                    // Vector3 offset, step         : Decoding of scale keys
+                // Repeating section, for the rotation, translation and scale channels
+                    // unsigned int numKeys
+                    // unsigned short times[numKeys]        : Indices of the key times
+                    // unsigned short values[numKeys * 3]   : Quantized key values
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
@@ -43,6 +43,8 @@ namespace Ogre {
         SKELETON_VERSION_1_0,
         /// OGRE version v1.8+
         SKELETON_VERSION_1_8,
+        /// OGRE version v1.10+
+        SKELETON_VERSION_1_10,
         
         /// Latest version available
         SKELETON_VERSION_LATEST = 100
@@ -89,6 +91,9 @@ namespace Ogre {
             and animations it uses to a .skeleton file.
         @param pSkeleton Weak reference to the Skeleton to export
         @param stream The destination stream
+        @param ver The version to write, SKELETON_VERSION_1_10 and later are
+            only written if an animation has compressed node tracks, the
+            file is written as SKELETON_VERSION_1_8 otherwise
         @param endianMode The endian mode to write in
         */
         void exportSkeleton(const Skeleton* pSkeleton, DataStreamPtr stream,
@@ -115,6 +120,7 @@ namespace Ogre {
         void writeAnimation(const Skeleton* pSkel, const Animation* anim, SkeletonVersion ver);
         void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track);
         void writeKeyFrame(const Skeleton* pSkel, const TransformKeyFrame* key);
+        void writeCompressedNodeTracks(const CompressedNodeTracks* tracks);
         void writeSkeletonAnimationLink(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link);
 
@@ -125,6 +131,7 @@ namespace Ogre {
         void readAnimation(DataStreamPtr& stream, Skeleton* pSkel);
         void readAnimationTrack(DataStreamPtr& stream, Animation* anim, Skeleton* pSkel);
         void readKeyFrame(DataStreamPtr& stream, NodeAnimationTrack* track, Skeleton* pSkel);
+        void readCompressedNodeTracks(DataStreamPtr& stream, Animation* anim);
         void readSkeletonAnimationLink(DataStreamPtr& stream, Skeleton* pSkel);
 
         size_t calcBoneSize(const Skeleton* pSkel, const Bone* pBone);
@@ -134,6 +141,7 @@ namespace Ogre {
         size_t calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack);
         size_t calcKeyFrameSize(const Skeleton* pSkel, const TransformKeyFrame* pKey);
         size_t calcKeyFrameSizeWithoutScale(const Skeleton* pSkel, const TransformKeyFrame* pKey);
+        size_t calcCompressedNodeTracksSize(const CompressedNodeTracks* tracks);
         size_t calcSkeletonAnimationLinkSize(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link);
 
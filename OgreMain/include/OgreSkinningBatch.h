@@ -0,0 +1,138 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SkinningBatch_H__
+#define __SkinningBatch_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreTaskScheduler.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Collects software vertex blends and performs them all at once.
+    @remarks
+        Each blend added is split into chunks of vertices, and the chunks of
+        all blends are skinned in parallel by the TaskScheduler using
+        OptimisedUtil::softwareVertexSkinning. The buffers involved are
+        locked when a blend is added and unlocked by flush, buffers shared
+        by several blends, like the source data of entities using the same
+        mesh, are only locked once.
+    @par
+        Entity adds its blends to the batch of its SceneManager while the
+        visible objects are being found, see SceneManager::setBatchedSkinning,
+        which lets many software skinned entities be processed together.
+    */
+    class _OgreExport SkinningBatch : public ParallelForBody, public AnimationAlloc
+    {
+    public:
+        /// Number of vertices skinned by one task
+        static const size_t VERTICES_PER_TASK = 1024;
+
+        SkinningBatch();
+        /// Performs outstanding blends
+        ~SkinningBatch();
+
+        /** Adds a software vertex blend to the batch.
+        @remarks
+            The parameters are the same as for Mesh::softwareVertexBlend.
+            The matrices pointed to must remain valid until flush is called,
+            the array of pointers is copied. The target vertex data is not
+            updated before flush.
+        */
+        void add(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+            const Matrix4* const* blendMatrices, size_t numMatrices, bool blendNormals);
+
+        /// Performs all blends added and unlocks their buffers
+        void flush(void);
+
+        /// Number of blends waiting for flush
+        size_t getNumBlends(void) const { return mBlends.size(); }
+
+        /// Skins the chunks [begin, end), called by the TaskScheduler
+        void execute(size_t begin, size_t end);
+
+    protected:
+        /// Pointers and strides of a blend
+        struct Blend
+        {
+            const float* srcPos;
+            float* destPos;
+            const float* srcNorm;
+            float* destNorm;
+            const float* blendWeight;
+            const unsigned char* blendIndex;
+            /// Index of the first blend matrix in mBlendMatrices
+            size_t firstMatrix;
+            size_t srcPosStride, destPosStride;
+            size_t srcNormStride, destNormStride;
+            size_t blendWeightStride, blendIndexStride;
+            size_t numWeightsPerVertex;
+            size_t numVertices;
+        };
+        typedef vector<Blend>::type BlendList;
+
+        /// A range of vertices of a blend
+        struct Chunk
+        {
+            size_t blend;
+            size_t firstVertex;
+            size_t numVertices;
+        };
+        typedef vector<Chunk>::type ChunkList;
+
+        /// A buffer locked by the batch
+        struct LockedBuffer
+        {
+            HardwareVertexBufferSharedPtr buffer;
+            void* data;
+        };
+        typedef map<HardwareVertexBuffer*, LockedBuffer>::type LockedBufferMap;
+
+        /// Lock a buffer unless it is locked already, returns its contents
+        void* lockBuffer(const HardwareVertexBufferSharedPtr& buffer, HardwareBuffer::LockOptions options);
+
+        BlendList mBlends;
+        ChunkList mChunks;
+        vector<const Matrix4*>::type mBlendMatrices;
+        LockedBufferMap mLockedBuffers;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __SkinningBatch_H__
@@ -0,0 +1,186 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TaskScheduler_H__
+#define __TaskScheduler_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSingleton.h"
+#include "OgreWorkQueue.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** A unit of work which can be added to a TaskGraph.
+    @remarks
+        execute may be called from any thread, so it must only touch data
+        which no other task running at the same time modifies.
+    */
+    class _OgreExport Task
+    {
+    public:
+        virtual ~Task() {}
+        /// Do the work of this task
+        virtual void execute(void) = 0;
+    };
+
+    /** The loop body of TaskScheduler::parallelFor.
+    @remarks
+        The index range is split into chunks, execute is called once per
+        chunk, possibly from several threads at the same time.
+    */
+    class _OgreExport ParallelForBody
+    {
+    public:
+        virtual ~ParallelForBody() {}
+        /// Process the indices in [begin, end)
+        virtual void execute(size_t begin, size_t end) = 0;
+    };
+
+    /** A set of tasks and the order they have to be executed in.
+    @remarks
+        Tasks are added with addTask and ordered with addDependency, the
+        dependencies must not form cycles. A graph only describes the work,
+        it is run by TaskScheduler::run and may be run as often as needed,
+        e.g. once per frame. The graph does not own the tasks.
+    */
+    class _OgreExport TaskGraph : public UtilityAlloc
+    {
+    public:
+        typedef size_t TaskID;
+
+        /// Add a task, returns the ID to refer to it in addDependency
+        TaskID addTask(Task* task);
+
+        /// Make a task wait until another one is done
+        void addDependency(TaskID task, TaskID prerequisite);
+
+        /// Remove all tasks
+        void clear(void) { mTasks.clear(); }
+
+        /// Number of tasks in the graph
+        size_t getNumTasks(void) const { return mTasks.size(); }
+
+        typedef vector<TaskID>::type TaskIDList;
+        /// A task along with its dependencies
+        struct Entry
+        {
+            Task* task;
+            /// Tasks waiting for this one
+            TaskIDList successors;
+            size_t numPrerequisites;
+        };
+        typedef vector<Entry>::type EntryList;
+
+        /// Internal method to access the tasks
+        const EntryList& _getTasks(void) const { return mTasks; }
+
+    protected:
+        EntryList mTasks;
+    };
+
+    /** Runs fine grained parallel work on the threads of the Root WorkQueue.
+    @remarks
+        WorkQueue requests are fire and forget, which makes them unsuitable
+        for splitting a loop within a frame. This class fans work out through
+        requests on its own channel instead and lets the calling thread take
+        part in it, returning once all of it is done. Since the caller helps,
+        the work is always completed even if the WorkQueue has not been
+        started or has no worker threads, and calls may be nested.
+    @par
+        All thread providers are supported. Without thread support everything
+        runs on the calling thread.
+    */
+    class _OgreExport TaskScheduler : public Singleton<TaskScheduler>, public UtilityAlloc,
+        public WorkQueue::RequestHandler
+    {
+    public:
+        /// Work shared by the calling thread and the workers helping it
+        class Job;
+
+        /** Creates the scheduler, attaching it to the given queue.
+        @note
+            Root creates an instance using its own WorkQueue.
+        */
+        TaskScheduler(WorkQueue* queue);
+        ~TaskScheduler();
+
+        /** Calls body.execute for chunks of [begin, end) in parallel.
+        @param begin, end The index range to process.
+        @param grainSize The minimum number of indices per chunk, or 0
+            to choose one based on the number of threads.
+        @param body The loop body, it must remain valid until this returns.
+        @remarks
+            If the body throws, the chunks not started yet are skipped and the
+            first exception is thrown again here once all threads are done.
+        */
+        void parallelFor(size_t begin, size_t end, size_t grainSize, ParallelForBody& body);
+
+        /** Executes all tasks of a graph, respecting their dependencies.
+        @remarks
+            Returns once every task is done. The calling thread executes
+            tasks too, blocking only when all tasks which are ready to run
+            are taken by other threads. If a task throws, the tasks not
+            started yet are skipped and the first exception is thrown again
+            here once all threads are done.
+        */
+        void run(const TaskGraph& graph);
+
+        /// Number of threads which may work on a job, including the caller
+        size_t getNumThreads(void) const;
+
+        /// Switch to another WorkQueue, called by Root::setWorkQueue
+        void _setWorkQueue(WorkQueue* queue);
+
+        /// @copydoc WorkQueue::RequestHandler::handleRequest
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+
+        /// @copydoc Singleton::getSingleton()
+        static TaskScheduler& getSingleton(void);
+        /// @copydoc Singleton::getSingleton()
+        static TaskScheduler* getSingletonPtr(void);
+
+    protected:
+        /// Let up to numHelpers worker threads join the job
+        void requestHelp(const SharedPtr<Job>& job, size_t numHelpers);
+
+        WorkQueue* mWorkQueue;
+        uint16 mWorkQueueChannel;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __TaskScheduler_H__
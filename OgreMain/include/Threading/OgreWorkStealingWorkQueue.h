@@ -0,0 +1,193 @@
+/*-------------------------------------------------------------------------
+This source file is a part of OGRE
+(Object-oriented Graphics Rendering Engine)
+
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+-------------------------------------------------------------------------*/
+#ifndef __OgreWorkStealingWorkQueue_H__
+#define __OgreWorkStealingWorkQueue_H__
+
+#include "../OgreWorkQueue.h"
+#include "../OgreAtomicScalar.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Work queue which gives every worker thread its own request deque.
+    @remarks
+        DefaultWorkQueue funnels all producers and workers through a single
+        request queue and mutex. This implementation distributes new requests
+        round robin over per-worker deques instead. Workers take requests from
+        the front of their own deque and, once it runs dry, steal from the back
+        of the others, so the deque locks are hardly ever contended.
+    @par
+        Requests are tracked in a hash table split into independently locked
+        shards, which makes abortRequest a constant time operation rather than
+        a scan of all queues. Request and response handling is otherwise the
+        same as DefaultWorkQueue, including idle thread requests and retries.
+    @par
+        Use Root::setUseWorkStealingQueue to make Root use this queue.
+    */
+    class _OgreExport WorkStealingWorkQueue : public DefaultWorkQueueBase
+    {
+    public:
+        WorkStealingWorkQueue(const String& name = BLANKSTRING);
+        virtual ~WorkStealingWorkQueue();
+
+        /// Main function for each thread spawned, uses the first deque
+        virtual void _threadMain();
+
+        /// Main function of the worker thread owning the given deque
+        void _threadMain(size_t workerIndex);
+
+        /// @copydoc DefaultWorkQueueBase::_processNextRequest
+        virtual void _processNextRequest();
+
+        /// @copydoc WorkQueue::shutdown
+        virtual void shutdown();
+
+        /// @copydoc WorkQueue::startup
+        virtual void startup(bool forceRestart = true);
+
+        /// @copydoc WorkQueue::addRequest
+        virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0,
+            bool forceSynchronous = false, bool idleThread = false);
+        /// @copydoc WorkQueue::abortRequest
+        virtual void abortRequest(RequestID id);
+        /// @copydoc WorkQueue::abortRequestsByChannel
+        virtual void abortRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortPendingRequestsByChannel
+        virtual void abortPendingRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortAllRequests
+        virtual void abortAllRequests();
+        /// @copydoc WorkQueue::processResponses
+        virtual void processResponses();
+
+    protected:
+        /// Request deque owned by one worker thread
+        struct WorkerDeque : public UtilityAlloc
+        {
+            OGRE_WQ_MUTEX(mutex);
+            RequestQueue requests;
+            /// Number of queued requests, lets thieves skip empty deques without locking
+            AtomicScalar<size_t> size;
+
+            WorkerDeque() : size(0) {}
+        };
+        typedef vector<WorkerDeque*>::type WorkerDequeList;
+
+        /// State of a request which has not been answered yet
+        struct TrackedRequest
+        {
+            Request* request;
+            /// Whether the request handler was called already
+            bool started;
+        };
+        typedef OGRE_HashMap<RequestID, TrackedRequest> TrackedRequestMap;
+
+        /// Part of the request table, selected by RequestID
+        struct RequestShard : public UtilityAlloc
+        {
+            OGRE_WQ_MUTEX(mutex);
+            TrackedRequestMap requests;
+        };
+        static const size_t NUM_SHARDS = 16;
+
+        /// Thread function binding a worker to its deque
+        struct _OgreExport StealingWorkerFunc OGRE_THREAD_WORKER_INHERIT
+        {
+            WorkStealingWorkQueue* mQueue;
+            size_t mIndex;
+
+            StealingWorkerFunc(WorkStealingWorkQueue* q, size_t index)
+                : mQueue(q), mIndex(index) {}
+
+            void operator()();
+
+            void operator()() const;
+
+            void run();
+        };
+
+        RequestShard& getShard(RequestID id) { return mShards[id % NUM_SHARDS]; }
+        void trackRequest(Request* r);
+        void untrackRequest(RequestID id);
+        /// Remember that the request handler is about to be called
+        void markStarted(Request* r);
+
+        /// Put a request on the next deque in round robin order
+        void pushRequest(Request* r);
+        /// Take a request from the given deque, stealing from the others if it is empty
+        Request* popRequest(size_t workerIndex);
+        /// Process a request and queue or handle its response
+        void processTrackedRequest(Request* r, bool synchronous);
+        /// Process requests added with idleThread set, returns whether any were processed
+        bool processIdleRequests();
+        /// Whether there are requests a worker could pick up
+        bool hasWork();
+        /// Block the calling worker until requests are added or the queue shuts down
+        void waitForRequests();
+        /// Dispatch a request to the handlers of its channel
+        Response* handleRequest(Request* r);
+        /// Delete all requests still held by the deques
+        void clearDeques();
+
+        virtual void notifyWorkers();
+
+        WorkerDequeList mDeques;
+        RequestShard mShards[NUM_SHARDS];
+
+        AtomicScalar<RequestID> mNextRequestID;
+        AtomicScalar<size_t> mNextDeque;
+        /// Number of requests in all deques
+        AtomicScalar<size_t> mNumQueued;
+        /// Number of requests in the idle request queue
+        AtomicScalar<size_t> mNumIdleQueued;
+        /// Number of workers blocked in waitForRequests
+        AtomicScalar<size_t> mNumSleeping;
+
+        OGRE_WQ_MUTEX(mWaitMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWaitCondition);
+
+        size_t mNumThreadsRegisteredWithRS;
+        /// Init notification mutex (must lock before waiting on initCondition)
+        OGRE_WQ_MUTEX(mInitMutex);
+        /// Synchroniser token to wait / notify on thread init
+        OGRE_WQ_THREAD_SYNCHRONISER(mInitSync);
+
+#if OGRE_THREAD_SUPPORT
+        typedef vector<StealingWorkerFunc*>::type WorkerFuncList;
+        WorkerFuncList mWorkerFuncs;
+        typedef vector<OGRE_THREAD_TYPE*>::type WorkerThreadList;
+        WorkerThreadList mWorkers;
+#endif
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreSkeleton.h"
 #include "OgreBone.h"
 #include "OgreMesh.h"
+#include "OgreCompressedNodeTracks.h"
 
 #include "OgreSubEntity.h"
 
@@ -43,7 +44,8 @@ namespace Ogre {
         Animation::msDefaultRotationInterpolationMode = Animation::RIM_LINEAR;
     //---------------------------------------------------------------------
     Animation::Animation(const String& name, Real length)
-        : mName(name)
+        : mCompressedNodeTracks(0)
+        , mName(name)
         , mLength(length)
         , mInterpolationMode(msDefaultInterpolationMode)
         , mRotationInterpolationMode(msDefaultRotationInterpolationMode)
@@ -58,6 +60,7 @@ namespace Ogre {
     Animation::~Animation()
     {
         destroyAllTracks();
+        OGRE_DELETE mCompressedNodeTracks;
     }
     //---------------------------------------------------------------------
     Real Animation::getLength(void) const
@@ -352,6 +355,9 @@ namespace Ogre {
     {
         _applyBaseKeyFrame();
 
+        if (mCompressedNodeTracks)
+            mCompressedNodeTracks->apply(skel, timePos, weight, 0, scale);
+
         // Calculate time index for fast keyframe search
         TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -371,6 +377,9 @@ namespace Ogre {
     {
         _applyBaseKeyFrame();
 
+        if (mCompressedNodeTracks)
+            mCompressedNodeTracks->apply(skel, timePos, weight, blendMask, scale);
+
         // Calculate time index for fast keyframe search
       TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -525,6 +534,22 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::compressNodeTracks(Real translateTolerance,
+        const Radian& rotationTolerance, Real scaleTolerance)
+    {
+        _applyBaseKeyFrame();
+
+        _setCompressedNodeTracks(OGRE_NEW CompressedNodeTracks(this,
+            translateTolerance, rotationTolerance, scaleTolerance));
+        destroyAllNodeTracks();
+    }
+    //-----------------------------------------------------------------------
+    void Animation::_setCompressedNodeTracks(CompressedNodeTracks* tracks)
+    {
+        OGRE_DELETE mCompressedNodeTracks;
+        mCompressedNodeTracks = tracks;
+    }
+    //-----------------------------------------------------------------------
     void Animation::_collectIdentityNodeTracks(TrackHandleList& tracks) const
     {
         NodeTrackList::const_iterator i, iend;
@@ -628,6 +653,8 @@ namespace Ogre {
         {
             i->second->_clone(newAnim);
         }
+        if (mCompressedNodeTracks)
+            newAnim->mCompressedNodeTracks = mCompressedNodeTracks->_clone(newAnim);
 
         newAnim->_keyFrameListChanged();
         return newAnim;
@@ -658,6 +685,19 @@ namespace Ogre {
         return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
     }
     //-----------------------------------------------------------------------
+    Real Animation::_getPrecedingKeyFrameTime(Real timePos) const
+    {
+        // The key frames of compressed tracks are not in the time list
+        if (mCompressedNodeTracks && mNodeTrackList.empty())
+            return mCompressedNodeTracks->getPrecedingKeyTime(timePos);
+
+        TimeIndex timeIndex = _getTimeIndex(timePos);
+        uint index = timeIndex.getKeyIndex();
+        if (index < mKeyFrameTimes.size() && mKeyFrameTimes[index] == timeIndex.getTimePos())
+            return mKeyFrameTimes[index];
+        return index > 0 ? mKeyFrameTimes[index - 1] : timeIndex.getTimePos();
+    }
+    //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
     {
         NodeTrackList::const_iterator i;
@@ -778,6 +818,24 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareForApply(void)
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        if (mInterpolationMode == IM_SPLINE)
+        {
+            for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+            {
+                i->second->_buildInterpolationSplines();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_notifyContainer(AnimationContainer* c)
     {
         mContainer = c;
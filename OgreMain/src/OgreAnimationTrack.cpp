@@ -693,6 +693,14 @@ namespace Ogre {
             
     }
     //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_buildInterpolationSplines(void) const
+    {
+        if (mSplineBuildNeeded)
+        {
+            buildInterpolationSplines();
+        }
+    }
+    //--------------------------------------------------------------------------
     VertexAnimationTrack::VertexAnimationTrack(Animation* parent,
         unsigned short handle, VertexAnimationType animType)
         : AnimationTrack(parent, handle)
@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include "OgreBillboard.h"
 #include "OgreStringConverter.h"
 #include "OgreSceneNode.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreTaskScheduler.h"
 
 namespace Ogre {
     String rendererTypeName = "billboard";
@@ -125,8 +127,87 @@ namespace Ogre {
         return rendererTypeName;
     }
     //-----------------------------------------------------------------------
+    void BillboardParticleRenderer::_particleToBillboard(Billboard& bb, const Particle* p, bool selfOriented)
+    {
+        bb.mPosition = p->mPosition;
+        if (selfOriented)
+        {
+            // Normalise direction vector
+            bb.mDirection = p->mDirection;
+            bb.mDirection.normalise();
+        }
+        bb.mColour = p->mColour;
+        bb.mRotation = p->mRotation;
+        // Assign and compare at the same time
+        if ((bb.mOwnDimensions = p->mOwnDimensions) == true)
+        {
+            bb.mWidth = p->mWidth;
+            bb.mHeight = p->mHeight;
+        }
+    }
+    //-----------------------------------------------------------------------
+    namespace {
+        /** Generates the billboards of fixed size chunks of particles in parallel,
+            each chunk records its own bounds which are merged afterwards.
+        */
+        class BillboardParticleGenerator : public ParallelForBody
+        {
+            /// Number of billboards passed to BillboardSet::injectBillboards at once
+            static const size_t BATCH_SIZE = 64;
+
+            BillboardSet* mBillboardSet;
+            const vector<Particle*>::type& mParticles;
+            const Matrix4* mInvWorld;
+            bool mSelfOriented;
+
+        public:
+            vector<AxisAlignedBox>::type mChunkBounds;
+            vector<Real>::type mChunkRadius;
+
+            BillboardParticleGenerator(BillboardSet* bset, const vector<Particle*>::type& particles,
+                const Matrix4* invWorld, bool selfOriented, size_t numChunks)
+                : mBillboardSet(bset), mParticles(particles), mInvWorld(invWorld),
+                  mSelfOriented(selfOriented), mChunkBounds(numChunks), mChunkRadius(numChunks, 0)
+            {
+            }
+
+            void execute(size_t begin, size_t end)
+            {
+                Billboard batch[BATCH_SIZE];
+                for (size_t chunk = begin; chunk < end; ++chunk)
+                {
+                    Vector3 bboxMin = Math::POS_INFINITY * Vector3::UNIT_SCALE;
+                    Vector3 bboxMax = Math::NEG_INFINITY * Vector3::UNIT_SCALE;
+                    Real radius = 0.0f;
+
+                    size_t first = chunk * BillboardParticleRenderer::PARALLEL_CHUNK_SIZE;
+                    size_t last = std::min(first + BillboardParticleRenderer::PARALLEL_CHUNK_SIZE,
+                        mParticles.size());
+                    for (size_t i = first; i < last; i += BATCH_SIZE)
+                    {
+                        size_t count = std::min(BATCH_SIZE, last - i);
+                        for (size_t b = 0; b < count; ++b)
+                        {
+                            const Particle* p = mParticles[i + b];
+                            Vector3 pos = mInvWorld ? *mInvWorld * p->mPosition : p->mPosition;
+                            bboxMin.makeFloor(pos);
+                            bboxMax.makeCeil(pos);
+                            radius = std::max(radius, p->mPosition.length());
+
+                            BillboardParticleRenderer::_particleToBillboard(batch[b], p, mSelfOriented);
+                        }
+                        mBillboardSet->injectBillboards(i, batch, count);
+                    }
+
+                    mChunkBounds[chunk].setExtents(bboxMin, bboxMax);
+                    mChunkRadius[chunk] = radius;
+                }
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
     void BillboardParticleRenderer::_updateRenderQueue(RenderQueue* queue, 
-        list<Particle*>::type& currentParticles, bool cullIndividually)
+        vector<Particle*>::type& currentParticles, bool cullIndividually)
     {
         mBillboardSet->setCullIndividually(cullIndividually);
 
@@ -135,43 +216,52 @@ namespace Ogre {
         Vector3 bboxMax = Math::NEG_INFINITY * Vector3::UNIT_SCALE;
         Real radius = 0.0f;
         mBillboardSet->beginBillboards(currentParticles.size());
-        Billboard bb;
         Matrix4 invWorld;
 
-        if (mBillboardSet->getBillboardsInWorldSpace() && mBillboardSet->getParentSceneNode())
+        bool worldSpace = mBillboardSet->getBillboardsInWorldSpace() && mBillboardSet->getParentSceneNode();
+        if (worldSpace)
             invWorld = mBillboardSet->getParentSceneNode()->_getFullTransform().inverse();
 
-        for (list<Particle*>::type::iterator i = currentParticles.begin();
-            i != currentParticles.end(); ++i)
-        {
-            Particle* p = *i;
-            bb.mPosition = p->mPosition;
-            Vector3 pos = p->mPosition;
-
-            if (mBillboardSet->getBillboardsInWorldSpace() && mBillboardSet->getParentSceneNode())
-                pos = invWorld * pos;
+        bool selfOriented = mBillboardSet->getBillboardType() == BBT_ORIENTED_SELF ||
+            mBillboardSet->getBillboardType() == BBT_PERPENDICULAR_SELF;
 
-            bboxMin.makeFloor( pos );
-            bboxMax.makeCeil( pos );
-            radius = std::max( radius, p->mPosition.length() );
+        // Individual culling changes the number of billboards as we go, and accurate
+        // facing modifies the billboard set per billboard, both need the serial path
+        size_t numChunks = (currentParticles.size() + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+        if (numChunks > 1 && !cullIndividually && !mBillboardSet->getUseAccurateFacing() &&
+            ParticleSystemManager::getSingleton().getParallelUpdate())
+        {
+            BillboardParticleGenerator generator(mBillboardSet, currentParticles,
+                worldSpace ? &invWorld : 0, selfOriented, numChunks);
+            TaskScheduler::getSingleton().parallelFor(0, numChunks, 1, generator);
 
-            if (mBillboardSet->getBillboardType() == BBT_ORIENTED_SELF ||
-                mBillboardSet->getBillboardType() == BBT_PERPENDICULAR_SELF)
+            for (size_t chunk = 0; chunk < numChunks; ++chunk)
             {
-                // Normalise direction vector
-                bb.mDirection = p->mDirection;
-                bb.mDirection.normalise();
+                bboxMin.makeFloor(generator.mChunkBounds[chunk].getMinimum());
+                bboxMax.makeCeil(generator.mChunkBounds[chunk].getMaximum());
+                radius = std::max(radius, generator.mChunkRadius[chunk]);
             }
-            bb.mColour = p->mColour;
-            bb.mRotation = p->mRotation;
-            // Assign and compare at the same time
-            if ((bb.mOwnDimensions = p->mOwnDimensions) == true)
+            mBillboardSet->_setNumVisibleBillboards(currentParticles.size());
+        }
+        else
+        {
+            Billboard bb;
+            for (vector<Particle*>::type::iterator i = currentParticles.begin();
+                i != currentParticles.end(); ++i)
             {
-                bb.mWidth = p->mWidth;
-                bb.mHeight = p->mHeight;
-            }
-            mBillboardSet->injectBillboard(bb);
+                Particle* p = *i;
+                Vector3 pos = p->mPosition;
 
+                if (worldSpace)
+                    pos = invWorld * pos;
+
+                bboxMin.makeFloor( pos );
+                bboxMax.makeCeil( pos );
+                radius = std::max( radius, p->mPosition.length() );
+
+                _particleToBillboard(bb, p, selfOriented);
+                mBillboardSet->injectBillboard(bb);
+            }
         }
 
         // Only set bounds if there are any active particles
@@ -484,13 +484,48 @@ namespace Ogre {
         // Skip if not visible (NB always true if not bounds checking individual billboards)
         if (!billboardVisible(mCurrentCamera, bb)) return;
 
+        genBillboard(mLockPtr, mCamX, mCamY, mVOffset, bb);
+
+        // Increment visibles
+        mNumVisibleBillboards++;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::injectBillboards(size_t first, const Billboard* billboards, size_t count)
+    {
+        assert(!mCullIndividual && "Billboards can't be culled individually when injected in ranges");
+
+        // Don't accept injections beyond pool size
+        if (first >= mPoolSize) return;
+        count = std::min(count, mPoolSize - first);
+
+        size_t billboardSize = mPointRendering ?
+            mMainBuf->getVertexSize() : mMainBuf->getVertexSize() * 4;
+        float* pDest = reinterpret_cast<float*>(
+            reinterpret_cast<unsigned char*>(mLockPtr) + first * billboardSize);
+
+        // Per billboard axes and offsets are worked out in local copies so that
+        // ranges can be generated concurrently
+        Vector3 camX = mCamX, camY = mCamY;
+        Vector3 vOffset[4] = { mVOffset[0], mVOffset[1], mVOffset[2], mVOffset[3] };
+        for (size_t i = 0; i < count; ++i)
+            genBillboard(pDest, camX, camY, vOffset, billboards[i]);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::_setNumVisibleBillboards(size_t num)
+    {
+        mNumVisibleBillboards = static_cast<unsigned short>(std::min(num, mPoolSize));
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::genBillboard(float*& pDest, Vector3& camX, Vector3& camY,
+        Vector3* vOffset, const Billboard& bb)
+    {
         if (!mPointRendering &&
             (mBillboardType == BBT_ORIENTED_SELF ||
             mBillboardType == BBT_PERPENDICULAR_SELF ||
             (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON)))
         {
             // Have to generate axes & offsets per billboard
-            genBillboardAxes(&mCamX, &mCamY, &bb);
+            genBillboardAxes(&camX, &camY, &bb);
         }
 
         // If they're all the same size or we're point rendering
@@ -507,9 +542,9 @@ namespace Ogre {
                 (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON)))
             {
                 genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
-                    mDefaultWidth, mDefaultHeight, mCamX, mCamY, mVOffset);
+                    mDefaultWidth, mDefaultHeight, camX, camY, vOffset);
             }
-            genVertices(mVOffset, bb);
+            genVertices(pDest, vOffset, bb);
         }
         else // not all default size and not point rendering
         {
@@ -522,17 +557,15 @@ namespace Ogre {
             {
                 // Generate using own dimensions
                 genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
-                    bb.mWidth, bb.mHeight, mCamX, mCamY, vOwnOffset);
+                    bb.mWidth, bb.mHeight, camX, camY, vOwnOffset);
                 // Create vertex data
-                genVertices(vOwnOffset, bb);
+                genVertices(pDest, vOwnOffset, bb);
             }
             else // Use default dimension, already computed before the loop, for faster creation
             {
-                genVertices(mVOffset, bb);
+                genVertices(pDest, vOffset, bb);
             }
         }
-        // Increment visibles
-        mNumVisibleBillboards++;
     }
     //-----------------------------------------------------------------------
     void BillboardSet::endBillboards(void)
@@ -1122,6 +1155,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardSet::genVertices(
         const Vector3* const offsets, const Billboard& bb)
+    {
+        genVertices(mLockPtr, offsets, bb);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::genVertices(float*& pDest,
+        const Vector3* const offsets, const Billboard& bb)
     {
         RGBA colour;
         Root::getSingleton().convertColourValue(bb.mColour, &colour);
@@ -1136,78 +1175,78 @@ namespace Ogre {
         {
             // Single vertex per billboard, ignore offsets
             // position
-            *mLockPtr++ = bb.mPosition.x;
-            *mLockPtr++ = bb.mPosition.y;
-            *mLockPtr++ = bb.mPosition.z;
+            *pDest++ = bb.mPosition.x;
+            *pDest++ = bb.mPosition.y;
+            *pDest++ = bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // No texture coords in point rendering
         }
         else if (mAllDefaultRotation || bb.mRotation == Radian(0))
         {
             // Left-top
             // Positions
-            *mLockPtr++ = offsets[0].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[0].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[0].z + bb.mPosition.z;
+            *pDest++ = offsets[0].x + bb.mPosition.x;
+            *pDest++ = offsets[0].y + bb.mPosition.y;
+            *pDest++ = offsets[0].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.left;
+            *pDest++ = r.top;
 
             // Right-top
             // Positions
-            *mLockPtr++ = offsets[1].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[1].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[1].z + bb.mPosition.z;
+            *pDest++ = offsets[1].x + bb.mPosition.x;
+            *pDest++ = offsets[1].y + bb.mPosition.y;
+            *pDest++ = offsets[1].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.right;
+            *pDest++ = r.top;
 
             // Left-bottom
             // Positions
-            *mLockPtr++ = offsets[2].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[2].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[2].z + bb.mPosition.z;
+            *pDest++ = offsets[2].x + bb.mPosition.x;
+            *pDest++ = offsets[2].y + bb.mPosition.y;
+            *pDest++ = offsets[2].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.left;
+            *pDest++ = r.bottom;
 
             // Right-bottom
             // Positions
-            *mLockPtr++ = offsets[3].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[3].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[3].z + bb.mPosition.z;
+            *pDest++ = offsets[3].x + bb.mPosition.x;
+            *pDest++ = offsets[3].y + bb.mPosition.y;
+            *pDest++ = offsets[3].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.right;
+            *pDest++ = r.bottom;
         }
         else if (mRotationType == BBR_VERTEX)
         {
@@ -1222,66 +1261,66 @@ namespace Ogre {
             // Left-top
             // Positions
             pt = rotation * offsets[0];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.left;
+            *pDest++ = r.top;
 
             // Right-top
             // Positions
             pt = rotation * offsets[1];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.right;
+            *pDest++ = r.top;
 
             // Left-bottom
             // Positions
             pt = rotation * offsets[2];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.left;
+            *pDest++ = r.bottom;
 
             // Right-bottom
             // Positions
             pt = rotation * offsets[3];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.right;
+            *pDest++ = r.bottom;
         }
         else
         {
@@ -1300,63 +1339,63 @@ namespace Ogre {
 
             // Left-top
             // Positions
-            *mLockPtr++ = offsets[0].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[0].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[0].z + bb.mPosition.z;
+            *pDest++ = offsets[0].x + bb.mPosition.x;
+            *pDest++ = offsets[0].y + bb.mPosition.y;
+            *pDest++ = offsets[0].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u - cos_rot_w + sin_rot_h;
-            *mLockPtr++ = mid_v - sin_rot_w - cos_rot_h;
+            *pDest++ = mid_u - cos_rot_w + sin_rot_h;
+            *pDest++ = mid_v - sin_rot_w - cos_rot_h;
 
             // Right-top
             // Positions
-            *mLockPtr++ = offsets[1].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[1].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[1].z + bb.mPosition.z;
+            *pDest++ = offsets[1].x + bb.mPosition.x;
+            *pDest++ = offsets[1].y + bb.mPosition.y;
+            *pDest++ = offsets[1].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u + cos_rot_w + sin_rot_h;
-            *mLockPtr++ = mid_v + sin_rot_w - cos_rot_h;
+            *pDest++ = mid_u + cos_rot_w + sin_rot_h;
+            *pDest++ = mid_v + sin_rot_w - cos_rot_h;
 
             // Left-bottom
             // Positions
-            *mLockPtr++ = offsets[2].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[2].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[2].z + bb.mPosition.z;
+            *pDest++ = offsets[2].x + bb.mPosition.x;
+            *pDest++ = offsets[2].y + bb.mPosition.y;
+            *pDest++ = offsets[2].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u - cos_rot_w - sin_rot_h;
-            *mLockPtr++ = mid_v - sin_rot_w + cos_rot_h;
+            *pDest++ = mid_u - cos_rot_w - sin_rot_h;
+            *pDest++ = mid_v - sin_rot_w + cos_rot_h;
 
             // Right-bottom
             // Positions
-            *mLockPtr++ = offsets[3].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[3].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[3].z + bb.mPosition.z;
+            *pDest++ = offsets[3].x + bb.mPosition.x;
+            *pDest++ = offsets[3].y + bb.mPosition.y;
+            *pDest++ = offsets[3].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u + cos_rot_w - sin_rot_h;
-            *mLockPtr++ = mid_v + sin_rot_w + cos_rot_h;
+            *pDest++ = mid_u + cos_rot_w - sin_rot_h;
+            *pDest++ = mid_v + sin_rot_w + cos_rot_h;
         }
 
     }
@@ -0,0 +1,501 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreCompressedNodeTracks.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreSkeleton.h"
+#include "OgreBone.h"
+
+namespace Ogre {
+
+    namespace {
+        /// Angle between a rotation and the interpolation of two others
+        Real keyError(const Quaternion& a, const Quaternion& b, Real f, const Quaternion& value)
+        {
+            Quaternion q = Quaternion::nlerp(f, a, b, true);
+            return 2 * Math::ACos(std::min<Real>(Math::Abs(q.Dot(value)), 1)).valueRadians();
+        }
+
+        /// Distance between a vector and the interpolation of two others
+        Real keyError(const Vector3& a, const Vector3& b, Real f, const Vector3& value)
+        {
+            return (a + (b - a) * f).distance(value);
+        }
+
+        /** Selects the keys of a channel which can't be interpolated from
+            their neighbours within the tolerance.
+        @remarks
+            The first and last keys are always kept, so wrapping around the
+            end of the animation is not affected. A constant channel keeps
+            only its first key and a channel which stays at identity none.
+        */
+        template <typename T>
+        void reduceKeys(const vector<Real>::type& times, const typename vector<T>::type& values,
+            const T& identity, Real tolerance, vector<size_t>::type& kept)
+        {
+            kept.clear();
+            size_t numKeys = values.size();
+
+            bool isIdentity = true;
+            bool isConstant = true;
+            for (size_t k = 0; k < numKeys; ++k)
+            {
+                isIdentity = isIdentity && keyError(identity, identity, 0, values[k]) <= tolerance;
+                isConstant = isConstant && keyError(values[0], values[0], 0, values[k]) <= tolerance;
+            }
+            if (isIdentity)
+                return;
+
+            kept.push_back(0);
+            if (isConstant)
+                return;
+
+            // Extend the segment starting at the last key kept as long as
+            // the keys it spans can be interpolated
+            size_t start = 0;
+            for (size_t end = 2; end < numKeys; ++end)
+            {
+                Real span = times[end] - times[start];
+                for (size_t k = start + 1; k < end; ++k)
+                {
+                    Real f = (times[k] - times[start]) / span;
+                    if (keyError(values[start], values[end], f, values[k]) > tolerance)
+                    {
+                        start = end - 1;
+                        kept.push_back(start);
+                        break;
+                    }
+                }
+            }
+            kept.push_back(numKeys - 1);
+        }
+
+        /// Largest value of a 15 bit quaternion component
+        const Real ROTATION_SCALE = 32767;
+        /// Largest value of a 16 bit translation or scale component
+        const Real VECTOR_SCALE = 65535;
+        const Real SQRT2 = 1.41421356f;
+        /// Maps a 15 bit component back to [-1/sqrt(2), 1/sqrt(2)]
+        const Real ROTATION_DECODE_SCALE = 2 / (ROTATION_SCALE * SQRT2);
+        const Real ROTATION_DECODE_OFFSET = 1 / SQRT2;
+    }
+    //-----------------------------------------------------------------------
+    CompressedNodeTracks::CompressedNodeTracks(Animation* parent)
+        : mParent(parent)
+    {
+    }
+    //-----------------------------------------------------------------------
+    CompressedNodeTracks::CompressedNodeTracks(Animation* parent, Real translateTolerance,
+        const Radian& rotationTolerance, Real scaleTolerance)
+        : mParent(parent)
+    {
+        // Collect the times of all keys
+        Animation::NodeTrackIterator it = parent->getNodeTrackIterator();
+        while (it.hasMoreElements())
+        {
+            const NodeAnimationTrack* track = it.getNext();
+            for (unsigned short k = 0; k < track->getNumKeyFrames(); ++k)
+                mTimes.push_back(track->getNodeKeyFrame(k)->getTime());
+        }
+        std::sort(mTimes.begin(), mTimes.end());
+        mTimes.erase(std::unique(mTimes.begin(), mTimes.end()), mTimes.end());
+        if (mTimes.size() > 0xFFFF)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Animation " + parent->getName() + " has too many key frame times",
+                "CompressedNodeTracks::CompressedNodeTracks");
+        }
+
+        vector<Real>::type times;
+        vector<Quaternion>::type rotations;
+        vector<Vector3>::type translates, scales;
+        vector<size_t>::type kept;
+
+        it = parent->getNodeTrackIterator();
+        while (it.hasMoreElements())
+        {
+            const NodeAnimationTrack* nodeTrack = it.getNext();
+            unsigned short numKeys = nodeTrack->getNumKeyFrames();
+            if (!numKeys)
+                continue;
+
+            times.resize(numKeys);
+            rotations.resize(numKeys);
+            translates.resize(numKeys);
+            scales.resize(numKeys);
+            for (unsigned short k = 0; k < numKeys; ++k)
+            {
+                const TransformKeyFrame* kf = nodeTrack->getNodeKeyFrame(k);
+                times[k] = kf->getTime();
+                rotations[k] = kf->getRotation();
+                translates[k] = kf->getTranslate();
+                scales[k] = kf->getScale();
+            }
+
+            Track track;
+            track.handle = nodeTrack->getHandle();
+
+            for (int ch = 0; ch < CH_COUNT; ++ch)
+            {
+                switch (ch)
+                {
+                case CH_ROTATION:
+                    reduceKeys(times, rotations, Quaternion::IDENTITY,
+                        rotationTolerance.valueRadians(), kept);
+                    break;
+                case CH_TRANSLATE:
+                    reduceKeys(times, translates, Vector3::ZERO, translateTolerance, kept);
+                    break;
+                case CH_SCALE:
+                    reduceKeys(times, scales, Vector3::UNIT_SCALE, scaleTolerance, kept);
+                    break;
+                }
+
+                KeyRange& range = track.keys[ch];
+                range.first = static_cast<uint32>(mKeyTimes[ch].size());
+                range.count = static_cast<uint32>(kept.size());
+
+                for (size_t k = 0; k < kept.size(); ++k)
+                {
+                    size_t timeIndex = std::lower_bound(mTimes.begin(), mTimes.end(),
+                        static_cast<float>(times[kept[k]])) - mTimes.begin();
+                    mKeyTimes[ch].push_back(static_cast<uint16>(timeIndex));
+                }
+
+                vector<uint16>::type& values = mKeyValues[ch];
+                if (ch == CH_ROTATION)
+                {
+                    for (size_t k = 0; k < kept.size(); ++k)
+                    {
+                        values.resize(values.size() + 3);
+                        encodeRotation(rotations[kept[k]], &values[values.size() - 3]);
+                    }
+                    continue;
+                }
+
+                // Quantize over the range of the values kept
+                const vector<Vector3>::type& source = ch == CH_TRANSLATE ? translates : scales;
+                Vector3 minimum(Math::POS_INFINITY), maximum(Math::NEG_INFINITY);
+                for (size_t k = 0; k < kept.size(); ++k)
+                {
+                    minimum.makeFloor(source[kept[k]]);
+                    maximum.makeCeil(source[kept[k]]);
+                }
+                Vector3& offset = track.offset[ch - CH_TRANSLATE];
+                Vector3& step = track.step[ch - CH_TRANSLATE];
+                offset = kept.empty() ? Vector3::ZERO : minimum;
+                step = kept.empty() ? Vector3::ZERO : (maximum - minimum) / VECTOR_SCALE;
+                for (size_t k = 0; k < kept.size(); ++k)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        Real q = step[c] > 0 ? (source[kept[k]][c] - offset[c]) / step[c] : 0;
+                        values.push_back(static_cast<uint16>(
+                            Math::Clamp<Real>(Math::Floor(q + 0.5f), 0, VECTOR_SCALE)));
+                    }
+                }
+            }
+
+            mTracks.push_back(track);
+        }
+    }
+    //-----------------------------------------------------------------------
+    CompressedNodeTracks* CompressedNodeTracks::_clone(Animation* newParent) const
+    {
+        CompressedNodeTracks* ret = OGRE_NEW CompressedNodeTracks(newParent);
+        ret->mTracks = mTracks;
+        ret->mTimes = mTimes;
+        for (int ch = 0; ch < CH_COUNT; ++ch)
+        {
+            ret->mKeyTimes[ch] = mKeyTimes[ch];
+            ret->mKeyValues[ch] = mKeyValues[ch];
+        }
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTracks::_remapHandles(const vector<ushort>::type& handleMap)
+    {
+        for (TrackList::iterator i = mTracks.begin(); i != mTracks.end(); ++i)
+            i->handle = handleMap[i->handle];
+    }
+    //-----------------------------------------------------------------------
+    size_t CompressedNodeTracks::getMemoryUsage(void) const
+    {
+        size_t memSize = sizeof(*this);
+        memSize += mTracks.capacity() * sizeof(Track);
+        memSize += mTimes.capacity() * sizeof(float);
+        for (int ch = 0; ch < CH_COUNT; ++ch)
+        {
+            memSize += mKeyTimes[ch].capacity() * sizeof(uint16);
+            memSize += mKeyValues[ch].capacity() * sizeof(uint16);
+        }
+        return memSize;
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTracks::encodeRotation(const Quaternion& rotation, uint16* data)
+    {
+        Quaternion q = rotation;
+        q.normalise();
+
+        // Drop the largest component, made positive, which can be recomputed
+        // from the others. These are then within [-1/sqrt(2), 1/sqrt(2)].
+        Real* c = q.ptr();
+        int largest = 0;
+        for (int i = 1; i < 4; ++i)
+        {
+            if (Math::Abs(c[i]) > Math::Abs(c[largest]))
+                largest = i;
+        }
+        Real sign = c[largest] < 0 ? -1.0f : 1.0f;
+
+        uint64 bits = static_cast<uint64>(largest);
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real v = (c[i] * sign * SQRT2 + 1) * 0.5f * ROTATION_SCALE;
+            bits = (bits << 15) | static_cast<uint64>(
+                Math::Clamp<Real>(Math::Floor(v + 0.5f), 0, ROTATION_SCALE));
+        }
+
+        data[0] = static_cast<uint16>(bits >> 32);
+        data[1] = static_cast<uint16>(bits >> 16);
+        data[2] = static_cast<uint16>(bits);
+    }
+    //-----------------------------------------------------------------------
+    Quaternion CompressedNodeTracks::decodeRotation(const uint16* data)
+    {
+        uint64 bits = (static_cast<uint64>(data[0]) << 32) |
+            (static_cast<uint64>(data[1]) << 16) | data[2];
+        int largest = static_cast<int>(bits >> 45);
+
+        Real c[4];
+        Real sum = 0;
+        for (int i = 3; i >= 0; --i)
+        {
+            if (i == largest)
+                continue;
+            c[i] = static_cast<Real>(bits & 0x7FFF) * ROTATION_DECODE_SCALE - ROTATION_DECODE_OFFSET;
+            bits >>= 15;
+            sum += c[i] * c[i];
+        }
+        c[largest] = Math::Sqrt(std::max<Real>(1 - sum, 0));
+
+        return Quaternion(c[0], c[1], c[2], c[3]);
+    }
+    //-----------------------------------------------------------------------
+    Real CompressedNodeTracks::getPrecedingKeyTime(Real timePos) const
+    {
+        uint16 index = findTime(timePos);
+        if (index < mTimes.size() && mTimes[index] == timePos)
+            return mTimes[index];
+        return index > 0 ? mTimes[index - 1] : timePos;
+    }
+    //-----------------------------------------------------------------------
+    uint16 CompressedNodeTracks::findTime(Real& timePos) const
+    {
+        // Wrap time like AnimationTrack::getKeyFramesAtTime
+        Real length = mParent->getLength();
+        if (timePos > length && length > 0.0f)
+            timePos = fmod(timePos, length);
+
+        return static_cast<uint16>(std::lower_bound(mTimes.begin(), mTimes.end(),
+            static_cast<float>(timePos)) - mTimes.begin());
+    }
+    //-----------------------------------------------------------------------
+    Real CompressedNodeTracks::findKeys(Real timePos, uint16 timeIndex, const KeyRange& range,
+        Channel channel, uint32& key1, uint32& key2) const
+    {
+        const uint16* keys = &mKeyTimes[channel][range.first];
+        uint32 k1, k2;
+        Real t1, t2;
+
+        // First key after or on the time, a channel keyed at all times
+        // needs no search
+        if (range.count == mTimes.size())
+            k2 = timeIndex;
+        else
+            k2 = static_cast<uint32>(std::lower_bound(keys, keys + range.count, timeIndex) - keys);
+        if (k2 == range.count)
+        {
+            // None, wrap back to the first key
+            k2 = 0;
+            t2 = mParent->getLength() + mTimes[keys[0]];
+            k1 = range.count - 1;
+        }
+        else
+        {
+            t2 = mTimes[keys[k2]];
+            k1 = (k2 != 0 && timePos < t2) ? k2 - 1 : k2;
+        }
+        t1 = mTimes[keys[k1]];
+
+        key1 = range.first + k1;
+        key2 = range.first + k2;
+        return t1 == t2 ? 0 : (timePos - t1) / (t2 - t1);
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTracks::sampleBatch(Real timePos, uint16 timeIndex, size_t first,
+        size_t count, Quaternion* rotations, Vector3* translates, Vector3* scales) const
+    {
+        assert(count <= TRACKS_PER_BATCH);
+
+        // Keys around the time position, one array per component so the
+        // interpolation loops can be vectorised
+        Real a[4][TRACKS_PER_BATCH], b[4][TRACKS_PER_BATCH], f[TRACKS_PER_BATCH];
+
+        // Rotations
+        for (size_t i = 0; i < count; ++i)
+        {
+            const KeyRange& range = mTracks[first + i].keys[CH_ROTATION];
+            Quaternion q1 = Quaternion::IDENTITY, q2 = Quaternion::IDENTITY;
+            f[i] = 0;
+            if (range.count)
+            {
+                uint32 k1, k2;
+                f[i] = findKeys(timePos, timeIndex, range, CH_ROTATION, k1, k2);
+                q1 = decodeRotation(&mKeyValues[CH_ROTATION][k1 * 3]);
+                q2 = decodeRotation(&mKeyValues[CH_ROTATION][k2 * 3]);
+            }
+            a[0][i] = q1.w; a[1][i] = q1.x; a[2][i] = q1.y; a[3][i] = q1.z;
+            b[0][i] = q2.w; b[1][i] = q2.x; b[2][i] = q2.y; b[3][i] = q2.z;
+        }
+        // Normalised lerp along the shortest path
+        for (size_t i = 0; i < count; ++i)
+        {
+            Real dot = a[0][i] * b[0][i] + a[1][i] * b[1][i] + a[2][i] * b[2][i] + a[3][i] * b[3][i];
+            Real sign = dot < 0 ? -1.0f : 1.0f;
+            Real w = a[0][i] + f[i] * (sign * b[0][i] - a[0][i]);
+            Real x = a[1][i] + f[i] * (sign * b[1][i] - a[1][i]);
+            Real y = a[2][i] + f[i] * (sign * b[2][i] - a[2][i]);
+            Real z = a[3][i] + f[i] * (sign * b[3][i] - a[3][i]);
+            Real invLength = 1.0f / std::sqrt(w * w + x * x + y * y + z * z);
+            a[0][i] = w * invLength;
+            a[1][i] = x * invLength;
+            a[2][i] = y * invLength;
+            a[3][i] = z * invLength;
+        }
+        for (size_t i = 0; i < count; ++i)
+            rotations[i] = Quaternion(a[0][i], a[1][i], a[2][i], a[3][i]);
+
+        // Translations and scales
+        for (int ch = CH_TRANSLATE; ch <= CH_SCALE; ++ch)
+        {
+            const Vector3& identity = ch == CH_TRANSLATE ? Vector3::ZERO : Vector3::UNIT_SCALE;
+            const uint16* values = mKeyValues[ch].empty() ? 0 : &mKeyValues[ch][0];
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Track& track = mTracks[first + i];
+                const KeyRange& range = track.keys[ch];
+                f[i] = 0;
+                if (range.count)
+                {
+                    uint32 k1, k2;
+                    f[i] = findKeys(timePos, timeIndex, range, static_cast<Channel>(ch), k1, k2);
+                    const Vector3& offset = track.offset[ch - CH_TRANSLATE];
+                    const Vector3& step = track.step[ch - CH_TRANSLATE];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        a[c][i] = offset[c] + values[k1 * 3 + c] * step[c];
+                        b[c][i] = offset[c] + values[k2 * 3 + c] * step[c];
+                    }
+                }
+                else
+                {
+                    for (int c = 0; c < 3; ++c)
+                        a[c][i] = b[c][i] = identity[c];
+                }
+            }
+            for (int c = 0; c < 3; ++c)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    a[c][i] += f[i] * (b[c][i] - a[c][i]);
+            }
+
+            Vector3* out = ch == CH_TRANSLATE ? translates : scales;
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Vector3(a[0][i], a[1][i], a[2][i]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTracks::sample(Real timePos, Quaternion* rotations,
+        Vector3* translates, Vector3* scales) const
+    {
+        uint16 timeIndex = findTime(timePos);
+        for (size_t first = 0; first < mTracks.size(); first += TRACKS_PER_BATCH)
+        {
+            size_t count = std::min(TRACKS_PER_BATCH, mTracks.size() - first);
+            sampleBatch(timePos, timeIndex, first, count,
+                rotations + first, translates + first, scales + first);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void CompressedNodeTracks::apply(Skeleton* skeleton, Real timePos, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scl) const
+    {
+        Quaternion rotations[TRACKS_PER_BATCH];
+        Vector3 translates[TRACKS_PER_BATCH];
+        Vector3 scales[TRACKS_PER_BATCH];
+
+        Animation::RotationInterpolationMode rim = mParent->getRotationInterpolationMode();
+        uint16 timeIndex = findTime(timePos);
+        for (size_t first = 0; first < mTracks.size(); first += TRACKS_PER_BATCH)
+        {
+            size_t count = std::min(TRACKS_PER_BATCH, mTracks.size() - first);
+            sampleBatch(timePos, timeIndex, first, count, rotations, translates, scales);
+
+            // Blend like NodeAnimationTrack::applyToNode
+            for (size_t i = 0; i < count; ++i)
+            {
+                unsigned short handle = mTracks[first + i].handle;
+                Real trackWeight = blendMask ? (*blendMask)[handle] * weight : weight;
+                if (!trackWeight)
+                    continue;
+
+                Bone* bone = skeleton->getBone(handle);
+                bone->translate(translates[i] * trackWeight * scl);
+
+                if (rim == Animation::RIM_LINEAR)
+                    bone->rotate(Quaternion::nlerp(trackWeight, Quaternion::IDENTITY, rotations[i], true));
+                else
+                    bone->rotate(Quaternion::Slerp(trackWeight, Quaternion::IDENTITY, rotations[i], true));
+
+                Vector3 scale = scales[i];
+                if (scale != Vector3::UNIT_SCALE)
+                {
+                    if (scl != 1.0f)
+                        scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * scl;
+                    else if (trackWeight != 1.0f)
+                        scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * trackWeight;
+                }
+                bone->scale(scale);
+            }
+        }
+    }
+}
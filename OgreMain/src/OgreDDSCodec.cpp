@@ -154,7 +154,7 @@ namespace Ogre {
     // Currently unused
 //    const uint32 DDSD_PITCH = 0x00000008;
 //    const uint32 DDSD_MIPMAPCOUNT = 0x00020000;
-//    const uint32 DDSD_LINEARSIZE = 0x00080000;
+    const uint32 DDSD_LINEARSIZE = 0x00080000;
 
     // Special FourCC codes
     const uint32 D3DFMT_R16F            = 111;
@@ -223,6 +223,7 @@ namespace Ogre {
         bool isFloat32r = (imgData->format == PF_FLOAT32_R);
         bool isFloat16 = (imgData->format == PF_FLOAT16_RGBA);
         bool isFloat32 = (imgData->format == PF_FLOAT32_RGBA);
+        bool isCompressed = PixelUtil::isCompressed(imgData->format);
         bool notImplemented = false;
         String notImplementedString = "";
 
@@ -257,6 +258,10 @@ namespace Ogre {
         case PF_FLOAT32_R:
         case PF_FLOAT16_RGBA:
         case PF_FLOAT32_RGBA:
+        case PF_DXT1:
+        case PF_DXT5:
+        case PF_BC4_UNORM:
+        case PF_BC5_UNORM:
             break;
         default:
             // No crazy FOURCC or 565 et al. file formats at this stage
@@ -329,6 +334,13 @@ namespace Ogre {
 
             // Initalise the SizeOrPitch flags (power two textures for now)
             ddsHeaderSizeOrPitch = static_cast<uint32>(ddsHeaderRgbBits * imgData->width);
+            if (isCompressed)
+            {
+                // Compressed textures store the size of the top level instead
+                ddsHeaderFlags |= DDSD_LINEARSIZE;
+                ddsHeaderSizeOrPitch = static_cast<uint32>(PixelUtil::getMemorySize(
+                    imgData->width, imgData->height, 1, imgData->format));
+            }
 
             // Initalise the caps flags
             ddsHeaderCaps1 = (isVolume||isCubeMap) ? DDSCAPS_COMPLEX|DDSCAPS_TEXTURE : DDSCAPS_TEXTURE;
@@ -365,8 +377,25 @@ namespace Ogre {
 
             ddsHeader.pixelFormat.size = DDS_PIXELFORMAT_SIZE;
             ddsHeader.pixelFormat.flags = (hasAlpha) ? DDPF_RGB|DDPF_ALPHAPIXELS : DDPF_RGB;
-            ddsHeader.pixelFormat.flags = (isFloat32r || isFloat16 || isFloat32) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
-            if (isFloat32r) {
+            ddsHeader.pixelFormat.flags = (isFloat32r || isFloat16 || isFloat32 || isCompressed) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
+            if (isCompressed) {
+                switch (imgData->format)
+                {
+                case PF_DXT1:
+                    ddsHeader.pixelFormat.fourCC = FOURCC('D', 'X', 'T', '1');
+                    break;
+                case PF_DXT5:
+                    ddsHeader.pixelFormat.fourCC = FOURCC('D', 'X', 'T', '5');
+                    break;
+                case PF_BC4_UNORM:
+                    ddsHeader.pixelFormat.fourCC = FOURCC('A', 'T', 'I', '1');
+                    break;
+                default:
+                    ddsHeader.pixelFormat.fourCC = FOURCC('A', 'T', 'I', '2');
+                    break;
+                }
+            }
+            else if (isFloat32r) {
                 ddsHeader.pixelFormat.fourCC = D3DFMT_R32F;
             }
             else if (isFloat16) {
@@ -385,6 +414,11 @@ namespace Ogre {
             ddsHeader.pixelFormat.redMask   = (isFloat32r) ? 0xFFFFFFFF :0x00FF0000;
             ddsHeader.pixelFormat.greenMask = (isFloat32r) ? 0x00000000 :0x0000FF00;
             ddsHeader.pixelFormat.blueMask  = (isFloat32r) ? 0x00000000 :0x000000FF;
+            if (isCompressed)
+            {
+                ddsHeader.pixelFormat.redMask = ddsHeader.pixelFormat.greenMask = 0;
+                ddsHeader.pixelFormat.blueMask = ddsHeader.pixelFormat.alphaMask = 0;
+            }
 
             if( flipRgbMasks )
                 std::swap( ddsHeader.pixelFormat.redMask, ddsHeader.pixelFormat.blueMask );
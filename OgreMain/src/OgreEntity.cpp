@@ -46,6 +46,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgrePass.h"
 #include "OgreSkeletonInstance.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreSkinningBatch.h"
 #include "OgreSceneNode.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
@@ -67,6 +68,12 @@ namespace Ogre {
           mNumBoneMatrices(0),
           mFrameAnimationLastUpdated(std::numeric_limits<unsigned long>::max()),
           mFrameBonesLastUpdated(NULL),
+          mBoneMatricesAnimationDirtyFrame(std::numeric_limits<unsigned long>::max()),
+          mBoneMatricesAnimationLodIndex(0),
+          mFrameSkeletonLastEvaluated(std::numeric_limits<unsigned long>::max()),
+          mLastSkeletonUpdate(SUR_UP_TO_DATE),
+          mAnimationLodIndex(0),
+          mAnimationLodFrame(std::numeric_limits<unsigned long>::max()),
           mSharedSkeletonEntities(NULL),
           mDisplaySkeleton(false),
         mCurrentHWAnimationState(false),
@@ -107,6 +114,12 @@ namespace Ogre {
         mNumBoneMatrices(0),
         mFrameAnimationLastUpdated(std::numeric_limits<unsigned long>::max()),
         mFrameBonesLastUpdated(NULL),
+        mBoneMatricesAnimationDirtyFrame(std::numeric_limits<unsigned long>::max()),
+        mBoneMatricesAnimationLodIndex(0),
+        mFrameSkeletonLastEvaluated(std::numeric_limits<unsigned long>::max()),
+        mLastSkeletonUpdate(SUR_UP_TO_DATE),
+        mAnimationLodIndex(0),
+        mAnimationLodFrame(std::numeric_limits<unsigned long>::max()),
         mSharedSkeletonEntities(NULL),
         mDisplaySkeleton(false),
         mCurrentHWAnimationState(false),
@@ -222,6 +235,8 @@ namespace Ogre {
         {
             mAnimationState = OGRE_NEW AnimationStateSet();
             mMesh->_initAnimationState(mAnimationState);
+            mBoneMatricesAnimationDirtyFrame = mAnimationState->getDirtyFrameNumber() - 1;
+            mFrameSkeletonLastEvaluated = std::numeric_limits<unsigned long>::max();
             prepareTempBlendBuffers();
         }
 
@@ -415,6 +430,24 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Entity::_updateAnimationLod(Camera* cam)
+    {
+        if (mAnimationLodLevels.empty() || !mParentNode)
+            return;
+
+        const LodStrategy* strategy = mMesh->getLodStrategy();
+        ushort animationLodIndex = strategy->getIndex(
+            strategy->getValue(this, cam) * mMeshLodFactorTransformed, mAnimationLodValues);
+
+        // Use the most detailed level needed by any camera this frame
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (mAnimationLodFrame != frame || animationLodIndex < mAnimationLodIndex)
+        {
+            mAnimationLodIndex = animationLodIndex;
+            mAnimationLodFrame = frame;
+        }
+    }
+    //-----------------------------------------------------------------------
     void Entity::_notifyCurrentCamera(Camera* cam)
     {
         MovableObject::_notifyCurrentCamera(cam);
@@ -456,6 +489,8 @@ namespace Ogre {
             lodValue *= mMaterialLodFactorTransformed;
 #endif
 
+            _updateAnimationLod(cam);
+
 
             SubEntityList::iterator i, iend;
             iend = mSubEntityList.end();
@@ -736,7 +771,9 @@ namespace Ogre {
         if (getAlwaysUpdateMainSkeleton() && hasSkeleton() && (mMeshLodIndex > 0))
         {
             //check if an update was made
-            if (cacheBoneMatrices())
+            SkeletonUpdateResult result = cacheBoneMatrices();
+            notifySkeletonUpdate(result);
+            if (result == SUR_EVALUATED || result == SUR_REDUCED)
             {
                 getSkeleton()->_updateTransforms();
                 //We will mark the skeleton as dirty. Otherwise, if in the same frame the entity will 
@@ -945,13 +982,20 @@ namespace Ogre {
 
             if (hasSkeleton())
             {
-                cacheBoneMatrices();
+                notifySkeletonUpdate(cacheBoneMatrices());
 
                 // Software blend?
                 if (softwareAnimation)
                 {
                     const Matrix4* blendMatrices[256];
 
+                    // Blends are deferred to the batch of the scene manager if it
+                    // has one, so that all entities are skinned together
+                    SkinningBatch* batch = mManager ? mManager->_getSkinningBatch() : 0;
+                    SkinningBatch localBatch;
+                    if (!batch)
+                        batch = &localBatch;
+
                     // Ok, we need to do a software blend
                     // Firstly, check out working vertex buffers
                     if (mSkelAnimVertexData)
@@ -967,7 +1011,7 @@ namespace Ogre {
                         Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                             mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
                         // Blend, taking source from either mesh data or morph data
-                        Mesh::softwareVertexBlend(
+                        batch->add(
                             (mMesh->getSharedVertexDataAnimationType() != VAT_NONE) ?
                             mSoftwareVertexAnimVertexData : mMesh->sharedVertexData,
                             mSkelAnimVertexData,
@@ -989,7 +1033,7 @@ namespace Ogre {
                             Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                                 mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
                             // Blend, taking source from either mesh data or morph data
-                            Mesh::softwareVertexBlend(
+                            batch->add(
                                 (se->getSubMesh()->getVertexAnimationType() != VAT_NONE)?
                                 se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData,
                                 se->mSkelAnimVertexData,
@@ -999,6 +1043,7 @@ namespace Ogre {
 
                     }
 
+                    localBatch.flush();
                 }
             }
 
@@ -1456,21 +1501,115 @@ namespace Ogre {
         return &mTempVertexAnimInfo;
     }
     //-----------------------------------------------------------------------
-    bool Entity::cacheBoneMatrices(void)
+    Entity::SkeletonUpdateResult Entity::cacheBoneMatrices(void)
     {
         Root& root = Root::getSingleton();
         unsigned long currentFrameNumber = root.getNextFrameNumber();
-        if ((*mFrameBonesLastUpdated != currentFrameNumber) ||
-            (hasSkeleton() && getSkeleton()->getManualBonesDirty()))
+        bool manualBonesDirty = hasSkeleton() && getSkeleton()->getManualBonesDirty();
+        if ((*mFrameBonesLastUpdated != currentFrameNumber) || manualBonesDirty)
         {
+            SkeletonUpdateResult result = SUR_EVALUATED;
             if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
-                mSkeletonInstance->setAnimationState(*mAnimationState);
+            {
+                if (mAnimationLodIndex)
+                {
+                    const AnimationLodLevel& lod = mAnimationLodLevels[mAnimationLodIndex - 1];
+                    // Only switching to a more detailed level is not worth waiting for
+                    if (!manualBonesDirty && mAnimationLodIndex >= mBoneMatricesAnimationLodIndex &&
+                        mFrameSkeletonLastEvaluated != std::numeric_limits<unsigned long>::max() &&
+                        currentFrameNumber - mFrameSkeletonLastEvaluated < lod.updateInterval)
+                    {
+                        // Keep the matrices of the last evaluation for this frame
+                        *mFrameBonesLastUpdated = currentFrameNumber;
+                        return SUR_THROTTLED;
+                    }
+                    mSkeletonInstance->setAnimationState(*mAnimationState,
+                        lod.maxBoneDepth, lod.snapToKeyFrames);
+                    result = SUR_REDUCED;
+                }
+                else
+                {
+                    mSkeletonInstance->setAnimationState(*mAnimationState);
+                }
+                mBoneMatricesAnimationDirtyFrame = mAnimationState->getDirtyFrameNumber();
+                mBoneMatricesAnimationLodIndex = mAnimationLodIndex;
+                mFrameSkeletonLastEvaluated = currentFrameNumber;
+            }
             mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
             *mFrameBonesLastUpdated  = currentFrameNumber;
 
-            return true;
+            return result;
+        }
+        return SUR_UP_TO_DATE;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::notifySkeletonUpdate(SkeletonUpdateResult result)
+    {
+        if (result != SUR_UP_TO_DATE)
+        {
+            mLastSkeletonUpdate = result;
+            if (mManager)
+                mManager->_notifySkeletonUpdated(this);
+        }
+    }
+    //-----------------------------------------------------------------------
+    Entity::SkeletonUpdateResult Entity::_updateSkeletonAnimation(void)
+    {
+        Root& root = Root::getSingleton();
+        unsigned long currentFrameNumber = root.getNextFrameNumber();
+        bool manualBonesDirty = mSkeletonInstance->getManualBonesDirty();
+        if (*mFrameBonesLastUpdated != currentFrameNumber && !mSkipAnimStateUpdates && !manualBonesDirty &&
+            mBoneMatricesAnimationDirtyFrame == mAnimationState->getDirtyFrameNumber() &&
+            mBoneMatricesAnimationLodIndex == mAnimationLodIndex)
+        {
+            // Neither time positions nor weights have changed, the cached matrices are still valid
+            *mFrameBonesLastUpdated = currentFrameNumber;
+            return mLastSkeletonUpdate = SUR_UNCHANGED;
+        }
+
+        SkeletonUpdateResult result = cacheBoneMatrices();
+        if (result == SUR_UP_TO_DATE)
+            return result;
+        mLastSkeletonUpdate = result;
+
+        if (manualBonesDirty && result != SUR_THROTTLED)
+        {
+            // The manual bones are not dirty any more once the matrices are cached,
+            // make sure the software blends of all entities using them are still redone
+            if (mSharedSkeletonEntities)
+            {
+                EntitySet::iterator i, iend = mSharedSkeletonEntities->end();
+                for (i = mSharedSkeletonEntities->begin(); i != iend; ++i)
+                {
+                    (*i)->mFrameAnimationLastUpdated = mAnimationState->getDirtyFrameNumber() - 1;
+                }
+            }
+            else
+            {
+                mFrameAnimationLastUpdated = mAnimationState->getDirtyFrameNumber() - 1;
+            }
         }
-        return false;
+        return result;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::setAnimationLodLevels(const AnimationLodLevelList& levels)
+    {
+        const LodStrategy* strategy = mMesh->getLodStrategy();
+        mAnimationLodValues.clear();
+        mAnimationLodValues.push_back(strategy->getBaseValue());
+        for (AnimationLodLevelList::const_iterator i = levels.begin(); i != levels.end(); ++i)
+        {
+            mAnimationLodValues.push_back(strategy->transformUserValue(i->userValue));
+        }
+        if (!strategy->isSorted(mAnimationLodValues))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Animation LOD levels of entity " + mName + " are not in order of decreasing detail",
+                "Entity::setAnimationLodLevels");
+        }
+
+        mAnimationLodLevels = levels;
+        mAnimationLodIndex = 0;
     }
     //-----------------------------------------------------------------------
     void Entity::setDisplaySkeleton(bool display)
@@ -2415,6 +2554,8 @@ namespace Ogre {
             mBoneMatrices = entity->mBoneMatrices;
             mAnimationState = entity->mAnimationState;
             mFrameBonesLastUpdated = entity->mFrameBonesLastUpdated;
+            mBoneMatricesAnimationDirtyFrame = mAnimationState->getDirtyFrameNumber() - 1;
+            mFrameSkeletonLastEvaluated = std::numeric_limits<unsigned long>::max();
             if (entity->mSharedSkeletonEntities == NULL)
             {
                 entity->mSharedSkeletonEntities = OGRE_NEW_T(EntitySet, MEMCATEGORY_ANIMATION)();
@@ -2447,6 +2588,8 @@ namespace Ogre {
             mAnimationState = OGRE_NEW AnimationStateSet();
             mMesh->_initAnimationState(mAnimationState);
             mFrameBonesLastUpdated = OGRE_NEW_T(unsigned long, MEMCATEGORY_ANIMATION)(std::numeric_limits<unsigned long>::max());
+            mBoneMatricesAnimationDirtyFrame = mAnimationState->getDirtyFrameNumber() - 1;
+            mFrameSkeletonLastEvaluated = std::numeric_limits<unsigned long>::max();
             mNumBoneMatrices = mSkeletonInstance->getNumBones();
             mBoneMatrices = static_cast<Matrix4*>(OGRE_MALLOC_SIMD(sizeof(Matrix4) * mNumBoneMatrices, MEMCATEGORY_ANIMATION));
 
@@ -41,6 +41,15 @@ THE SOFTWARE.
 #   include <sys/param.h>
 #endif
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+    OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS || \
+    OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+#   include <sys/mman.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   define OGRE_FILESYSTEM_MMAP_POSIX
+#endif
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
 #  define WIN32_LEAN_AND_MEAN
 #  if !defined(NOMINMAX) && defined(_MSC_VER)
@@ -54,6 +63,80 @@ THE SOFTWARE.
 namespace Ogre {
 
     bool FileSystemArchive::msIgnoreHidden = true;
+    bool FileSystemArchive::msMemoryMapping = false;
+
+    namespace {
+        /// Map a whole file read-only, returns 0 if not possible
+        void* mapFile(const String& fullPath, size_t size)
+        {
+            if (size == 0)
+                return 0;
+#if defined(OGRE_FILESYSTEM_MMAP_POSIX)
+            int fd = ::open(fullPath.c_str(), O_RDONLY);
+            if (fd == -1)
+                return 0;
+            void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            // the mapping keeps the file referenced
+            ::close(fd);
+            if (data == MAP_FAILED)
+                return 0;
+            // files are mostly read as a whole, start reading ahead
+            madvise(data, size, MADV_WILLNEED);
+            return data;
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+            HANDLE file = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (file == INVALID_HANDLE_VALUE)
+                return 0;
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+            // the view keeps the file and mapping referenced
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            return data;
+#else
+            return 0;
+#endif
+        }
+
+        void unmapFile(void* data, size_t size)
+        {
+#if defined(OGRE_FILESYSTEM_MMAP_POSIX)
+            munmap(data, size);
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+            UnmapViewOfFile(data);
+#endif
+        }
+
+        /** Read-only stream on a memory mapped file.
+        @remarks
+            Since it is a MemoryDataStream, users can access the file contents
+            directly through getPtr, without copying them first.
+        */
+        class MappedFileDataStream : public MemoryDataStream
+        {
+        public:
+            MappedFileDataStream(const String& name, void* data, size_t size)
+                : MemoryDataStream(name, data, size, false, true)
+            {
+            }
+
+            ~MappedFileDataStream()
+            {
+                close();
+            }
+
+            void close(void)
+            {
+                if (mData)
+                {
+                    unmapFile(mData, mSize);
+                    mData = 0;
+                }
+            }
+        };
+    }
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
@@ -224,6 +307,13 @@ namespace Ogre {
                         "FileSystemArchive::open");
         }
 
+        if (readOnly && msMemoryMapping)
+        {
+            // fall back to a file stream if the file can not be mapped
+            if (void* data = mapFile(full_path, (size_t)tagStat.st_size))
+                return DataStreamPtr(OGRE_NEW MappedFileDataStream(filename, data, (size_t)tagStat.st_size));
+        }
+
         if (!readOnly)
         {
             mode |= std::ios::out;
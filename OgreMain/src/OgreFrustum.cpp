@@ -549,10 +549,19 @@ namespace Ogre {
 #endif
 
         RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
-        // API specific
-        renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRS);
-        // API specific for Gpu Programs
-        renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRSDepth, true);
+        if (renderSystem)
+        {
+            // API specific
+            renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRS);
+            // API specific for Gpu Programs
+            renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRSDepth, true);
+        }
+        else
+        {
+            // No render system yet, e.g. culling without rendering
+            mProjMatrixRS = mProjMatrix;
+            mProjMatrixRSDepth = mProjMatrix;
+        }
 
 
         // Calculate bounding box (local)
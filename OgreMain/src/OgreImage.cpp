@@ -31,10 +31,164 @@ THE SOFTWARE.
 #include "OgreImageCodec.h"
 #include "OgreColourValue.h"
 #include "OgreMath.h"
+#include "OgreSIMDHelper.h"
 #include "OgreImageResampler.h"
+#include "OgreImageCompressor.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreTaskScheduler.h"
 
 namespace Ogre {
+    namespace {
+        /// Destination boxes with fewer pixels are resampled on the calling thread
+        const size_t PARALLEL_RESAMPLE_MIN_PIXELS = 128 * 128;
+        /// Number of destination rows resampled by a task at least
+        const size_t PARALLEL_RESAMPLE_GRAIN_SIZE = 16;
+
+        /// Resamples a range of destination rows, see resample
+        template<class Resampler> class RowResampler : public ParallelForBody
+        {
+            const PixelBox& mSrc;
+            const PixelBox& mDst;
+        public:
+            RowResampler(const PixelBox& src, const PixelBox& dst) : mSrc(src), mDst(dst) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                Resampler::scale(mSrc, mDst, begin, end);
+            }
+        };
+
+        /** Resample src into dst, splitting large boxes by rows between the
+            TaskScheduler threads. Every destination pixel is written by exactly
+            one task, so the result does not depend on the number of threads.
+        */
+        template<class Resampler> void resample(const PixelBox& src, const PixelBox& dst)
+        {
+            TaskScheduler* scheduler = TaskScheduler::getSingletonPtr();
+            size_t rows = dst.getHeight();
+            if (scheduler && dst.getWidth() * rows * dst.getDepth() >= PARALLEL_RESAMPLE_MIN_PIXELS)
+            {
+                RowResampler<Resampler> body(src, dst);
+                scheduler->parallelFor(0, rows, PARALLEL_RESAMPLE_GRAIN_SIZE, body);
+            }
+            else
+            {
+                Resampler::scale(src, dst, 0, rows);
+            }
+        }
+
+        /// Number of block rows encoded by a task at least
+        const size_t PARALLEL_COMPRESS_GRAIN_SIZE = 4;
+
+        /// Compresses a range of block rows, see compressBlocks
+        template<class Encoder> class BlockRowCompressor : public ParallelForBody
+        {
+            const PixelBox& mSrc;
+            uint8* mDst;
+        public:
+            BlockRowCompressor(const PixelBox& src, uint8* dst) : mSrc(src), mDst(dst) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                BlockCompressor<Encoder>::compress(mSrc, mDst, begin, end);
+            }
+        };
+
+        /** Compress the PF_BYTE_RGBA box src into dst, splitting large boxes by
+            block rows between the TaskScheduler threads.
+        */
+        template<class Encoder> void compressBlocks(const PixelBox& src, uint8* dst)
+        {
+            TaskScheduler* scheduler = TaskScheduler::getSingletonPtr();
+            size_t rows = (src.getHeight() + 3) / 4;
+            if (scheduler && src.getWidth() * src.getHeight() >= PARALLEL_RESAMPLE_MIN_PIXELS)
+            {
+                BlockRowCompressor<Encoder> body(src, dst);
+                scheduler->parallelFor(0, rows, PARALLEL_COMPRESS_GRAIN_SIZE, body);
+            }
+            else
+            {
+                BlockCompressor<Encoder>::compress(src, dst, 0, rows);
+            }
+        }
+
+        /// Converts the colours of a PF_FLOAT32_RGBA box between sRGB and linear, alpha is linear in both
+        void convertSRGB(const PixelBox& box, bool toLinear)
+        {
+            float* data = static_cast<float*>(box.data);
+            size_t numPixels = box.getWidth() * box.getHeight() * box.getDepth();
+            for (size_t i = 0; i < numPixels * 4; ++i)
+            {
+                if (i % 4 == 3)
+                    continue;
+                float c = data[i];
+                if (toLinear)
+                    c = c <= 0.04045f ? c / 12.92f : Math::Pow((c + 0.055f) / 1.055f, 2.4f);
+                else
+                    c = c <= 0.0031308f ? c * 12.92f : 1.055f * Math::Pow(c, 1.0f / 2.4f) - 0.055f;
+                data[i] = c;
+            }
+        }
+
+        /// Filters the mipmaps of a range of faces from their top levels
+        class MipmapGenerator : public ParallelForBody
+        {
+            const Image& mImage;
+            Image::Filter mFilter;
+            bool mGammaCorrect;
+        public:
+            MipmapGenerator(const Image& image, Image::Filter filter, bool gammaCorrect)
+                : mImage(image), mFilter(filter), mGammaCorrect(gammaCorrect) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t face = begin; face < end; ++face)
+                {
+                    if (mGammaCorrect)
+                    {
+                        executeLinear(face);
+                        continue;
+                    }
+                    for (size_t mip = 1; mip <= mImage.getNumMipmaps(); ++mip)
+                    {
+                        Image::scale(mImage.getPixelBox(face, mip - 1), mImage.getPixelBox(face, mip), mFilter);
+                    }
+                }
+            }
+
+            /** Filters the linear colours of an sRGB face. They are kept as floats
+                from level to level, so that the sRGB values are only rounded once.
+            */
+            void executeLinear(size_t face)
+            {
+                PixelBox top = mImage.getPixelBox(face, 0);
+                size_t size = PixelUtil::getMemorySize(top.getWidth(), top.getHeight(), top.getDepth(),
+                    PF_FLOAT32_RGBA);
+                MemoryDataStream first(size), second(size);
+                uchar* buffers[2] = { first.getPtr(), second.getPtr() };
+                PixelBox linear(top.getWidth(), top.getHeight(), top.getDepth(), PF_FLOAT32_RGBA, buffers[0]);
+                PixelUtil::bulkPixelConversion(top, linear);
+                convertSRGB(linear, true);
+
+                for (size_t mip = 1; mip <= mImage.getNumMipmaps(); ++mip)
+                {
+                    PixelBox level = mImage.getPixelBox(face, mip);
+                    PixelBox next(level.getWidth(), level.getHeight(), level.getDepth(), PF_FLOAT32_RGBA,
+                        buffers[mip % 2]);
+                    Image::scale(linear, next, mFilter);
+
+                    // the previous level is not needed any more, its buffer holds the sRGB colours
+                    PixelBox encoded(next.getWidth(), next.getHeight(), next.getDepth(), PF_FLOAT32_RGBA,
+                        linear.data);
+                    memcpy(encoded.data, next.data, next.getConsecutiveSize());
+                    convertSRGB(encoded, false);
+                    PixelUtil::bulkPixelConversion(encoded, level);
+                    linear = next;
+                }
+            }
+        };
+    }
+
     ImageCodec::~ImageCodec() {
     }
 
@@ -578,6 +732,115 @@ namespace Ogre {
         Image::scale(temp.getPixelBox(), getPixelBox(), filter);
     }
     //-----------------------------------------------------------------------
+    void Image::generateMipmaps(Filter filter, bool gammaCorrect, uint32 maxMipmaps)
+    {
+        if (PixelUtil::isCompressed(mFormat))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Cannot generate mipmaps for a compressed image",
+                "Image::generateMipmaps");
+        }
+
+        uint32 numMips = 0;
+        for (uint32 size = std::max(std::max(mWidth, mHeight), mDepth); size > 1 && numMips < maxMipmaps; size /= 2)
+            ++numMips;
+
+        // keep the top level of every face and drop the old mipmaps
+        size_t faces = getNumFaces();
+        size_t topSize = PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+        size_t oldFaceSize = calculateSize(mNumMipmaps, 1, mWidth, mHeight, mDepth, mFormat);
+        size_t faceSize = calculateSize(numMips, 1, mWidth, mHeight, mDepth, mFormat);
+        uchar* buffer = OGRE_ALLOC_T(uchar, faceSize * faces, MEMCATEGORY_GENERAL);
+        for (size_t face = 0; face < faces; ++face)
+        {
+            memcpy(buffer + face * faceSize, mBuffer + face * oldFaceSize, topSize);
+        }
+
+        freeMemory();
+        mBuffer = buffer;
+        mBufSize = faceSize * faces;
+        mNumMipmaps = numMips;
+        mAutoDelete = true;
+
+        // the levels of a face depend on each other, the faces do not
+        MipmapGenerator body(*this, filter, gammaCorrect);
+        TaskScheduler* scheduler = TaskScheduler::getSingletonPtr();
+        if (scheduler && faces > 1)
+            scheduler->parallelFor(0, faces, 1, body);
+        else
+            body.execute(0, faces);
+    }
+    //-----------------------------------------------------------------------
+    void Image::compress(PixelFormat format)
+    {
+        if (PixelUtil::isCompressed(mFormat))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Image is already compressed",
+                "Image::compress");
+        }
+        if (mDepth > 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                "Compression of volume images is not supported",
+                "Image::compress");
+        }
+        switch (format)
+        {
+        case PF_DXT1:
+        case PF_DXT5:
+        case PF_BC4_UNORM:
+        case PF_BC5_UNORM:
+        case PF_ETC1_RGB8:
+        case PF_ETC2_RGB8:
+        case PF_ETC2_RGBA8:
+            break;
+        default:
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                "Compression to " + PixelUtil::getFormatName(format) + " is not supported",
+                "Image::compress");
+        }
+
+        size_t faces = getNumFaces();
+        size_t size = calculateSize(mNumMipmaps, faces, mWidth, mHeight, 1, format);
+        uchar* buffer = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+
+        // the encoders read r, g, b, a bytes
+        MemoryDataStream converted(PixelUtil::getMemorySize(mWidth, mHeight, 1, PF_BYTE_RGBA));
+        uchar* dst = buffer;
+        for (size_t face = 0; face < faces; ++face)
+        {
+            for (size_t mip = 0; mip <= mNumMipmaps; ++mip)
+            {
+                PixelBox src = getPixelBox(face, mip);
+                PixelBox rgba(src.getWidth(), src.getHeight(), 1, PF_BYTE_RGBA, converted.getPtr());
+                PixelUtil::bulkPixelConversion(src, rgba);
+
+                switch (format)
+                {
+                case PF_DXT1: compressBlocks<BlockEncoder<PF_DXT1> >(rgba, dst); break;
+                case PF_DXT5: compressBlocks<BlockEncoder<PF_DXT5> >(rgba, dst); break;
+                case PF_BC4_UNORM: compressBlocks<BlockEncoder<PF_BC4_UNORM> >(rgba, dst); break;
+                case PF_BC5_UNORM: compressBlocks<BlockEncoder<PF_BC5_UNORM> >(rgba, dst); break;
+                case PF_ETC1_RGB8: compressBlocks<BlockEncoder<PF_ETC1_RGB8> >(rgba, dst); break;
+                case PF_ETC2_RGB8: compressBlocks<BlockEncoder<PF_ETC2_RGB8> >(rgba, dst); break;
+                case PF_ETC2_RGBA8: compressBlocks<BlockEncoder<PF_ETC2_RGBA8> >(rgba, dst); break;
+                default:
+                    // never reached
+                    assert(false);
+                }
+                dst += PixelUtil::getMemorySize(src.getWidth(), src.getHeight(), 1, format);
+            }
+        }
+
+        freeMemory();
+        mBuffer = buffer;
+        mBufSize = size;
+        mAutoDelete = true;
+        mFormat = format;
+        mPixelSize = static_cast<uchar>(PixelUtil::getNumElemBytes(mFormat));
+        mFlags |= IF_COMPRESSED;
+    }
+    //-----------------------------------------------------------------------
     void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter) 
     {
         assert(PixelUtil::isAccessible(src.format));
@@ -586,6 +849,29 @@ namespace Ogre {
         PixelBox temp;
         switch (filter) 
         {
+        case FILTER_BOX:
+        case FILTER_TRIANGLE:
+        case FILTER_BICUBIC:
+            {
+                // Each destination row is filtered from several source rows, which
+                // must not be overwritten when scaling in place
+                temp = src;
+                if (src.data == scaled.data)
+                {
+                    temp = PixelBox(src.getWidth(), src.getHeight(), src.getDepth(), src.format);
+                    buf.reset(OGRE_NEW MemoryDataStream(temp.getConsecutiveSize()));
+                    temp.data = buf->getPtr();
+                    PixelUtil::bulkPixelConversion(src, temp);
+                }
+                if (filter == FILTER_BOX)
+                    resample<FilterResampler<BoxKernel> >(temp, scaled);
+                else if (filter == FILTER_TRIANGLE)
+                    resample<FilterResampler<TriangleKernel> >(temp, scaled);
+                else
+                    resample<FilterResampler<BicubicKernel> >(temp, scaled);
+            }
+            break;
+
         default:
         case FILTER_NEAREST:
             if(src.format == scaled.format) 
@@ -603,14 +889,14 @@ namespace Ogre {
             // super-optimized: no conversion
             switch (PixelUtil::getNumElemBytes(src.format)) 
             {
-            case 1: NearestResampler<1>::scale(src, temp); break;
-            case 2: NearestResampler<2>::scale(src, temp); break;
-            case 3: NearestResampler<3>::scale(src, temp); break;
-            case 4: NearestResampler<4>::scale(src, temp); break;
-            case 6: NearestResampler<6>::scale(src, temp); break;
-            case 8: NearestResampler<8>::scale(src, temp); break;
-            case 12: NearestResampler<12>::scale(src, temp); break;
-            case 16: NearestResampler<16>::scale(src, temp); break;
+            case 1: resample<NearestResampler<1> >(src, temp); break;
+            case 2: resample<NearestResampler<2> >(src, temp); break;
+            case 3: resample<NearestResampler<3> >(src, temp); break;
+            case 4: resample<NearestResampler<4> >(src, temp); break;
+            case 6: resample<NearestResampler<6> >(src, temp); break;
+            case 8: resample<NearestResampler<8> >(src, temp); break;
+            case 12: resample<NearestResampler<12> >(src, temp); break;
+            case 16: resample<NearestResampler<16> >(src, temp); break;
             default:
                 // never reached
                 assert(false);
@@ -646,10 +932,10 @@ namespace Ogre {
                 // super-optimized: byte-oriented math, no conversion
                 switch (PixelUtil::getNumElemBytes(src.format)) 
                 {
-                case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-                case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-                case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-                case 4: LinearResampler_Byte<4>::scale(src, temp); break;
+                case 1: resample<LinearResampler_Byte<1> >(src, temp); break;
+                case 2: resample<LinearResampler_Byte<2> >(src, temp); break;
+                case 3: resample<LinearResampler_Byte<3> >(src, temp); break;
+                case 4: resample<LinearResampler_Byte<4> >(src, temp); break;
                 default:
                     // never reached
                     assert(false);
@@ -665,13 +951,13 @@ namespace Ogre {
                 if (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA)
                 {
                     // float32 to float32, avoid unpack/repack overhead
-                    LinearResampler_Float32::scale(src, scaled);
+                    resample<LinearResampler_Float32>(src, scaled);
                     break;
                 }
                 // else, fall through
             default:
                 // non-optimized: floating-point math, performs conversion but always works
-                LinearResampler::scale(src, scaled);
+                resample<LinearResampler>(src, scaled);
             }
             break;
         }
@@ -0,0 +1,549 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef OGREIMAGECOMPRESSOR_H
+#define OGREIMAGECOMPRESSOR_H
+
+#include <algorithm>
+
+// this file is inlined into OgreImage.cpp!
+// do not include anywhere else.
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+// all encoders take a 4x4 block of PF_BYTE_RGBA texels, i.e. r, g, b and a
+// bytes, row after row, and write one block of the target format. Multi byte
+// values are written little endian as the DDS files and the GPUs expect them.
+
+// finds the closest of numColours palette colours for each of numTexels
+// texels, given as separate red, green and blue arrays, and returns the
+// summed squared error. numTexels is a multiple of 4. Ties go to the first
+// colour. With SSE four texels are compared at once, in the same order of
+// operations as the scalar code, so both give the same indices and error.
+struct PaletteSearch {
+    static float findClosest(const float* r, const float* g, const float* b, size_t numTexels,
+        const float (*palette)[3], size_t numColours, uint8* indices) {
+        float errors[16];
+        assert(numTexels <= 16 && numTexels % 4 == 0);
+#if __OGRE_HAVE_SSE
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE) {
+            for (size_t i = 0; i < numTexels; i += 4) {
+                __m128 tr = _mm_loadu_ps(r + i), tg = _mm_loadu_ps(g + i), tb = _mm_loadu_ps(b + i);
+                __m128 best = _mm_set1_ps(std::numeric_limits<float>::max());
+                __m128 bestIndex = _mm_setzero_ps();
+                for (size_t p = 0; p < numColours; p++) {
+                    __m128 dr = _mm_sub_ps(tr, _mm_set1_ps(palette[p][0]));
+                    __m128 dg = _mm_sub_ps(tg, _mm_set1_ps(palette[p][1]));
+                    __m128 db = _mm_sub_ps(tb, _mm_set1_ps(palette[p][2]));
+                    __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+                    __m128 closer = _mm_cmplt_ps(dist, best);
+                    best = _mm_or_ps(_mm_and_ps(closer, dist), _mm_andnot_ps(closer, best));
+                    bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(float(p))), _mm_andnot_ps(closer, bestIndex));
+                }
+                float index[4];
+                _mm_storeu_ps(errors + i, best);
+                _mm_storeu_ps(index, bestIndex);
+                for (size_t k = 0; k < 4; k++)
+                    indices[i + k] = static_cast<uint8>(index[k]);
+            }
+        } else
+#endif
+        {
+            for (size_t i = 0; i < numTexels; i++) {
+                float best = std::numeric_limits<float>::max();
+                for (size_t p = 0; p < numColours; p++) {
+                    float dr = r[i] - palette[p][0];
+                    float dg = g[i] - palette[p][1];
+                    float db = b[i] - palette[p][2];
+                    float dist = dr * dr + dg * dg + db * db;
+                    if (dist < best) {
+                        best = dist;
+                        indices[i] = static_cast<uint8>(p);
+                    }
+                }
+                errors[i] = best;
+            }
+        }
+
+        float error = 0;
+        for (size_t i = 0; i < numTexels; i++)
+            error += errors[i];
+        return error;
+    }
+};
+
+// encodes the rgb channels as a BC1 (DXT1) colour block. The endpoints are the
+// texels at the extremes of the principal axis of the colours, refined once by
+// a least squares fit to the chosen indices. Alpha is ignored.
+struct ColourBlockEncoder {
+    // rounds c to R5G6B5, expanded is the colour the decoder will see
+    static uint16 quantise(const float* c, float* expanded) {
+        int r = std::min(std::max(int(c[0] * (31.0f / 255.0f) + 0.5f), 0), 31);
+        int g = std::min(std::max(int(c[1] * (63.0f / 255.0f) + 0.5f), 0), 63);
+        int b = std::min(std::max(int(c[2] * (31.0f / 255.0f) + 0.5f), 0), 31);
+        expanded[0] = float((r << 3) | (r >> 2));
+        expanded[1] = float((g << 2) | (g >> 4));
+        expanded[2] = float((b << 3) | (b >> 2));
+        return static_cast<uint16>((r << 11) | (g << 5) | b);
+    }
+
+    // assigns every texel the closest colour of the 4 colour palette spanned
+    // by c0 and c1, returns the summed squared error
+    static float findIndices(const float (&texels)[16][3], const float* c0, const float* c1,
+        uint8 (&indices)[16]) {
+        float palette[4][3];
+        for (int c = 0; c < 3; c++) {
+            palette[0][c] = c0[c];
+            palette[1][c] = c1[c];
+            palette[2][c] = (2 * c0[c] + c1[c]) * (1.0f / 3.0f);
+            palette[3][c] = (c0[c] + 2 * c1[c]) * (1.0f / 3.0f);
+        }
+
+        float channels[3][16];
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++)
+                channels[c][i] = texels[i][c];
+        }
+        return PaletteSearch::findClosest(channels[0], channels[1], channels[2], 16, palette, 4, indices);
+    }
+
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        float texels[16][3];
+        float mean[3] = { 0, 0, 0 };
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++) {
+                texels[i][c] = block[i][c];
+                mean[c] += texels[i][c];
+            }
+        }
+        for (int c = 0; c < 3; c++)
+            mean[c] *= 1.0f / 16.0f;
+
+        // covariance matrix, rr rg rb gg gb bb
+        float cov[6] = { 0, 0, 0, 0, 0, 0 };
+        for (int i = 0; i < 16; i++) {
+            float r = texels[i][0] - mean[0];
+            float g = texels[i][1] - mean[1];
+            float b = texels[i][2] - mean[2];
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+
+        // power iteration for the principal axis, starting with the row of
+        // the channel that varies the most
+        float axis[3];
+        if (cov[0] >= cov[3] && cov[0] >= cov[5]) {
+            axis[0] = cov[0]; axis[1] = cov[1]; axis[2] = cov[2];
+        } else if (cov[3] >= cov[5]) {
+            axis[0] = cov[1]; axis[1] = cov[3]; axis[2] = cov[4];
+        } else {
+            axis[0] = cov[2]; axis[1] = cov[4]; axis[2] = cov[5];
+        }
+        for (int iter = 0; iter < 8; iter++) {
+            float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            float norm = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+            if (norm == 0)
+                break;
+            axis[0] = x / norm; axis[1] = y / norm; axis[2] = z / norm;
+        }
+
+        int minTexel = 0, maxTexel = 0;
+        float minDot = std::numeric_limits<float>::max();
+        float maxDot = -std::numeric_limits<float>::max();
+        for (int i = 0; i < 16; i++) {
+            float dot = texels[i][0] * axis[0] + texels[i][1] * axis[1] + texels[i][2] * axis[2];
+            if (dot < minDot) { minDot = dot; minTexel = i; }
+            if (dot > maxDot) { maxDot = dot; maxTexel = i; }
+        }
+
+        float c0[3], c1[3];
+        uint16 colour0 = quantise(texels[maxTexel], c0);
+        uint16 colour1 = quantise(texels[minTexel], c1);
+        uint8 indices[16];
+        float error = findIndices(texels, c0, c1, indices);
+
+        if (colour0 != colour1) {
+            // least squares endpoints for the chosen indices, the weights of c0
+            static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            float aa = 0, bb = 0, ab = 0;
+            float ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+            for (int i = 0; i < 16; i++) {
+                float a = weights[indices[i]], b = 1 - a;
+                aa += a * a; bb += b * b; ab += a * b;
+                for (int c = 0; c < 3; c++) {
+                    ax[c] += a * texels[i][c];
+                    bx[c] += b * texels[i][c];
+                }
+            }
+            float det = aa * bb - ab * ab;
+            if (std::abs(det) > 1e-6f) {
+                float fit0[3], fit1[3], e0[3], e1[3];
+                for (int c = 0; c < 3; c++) {
+                    fit0[c] = (ax[c] * bb - bx[c] * ab) / det;
+                    fit1[c] = (bx[c] * aa - ax[c] * ab) / det;
+                }
+                uint16 fitColour0 = quantise(fit0, e0);
+                uint16 fitColour1 = quantise(fit1, e1);
+                uint8 fitIndices[16];
+                float fitError = findIndices(texels, e0, e1, fitIndices);
+                if (fitError < error) {
+                    colour0 = fitColour0;
+                    colour1 = fitColour1;
+                    std::copy(fitIndices, fitIndices + 16, indices);
+                }
+            }
+        }
+
+        // colour_0 > colour_1 selects the 4 colour mode, the other one has
+        // transparent texels and makes decoders treat the texture as RGBA
+        if (colour0 < colour1) {
+            std::swap(colour0, colour1);
+            // 0 <-> 1 and 2 <-> 3
+            for (int i = 0; i < 16; i++)
+                indices[i] ^= 1;
+        } else if (colour0 == colour1) {
+            // solid block, move one endpoint and only use the other
+            if (colour1 > 0) {
+                colour1--;
+                std::fill(indices, indices + 16, 0);
+            } else {
+                colour0++;
+                std::fill(indices, indices + 16, 1);
+            }
+        }
+
+        out[0] = static_cast<uint8>(colour0 & 0xFF);
+        out[1] = static_cast<uint8>(colour0 >> 8);
+        out[2] = static_cast<uint8>(colour1 & 0xFF);
+        out[3] = static_cast<uint8>(colour1 >> 8);
+        for (int row = 0; row < 4; row++) {
+            const uint8* idx = indices + row * 4;
+            out[4 + row] = static_cast<uint8>(idx[0] | (idx[1] << 2) | (idx[2] << 4) | (idx[3] << 6));
+        }
+    }
+};
+
+// encodes one channel as a BC4 block, which is also the alpha block of DXT5.
+// Uses the 8 value mode spanning the range of the block, in which the
+// nearest value can be computed directly.
+template<unsigned int channel> struct ChannelBlockEncoder {
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        uint8 minValue = 255, maxValue = 0;
+        for (int i = 0; i < 16; i++) {
+            minValue = std::min(minValue, block[i][channel]);
+            maxValue = std::max(maxValue, block[i][channel]);
+        }
+
+        out[0] = maxValue;
+        out[1] = minValue;
+        uint64 bits = 0;
+        if (maxValue > minValue) {
+            float scale = 7.0f / (maxValue - minValue);
+            for (int i = 0; i < 16; i++) {
+                // step 0 is alpha_0 (index 0), step 7 alpha_1 (index 1), the
+                // steps in between are interpolated (indexes 2 to 7)
+                int step = int((maxValue - block[i][channel]) * scale + 0.5f);
+                uint64 index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+                bits |= index << (3 * i);
+            }
+        }
+        for (int i = 0; i < 6; i++)
+            out[2 + i] = static_cast<uint8>(bits >> (8 * i));
+    }
+};
+
+// encodes the rgb channels as an ETC1 block, which ETC2 decoders read the
+// same way. Both ways of splitting the block into halves are tried. The base
+// colour of a half is its average, differentially coded if the two are close
+// enough, and each half uses the modifier table with the least error.
+// Unlike the DXT formats, multi byte values are big endian.
+struct ETCBlockEncoder {
+    // indices 0 and 1 add the small and the large modifier of a table, 2 and 3 subtract them
+    static int modifier(int table, int index) {
+        static const int modifiers[8][2] = {
+            { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+        };
+        int m = modifiers[table][index & 1];
+        return (index & 2) ? -m : m;
+    }
+
+    // picks the table with the least error for the texels of a half, returns the error
+    static float encodeHalf(const float (&texels)[3][8], const int* base, int& table, uint8 (&indices)[8]) {
+        float best = std::numeric_limits<float>::max();
+        for (int t = 0; t < 8; t++) {
+            float palette[4][3];
+            for (int p = 0; p < 4; p++) {
+                for (int c = 0; c < 3; c++)
+                    palette[p][c] = float(std::min(std::max(base[c] + modifier(t, p), 0), 255));
+            }
+            uint8 tableIndices[8];
+            float error = PaletteSearch::findClosest(texels[0], texels[1], texels[2], 8, palette, 4, tableIndices);
+            if (error < best) {
+                best = error;
+                table = t;
+                std::copy(tableIndices, tableIndices + 8, indices);
+            }
+        }
+        return best;
+    }
+
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        uint64 bestBits = 0;
+        float bestError = std::numeric_limits<float>::max();
+        for (int flip = 0; flip < 2; flip++) {
+            // halves are the left and right columns, or the top and bottom rows if flipped
+            float texels[2][3][8];
+            int positions[2][8];
+            float mean[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+            int count[2] = { 0, 0 };
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    int half = flip ? y / 2 : x / 2;
+                    int n = count[half]++;
+                    // the index bits of the texels are numbered column by column
+                    positions[half][n] = x * 4 + y;
+                    for (int c = 0; c < 3; c++) {
+                        texels[half][c][n] = block[y * 4 + x][c];
+                        mean[half][c] += block[y * 4 + x][c] * (1.0f / 8.0f);
+                    }
+                }
+            }
+
+            // 5 bit base colours with a 3 bit signed difference, or two 4 bit ones
+            int q[2][3], base[2][3];
+            bool differential = true;
+            for (int h = 0; h < 2; h++) {
+                for (int c = 0; c < 3; c++)
+                    q[h][c] = std::min(std::max(int(mean[h][c] * (31.0f / 255.0f) + 0.5f), 0), 31);
+            }
+            for (int c = 0; c < 3; c++) {
+                int d = q[1][c] - q[0][c];
+                if (d < -4 || d > 3)
+                    differential = false;
+            }
+            for (int h = 0; h < 2; h++) {
+                for (int c = 0; c < 3; c++) {
+                    if (differential) {
+                        base[h][c] = (q[h][c] << 3) | (q[h][c] >> 2);
+                    } else {
+                        q[h][c] = std::min(std::max(int(mean[h][c] * (15.0f / 255.0f) + 0.5f), 0), 15);
+                        base[h][c] = q[h][c] * 17;
+                    }
+                }
+            }
+
+            int tables[2];
+            uint8 indices[2][8];
+            float error = encodeHalf(texels[0], base[0], tables[0], indices[0]);
+            error += encodeHalf(texels[1], base[1], tables[1], indices[1]);
+            if (error >= bestError)
+                continue;
+
+            bestError = error;
+            uint64 bits = 0;
+            for (int c = 0; c < 3; c++) {
+                if (differential) {
+                    bits |= uint64(q[0][c]) << (59 - 8 * c);
+                    bits |= uint64((q[1][c] - q[0][c]) & 0x7) << (56 - 8 * c);
+                } else {
+                    bits |= uint64(q[0][c]) << (60 - 8 * c);
+                    bits |= uint64(q[1][c]) << (56 - 8 * c);
+                }
+            }
+            bits |= uint64(tables[0]) << 37 | uint64(tables[1]) << 34;
+            bits |= uint64(differential ? 1 : 0) << 33 | uint64(flip) << 32;
+            for (int h = 0; h < 2; h++) {
+                for (int n = 0; n < 8; n++) {
+                    // most significant index bits in the upper half
+                    bits |= uint64(indices[h][n] >> 1) << (16 + positions[h][n]);
+                    bits |= uint64(indices[h][n] & 1) << positions[h][n];
+                }
+            }
+            bestBits = bits;
+        }
+        for (int i = 0; i < 8; i++)
+            out[i] = static_cast<uint8>(bestBits >> (56 - 8 * i));
+    }
+};
+
+// encodes alpha as an ETC2 EAC block. For every modifier table the multiplier
+// is chosen to span the range of the block and the base value centres the
+// table on it, the combination with the least error is used.
+struct EACBlockEncoder {
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        static const int modifiers[16][8] = {
+            { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+            { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+            { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+            { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+            { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+            { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+            { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+            { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 }
+        };
+
+        // texels column by column, in the order of the indices
+        float alpha[16], zero[16];
+        int minAlpha = 255, maxAlpha = 0;
+        for (int x = 0; x < 4; x++) {
+            for (int y = 0; y < 4; y++) {
+                int a = block[y * 4 + x][3];
+                alpha[x * 4 + y] = float(a);
+                zero[x * 4 + y] = 0;
+                minAlpha = std::min(minAlpha, a);
+                maxAlpha = std::max(maxAlpha, a);
+            }
+        }
+
+        uint64 bestBits = 0;
+        float bestError = std::numeric_limits<float>::max();
+        for (int t = 0; t < 16 && bestError > 0; t++) {
+            // the most negative and the largest modifier of every table
+            int low = modifiers[t][3], high = modifiers[t][7];
+            int multiplier = int(float(maxAlpha - minAlpha) / (high - low) + 0.5f);
+            // a multiplier of 0 must not be used
+            for (int m = std::max(multiplier - 1, 1); m <= std::min(multiplier + 1, 15); m++) {
+                int base = int(std::floor((minAlpha + maxAlpha - (low + high) * m) * 0.5f + 0.5f));
+                base = std::min(std::max(base, 0), 255);
+                float palette[8][3];
+                for (int k = 0; k < 8; k++) {
+                    palette[k][0] = float(std::min(std::max(base + modifiers[t][k] * m, 0), 255));
+                    palette[k][1] = palette[k][2] = 0;
+                }
+                uint8 indices[16];
+                float error = PaletteSearch::findClosest(alpha, zero, zero, 16, palette, 8, indices);
+                if (error < bestError) {
+                    bestError = error;
+                    bestBits = uint64(base) << 56 | uint64(m) << 52 | uint64(t) << 48;
+                    for (int i = 0; i < 16; i++)
+                        bestBits |= uint64(indices[i]) << (45 - 3 * i);
+                }
+            }
+        }
+        for (int i = 0; i < 8; i++)
+            out[i] = static_cast<uint8>(bestBits >> (56 - 8 * i));
+    }
+};
+
+// per format encoders, blockSize is the size of an encoded block in bytes
+template<PixelFormat format> struct BlockEncoder;
+
+template<> struct BlockEncoder<PF_DXT1> {
+    static const size_t blockSize = 8;
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        ColourBlockEncoder::encode(block, out);
+    }
+};
+
+template<> struct BlockEncoder<PF_DXT5> {
+    static const size_t blockSize = 16;
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        // alpha precedes colour
+        ChannelBlockEncoder<3>::encode(block, out);
+        ColourBlockEncoder::encode(block, out + 8);
+    }
+};
+
+template<> struct BlockEncoder<PF_BC4_UNORM> {
+    static const size_t blockSize = 8;
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        ChannelBlockEncoder<0>::encode(block, out);
+    }
+};
+
+template<> struct BlockEncoder<PF_BC5_UNORM> {
+    static const size_t blockSize = 16;
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        ChannelBlockEncoder<0>::encode(block, out);
+        ChannelBlockEncoder<1>::encode(block, out + 8);
+    }
+};
+
+template<> struct BlockEncoder<PF_ETC1_RGB8> {
+    static const size_t blockSize = 8;
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        ETCBlockEncoder::encode(block, out);
+    }
+};
+
+template<> struct BlockEncoder<PF_ETC2_RGB8> {
+    static const size_t blockSize = 8;
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        ETCBlockEncoder::encode(block, out);
+    }
+};
+
+template<> struct BlockEncoder<PF_ETC2_RGBA8> {
+    static const size_t blockSize = 16;
+    static void encode(const uint8 (&block)[16][4], uint8* out) {
+        // alpha precedes colour
+        EACBlockEncoder::encode(block, out);
+        ETCBlockEncoder::encode(block, out + 8);
+    }
+};
+
+// compresses the block rows [rowBegin, rowEnd) of a PF_BYTE_RGBA box into
+// consecutive blocks at dst. Texels outside of partial blocks repeat the last
+// row and column, so that they do not widen the ranges of the block.
+template<class Encoder> struct BlockCompressor {
+    static void compress(const PixelBox& src, uint8* dst, size_t rowBegin, size_t rowEnd) {
+        // assert(src.format == PF_BYTE_RGBA);
+        const uint8* srcdata = static_cast<const uint8*>(src.getTopLeftFrontPixelPtr());
+        size_t width = src.getWidth(), height = src.getHeight();
+        size_t blocksPerRow = (width + 3) / 4;
+        uint8* pdst = dst + rowBegin * blocksPerRow * Encoder::blockSize;
+
+        uint8 block[16][4];
+        for (size_t by = rowBegin; by < rowEnd; by++) {
+            for (size_t bx = 0; bx < blocksPerRow; bx++) {
+                for (size_t y = 0; y < 4; y++) {
+                    size_t sy = std::min(by * 4 + y, height - 1);
+                    for (size_t x = 0; x < 4; x++) {
+                        size_t sx = std::min(bx * 4 + x, width - 1);
+                        memcpy(block[y * 4 + x], srcdata + 4 * (sy * src.rowPitch + sx), 4);
+                    }
+                }
+                Encoder::encode(block, pdst);
+                pdst += Encoder::blockSize;
+            }
+        }
+    }
+};
+
+/** @} */
+/** @} */
+
+}
+
+#endif
@@ -53,6 +53,7 @@ namespace Ogre
                 mBoundingRadius( 0 ),
                 mBoundsDirty( false ),
                 mBoundsUpdated( false ),
+                mBoundsDirtyDeferred( 0 ),
                 mCurrentCamera( 0 ),
                 mMaterialLodIndex( 0 ),
                 mDirtyAnimation(true),
@@ -476,6 +477,15 @@ namespace Ogre
         mBoundsDirty = true;
     }
     //-----------------------------------------------------------------------
+    void InstanceBatch::_applyDeferredBoundsDirty(void)
+    {
+        if( mBoundsDirtyDeferred.load() )
+        {
+            mBoundsDirtyDeferred.store( 0 );
+            _boundsDirty();
+        }
+    }
+    //-----------------------------------------------------------------------
     const String& InstanceBatch::getMovableType(void) const
     {
         static String sType = "InstanceBatch";
@@ -511,6 +511,23 @@ namespace Ogre
         mDirtyBatches.clear();
     }
     //-----------------------------------------------------------------------
+    void InstanceManager::_applyDeferredBoundsDirty(void)
+    {
+        InstanceBatchMap::const_iterator itor = mInstanceBatches.begin();
+        InstanceBatchMap::const_iterator end  = mInstanceBatches.end();
+
+        while( itor != end )
+        {
+            InstanceBatchVec::const_iterator it = itor->second.begin();
+            InstanceBatchVec::const_iterator en = itor->second.end();
+
+            while( it != en )
+                (*it++)->_applyDeferredBoundsDirty();
+
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------
     // Helper functions to unshare the vertices
     //-----------------------------------------------------------------------
     typedef map<uint32, uint32>::type IndicesMap;
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreCamera.h"
 #include "OgreException.h"
 #include "OgreNameGenerator.h"
+#include "OgreSceneManager.h"
 
 namespace Ogre
 {
@@ -372,7 +373,18 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void InstancedEntity::_notifyMoved(void)
     {
-        markTransformDirty();
+        SceneManager* sceneManager = mBatchOwner->_getManager();
+        if (sceneManager && sceneManager->_isUpdatingNodesInParallel())
+        {
+            // Other threads move instances of the same batch, it is told later
+            mNeedTransformUpdate = true;
+            mNeedAnimTransformUpdate = true;
+            mBatchOwner->_boundsDirtyDeferred();
+        }
+        else
+        {
+            markTransformDirty();
+        }
         MovableObject::_notifyMoved();
         updateTransforms();
     }
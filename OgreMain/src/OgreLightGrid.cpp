@@ -0,0 +1,194 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreLightGrid.h"
+#include "OgreLight.h"
+#include "OgreSphere.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    LightGrid::LightGrid()
+        : mOrigin(Vector3::ZERO)
+        , mInvCellSize(Vector3::UNIT_SCALE)
+    {
+        mNumCells[0] = mNumCells[1] = mNumCells[2] = 0;
+    }
+    //-----------------------------------------------------------------------
+    size_t LightGrid::getCell(Real pos, int axis) const
+    {
+        // Clamp before converting, ranges may be huge
+        Real cell = Math::Floor((pos - mOrigin[axis]) * mInvCellSize[axis]);
+        cell = Math::Clamp(cell, Real(0), Real(mNumCells[axis] - 1));
+        return static_cast<size_t>(cell);
+    }
+    //-----------------------------------------------------------------------
+    size_t LightGrid::getCellRange(const Vector3& min, const Vector3& max,
+        size_t* first, size_t* last) const
+    {
+        size_t count = 1;
+        for (int a = 0; a < 3; ++a)
+        {
+            first[a] = getCell(min[a], a);
+            last[a] = getCell(max[a], a);
+            count *= last[a] - first[a] + 1;
+        }
+        return count;
+    }
+    //-----------------------------------------------------------------------
+    void LightGrid::build(const LightList& lights)
+    {
+        mLights = lights;
+        mGlobalLights.clear();
+        mCellStart.clear();
+        mCellLights.clear();
+
+        // Bounds of the light positions and the typical light range
+        IndexList positional;
+        vector<Real>::type ranges;
+        Vector3 boundsMin(Math::POS_INFINITY), boundsMax(Math::NEG_INFINITY);
+        for (size_t i = 0; i < mLights.size(); ++i)
+        {
+            Light* l = mLights[i];
+            if (l->getType() == Light::LT_DIRECTIONAL)
+                continue;
+            const Vector3& pos = l->getDerivedPosition();
+            boundsMin.makeFloor(pos);
+            boundsMax.makeCeil(pos);
+            positional.push_back(static_cast<uint32>(i));
+            ranges.push_back(l->getAttenuationRange());
+        }
+
+        if (positional.empty())
+        {
+            mNumCells[0] = mNumCells[1] = mNumCells[2] = 0;
+            for (size_t i = 0; i < mLights.size(); ++i)
+                mGlobalLights.push_back(static_cast<uint32>(i));
+            return;
+        }
+
+        // Cells the size of the median light sphere, so most lights overlap
+        // at most 8 of them
+        std::nth_element(ranges.begin(), ranges.begin() + ranges.size() / 2, ranges.end());
+        Real cellSize = 2 * ranges[ranges.size() / 2];
+
+        Vector3 extent = boundsMax - boundsMin;
+        size_t totalCells = 1;
+        for (int a = 0; a < 3; ++a)
+        {
+            size_t cells = 1;
+            if (cellSize > 0 && extent[a] > 0)
+            {
+                cells = static_cast<size_t>(std::min(
+                    Math::Ceil(extent[a] / cellSize), Real(MAX_CELLS_PER_AXIS)));
+                cells = std::max<size_t>(cells, 1);
+            }
+            mNumCells[a] = cells;
+            mInvCellSize[a] = extent[a] > 0 ? Real(cells) / extent[a] : 1;
+            totalCells *= cells;
+        }
+        mOrigin = boundsMin;
+
+        // Count the entries per cell, then fill them in light order
+        size_t first[3], last[3];
+        mCellStart.assign(totalCells + 1, 0);
+        IndexList::iterator i, iend = positional.end();
+        for (i = positional.begin(); i != iend; ++i)
+        {
+            Light* l = mLights[*i];
+            Vector3 r(l->getAttenuationRange());
+            const Vector3& pos = l->getDerivedPosition();
+            if (getCellRange(pos - r, pos + r, first, last) * 2 > totalCells)
+            {
+                mGlobalLights.push_back(*i);
+                continue;
+            }
+            for (size_t z = first[2]; z <= last[2]; ++z)
+                for (size_t y = first[1]; y <= last[1]; ++y)
+                    for (size_t x = first[0]; x <= last[0]; ++x)
+                        ++mCellStart[(z * mNumCells[1] + y) * mNumCells[0] + x + 1];
+        }
+        for (size_t c = 1; c <= totalCells; ++c)
+            mCellStart[c] += mCellStart[c - 1];
+
+        mCellLights.resize(mCellStart.back());
+        IndexList fill(mCellStart.begin(), mCellStart.end() - 1);
+        for (i = positional.begin(); i != iend; ++i)
+        {
+            Light* l = mLights[*i];
+            Vector3 r(l->getAttenuationRange());
+            const Vector3& pos = l->getDerivedPosition();
+            if (getCellRange(pos - r, pos + r, first, last) * 2 > totalCells)
+                continue;
+            for (size_t z = first[2]; z <= last[2]; ++z)
+                for (size_t y = first[1]; y <= last[1]; ++y)
+                    for (size_t x = first[0]; x <= last[0]; ++x)
+                        mCellLights[fill[(z * mNumCells[1] + y) * mNumCells[0] + x]++] = *i;
+        }
+
+        // Directional lights are not part of the positional ones
+        for (size_t l = 0; l < mLights.size(); ++l)
+        {
+            if (mLights[l]->getType() == Light::LT_DIRECTIONAL)
+                mGlobalLights.push_back(static_cast<uint32>(l));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void LightGrid::findLights(const Sphere& sphere, FoundLightList& destList) const
+    {
+        destList.clear();
+
+        size_t first[3], last[3];
+        Vector3 r(sphere.getRadius());
+        if (mCellStart.empty() ||
+            getCellRange(sphere.getCenter() - r, sphere.getCenter() + r, first, last) >= mLights.size())
+        {
+            // Visiting the cells would take longer than a linear search
+            destList.assign(mLights.begin(), mLights.end());
+            return;
+        }
+
+        FoundIndexList found(mGlobalLights.begin(), mGlobalLights.end());
+        for (size_t z = first[2]; z <= last[2]; ++z)
+        {
+            for (size_t y = first[1]; y <= last[1]; ++y)
+            {
+                size_t cell = (z * mNumCells[1] + y) * mNumCells[0];
+                found.insert(found.end(), mCellLights.begin() + mCellStart[cell + first[0]],
+                    mCellLights.begin() + mCellStart[cell + last[0] + 1]);
+            }
+        }
+
+        // Keep the order of the original list, lights in several cells are
+        // found several times
+        std::sort(found.begin(), found.end());
+        FoundIndexList::iterator end = std::unique(found.begin(), found.end());
+        destList.reserve(end - found.begin());
+        for (FoundIndexList::const_iterator it = found.begin(); it != end; ++it)
+            destList.push_back(mLights[*it]);
+    }
+}
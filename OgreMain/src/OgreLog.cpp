@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #include "OgreLog.h"
+#include "OgreAtomicScalar.h"
 #include <iomanip>
 #include <iostream>
 
@@ -45,11 +46,269 @@ namespace Ogre
 #if OGRE_PLATFORM == OGRE_PLATFORM_NACL
     pp::Instance* Log::mInstance = NULL;    
 #endif
-    
+
+#if OGRE_THREAD_SUPPORT
+namespace
+{
+    /** Full memory barrier.
+    @remarks
+        Without C++11 AtomicScalar::load and store are plain volatile accesses,
+        which order neither the message data nor a store against a later load.
+    */
+    inline void memoryBarrier()
+    {
+#if OGRE_USE_STD11
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#elif OGRE_COMPILER == OGRE_COMPILER_MSVC
+        MemoryBarrier();
+#else
+        __sync_synchronize();
+#endif
+    }
+
+    /// Loads a value, later reads see what was written before it was stored
+    inline size_t loadAcquire(const AtomicScalar<size_t>& value)
+    {
+        size_t result = value.load();
+        memoryBarrier();
+        return result;
+    }
+
+    /// Stores a value after all earlier writes, and before any later read
+    inline void storeRelease(AtomicScalar<size_t>& value, size_t v)
+    {
+        memoryBarrier();
+        value.store(v);
+        memoryBarrier();
+    }
+}
+
+    /** Bounded queue of messages with a thread writing them out.
+    @remarks
+        Any number of threads may push, only the writer thread pops. Every slot
+        carries a sequence number telling whether it is free for the producer of
+        a position or holds the message for the consumer, so producers only
+        contend on the enqueue position and never on a lock.
+    */
+    class Log::AsyncWriter : public LogAlloc
+    {
+    public:
+        AsyncWriter(Log* log, size_t queueSize);
+        /// Writes the remaining messages and stops the thread
+        ~AsyncWriter();
+
+        /// Queues a message, returns its position in the queue
+        size_t push(const String& message, LogMessageLevel lml, bool maskDebug);
+        /// Waits until all messages before the given position are written
+        void waitWritten(size_t position);
+        /// Position the next message will get
+        size_t getEnqueuePosition() const { return loadAcquire(mEnqueuePos); }
+        /// Whether the calling thread is the writer thread
+        bool isWriterThread() const { return mThread->get_id() == OGRE_THREAD_CURRENT_ID; }
+
+        void threadMain();
+
+    private:
+        struct Entry
+        {
+            AtomicScalar<size_t> sequence;
+            String message;
+            LogMessageLevel lml;
+            bool maskDebug;
+            time_t time;
+        };
+
+        struct Message
+        {
+            String message;
+            LogMessageLevel lml;
+            bool maskDebug;
+            time_t time;
+        };
+        typedef vector<Message>::type MessageList;
+
+        struct WriterFunc OGRE_THREAD_WORKER_INHERIT
+        {
+            AsyncWriter* mWriter;
+            WriterFunc(AsyncWriter* writer) : mWriter(writer) {}
+            void operator()() { mWriter->threadMain(); }
+            void operator()() const { mWriter->threadMain(); }
+            void run() { mWriter->threadMain(); }
+        };
+
+        /// Whether the slot at the dequeue position holds a message
+        bool hasMessage() const { return loadAcquire(mEntries[mDequeuePos & mMask].sequence) == mDequeuePos + 1; }
+        /// Takes queued messages and writes them, returns false if there were none
+        bool writeBatch();
+        void wakeWriter();
+
+        /// Upper bound of the messages written between two progress notifications
+        static const size_t MAX_BATCH_SIZE = 256;
+
+        Log* mLog;
+        Entry* mEntries;
+        size_t mCapacity;
+        size_t mMask;
+        AtomicScalar<size_t> mEnqueuePos;
+        /// Only used by the writer thread
+        size_t mDequeuePos;
+        MessageList mBatch;
+
+        AtomicScalar<size_t> mNumSleeping;
+        bool mShuttingDown;
+        OGRE_WQ_MUTEX(mWaitMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWaitCondition);
+
+        /// All messages before this position are written
+        size_t mWrittenPos;
+        OGRE_WQ_MUTEX(mWrittenMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWrittenCondition);
+
+        WriterFunc* mWriterFunc;
+        OGRE_THREAD_TYPE* mThread;
+    };
+    //-----------------------------------------------------------------------
+    Log::AsyncWriter::AsyncWriter(Log* log, size_t queueSize)
+        : mLog(log), mEntries(0), mCapacity(2), mMask(1), mEnqueuePos(0), mDequeuePos(0)
+        , mNumSleeping(0), mShuttingDown(false), mWrittenPos(0), mWriterFunc(0), mThread(0)
+    {
+        while (mCapacity < queueSize)
+            mCapacity <<= 1;
+        mMask = mCapacity - 1;
+
+        mEntries = OGRE_NEW_ARRAY_T(Entry, mCapacity, MEMCATEGORY_GENERAL);
+        for (size_t i = 0; i < mCapacity; ++i)
+            mEntries[i].sequence.store(i);
+        mBatch.reserve(MAX_BATCH_SIZE);
+
+        mWriterFunc = OGRE_NEW_T(WriterFunc(this), MEMCATEGORY_GENERAL);
+        OGRE_THREAD_CREATE(t, *mWriterFunc);
+        mThread = t;
+    }
+    //-----------------------------------------------------------------------
+    Log::AsyncWriter::~AsyncWriter()
+    {
+        {
+            OGRE_WQ_LOCK_MUTEX(mWaitMutex);
+            mShuttingDown = true;
+            OGRE_THREAD_NOTIFY_ONE(mWaitCondition);
+        }
+        mThread->join();
+        OGRE_THREAD_DESTROY(mThread);
+        OGRE_DELETE_T(mWriterFunc, WriterFunc, MEMCATEGORY_GENERAL);
+        OGRE_DELETE_ARRAY_T(mEntries, Entry, mCapacity, MEMCATEGORY_GENERAL);
+    }
+    //-----------------------------------------------------------------------
+    size_t Log::AsyncWriter::push(const String& message, LogMessageLevel lml, bool maskDebug)
+    {
+        size_t pos = loadAcquire(mEnqueuePos);
+        Entry* entry;
+        for (;;)
+        {
+            entry = &mEntries[pos & mMask];
+            size_t seq = loadAcquire(entry->sequence);
+            if (seq == pos)
+            {
+                // Slot is free, try to claim the position
+                if (mEnqueuePos.compare_exchange_strong(pos, pos + 1))
+                    break;
+            }
+            else if (seq < pos)
+            {
+                // Queue is full, wait for the writer to take the message of the
+                // previous round from this slot
+                waitWritten(pos - mMask);
+            }
+            pos = loadAcquire(mEnqueuePos);
+        }
+
+        entry->message = message;
+        entry->lml = lml;
+        entry->maskDebug = maskDebug;
+        entry->time = time(NULL);
+        // Publish the message to the writer, the barrier also keeps the check
+        // for a sleeping writer from being done before
+        storeRelease(entry->sequence, pos + 1);
+
+        if (loadAcquire(mNumSleeping) > 0)
+            wakeWriter();
+
+        return pos;
+    }
+    //-----------------------------------------------------------------------
+    void Log::AsyncWriter::waitWritten(size_t position)
+    {
+        wakeWriter();
+        OGRE_WQ_LOCK_MUTEX_NAMED(mWrittenMutex, lock);
+        while (mWrittenPos < position)
+            OGRE_THREAD_WAIT(mWrittenCondition, mWrittenMutex, lock);
+    }
+    //-----------------------------------------------------------------------
+    void Log::AsyncWriter::wakeWriter()
+    {
+        OGRE_WQ_LOCK_MUTEX(mWaitMutex);
+        OGRE_THREAD_NOTIFY_ONE(mWaitCondition);
+    }
+    //-----------------------------------------------------------------------
+    void Log::AsyncWriter::threadMain()
+    {
+        for (;;)
+        {
+            if (writeBatch())
+                continue;
+
+            OGRE_WQ_LOCK_MUTEX_NAMED(mWaitMutex, lock);
+            // Producers only notify if someone sleeps, so announce it before
+            // checking the queue again
+            ++mNumSleeping;
+            while (!mShuttingDown && !hasMessage())
+                OGRE_THREAD_WAIT(mWaitCondition, mWaitMutex, lock);
+            --mNumSleeping;
+
+            if (mShuttingDown && !hasMessage())
+                break;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool Log::AsyncWriter::writeBatch()
+    {
+        mBatch.clear();
+        while (mBatch.size() < MAX_BATCH_SIZE && hasMessage())
+        {
+            Entry& entry = mEntries[mDequeuePos & mMask];
+            mBatch.push_back(Message());
+            Message& msg = mBatch.back();
+            msg.message.swap(entry.message);
+            msg.lml = entry.lml;
+            msg.maskDebug = entry.maskDebug;
+            msg.time = entry.time;
+            // Hand the slot back to the producers of the next round
+            storeRelease(entry.sequence, mDequeuePos + mCapacity);
+            ++mDequeuePos;
+        }
+
+        if (mBatch.empty())
+            return false;
+
+        {
+            OGRE_LOCK_MUTEX(mLog->OGRE_AUTO_MUTEX_NAME);
+            OGRE_WQ_LOCK_MUTEX(mLog->mOutputMutex);
+            for (MessageList::iterator i = mBatch.begin(); i != mBatch.end(); ++i)
+                mLog->writeMessage(i->message, i->lml, i->maskDebug, i->time, false);
+            mLog->flushOutput();
+        }
+
+        OGRE_WQ_LOCK_MUTEX(mWrittenMutex);
+        mWrittenPos = mDequeuePos;
+        OGRE_THREAD_NOTIFY_ALL(mWrittenCondition);
+        return true;
+    }
+#endif
     //-----------------------------------------------------------------------
     Log::Log( const String& name, bool debuggerOuput, bool suppressFile ) : 
         mLogLevel(LL_NORMAL), mDebugOut(debuggerOuput),
-        mSuppressFile(suppressFile), mTimeStamp(true), mLogName(name)
+        mSuppressFile(suppressFile), mTimeStamp(true), mLogName(name),
+        mAsyncWriter(0), mLastTime(0)
     {
         if (!mSuppressFile)
         {
@@ -59,7 +318,11 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Log::~Log()
     {
+        // Write out what is still queued
+        setAsynchronous(false);
+
         OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_MUTEX(mOutputMutex);
         if (!mSuppressFile)
         {
             mLog.close();
@@ -68,67 +331,134 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void Log::logMessage( const String& message, LogMessageLevel lml, bool maskDebug )
     {
+#if OGRE_THREAD_SUPPORT
+        // Listeners logging from the writer thread are written directly
+        if (mAsyncWriter && !mAsyncWriter->isWriterThread())
+        {
+            if ((mLogLevel + lml) >= OGRE_LOG_THRESHOLD)
+            {
+                size_t position = mAsyncWriter->push(message, lml, maskDebug);
+                if (lml == LML_CRITICAL)
+                    mAsyncWriter->waitWritten(position + 1);
+            }
+            return;
+        }
+#endif
         OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_MUTEX(mOutputMutex);
         if ((mLogLevel + lml) >= OGRE_LOG_THRESHOLD)
         {
-            bool skipThisMessage = false;
-            for( mtLogListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
-                (*i)->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage);
-            
-            if (!skipThisMessage)
-            {
+            writeMessage(message, lml, maskDebug, time(NULL), true);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Log::writeMessage(const String& message, LogMessageLevel lml, bool maskDebug, time_t time, bool flush)
+    {
+        bool skipThisMessage = false;
+        for( mtLogListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
+            (*i)->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage);
+
+        if (skipThisMessage)
+            return;
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_NACL
-                if(mInstance != NULL)
-                {
-                    mInstance->PostMessage(message.c_str());
-                }
+        if(mInstance != NULL)
+        {
+            mInstance->PostMessage(message.c_str());
+        }
 #else
-                if (mDebugOut && !maskDebug)
-                {
+        if (mDebugOut && !maskDebug)
+        {
 #    if (OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT) && OGRE_DEBUG_MODE
 #        if OGRE_WCHAR_T_STRINGS
-                    OutputDebugStringW(L"Ogre: ");
-                    OutputDebugStringW(message.c_str());
-                    OutputDebugStringW(L"\n");
+            OutputDebugStringW(L"Ogre: ");
+            OutputDebugStringW(message.c_str());
+            OutputDebugStringW(L"\n");
 #        else
-                    OutputDebugStringA("Ogre: ");
-                    OutputDebugStringA(message.c_str());
-                    OutputDebugStringA("\n");
+            OutputDebugStringA("Ogre: ");
+            OutputDebugStringA(message.c_str());
+            OutputDebugStringA("\n");
 #        endif
 #    endif
-                    if (lml == LML_CRITICAL)
-                        std::cerr << message << std::endl;
-                    else
-                        std::cout << message << std::endl;
-                }
+            if (lml == LML_CRITICAL)
+                std::cerr << message << '\n';
+            else
+                std::cout << message << '\n';
+        }
 #endif
 
-                // Write time into log
-                if (!mSuppressFile)
+        // Write time into log
+        if (!mSuppressFile)
+        {
+            if (mTimeStamp)
+            {
+                // Formatting the local time is costly, most messages share the second
+                if (time != mLastTime || mLastTimeStamp.empty())
                 {
-                    if (mTimeStamp)
-                    {
-                        struct tm *pTime;
-                        time_t ctTime; time(&ctTime);
-                        pTime = localtime( &ctTime );
-                        mLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
-                            << ": ";
-                    }
-                    mLog << message << std::endl;
-
-                    // Flush stcmdream to ensure it is written (incase of a crash, we need log to be up to date)
-                    mLog.flush();
+                    struct tm *pTime = localtime( &time );
+                    StringStream str;
+                    str << std::setw(2) << std::setfill('0') << pTime->tm_hour
+                        << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
+                        << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
+                        << ": ";
+                    mLastTimeStamp = str.str();
+                    mLastTime = time;
                 }
+                mLog << mLastTimeStamp;
             }
+            mLog << message << '\n';
+        }
+
+        // Flush stream to ensure it is written (incase of a crash, we need log to be up to date)
+        if (flush)
+            flushOutput();
+    }
+    //-----------------------------------------------------------------------
+    void Log::flushOutput()
+    {
+#if OGRE_PLATFORM != OGRE_PLATFORM_NACL
+        if (mDebugOut)
+            std::cout.flush();
+#endif
+        if (!mSuppressFile)
+            mLog.flush();
+    }
+    //-----------------------------------------------------------------------
+    void Log::setAsynchronous(bool async, size_t queueSize)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (async == (mAsyncWriter != 0))
+            return;
+
+        if (async)
+        {
+            mAsyncWriter = OGRE_NEW AsyncWriter(this, queueSize);
         }
+        else
+        {
+            AsyncWriter* writer = mAsyncWriter;
+            mAsyncWriter = 0;
+            OGRE_DELETE writer;
+        }
+#else
+        (void)async;
+        (void)queueSize;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void Log::flush()
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mAsyncWriter && !mAsyncWriter->isWriterThread())
+            mAsyncWriter->waitWritten(mAsyncWriter->getEnqueuePosition());
+#endif
     }
     
     //-----------------------------------------------------------------------
     void Log::setTimeStampEnabled(bool timeStamp)
     {
         OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_MUTEX(mOutputMutex);
         mTimeStamp = timeStamp;
     }
 
@@ -136,6 +466,7 @@ namespace Ogre
     void Log::setDebugOutputEnabled(bool debugOutput)
     {
         OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_MUTEX(mOutputMutex);
         mDebugOut = debugOutput;
     }
 
@@ -143,6 +474,7 @@ namespace Ogre
     void Log::setLogDetail(LoggingLevel ll)
     {
         OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_MUTEX(mOutputMutex);
         mLogLevel = ll;
     }
 
@@ -150,6 +482,7 @@ namespace Ogre
     void Log::addListener(LogListener* listener)
     {
         OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_MUTEX(mOutputMutex);
         if (std::find(mListeners.begin(), mListeners.end(), listener) == mListeners.end())
             mListeners.push_back(listener);
     }
@@ -158,6 +491,7 @@ namespace Ogre
     void Log::removeListener(LogListener* listener)
     {
         OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_MUTEX(mOutputMutex);
         mtLogListener::iterator i = std::find(mListeners.begin(), mListeners.end(), listener);
         if (i != mListeners.end())
             mListeners.erase(i);
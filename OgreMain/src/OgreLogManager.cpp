@@ -50,10 +50,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     LogManager::~LogManager()
     {
-        OGRE_LOCK_AUTO_MUTEX;
-        // Destroy all logs
+        LogList logs;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            logs.swap(mLogs);
+            mDefaultLog = 0;
+        }
+        // Destroy all logs. Asynchronous logs write what is still queued, so
+        // listeners logging through this manager must not find it locked.
         LogList::iterator i;
-        for (i = mLogs.begin(); i != mLogs.end(); ++i)
+        for (i = logs.begin(); i != logs.end(); ++i)
         {
             OGRE_DELETE i->second;
         }
@@ -132,19 +138,23 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void LogManager::logMessage( const String& message, LogMessageLevel lml, bool maskDebug)
     {
-        OGRE_LOCK_AUTO_MUTEX;
-        if (mDefaultLog)
+        // The log locks itself. An asynchronous log may block until its writer
+        // thread calls the listeners, which may log through this manager again,
+        // so the lock is not held meanwhile.
+        Log* log = getDefaultLog();
+        if (log)
         {
-            mDefaultLog->logMessage(message, lml, maskDebug);
+            log->logMessage(message, lml, maskDebug);
         }
     }
     //-----------------------------------------------------------------------
     void LogManager::setLogDetail(LoggingLevel ll)
     {
-        OGRE_LOCK_AUTO_MUTEX;
-        if (mDefaultLog)
+        // see logMessage
+        Log* log = getDefaultLog();
+        if (log)
         {
-            mDefaultLog->setLogDetail(ll);
+            log->setLogDetail(ll);
         }
     }
     //---------------------------------------------------------------------
@@ -0,0 +1,364 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreMemoryFrameAlloc.h"
+#include "OgreAlignedAllocator.h"
+#include "OgreAtomicScalar.h"
+
+#if OGRE_THREAD_SUPPORT
+#   if OGRE_COMPILER == OGRE_COMPILER_MSVC
+#       define OGRE_FRAME_ALLOC_TLS __declspec(thread)
+#   else
+#       define OGRE_FRAME_ALLOC_TLS __thread
+#   endif
+#else
+#   define OGRE_FRAME_ALLOC_TLS
+#endif
+
+#if OGRE_THREAD_SUPPORT
+#   if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+#       include <windows.h>
+#   else
+#       include <pthread.h>
+#   endif
+#endif
+
+namespace Ogre
+{
+namespace
+{
+    /// Usable size of a block
+    const size_t BLOCK_SIZE = 64 * 1024;
+    /// Allocations larger than this are passed on to the heap
+    const size_t MAX_BLOCK_ALLOCATION = BLOCK_SIZE / 4;
+    /// Threads holding blocks of this size pass further allocations on to the heap
+    const size_t MAX_RESERVED_BYTES = 16 * 1024 * 1024;
+    /// Alignment of the allocations, also the size of their header
+    const size_t ALIGNMENT = 16;
+
+    struct Block
+    {
+        Block* next;
+    };
+
+    /** The blocks of a thread.
+    @remarks
+        Only the owning thread allocates, any thread may deallocate.
+    */
+    struct Arena
+    {
+        Arena()
+            : mNext(0), mOwned(1), mFirst(0), mCurrent(0), mOffset(0)
+            , mNumLive(0), mNumAllocations(0), mNumBytes(0), mReservedBytes(0)
+        {
+        }
+
+        void* allocate(size_t count)
+        {
+            const size_t size = (count + 2 * ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+            if (size - ALIGNMENT > MAX_BLOCK_ALLOCATION)
+                return 0;
+
+            // Nothing is using the blocks, start from the beginning
+            if (mNumLive.load() == 0)
+            {
+                mCurrent = mFirst;
+                mOffset = 0;
+            }
+
+            while (!mCurrent || mOffset + size > BLOCK_SIZE)
+            {
+                if (mCurrent && mCurrent->next)
+                {
+                    mCurrent = mCurrent->next;
+                }
+                else
+                {
+                    if (mReservedBytes.load() + BLOCK_SIZE > MAX_RESERVED_BYTES)
+                        return 0;
+                    Block* block = static_cast<Block*>(
+                        AlignedMemory::allocate(ALIGNMENT + BLOCK_SIZE, ALIGNMENT));
+                    block->next = 0;
+                    if (mCurrent)
+                        mCurrent->next = block;
+                    else
+                        mFirst = block;
+                    mCurrent = block;
+                    mReservedBytes += BLOCK_SIZE;
+                }
+                mOffset = 0;
+            }
+
+            char* header = reinterpret_cast<char*>(mCurrent) + ALIGNMENT + mOffset;
+            mOffset += size;
+            ++mNumLive;
+            ++mNumAllocations;
+            mNumBytes += size;
+
+            *reinterpret_cast<Arena**>(header) = this;
+            return header + ALIGNMENT;
+        }
+
+        void deallocate()
+        {
+            --mNumLive;
+        }
+
+        /// Return the blocks to the heap, only valid while nothing uses them
+        void releaseBlocks()
+        {
+            while (mFirst)
+            {
+                Block* next = mFirst->next;
+                AlignedMemory::deallocate(mFirst);
+                mFirst = next;
+            }
+            mCurrent = 0;
+            mOffset = 0;
+            mReservedBytes.store(0);
+        }
+
+        /// Next arena in the list of all arenas
+        Arena* mNext;
+        /// Whether a thread allocates from this arena
+        AtomicScalar<size_t> mOwned;
+
+        Block* mFirst;
+        Block* mCurrent;
+        /// Offset of the next allocation in the current block
+        size_t mOffset;
+
+        /// Allocations not deallocated yet
+        AtomicScalar<size_t> mNumLive;
+        /// Totals for the statistics
+        AtomicScalar<size_t> mNumAllocations;
+        AtomicScalar<size_t> mNumBytes;
+        AtomicScalar<size_t> mReservedBytes;
+    };
+
+    /// All arenas ever created, only their blocks are freed, the arenas are handed to new threads
+    AtomicScalar<Arena*> sArenas(0);
+    /// The arena of the calling thread
+    OGRE_FRAME_ALLOC_TLS Arena* tArena = 0;
+
+    AtomicScalar<size_t> sNumHeapAllocations(0);
+    /// Totals at the end of the last frame
+    FrameAllocPolicy::Statistics sFrameEndTotals;
+    FrameAllocPolicy::Statistics sLastFrame;
+
+    /** Let another thread take over an arena.
+    @remarks
+        The exchange is a full barrier with every AtomicScalar implementation,
+        so the blocks written by the previous owner are visible to the next one.
+    */
+    void releaseArena(Arena* arena)
+    {
+        if (tArena == arena)
+            tArena = 0;
+        size_t owned = 1;
+        arena->mOwned.compare_exchange_strong(owned, 0);
+    }
+
+#if OGRE_THREAD_SUPPORT
+    /** Releases the arena of a thread when it exits.
+    @remarks
+        Covers the threads which do not call FrameAllocPolicy::_threadEnded,
+        like the log writer or the threads of the application. Until this is
+        constructed the key is not valid and arenas are only released
+        explicitly.
+    */
+    struct ThreadExitHook
+    {
+#   if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        ThreadExitHook() : key(FlsAlloc(&threadExited)), valid(key != FLS_OUT_OF_INDEXES) {}
+        ~ThreadExitHook()
+        {
+            if (valid)
+                FlsFree(key);
+            valid = false;
+        }
+
+        void set(Arena* arena)
+        {
+            if (valid)
+                FlsSetValue(key, arena);
+        }
+
+        static void WINAPI threadExited(void* arena)
+        {
+            if (arena)
+                releaseArena(static_cast<Arena*>(arena));
+        }
+
+        DWORD key;
+#   else
+        ThreadExitHook() : valid(pthread_key_create(&key, &threadExited) == 0) {}
+        ~ThreadExitHook()
+        {
+            if (valid)
+                pthread_key_delete(key);
+            valid = false;
+        }
+
+        void set(Arena* arena)
+        {
+            if (valid)
+                pthread_setspecific(key, arena);
+        }
+
+        static void threadExited(void* arena)
+        {
+            releaseArena(static_cast<Arena*>(arena));
+        }
+
+        pthread_key_t key;
+#   endif
+        bool valid;
+    };
+#else
+    struct ThreadExitHook
+    {
+        void set(Arena*) {}
+    };
+#endif
+    ThreadExitHook sThreadExitHook;
+
+    Arena* getArena()
+    {
+        if (tArena)
+            return tArena;
+
+        // Take over the arena of a thread which ended
+        Arena* arena = 0;
+        for (Arena* a = sArenas.load(); a && !arena; a = a->mNext)
+        {
+            size_t owned = 0;
+            if (a->mOwned.load() == 0 && a->mOwned.compare_exchange_strong(owned, 1))
+                arena = a;
+        }
+
+        if (!arena)
+        {
+            arena = new (AlignedMemory::allocate(sizeof(Arena))) Arena();
+            Arena* head = sArenas.load();
+            for (;;)
+            {
+                arena->mNext = head;
+                if (sArenas.compare_exchange_strong(head, arena))
+                    break;
+                head = sArenas.load();
+            }
+        }
+
+        tArena = arena;
+        sThreadExitHook.set(arena);
+        return arena;
+    }
+}
+    //-----------------------------------------------------------------------
+    void* FrameAllocPolicy::allocateBytes(size_t count, const char*, int, const char*)
+    {
+        void* ptr = getArena()->allocate(count);
+        if (ptr)
+            return ptr;
+
+        ++sNumHeapAllocations;
+        char* header = static_cast<char*>(AlignedMemory::allocate(ALIGNMENT + count, ALIGNMENT));
+        *reinterpret_cast<Arena**>(header) = 0;
+        return header + ALIGNMENT;
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocPolicy::deallocateBytes(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        char* header = static_cast<char*>(ptr) - ALIGNMENT;
+        Arena* arena = *reinterpret_cast<Arena**>(header);
+        if (arena)
+            arena->deallocate();
+        else
+            AlignedMemory::deallocate(header);
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocPolicy::_frameEnded(void)
+    {
+        Statistics totals;
+        for (Arena* a = sArenas.load(); a; a = a->mNext)
+        {
+            totals.numAllocations += a->mNumAllocations.load();
+            totals.numBytes += a->mNumBytes.load();
+        }
+        totals.numHeapAllocations = sNumHeapAllocations.load();
+
+        sLastFrame.numAllocations = totals.numAllocations - sFrameEndTotals.numAllocations;
+        sLastFrame.numBytes = totals.numBytes - sFrameEndTotals.numBytes;
+        sLastFrame.numHeapAllocations = totals.numHeapAllocations - sFrameEndTotals.numHeapAllocations;
+        sFrameEndTotals = totals;
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocPolicy::_threadEnded(void)
+    {
+        if (tArena)
+        {
+            sThreadExitHook.set(0);
+            releaseArena(tArena);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocPolicy::_shutdown(void)
+    {
+        _threadEnded();
+
+        // Free the blocks of the arenas no thread owns, unless allocations from
+        // them are still alive. Owning the arena meanwhile keeps threads away.
+        for (Arena* a = sArenas.load(); a; a = a->mNext)
+        {
+            size_t owned = 0;
+            if (a->mOwned.load() != 0 || !a->mOwned.compare_exchange_strong(owned, 1))
+                continue;
+            if (a->mNumLive.load() == 0)
+                a->releaseBlocks();
+            releaseArena(a);
+        }
+    }
+    //-----------------------------------------------------------------------
+    FrameAllocPolicy::Statistics FrameAllocPolicy::getLastFrameStatistics(void)
+    {
+        return sLastFrame;
+    }
+    //-----------------------------------------------------------------------
+    size_t FrameAllocPolicy::getReservedBytes(void)
+    {
+        size_t bytes = 0;
+        for (Arena* a = sArenas.load(); a; a = a->mNext)
+            bytes += a->mReservedBytes.load();
+        return bytes;
+    }
+}
@@ -217,8 +217,24 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless the stream already is in memory
+        // (e.g. a memory mapped file) and can be read without copying
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get());
+        if (!memStream)
+        {
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+            return;
+        }
+
+        // The pages of a mapped file are only read when first accessed, touch
+        // them now so that the I/O happens here rather than in loadImpl, which
+        // may be on another thread. 4096 is the smallest common page size.
+        const volatile uchar* data = memStream->getPtr();
+        const size_t size = memStream->size();
+        uchar sum = 0;
+        for (size_t i = 0; i < size; i += 4096)
+            sum ^= data[i];
+        (void)sum;
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -822,16 +822,19 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
-        stream->read(pBuf, dest->vertexCount * vertexSize);
-
-        // endian conversion for OSX
-        flipFromLittleEndian(
-            pBuf,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
-        vbuf->unlock();
+        if (!readBufferDirect(stream, vbuf.get()))
+        {
+            void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
+            stream->read(pBuf, dest->vertexCount * vertexSize);
+
+            // endian conversion for OSX
+            flipFromLittleEndian(
+                pBuf,
+                dest->vertexCount,
+                vertexSize,
+                dest->vertexDeclaration->findElementsBySource(bindIndex));
+            vbuf->unlock();
+        }
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -1018,12 +1021,15 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                // unsigned int* faceVertexIndices
-                unsigned int* pIdx = static_cast<unsigned int*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readInts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
+                if (!readBufferDirect(stream, ibuf.get()))
+                {
+                    // unsigned int* faceVertexIndices
+                    unsigned int* pIdx = static_cast<unsigned int*>(
+                        ibuf->lock(HardwareBuffer::HBL_DISCARD)
+                        );
+                    readInts(stream, pIdx, sm->indexData->indexCount);
+                    ibuf->unlock();
+                }
 
             }
             else // 16-bit
@@ -1033,12 +1039,15 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                // unsigned short* faceVertexIndices
-                unsigned short* pIdx = static_cast<unsigned short*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readShorts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
+                if (!readBufferDirect(stream, ibuf.get()))
+                {
+                    // unsigned short* faceVertexIndices
+                    unsigned short* pIdx = static_cast<unsigned short*>(
+                        ibuf->lock(HardwareBuffer::HBL_DISCARD)
+                        );
+                    readShorts(stream, pIdx, sm->indexData->indexCount);
+                    ibuf->unlock();
+                }
             }
         }
         sm->indexData->indexBuffer = ibuf;
@@ -1597,23 +1606,41 @@ namespace Ogre {
                 indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                     idx32Bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
                     buffIndexCount, pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                void* pIdx = static_cast<unsigned int*>(indexData->indexBuffer->lock(
-                    0, indexData->indexBuffer->getSizeInBytes(), HardwareBuffer::HBL_DISCARD));
-
-                // unsigned short*/int* faceIndexes;  ((v1, v2, v3) * numFaces)
-                if (idx32Bit)
+                if (!readBufferDirect(stream, indexData->indexBuffer.get()))
                 {
-                    readInts(stream, (uint32*)pIdx, buffIndexCount);
-                }
-                else
-                {
-                    readShorts(stream, (uint16*)pIdx, buffIndexCount);
+                    void* pIdx = static_cast<unsigned int*>(indexData->indexBuffer->lock(
+                        0, indexData->indexBuffer->getSizeInBytes(), HardwareBuffer::HBL_DISCARD));
+
+                    // unsigned short*/int* faceIndexes;  ((v1, v2, v3) * numFaces)
+                    if (idx32Bit)
+                    {
+                        readInts(stream, (uint32*)pIdx, buffIndexCount);
+                    }
+                    else
+                    {
+                        readShorts(stream, (uint16*)pIdx, buffIndexCount);
+                    }
+                    indexData->indexBuffer->unlock();
                 }
-                indexData->indexBuffer->unlock();
             }
         }
     }
 #endif
+    //---------------------------------------------------------------------
+    bool MeshSerializerImpl::readBufferDirect(DataStreamPtr& stream, HardwareBuffer* buf)
+    {
+        if (mFlipEndian)
+            return false;
+
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        size_t size = buf->getSizeInBytes();
+        if (!memStream || memStream->size() - memStream->tell() < size)
+            return false;
+
+        buf->writeData(0, size, memStream->getCurrentPtr(), true);
+        memStream->skip(size);
+        return true;
+    }
     //---------------------------------------------------------------------
     void MeshSerializerImpl::flipFromLittleEndian(void* pData, size_t vertexCount,
         size_t vertexSize, const VertexDeclaration::VertexElementList& elems)
@@ -3030,14 +3057,17 @@ namespace Ogre {
                     indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                         HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    unsigned int* pIdx = static_cast<unsigned int*>(
-                        indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD));
-
-                    readInts(stream, pIdx, indexData->indexCount);
-                    indexData->indexBuffer->unlock();
+                    if (!readBufferDirect(stream, indexData->indexBuffer.get()))
+                    {
+                        unsigned int* pIdx = static_cast<unsigned int*>(
+                            indexData->indexBuffer->lock(
+                            0,
+                            indexData->indexBuffer->getSizeInBytes(),
+                            HardwareBuffer::HBL_DISCARD));
+
+                        readInts(stream, pIdx, indexData->indexCount);
+                        indexData->indexBuffer->unlock();
+                    }
 
                 }
                 else
@@ -3045,13 +3075,16 @@ namespace Ogre {
                     indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                         HardwareIndexBuffer::IT_16BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    unsigned short* pIdx = static_cast<unsigned short*>(
-                        indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD));
-                    readShorts(stream, pIdx, indexData->indexCount);
-                    indexData->indexBuffer->unlock();
+                    if (!readBufferDirect(stream, indexData->indexBuffer.get()))
+                    {
+                        unsigned short* pIdx = static_cast<unsigned short*>(
+                            indexData->indexBuffer->lock(
+                            0,
+                            indexData->indexBuffer->getSizeInBytes(),
+                            HardwareBuffer::HBL_DISCARD));
+                        readShorts(stream, pIdx, indexData->indexCount);
+                        indexData->indexBuffer->unlock();
+                    }
                 }
             }
         }
@@ -249,6 +249,43 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Node::_updateSelf(bool parentHasChanged, ChildUpdateList& children)
+    {
+        // same sequence as _update, but hand the children back to the caller
+        mParentNotified = false;
+
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+        }
+
+        if (mNeedChildUpdate || parentHasChanged)
+        {
+            ChildNodeMap::iterator it, itend;
+            itend = mChildren.end();
+            for (it = mChildren.begin(); it != itend; ++it)
+            {
+#if OGRE_NODE_STORAGE_LEGACY
+                children.push_back(std::make_pair(it->second, true));
+#else
+                children.push_back(std::make_pair(*it, true));
+#endif
+            }
+        }
+        else
+        {
+            ChildUpdateSet::iterator it, itend;
+            itend = mChildrenToUpdate.end();
+            for(it = mChildrenToUpdate.begin(); it != itend; ++it)
+            {
+                children.push_back(std::make_pair(*it, false));
+            }
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+    }
+    //-----------------------------------------------------------------------
     void Node::_updateFromParent(void) const
     {
         updateFromParentImpl();
@@ -316,6 +353,18 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void Node::setDerivedTransformImpl(const Vector3& position,
+        const Quaternion& orientation, const Vector3& scale) const
+    {
+        mCachedTransformOutOfDate = true;
+
+        mDerivedPosition = position;
+        mDerivedOrientation = orientation;
+        mDerivedScale = scale;
+
+        mNeedParentUpdate = false;
+    }
+    //-----------------------------------------------------------------------
     Node* Node::createChild(const Vector3& inTranslate, const Quaternion& inRotate)
     {
         Node* newNode = createChildImpl();
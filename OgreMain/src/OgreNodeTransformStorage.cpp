@@ -0,0 +1,305 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreNodeTransformStorage.h"
+#include "OgreNode.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+
+    namespace {
+        // Component arrays are padded so every depth level starts on a SIMD boundary
+        const size_t SLOT_ALIGNMENT = 4;
+
+        void storeTransform(Real* buffer, size_t stride, size_t slot,
+            const Vector3& position, const Quaternion& orientation, const Vector3& scale)
+        {
+            Real* p = buffer + slot;
+            p[0] = position.x;
+            p[stride] = position.y;
+            p[2*stride] = position.z;
+            p[3*stride] = orientation.w;
+            p[4*stride] = orientation.x;
+            p[5*stride] = orientation.y;
+            p[6*stride] = orientation.z;
+            p[7*stride] = scale.x;
+            p[8*stride] = scale.y;
+            p[9*stride] = scale.z;
+        }
+
+        void copyTransform(const Real* src, size_t srcSlot, Real* dst, size_t dstSlot,
+            size_t stride, size_t numComponents)
+        {
+            for (size_t c = 0; c < numComponents; ++c)
+            {
+                dst[c*stride + dstSlot] = src[c*stride + srcSlot];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    NodeTransformStorage::NodeTransformStorage()
+        : mParentTransforms(0)
+        , mLocalTransforms(0)
+        , mDerivedTransforms(0)
+        , mStride(0)
+        , mNumNodes(0)
+        , mRoot(0)
+        , mLayoutOutOfDate(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    NodeTransformStorage::~NodeTransformStorage()
+    {
+        freeBuffers();
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformStorage::freeBuffers(void)
+    {
+        OGRE_FREE_SIMD(mParentTransforms, MEMCATEGORY_SCENE_CONTROL);
+        OGRE_FREE_SIMD(mLocalTransforms, MEMCATEGORY_SCENE_CONTROL);
+        OGRE_FREE_SIMD(mDerivedTransforms, MEMCATEGORY_SCENE_CONTROL);
+        mParentTransforms = mLocalTransforms = mDerivedTransforms = 0;
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformStorage::allocateBuffers(void)
+    {
+        freeBuffers();
+
+        if (!mStride)
+            return;
+
+        // Zero them, so slots which are never written hold valid numbers
+        size_t bytes = sizeof(Real) * NUM_COMPONENTS * mStride;
+        mParentTransforms = static_cast<Real*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_SCENE_CONTROL));
+        mLocalTransforms = static_cast<Real*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_SCENE_CONTROL));
+        mDerivedTransforms = static_cast<Real*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_SCENE_CONTROL));
+        memset(mParentTransforms, 0, bytes);
+        memset(mLocalTransforms, 0, bytes);
+        memset(mDerivedTransforms, 0, bytes);
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformStorage::buildLayout(Node* root)
+    {
+        mNodes.clear();
+        mParents.clear();
+        mLevels.clear();
+        mNumNodes = 0;
+        mRoot = root;
+
+        if (root)
+        {
+            mNodes.push_back(root);
+            mParents.push_back(0);
+            Level rootLevel = { 0, 1 };
+            mLevels.push_back(rootLevel);
+            mNumNodes = 1;
+
+            while (true)
+            {
+                const Level parents = mLevels.back();
+
+                while (mNodes.size() % SLOT_ALIGNMENT)
+                {
+                    mNodes.push_back(0);
+                    mParents.push_back(0);
+                }
+
+                Level level;
+                level.begin = mNodes.size();
+                for (size_t p = parents.begin; p < parents.end; ++p)
+                {
+                    Node* parent = mNodes[p];
+                    if (!parent)
+                        continue;
+
+                    Node::ChildNodeMap::const_iterator it, itend;
+                    itend = parent->mChildren.end();
+                    for (it = parent->mChildren.begin(); it != itend; ++it)
+                    {
+#if OGRE_NODE_STORAGE_LEGACY
+                        mNodes.push_back(it->second);
+#else
+                        mNodes.push_back(*it);
+#endif
+                        mParents.push_back(p);
+                    }
+                }
+                level.end = mNodes.size();
+
+                if (level.begin == level.end)
+                    break;
+
+                mNumNodes += level.end - level.begin;
+                mLevels.push_back(level);
+            }
+        }
+
+        mFlags.assign(mNodes.size(), 0);
+
+        if (mNodes.size() != mStride)
+        {
+            mStride = mNodes.size();
+            allocateBuffers();
+        }
+
+        mLayoutOutOfDate = false;
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformStorage::update(Node* root)
+    {
+        if (mLayoutOutOfDate || root != mRoot)
+            buildLayout(root);
+
+        mUpdatedNodes.clear();
+        if (!root)
+            return;
+
+        const size_t stride = mStride;
+
+        for (LevelList::const_iterator l = mLevels.begin(); l != mLevels.end(); ++l)
+        {
+            size_t numRecalculated = 0;
+
+            // Work out which nodes the recursive update would visit and gather
+            // the inputs of the ones which have to be recalculated
+            for (size_t i = l->begin; i < l->end; ++i)
+            {
+                Node* node = mNodes[i];
+                if (!node)
+                {
+                    mFlags[i] = 0;
+                    continue;
+                }
+
+                uint8 flags = 0;
+                bool parentHasChanged = false;
+                if (node == root)
+                {
+                    flags = SF_VISITED;
+                }
+                else
+                {
+                    uint8 parentFlags = mFlags[mParents[i]];
+                    parentHasChanged = (parentFlags & SF_CHILDREN_CHANGED) != 0;
+                    if ((parentFlags & SF_VISITED) && (parentHasChanged || node->mParentNotified))
+                        flags = SF_VISITED;
+                }
+
+                if (flags & SF_VISITED)
+                {
+                    node->mParentNotified = false;
+                    if (node->mNeedParentUpdate || parentHasChanged)
+                        flags |= SF_RECALCULATE;
+                    if (node->mNeedChildUpdate || parentHasChanged)
+                        flags |= SF_CHILDREN_CHANGED;
+
+                    node->mChildrenToUpdate.clear();
+                    node->mNeedChildUpdate = false;
+                    mUpdatedNodes.push_back(node);
+
+#if OGRE_NODE_INHERIT_TRANSFORM
+                    // Full matrix inheritance is not supported by the sweep
+                    if (flags & SF_RECALCULATE)
+                        node->_updateFromParent();
+                    flags &= ~SF_RECALCULATE;
+#endif
+
+                    if (flags & SF_RECALCULATE)
+                    {
+                        ++numRecalculated;
+                        storeTransform(mLocalTransforms, stride, i,
+                            node->mPosition, node->mOrientation, node->mScale);
+                        if (node != root)
+                        {
+                            copyTransform(mDerivedTransforms, mParents[i],
+                                mParentTransforms, i, stride, NUM_COMPONENTS);
+                        }
+                    }
+                    else
+                    {
+                        // Up to date, but its children might need it
+                        storeTransform(mDerivedTransforms, stride, i,
+                            node->mDerivedPosition, node->mDerivedOrientation, node->mDerivedScale);
+                    }
+                }
+
+                mFlags[i] = flags;
+            }
+
+            if (!numRecalculated)
+                continue;
+
+            if (l == mLevels.begin())
+            {
+                // Root node, no parent
+                copyTransform(mLocalTransforms, 0, mDerivedTransforms, 0, stride, NUM_COMPONENTS);
+            }
+            else
+            {
+                OptimisedUtil::getImplementation()->concatenateNodeTransforms(
+                    mParentTransforms + l->begin,
+                    mLocalTransforms + l->begin,
+                    mDerivedTransforms + l->begin,
+                    stride,
+                    l->end - l->begin);
+            }
+
+            // Handle disabled inheritance and write the results back
+            for (size_t i = l->begin; i < l->end; ++i)
+            {
+                if (!(mFlags[i] & SF_RECALCULATE))
+                    continue;
+
+                Node* node = mNodes[i];
+                if (!node->mInheritOrientation)
+                {
+                    // orientation is components 3 to 6
+                    copyTransform(mLocalTransforms + 3*stride, i,
+                        mDerivedTransforms + 3*stride, i, stride, 4);
+                }
+                if (!node->mInheritScale)
+                {
+                    // scale is components 7 to 9
+                    copyTransform(mLocalTransforms + 7*stride, i,
+                        mDerivedTransforms + 7*stride, i, stride, 3);
+                }
+
+                const Real* d = mDerivedTransforms + i;
+                node->setDerivedTransformImpl(
+                    Vector3(d[0], d[stride], d[2*stride]),
+                    Quaternion(d[3*stride], d[4*stride], d[5*stride], d[6*stride]),
+                    Vector3(d[7*stride], d[8*stride], d[9*stride]));
+
+                if (node->mListener)
+                {
+                    node->mListener->nodeUpdated(node);
+                }
+            }
+        }
+    }
+}
@@ -348,6 +348,63 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void concatenateNodeTransforms(
+            const Real* parent,
+            const Real* local,
+            Real* derived,
+            size_t stride,
+            size_t numNodes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->concatenateNodeTransforms(
+                parent,
+                local,
+                derived,
+                stride,
+                numNodes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* boxes,
+            size_t stride,
+            size_t numBoxes,
+            uint8* visible)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->cullAxisAlignedBoxes(
+                planes,
+                numPlanes,
+                boxes,
+                stride,
+                numBoxes,
+                visible);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -31,6 +31,8 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
+#include "OgrePlane.h"
 
 namespace Ogre {
 
@@ -94,6 +96,23 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const Real* parent,
+            const Real* local,
+            Real* derived,
+            size_t stride,
+            size_t numNodes);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* boxes,
+            size_t stride,
+            size_t numBoxes,
+            uint8* visible);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -392,6 +411,74 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::concatenateNodeTransforms(
+        const Real* parent,
+        const Real* local,
+        Real* derived,
+        size_t stride,
+        size_t numNodes)
+    {
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            const Real* p = parent + i;
+            const Real* l = local + i;
+            Real* d = derived + i;
+
+            // Use the same operators as Node::updateFromParentImpl so the
+            // results are bitwise identical
+            Vector3 parentPosition(p[0], p[stride], p[2*stride]);
+            Quaternion parentOrientation(p[3*stride], p[4*stride], p[5*stride], p[6*stride]);
+            Vector3 parentScale(p[7*stride], p[8*stride], p[9*stride]);
+
+            Vector3 position(l[0], l[stride], l[2*stride]);
+            Quaternion orientation(l[3*stride], l[4*stride], l[5*stride], l[6*stride]);
+            Vector3 scale(l[7*stride], l[8*stride], l[9*stride]);
+
+            Vector3 derivedPosition = parentOrientation * (parentScale * position);
+            derivedPosition += parentPosition;
+            Quaternion derivedOrientation = parentOrientation * orientation;
+            Vector3 derivedScale = parentScale * scale;
+
+            d[0] = derivedPosition.x;
+            d[stride] = derivedPosition.y;
+            d[2*stride] = derivedPosition.z;
+            d[3*stride] = derivedOrientation.w;
+            d[4*stride] = derivedOrientation.x;
+            d[5*stride] = derivedOrientation.y;
+            d[6*stride] = derivedOrientation.z;
+            d[7*stride] = derivedScale.x;
+            d[8*stride] = derivedScale.y;
+            d[9*stride] = derivedScale.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const Real* boxes,
+        size_t stride,
+        size_t numBoxes,
+        uint8* visible)
+    {
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            const Real* b = boxes + i;
+            Vector3 centre(b[0], b[stride], b[2*stride]);
+            Vector3 halfSize(b[3*stride], b[4*stride], b[5*stride]);
+
+            uint8 result = 1;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                if (planes[p].getSide(centre, halfSize) == Plane::NEGATIVE_SIDE)
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            visible[i] = result;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #if __OGRE_HAVE_SSE
 
 #include "OgreMatrix4.h"
+#include "OgrePlane.h"
 
 // Should keep this includes at latest to avoid potential "xmmintrin.h" included by
 // other header file on some platform for some reason.
@@ -65,6 +66,8 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
 //-------------------------------------------------------------------------
 // Local classes
 //-------------------------------------------------------------------------
@@ -132,6 +135,23 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE concatenateNodeTransforms(
+            const Real* parent,
+            const Real* local,
+            Real* derived,
+            size_t stride,
+            size_t numNodes);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* boxes,
+            size_t stride,
+            size_t numBoxes,
+            uint8* visible);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -271,6 +291,44 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const Real* parent,
+            const Real* local,
+            Real* derived,
+            size_t stride,
+            size_t numNodes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->concatenateNodeTransforms(
+                parent,
+                local,
+                derived,
+                stride,
+                numNodes);
+        }
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Real* boxes,
+            size_t stride,
+            size_t numBoxes,
+            uint8* visible)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullAxisAlignedBoxes(
+                planes,
+                numPlanes,
+                boxes,
+                stride,
+                numBoxes,
+                visible);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -2136,6 +2194,164 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::concatenateNodeTransforms(
+        const Real* parent,
+        const Real* local,
+        Real* derived,
+        size_t stride,
+        size_t numNodes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        assert(_isAlignedForSSE(parent));
+        assert(_isAlignedForSSE(local));
+        assert(_isAlignedForSSE(derived));
+        assert(stride % 4 == 0);
+
+        // Operations are done in the same order as Node::updateFromParentImpl
+        // so the results match it exactly
+        const __m128 two = _mm_set_ps1(2.0f);
+
+        size_t numIterations = numNodes / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            // Load parent transforms
+            __m128 ppx = __MM_LOAD_PS(parent);
+            __m128 ppy = __MM_LOAD_PS(parent + stride);
+            __m128 ppz = __MM_LOAD_PS(parent + 2*stride);
+            __m128 pow = __MM_LOAD_PS(parent + 3*stride);
+            __m128 pox = __MM_LOAD_PS(parent + 4*stride);
+            __m128 poy = __MM_LOAD_PS(parent + 5*stride);
+            __m128 poz = __MM_LOAD_PS(parent + 6*stride);
+            __m128 psx = __MM_LOAD_PS(parent + 7*stride);
+            __m128 psy = __MM_LOAD_PS(parent + 8*stride);
+            __m128 psz = __MM_LOAD_PS(parent + 9*stride);
+
+            // Local orientation
+            __m128 low = __MM_LOAD_PS(local + 3*stride);
+            __m128 lox = __MM_LOAD_PS(local + 4*stride);
+            __m128 loy = __MM_LOAD_PS(local + 5*stride);
+            __m128 loz = __MM_LOAD_PS(local + 6*stride);
+
+            // Derived orientation = parent orientation * orientation
+            __MM_STORE_PS(derived + 3*stride, _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(
+                _mm_mul_ps(pow, low), _mm_mul_ps(pox, lox)), _mm_mul_ps(poy, loy)), _mm_mul_ps(poz, loz)));
+            __MM_STORE_PS(derived + 4*stride, _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(pow, lox), _mm_mul_ps(pox, low)), _mm_mul_ps(poy, loz)), _mm_mul_ps(poz, loy)));
+            __MM_STORE_PS(derived + 5*stride, _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(pow, loy), _mm_mul_ps(poy, low)), _mm_mul_ps(poz, lox)), _mm_mul_ps(pox, loz)));
+            __MM_STORE_PS(derived + 6*stride, _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(pow, loz), _mm_mul_ps(poz, low)), _mm_mul_ps(pox, loy)), _mm_mul_ps(poy, lox)));
+
+            // Derived scale = parent scale * scale
+            __MM_STORE_PS(derived + 7*stride, _mm_mul_ps(psx, __MM_LOAD_PS(local + 7*stride)));
+            __MM_STORE_PS(derived + 8*stride, _mm_mul_ps(psy, __MM_LOAD_PS(local + 8*stride)));
+            __MM_STORE_PS(derived + 9*stride, _mm_mul_ps(psz, __MM_LOAD_PS(local + 9*stride)));
+
+            // v = parent scale * position
+            __m128 vx = _mm_mul_ps(psx, __MM_LOAD_PS(local));
+            __m128 vy = _mm_mul_ps(psy, __MM_LOAD_PS(local + stride));
+            __m128 vz = _mm_mul_ps(psz, __MM_LOAD_PS(local + 2*stride));
+
+            // Rotate v by the parent orientation, as Quaternion::operator*(Vector3)
+            __m128 uvx = _mm_sub_ps(_mm_mul_ps(poy, vz), _mm_mul_ps(poz, vy));
+            __m128 uvy = _mm_sub_ps(_mm_mul_ps(poz, vx), _mm_mul_ps(pox, vz));
+            __m128 uvz = _mm_sub_ps(_mm_mul_ps(pox, vy), _mm_mul_ps(poy, vx));
+            __m128 uuvx = _mm_sub_ps(_mm_mul_ps(poy, uvz), _mm_mul_ps(poz, uvy));
+            __m128 uuvy = _mm_sub_ps(_mm_mul_ps(poz, uvx), _mm_mul_ps(pox, uvz));
+            __m128 uuvz = _mm_sub_ps(_mm_mul_ps(pox, uvy), _mm_mul_ps(poy, uvx));
+            __m128 w2 = _mm_mul_ps(two, pow);
+
+            // Derived position = v + uv * 2w + uuv * 2 + parent position
+            __MM_STORE_PS(derived, _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                vx, _mm_mul_ps(uvx, w2)), _mm_mul_ps(uuvx, two)), ppx));
+            __MM_STORE_PS(derived + stride, _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                vy, _mm_mul_ps(uvy, w2)), _mm_mul_ps(uuvy, two)), ppy));
+            __MM_STORE_PS(derived + 2*stride, _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                vz, _mm_mul_ps(uvz, w2)), _mm_mul_ps(uuvz, two)), ppz));
+
+            parent += 4;
+            local += 4;
+            derived += 4;
+        }
+
+        // Left over nodes
+        size_t numLeftOver = numNodes & 3;
+        if (numLeftOver)
+        {
+            _getOptimisedUtilGeneral()->concatenateNodeTransforms(
+                parent, local, derived, stride, numLeftOver);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const Real* boxes,
+        size_t stride,
+        size_t numBoxes,
+        uint8* visible)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        assert(_isAlignedForSSE(boxes));
+        assert(stride % 4 == 0);
+
+        // Same operations as Plane::getSide, so the results match it exactly
+        const __m128 signMask = _mm_set_ps1(-0.0f);
+
+        size_t numIterations = numBoxes / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 cx = __MM_LOAD_PS(boxes);
+            __m128 cy = __MM_LOAD_PS(boxes + stride);
+            __m128 cz = __MM_LOAD_PS(boxes + 2*stride);
+            __m128 hx = __MM_LOAD_PS(boxes + 3*stride);
+            __m128 hy = __MM_LOAD_PS(boxes + 4*stride);
+            __m128 hz = __MM_LOAD_PS(boxes + 5*stride);
+
+            // Lanes of boxes found on the negative side of any plane
+            __m128 culled = _mm_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Plane& plane = planes[p];
+                __m128 nx = _mm_load_ps1(&plane.normal.x);
+                __m128 ny = _mm_load_ps1(&plane.normal.y);
+                __m128 nz = _mm_load_ps1(&plane.normal.z);
+
+                // dist = normal.dotProduct(centre) + d
+                __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz)),
+                    _mm_load_ps1(&plane.d));
+                // maxAbsDist = normal.absDotProduct(halfSize)
+                __m128 maxAbsDist = _mm_add_ps(_mm_add_ps(
+                    _mm_andnot_ps(signMask, _mm_mul_ps(nx, hx)),
+                    _mm_andnot_ps(signMask, _mm_mul_ps(ny, hy))),
+                    _mm_andnot_ps(signMask, _mm_mul_ps(nz, hz)));
+
+                culled = _mm_or_ps(culled,
+                    _mm_cmplt_ps(dist, _mm_xor_ps(maxAbsDist, signMask)));
+            }
+
+            int mask = _mm_movemask_ps(culled);
+            visible[0] = !(mask & 1);
+            visible[1] = !(mask & 2);
+            visible[2] = !(mask & 4);
+            visible[3] = !(mask & 8);
+
+            boxes += 4;
+            visible += 4;
+        }
+
+        // Left over boxes
+        size_t numLeftOver = numBoxes & 3;
+        if (numLeftOver)
+        {
+            _getOptimisedUtilGeneral()->cullAxisAlignedBoxes(
+                planes, numPlanes, boxes, stride, numLeftOver, visible);
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
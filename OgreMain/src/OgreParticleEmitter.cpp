@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreParticleEmitter.h"
 #include "OgreParticleEmitterFactory.h"
+#include "OgreParticleSystem.h"
 
 namespace Ogre
 {
@@ -239,10 +240,10 @@ namespace Ogre
             if (mAngle != Radian(0))
             {
                 // Randomise angle
-                Radian angle = Math::UnitRandom() * mAngle;
+                Radian angle = genRandomUnit() * mAngle;
 
                 // Randomise direction
-                destVector = particleDir.randomDeviant( angle );
+                destVector = randomDeviant(particleDir, angle, particleDir.perpendicular());
             }
             else
             {
@@ -255,10 +256,10 @@ namespace Ogre
             if (mAngle != Radian(0))
             {
                 // Randomise angle
-                Radian angle = Math::UnitRandom() * mAngle;
+                Radian angle = genRandomUnit() * mAngle;
 
                 // Randomise direction
-                destVector = mDirection.randomDeviant(angle, mUp);
+                destVector = randomDeviant(mDirection, angle, mUp);
             }
             else
             {
@@ -271,12 +272,23 @@ namespace Ogre
         // both direction and 'up' are.
     }
     //-----------------------------------------------------------------------
+    Vector3 ParticleEmitter::randomDeviant(const Vector3& direction, const Radian& angle, const Vector3& up)
+    {
+        // Same as Vector3::randomDeviant, with the generator of the system
+        Quaternion q;
+        q.FromAngleAxis(Radian(genRandomUnit() * Math::TWO_PI), direction);
+        Vector3 newUp = q * up;
+
+        q.FromAngleAxis(angle, newUp);
+        return q * direction;
+    }
+    //-----------------------------------------------------------------------
     void ParticleEmitter::genEmissionVelocity(Vector3& destVector)
     {
         Real scalar;
         if (mMinSpeed != mMaxSpeed)
         {
-            scalar = mMinSpeed + (Math::UnitRandom() * (mMaxSpeed - mMinSpeed));
+            scalar = mMinSpeed + (genRandomUnit() * (mMaxSpeed - mMinSpeed));
         }
         else
         {
@@ -290,7 +302,7 @@ namespace Ogre
     {
         if (mMaxTTL != mMinTTL)
         {
-            return mMinTTL + (Math::UnitRandom() * (mMaxTTL - mMinTTL));
+            return mMinTTL + (genRandomUnit() * (mMaxTTL - mMinTTL));
         }
         else
         {
@@ -345,16 +357,21 @@ namespace Ogre
 
     }
     //-----------------------------------------------------------------------
+    Real ParticleEmitter::genRandomUnit(void)
+    {
+        return mParent ? mParent->_getRandomUnit() : Math::UnitRandom();
+    }
+    //-----------------------------------------------------------------------
     void ParticleEmitter::genEmissionColour(ColourValue& destColour)
     {
         if (mColourRangeStart != mColourRangeEnd)
         {
             // Randomise
             //Real t = Math::UnitRandom();
-            destColour.r = mColourRangeStart.r + (Math::UnitRandom() * (mColourRangeEnd.r - mColourRangeStart.r));
-            destColour.g = mColourRangeStart.g + (Math::UnitRandom() * (mColourRangeEnd.g - mColourRangeStart.g));
-            destColour.b = mColourRangeStart.b + (Math::UnitRandom() * (mColourRangeEnd.b - mColourRangeStart.b));
-            destColour.a = mColourRangeStart.a + (Math::UnitRandom() * (mColourRangeEnd.a - mColourRangeStart.a));
+            destColour.r = mColourRangeStart.r + (genRandomUnit() * (mColourRangeEnd.r - mColourRangeStart.r));
+            destColour.g = mColourRangeStart.g + (genRandomUnit() * (mColourRangeEnd.g - mColourRangeStart.g));
+            destColour.b = mColourRangeStart.b + (genRandomUnit() * (mColourRangeEnd.b - mColourRangeStart.b));
+            destColour.a = mColourRangeStart.a + (genRandomUnit() * (mColourRangeEnd.a - mColourRangeStart.a));
         }
         else
         {
@@ -598,7 +615,7 @@ namespace Ogre
             }
             else
             {
-                mDurationRemain = Math::RangeRandom(mDurationMin, mDurationMax);
+                mDurationRemain = genRandomRange(mDurationMin, mDurationMax);
             }
         }
         else
@@ -610,7 +627,7 @@ namespace Ogre
             }
             else
             {
-                mRepeatDelayRemain = Math::RangeRandom(mRepeatDelayMax, mRepeatDelayMin);
+                mRepeatDelayRemain = genRandomRange(mRepeatDelayMax, mRepeatDelayMin);
             }
 
         }
@@ -72,7 +72,14 @@ namespace Ogre {
 
         Real getValue(void) const { return 0; } // N/A
 
-        void setValue(Real value) { mTarget->_update(value); }
+        void setValue(Real value)
+        {
+            ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+            if (mgr.getParallelUpdate())
+                mgr._queueUpdate(mTarget, value);
+            else
+                mTarget->_update(value);
+        }
 
     };
     //-----------------------------------------------------------------------
@@ -99,7 +106,9 @@ namespace Ogre {
         mRenderer(0),
         mCullIndividual(false),
         mPoolSize(0),
-        mEmittedEmitterPoolSize(0)
+        mEmittedEmitterPoolSize(0),
+        mBoundsUpdated(false),
+        mRandomState(static_cast<uint32>(Math::UnitRandom() * Real(0xFFFFFF)) << 8 | 1)
     {
         initParameters();
 
@@ -132,7 +141,9 @@ namespace Ogre {
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
-        mEmittedEmitterPoolSize(0)
+        mEmittedEmitterPoolSize(0),
+        mBoundsUpdated(false),
+        mRandomState(static_cast<uint32>(Math::UnitRandom() * Real(0xFFFFFF)) << 8 | 1)
     {
         setDefaultDimensions( 100, 100 );
         mMaterial = MaterialManager::getSingleton().getDefaultMaterial();
@@ -152,6 +163,7 @@ namespace Ogre {
             // Destroy controller
             ControllerManager::getSingleton().destroyController(mTimeController);
             mTimeController = 0;
+            ParticleSystemManager::getSingleton()._cancelUpdate(this);
         }
 
         // Arrange for the deletion of emitters & affectors
@@ -162,10 +174,10 @@ namespace Ogre {
         // Deallocate all particles
         destroyVisualParticles(0, mParticlePool.size());
         // Free pool items
-        ParticlePool::iterator i;
-        for (i = mParticlePool.begin(); i != mParticlePool.end(); ++i)
+        ParticleBlockList::iterator i;
+        for (i = mParticleBlocks.begin(); i != mParticleBlocks.end(); ++i)
         {
-            OGRE_DELETE *i;
+            OGRE_DELETE_ARRAY_T(i->first, Particle, i->second, MEMCATEGORY_SCENE_OBJECTS);
         }
 
         if (mRenderer)
@@ -366,10 +378,19 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_update(Real timeElapsed)
+    {
+        if (_prepareUpdate(timeElapsed))
+        {
+            _performUpdate(timeElapsed);
+            _finishUpdate();
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::_prepareUpdate(Real& timeElapsed)
     {
         // Only update if attached to a node
         if (!mParentNode)
-            return;
+            return false;
 
         Real nonvisibleTimeout = mNonvisibleTimeoutSet ?
             mNonvisibleTimeout : msDefaultNonvisibleTimeout;
@@ -385,7 +406,7 @@ namespace Ogre {
                 if (mTimeSinceLastVisible >= nonvisibleTimeout)
                 {
                     // No update
-                    return;
+                    return false;
                 }
             }
         }
@@ -399,6 +420,34 @@ namespace Ogre {
         // Initialise emitted emitters list if not done already
         initialiseEmittedEmitters();
 
+        // Bring the cached parent transform up to date, so that converting
+        // particles into world space does not modify the node
+        mParentNode->_getFullTransform();
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::_isParallelUpdateSupported(void) const
+    {
+        if (!mRenderer || !mRenderer->_isParallelUpdateSupported())
+            return false;
+
+        // emitted emitters are copies of the emitters of the system
+        for (ParticleEmitterList::const_iterator i = mEmitters.begin(); i != mEmitters.end(); ++i)
+        {
+            if (!(*i)->_isParallelUpdateSupported())
+                return false;
+        }
+        for (ParticleAffectorList::const_iterator i = mAffectors.begin(); i != mAffectors.end(); ++i)
+        {
+            if (!(*i)->_isParallelUpdateSupported())
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_performUpdate(Real timeElapsed)
+    {
         Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
         if (iterationInterval > 0)
@@ -408,9 +457,7 @@ namespace Ogre {
             while (mUpdateRemainTime >= iterationInterval)
             {
                 // Update existing particles
-                _expire(iterationInterval);
-                _triggerAffectors(iterationInterval);
-                _applyMotion(iterationInterval);
+                _updateParticles(iterationInterval);
 
                 if(mIsEmitting)
                 {
@@ -424,9 +471,7 @@ namespace Ogre {
         else
         {
             // Update existing particles
-            _expire(timeElapsed);
-            _triggerAffectors(timeElapsed);
-            _applyMotion(timeElapsed);
+            _updateParticles(timeElapsed);
 
             if(mIsEmitting)
             {
@@ -437,21 +482,78 @@ namespace Ogre {
 
         if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
             mBoundsUpdateTime -= timeElapsed; // count down 
-        _updateBounds();
+        mBoundsUpdated = calculateBounds();
+
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_finishUpdate(void)
+    {
+        if (mBoundsUpdated)
+        {
+            mParentNode->needUpdate();
+            mBoundsUpdated = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_updateParticles(Real timeElapsed)
+    {
+        ParticleAffectorList::iterator i, itEnd;
+
+        itEnd = mAffectors.end();
+        for (i = mAffectors.begin(); i != itEnd; ++i)
+        {
+            if (!(*i)->_isParticleRangeSupported())
+                break;
+        }
+
+        if (i != itEnd)
+        {
+            // An affector needs to see the whole system, do each step for all particles
+            _expire(timeElapsed);
+            _triggerAffectors(timeElapsed);
+            _applyMotion(timeElapsed);
+            return;
+        }
+
+        // Do all steps block by block, so that each particle is only fetched once.
+        // The survivors of each block are compacted behind those of the previous
+        // blocks, which keeps the particles in order for unsorted systems.
+        const size_t numParticles = mActiveParticles.size();
+        size_t numAlive = 0;
+        for (size_t begin = 0; begin < numParticles; begin += PARTICLE_UPDATE_BLOCK_SIZE)
+        {
+            size_t first = numAlive;
+            numAlive = _expire(begin, 
+                std::min(begin + PARTICLE_UPDATE_BLOCK_SIZE, numParticles), first, timeElapsed);
+            if (numAlive == first)
+                continue;
+
+            for (i = mAffectors.begin(); i != itEnd; ++i)
+            {
+                (*i)->_affectParticleRange(&mActiveParticles[first], numAlive - first, timeElapsed);
+            }
+
+            _applyMotion(first, numAlive, timeElapsed);
+        }
+        mActiveParticles.resize(numAlive);
 
+        // Notify renderer
+        mRenderer->_notifyParticleMoved(mActiveParticles);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
     {
-        ActiveParticleList::iterator i, itEnd;
+        mActiveParticles.resize(_expire(0, mActiveParticles.size(), 0, timeElapsed));
+    }
+    //-----------------------------------------------------------------------
+    size_t ParticleSystem::_expire(size_t begin, size_t end, size_t dest, Real timeElapsed)
+    {
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
-        itEnd = mActiveParticles.end();
-
-        for (i = mActiveParticles.begin(); i != itEnd; )
+        for (size_t i = begin; i < end; ++i)
         {
-            pParticle = static_cast<Particle*>(*i);
+            pParticle = mActiveParticles[i];
             if (pParticle->mTimeToLive < timeElapsed)
             {
                 // Notify renderer
@@ -461,37 +563,36 @@ namespace Ogre {
                 if (pParticle->mParticleType == Particle::Visual)
                 {
                     // Destroy this one
-                    mFreeParticles.splice(mFreeParticles.end(), mActiveParticles, i++);
+                    mFreeParticles.push_back(pParticle);
                 }
                 else
                 {
                     // For now, it can only be an emitted emitter
-                    pParticleEmitter = static_cast<ParticleEmitter*>(*i);
+                    pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
                     list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
                     fee->push_back(pParticleEmitter);
 
                     // Also erase from mActiveEmittedEmitters
                     removeFromActiveEmittedEmitters (pParticleEmitter);
-
-                    // And erase from mActiveParticles
-                    i = mActiveParticles.erase( i );
                 }
             }
             else
             {
                 // Decrement TTL
                 pParticle->mTimeToLive -= timeElapsed;
-                ++i;
+                mActiveParticles[dest++] = pParticle;
             }
 
         }
+
+        return dest;
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_triggerEmitters(Real timeElapsed)
     {
         // Add up requests for emission
-        static vector<unsigned>::type requested;
-        static vector<unsigned>::type emittedRequested;
+        vector<unsigned>::type& requested = mRequestedEmissions;
+        vector<unsigned>::type& emittedRequested = mEmittedRequestedEmissions;
 
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
@@ -623,14 +724,20 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_applyMotion(Real timeElapsed)
     {
-        ActiveParticleList::iterator i, itEnd;
+        _applyMotion(0, mActiveParticles.size(), timeElapsed);
+
+        // Notify renderer
+        mRenderer->_notifyParticleMoved(mActiveParticles);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_applyMotion(size_t begin, size_t end, Real timeElapsed)
+    {
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
-        itEnd = mActiveParticles.end();
-        for (i = mActiveParticles.begin(); i != itEnd; ++i)
+        for (size_t i = begin; i < end; ++i)
         {
-            pParticle = static_cast<Particle*>(*i);
+            pParticle = mActiveParticles[i];
             pParticle->mPosition += (pParticle->mDirection * timeElapsed);
 
             if (pParticle->mParticleType == Particle::Emitter)
@@ -638,13 +745,10 @@ namespace Ogre {
                 // If it is an emitter, the emitter position must also be updated
                 // Note, that position of the emitter becomes a position in worldspace if mLocalSpace is set 
                 // to false (will this become a problem?)
-                pParticleEmitter = static_cast<ParticleEmitter*>(*i);
+                pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
                 pParticleEmitter->setPosition(pParticle->mPosition);
             }
         }
-
-        // Notify renderer
-        mRenderer->_notifyParticleMoved(mActiveParticles);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_triggerAffectors(Real timeElapsed)
@@ -662,15 +766,21 @@ namespace Ogre {
     void ParticleSystem::increasePool(size_t size)
     {
         size_t oldSize = mParticlePool.size();
+        if (size <= oldSize)
+            return;
 
         // Increase size
         mParticlePool.reserve(size);
         mParticlePool.resize(size);
+        mActiveParticles.reserve(size);
+        mFreeParticles.reserve(size);
 
-        // Create new particles
+        // Create new particles in one block, so that they are close together in memory
+        Particle* block = OGRE_NEW_ARRAY_T(Particle, size - oldSize, MEMCATEGORY_SCENE_OBJECTS);
+        mParticleBlocks.push_back(ParticleBlock(block, size - oldSize));
         for( size_t i = oldSize; i < size; i++ )
         {
-            mParticlePool[i] = OGRE_NEW Particle();
+            mParticlePool[i] = block + (i - oldSize);
         }
 
         if (mIsRendererConfigured)
@@ -689,9 +799,7 @@ namespace Ogre {
     Particle* ParticleSystem::getParticle(size_t index) 
     {
         assert (index < mActiveParticles.size() && "Index out of bounds!");
-        ActiveParticleList::iterator i = mActiveParticles.begin();
-        std::advance(i, index);
-        return *i;
+        return mActiveParticles[index];
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::createParticle(void)
@@ -700,8 +808,9 @@ namespace Ogre {
         if (!mFreeParticles.empty())
         {
             // Fast creation (don't use superclass since emitter will init)
-            p = mFreeParticles.front();
-            mActiveParticles.splice(mActiveParticles.end(), mFreeParticles, mFreeParticles.begin());
+            p = mFreeParticles.back();
+            mFreeParticles.pop_back();
+            mActiveParticles.push_back(p);
 
             p->_notifyOwner(this);
         }
@@ -818,7 +927,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_updateBounds()
     {
-
+        if (calculateBounds())
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::calculateBounds(void)
+    {
         if (mParentNode && (mBoundsAutoUpdate || mBoundsUpdateTime > 0.0f))
         {
             if (mActiveParticles.empty())
@@ -885,8 +999,9 @@ namespace Ogre {
                 mAABB.merge(newAABB);
             }
 
-            mParentNode->needUpdate();
+            return true;
         }
+        return false;
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::fastForward(Real time, Real interval)
@@ -1020,6 +1135,7 @@ namespace Ogre {
             // Destroy controller
             ControllerManager::getSingleton().destroyController(mTimeController);
             mTimeController = 0;
+            ParticleSystemManager::getSingleton()._cancelUpdate(this);
         }
     }
     //-----------------------------------------------------------------------
@@ -1046,8 +1162,14 @@ namespace Ogre {
             mRenderer->_notifyParticleCleared(mActiveParticles);
         }
 
-        // Move actives to free list
-        mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+        // Move actives to free list, emitted emitters are returned below
+        ActiveParticleList::iterator i;
+        for (i = mActiveParticles.begin(); i != mActiveParticles.end(); ++i)
+        {
+            if ((*i)->mParticleType == Particle::Visual)
+                mFreeParticles.push_back(*i);
+        }
+        mActiveParticles.clear();
 
         // Add active emitted emitters to free list
         addActiveEmittedEmittersToFreeList();
@@ -1085,10 +1207,10 @@ namespace Ogre {
         {
             this->increasePool(size);
 
-            for( size_t i = currSize; i < size; ++i )
+            // Add new items to the stack, in reverse so that they are used in memory order
+            for( size_t i = size; i > currSize; --i )
             {
-                // Add new items to the queue
-                mFreeParticles.push_back( mParticlePool[i] );
+                mFreeParticles.push_back( mParticlePool[i - 1] );
             }
 
             // Tell the renderer, if already configured
@@ -1611,6 +1733,23 @@ namespace Ogre {
     {
     }
     //-----------------------------------------------------------------------
+    void ParticleAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    {
+        ParticleSystem::ActiveParticleList& particles = pSystem->_getActiveParticles();
+        if (!particles.empty())
+        {
+            _affectParticleRange(&particles[0], particles.size(), timeElapsed);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleAffector::_affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed)
+    {
+        // only reached if the affector overrides neither this nor _affectParticles
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Affector of type '" + mType + "' must implement _affectParticles or _affectParticleRange",
+            "ParticleAffector::_affectParticleRange");
+    }
+    //-----------------------------------------------------------------------
     ParticleAffectorFactory::~ParticleAffectorFactory() 
     {
         // Destroy all affectors
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreBillboardParticleRenderer.h"
 #include "OgreScriptCompiler.h"
 #include "OgreParticleSystem.h"
+#include "OgreTaskScheduler.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -54,6 +55,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ParticleSystemManager::ParticleSystemManager()
+        : mParallelUpdate(false)
     {
         OGRE_LOCK_AUTO_MUTEX;
         mFactory = OGRE_NEW ParticleSystemFactory();
@@ -367,6 +369,86 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /** Runs ParticleSystem::_performUpdate for the queued systems, see
+            ParticleSystemManager::_updateQueuedSystems.
+        */
+        class ParallelParticleSystemUpdater : public ParallelForBody
+        {
+            const vector<std::pair<ParticleSystem*, Real> >::type& mSystems;
+        public:
+            ParallelParticleSystemUpdater(const vector<std::pair<ParticleSystem*, Real> >::type& systems)
+                : mSystems(systems) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    mSystems[i].first->_performUpdate(mSystems[i].second);
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::setParallelUpdate(bool enabled)
+    {
+        // Don't lose updates queued so far
+        if (!enabled)
+            _updateQueuedSystems();
+        mParallelUpdate = enabled;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_queueUpdate(ParticleSystem* sys, Real timeElapsed)
+    {
+        mQueuedUpdates.push_back(std::make_pair(sys, timeElapsed));
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_cancelUpdate(ParticleSystem* sys)
+    {
+        QueuedUpdateList::iterator i = mQueuedUpdates.begin();
+        while (i != mQueuedUpdates.end())
+        {
+            if (i->first == sys)
+                i = mQueuedUpdates.erase(i);
+            else
+                ++i;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_updateQueuedSystems(void)
+    {
+        if (mQueuedUpdates.empty())
+            return;
+
+        // Preparation touches nodes and renderers, so it's done here. Systems which
+        // can't be updated concurrently are done right away, the rest is compacted
+        // to the front of the list.
+        size_t numParallel = 0;
+        for (size_t i = 0; i < mQueuedUpdates.size(); ++i)
+        {
+            ParticleSystem* sys = mQueuedUpdates[i].first;
+            Real timeElapsed = mQueuedUpdates[i].second;
+            if (!sys->_prepareUpdate(timeElapsed))
+                continue;
+
+            if (sys->_isParallelUpdateSupported())
+            {
+                mQueuedUpdates[numParallel++] = std::make_pair(sys, timeElapsed);
+            }
+            else
+            {
+                sys->_performUpdate(timeElapsed);
+                sys->_finishUpdate();
+            }
+        }
+        mQueuedUpdates.resize(numParallel);
+
+        ParallelParticleSystemUpdater updater(mQueuedUpdates);
+        TaskScheduler::getSingleton().parallelFor(0, numParallel, 1, updater);
+
+        for (size_t i = 0; i < numParallel; ++i)
+            mQueuedUpdates[i].first->_finishUpdate();
+        mQueuedUpdates.clear();
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystemManager::parseNewEmitter(const String& type, DataStreamPtr& stream, ParticleSystem* sys)
     {
         // Create new emitter
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include "OgreColourValue.h"
 #include "OgreException.h"
 #include "OgrePixelFormatDescriptions.h"
+#include "OgreTaskScheduler.h"
+#include "OgreSIMDHelper.h"
 
 namespace {
 #include "OgrePixelConversions.h"
@@ -137,9 +139,11 @@ namespace Ogre {
                 // https://www.khronos.org/registry/OpenGL/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
                 case PF_ETC1_RGB8:
                 case PF_ETC2_RGB8:
-                case PF_ETC2_RGBA8:
                 case PF_ETC2_RGB8A1:
                     return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+                // an EAC alpha block precedes every colour block
+                case PF_ETC2_RGBA8:
+                    return ((width + 3) / 4) * ((height + 3) / 4) * 16;
 
                 case PF_ATC_RGB:
                     return ((width + 3) / 4) * ((height + 3) / 4) * 8;
@@ -683,6 +687,494 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /// Boxes with fewer pixels are converted on the calling thread
+        const size_t PARALLEL_CONVERSION_MIN_PIXELS = 128 * 128;
+        /// Number of rows converted by a task at least
+        const size_t PARALLEL_CONVERSION_GRAIN_SIZE = 16;
+
+        /** Where the channels of a pixel are, for formats storing each channel
+            in a byte of its own.
+        */
+        struct ByteChannelLayout
+        {
+            /// Byte offsets of red (or luminance), green, blue and alpha, -1 if missing
+            int offset[4];
+            bool luminance;
+        };
+
+        /// Get the layout of a format, returns false unless all its channels are bytes
+        bool getByteChannelLayout(PixelFormat format, ByteChannelLayout& layout)
+        {
+            const PixelFormatDescription& des = getDescriptionFor(format);
+            if (!(des.flags & PFF_NATIVEENDIAN) || (des.flags & (PFF_FLOAT | PFF_COMPRESSED | PFF_DEPTH)) ||
+                des.elemBytes > 4 || (des.abits != 0) != ((des.flags & PFF_HASALPHA) != 0))
+                return false;
+
+            const unsigned char bits[4] = { des.rbits, des.gbits, des.bbits, des.abits };
+            const uint64 masks[4] = { des.rmask, des.gmask, des.bmask, des.amask };
+            const unsigned char shifts[4] = { des.rshift, des.gshift, des.bshift, des.ashift };
+            for (int c = 0; c < 4; ++c)
+            {
+                layout.offset[c] = -1;
+                if (bits[c] == 0 && masks[c] == 0)
+                    continue;
+                if (bits[c] != 8 || shifts[c] % 8 || shifts[c] + 8u > des.elemBytes * 8u ||
+                    masks[c] != (uint64(0xFF) << shifts[c]))
+                    return false;
+#if OGRE_ENDIAN == OGRE_ENDIAN_BIG
+                layout.offset[c] = des.elemBytes - 1 - shifts[c] / 8;
+#else
+                layout.offset[c] = shifts[c] / 8;
+#endif
+            }
+            layout.luminance = (des.flags & PFF_LUMINANCE) != 0;
+            return true;
+        }
+
+        /// Whether the SSE2 conversions may be used
+        bool useSSE2(void)
+        {
+#if __OGRE_HAVE_SSE2
+            return (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE2) != 0;
+#else
+            return false;
+#endif
+        }
+
+#if __OGRE_HAVE_SSE2
+        /// Load n <= 4 pixels of up to 4 bytes, one into each 32 bit lane
+        inline __m128i loadPixels(const uint8* src, size_t pixelSize, size_t n)
+        {
+            if (pixelSize == 4 && n == 4)
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            uint32 lanes[4] = { 0, 0, 0, 0 };
+            for (size_t i = 0; i < n; ++i)
+                memcpy(&lanes[i], src + i * pixelSize, pixelSize);
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+        }
+
+        /// Store the first pixelSize bytes of n <= 4 lanes as pixels
+        inline void storePixels(__m128i pixels, uint8* dst, size_t pixelSize, size_t n)
+        {
+            if (pixelSize == 4 && n == 4)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), pixels);
+                return;
+            }
+            uint32 lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), pixels);
+            for (size_t i = 0; i < n; ++i)
+                memcpy(dst + i * pixelSize, &lanes[i], pixelSize);
+        }
+#endif
+
+        /** Convert between two formats with byte channels by copying bytes around,
+            which gives the same result as unpacking and packing every pixel.
+        */
+        template<size_t srcPixelSize>
+        void convertByteChannels(const PixelBox &src, const ByteChannelLayout& srcLayout,
+            const PixelBox &dst, const ByteChannelLayout& dstLayout)
+        {
+            // Every destination byte is copied from the source pixel followed by
+            // a 0 for missing colours and unused bytes, and 0xFF for missing alpha
+            const size_t zero = srcPixelSize, one = srcPixelSize + 1;
+            size_t map[4] = { zero, zero, zero, zero };
+            for (int c = 0; c < 4; ++c)
+            {
+                if (dstLayout.offset[c] < 0)
+                    continue;
+                int srcOffset = (srcLayout.luminance && c < 3) ? srcLayout.offset[0] : srcLayout.offset[c];
+                map[dstLayout.offset[c]] = srcOffset >= 0 ? srcOffset : (c == 3 ? one : zero);
+            }
+            uint8 pixel[srcPixelSize + 2];
+            pixel[zero] = 0;
+            pixel[one] = 0xFF;
+
+            const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
+            const size_t width = src.getWidth();
+            const uint8 *srcptr = static_cast<const uint8*>(src.getTopLeftFrontPixelPtr());
+            uint8 *dstptr = static_cast<uint8*>(dst.getTopLeftFrontPixelPtr());
+            const size_t srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
+            const size_t srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
+            const size_t dstRowSkipBytes = dst.getRowSkip()*dstPixelSize;
+            const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstPixelSize;
+
+#if __OGRE_HAVE_SSE2
+            // With SSE2 four pixels are moved at once, every destination byte
+            // is shifted from its source byte
+            const bool sse2 = useSSE2();
+            __m128i shiftIn[4], shiftOut[4];
+            uint32 constant = 0;
+            for (size_t k = 0; k < dstPixelSize; ++k)
+            {
+                shiftIn[k] = _mm_cvtsi32_si128(static_cast<int>(map[k] < srcPixelSize ? map[k] * 8 : 0));
+                shiftOut[k] = _mm_cvtsi32_si128(static_cast<int>(k * 8));
+                if (map[k] == one)
+                    constant |= 0xFFu << (k * 8);
+            }
+            const __m128i byteMask = _mm_set1_epi32(0xFF);
+            const __m128i constantBytes = _mm_set1_epi32(static_cast<int>(constant));
+#endif
+
+            for(size_t z=src.front; z<src.back; z++)
+            {
+                for(size_t y=src.top; y<src.bottom; y++)
+                {
+                    size_t x = 0;
+#if __OGRE_HAVE_SSE2
+                    if (sse2)
+                    {
+                        for(; x<width; x+=4)
+                        {
+                            size_t n = std::min<size_t>(4, width - x);
+                            __m128i in = loadPixels(srcptr, srcPixelSize, n);
+                            __m128i out = constantBytes;
+                            for(size_t k=0; k<dstPixelSize; k++)
+                            {
+                                if (map[k] < srcPixelSize)
+                                {
+                                    out = _mm_or_si128(out, _mm_sll_epi32(
+                                        _mm_and_si128(_mm_srl_epi32(in, shiftIn[k]), byteMask), shiftOut[k]));
+                                }
+                            }
+                            storePixels(out, dstptr, dstPixelSize, n);
+                            srcptr += n * srcPixelSize;
+                            dstptr += n * dstPixelSize;
+                        }
+                    }
+#endif
+                    for(; x<width; x++)
+                    {
+                        memcpy(pixel, srcptr, srcPixelSize);
+                        for(size_t k=0; k<dstPixelSize; k++)
+                            dstptr[k] = pixel[map[k]];
+                        srcptr += srcPixelSize;
+                        dstptr += dstPixelSize;
+                    }
+                    srcptr += srcRowSkipBytes;
+                    dstptr += dstRowSkipBytes;
+                }
+                srcptr += srcSliceSkipBytes;
+                dstptr += dstSliceSkipBytes;
+            }
+        }
+
+        /** How the channels of a pixel are stored, for PF_FLOAT32_RGB(A) and for
+            native endian formats which pack integer channels of up to 16 bits into
+            at most 32 bits, like PF_A8R8G8B8, PF_R5G6B5 or PF_L16.
+        */
+        struct PackedLayout
+        {
+            /// Number of floats for PF_FLOAT32_RGB(A), 0 for packed integers
+            size_t floats;
+            size_t elemBytes;
+            /// Bits and shifts of red (or luminance), green, blue and alpha, no bits if missing
+            unsigned int bits[4];
+            unsigned int shift[4];
+            bool luminance;
+
+            /// Whether pixels have all colour channels, unpackColour gives NaN for missing ones
+            bool hasColour(void) const
+            {
+                return floats || luminance || (bits[0] && bits[1] && bits[2]);
+            }
+        };
+
+        /// Get the layout of a format, returns false if it is not of those supported
+        bool getPackedLayout(PixelFormat format, PackedLayout& layout)
+        {
+            const PixelFormatDescription& des = getDescriptionFor(format);
+            layout.elemBytes = des.elemBytes;
+            layout.luminance = (des.flags & PFF_LUMINANCE) != 0;
+            if (format == PF_FLOAT32_RGB || format == PF_FLOAT32_RGBA)
+            {
+                layout.floats = des.elemBytes / sizeof(float);
+                return true;
+            }
+            layout.floats = 0;
+            if (!(des.flags & PFF_NATIVEENDIAN) || (des.flags & (PFF_FLOAT | PFF_COMPRESSED | PFF_DEPTH)) ||
+                des.elemBytes > 4 || (des.abits != 0) != ((des.flags & PFF_HASALPHA) != 0))
+                return false;
+
+            const unsigned char bits[4] = { des.rbits, des.gbits, des.bbits, des.abits };
+            const uint64 masks[4] = { des.rmask, des.gmask, des.bmask, des.amask };
+            const unsigned char shifts[4] = { des.rshift, des.gshift, des.bshift, des.ashift };
+            for (int c = 0; c < 4; ++c)
+            {
+                layout.bits[c] = 0;
+                layout.shift[c] = 0;
+                if (bits[c] == 0 && masks[c] == 0)
+                    continue;
+                if (bits[c] == 0 || bits[c] > 16 || masks[c] != (uint64((1 << bits[c]) - 1) << shifts[c]))
+                    return false;
+                layout.bits[c] = bits[c];
+                layout.shift[c] = shifts[c];
+            }
+            return true;
+        }
+
+        /// Read a pixel as red, green, blue and alpha like unpackColour
+        inline void readPixel(const uint8* src, const PackedLayout& layout, float* rgba)
+        {
+            if (layout.floats)
+            {
+                memcpy(rgba, src, layout.floats * sizeof(float));
+                if (layout.floats == 3)
+                    rgba[3] = 1.0f;
+                return;
+            }
+            const unsigned int value = Bitwise::intRead(src, static_cast<int>(layout.elemBytes));
+            for (int c = 0; c < 4; ++c)
+            {
+                if (layout.bits[c])
+                {
+                    rgba[c] = Bitwise::fixedToFloat(
+                        (value >> layout.shift[c]) & ((1u << layout.bits[c]) - 1), layout.bits[c]);
+                }
+            }
+            if (layout.luminance)
+                rgba[1] = rgba[2] = rgba[0];
+            if (!layout.bits[3])
+                rgba[3] = 1.0f;
+        }
+
+        /// Write a pixel from red, green, blue and alpha like packColour
+        inline void writePixel(const float* rgba, const PackedLayout& layout, uint8* dst)
+        {
+            if (layout.floats)
+            {
+                memcpy(dst, rgba, layout.floats * sizeof(float));
+                return;
+            }
+            unsigned int value = 0;
+            for (int c = 0; c < 4; ++c)
+            {
+                if (layout.bits[c])
+                    value |= Bitwise::floatToFixed(rgba[c], layout.bits[c]) << layout.shift[c];
+            }
+            Bitwise::intWrite(dst, static_cast<int>(layout.elemBytes), value);
+        }
+
+#if __OGRE_HAVE_SSE2
+        /// Read n <= 4 pixels into one vector of each red, green, blue and alpha
+        inline void readPixels(const uint8* src, const PackedLayout& layout, size_t n, __m128* rgba)
+        {
+            if (layout.floats)
+            {
+                const float* f = reinterpret_cast<const float*>(src);
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    if (i >= n)
+                        rgba[i] = _mm_setzero_ps();
+                    else if (layout.floats == 4)
+                        rgba[i] = _mm_loadu_ps(f + i * 4);
+                    else
+                        rgba[i] = _mm_set_ps(1.0f, f[i * 3 + 2], f[i * 3 + 1], f[i * 3]);
+                }
+                _MM_TRANSPOSE4_PS(rgba[0], rgba[1], rgba[2], rgba[3]);
+                return;
+            }
+            __m128i pixels = loadPixels(src, layout.elemBytes, n);
+            for (int c = 0; c < 4; ++c)
+            {
+                if (!layout.bits[c])
+                    continue;
+                const int maxValue = (1 << layout.bits[c]) - 1;
+                __m128i value = _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(static_cast<int>(layout.shift[c]))),
+                    _mm_set1_epi32(maxValue));
+                rgba[c] = _mm_div_ps(_mm_cvtepi32_ps(value), _mm_set1_ps(static_cast<float>(maxValue)));
+            }
+            if (layout.luminance)
+                rgba[1] = rgba[2] = rgba[0];
+            if (!layout.bits[3])
+                rgba[3] = _mm_set1_ps(1.0f);
+        }
+
+        /// Write n <= 4 pixels from one vector of each red, green, blue and alpha
+        inline void writePixels(__m128* rgba, const PackedLayout& layout, size_t n, uint8* dst)
+        {
+            if (layout.floats)
+            {
+                _MM_TRANSPOSE4_PS(rgba[0], rgba[1], rgba[2], rgba[3]);
+                float* f = reinterpret_cast<float*>(dst);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (layout.floats == 4)
+                    {
+                        _mm_storeu_ps(f + i * 4, rgba[i]);
+                    }
+                    else
+                    {
+                        float pixel[4];
+                        _mm_storeu_ps(pixel, rgba[i]);
+                        memcpy(f + i * 3, pixel, 3 * sizeof(float));
+                    }
+                }
+                return;
+            }
+            // Bitwise::floatToFixed, 1.0 and more become the maximum value
+            __m128i pixels = _mm_setzero_si128();
+            for (int c = 0; c < 4; ++c)
+            {
+                if (!layout.bits[c])
+                    continue;
+                const float maxValue = static_cast<float>((1 << layout.bits[c]) - 1);
+                __m128 scaled = _mm_mul_ps(rgba[c], _mm_set1_ps(static_cast<float>(1 << layout.bits[c])));
+                scaled = _mm_min_ps(_mm_max_ps(scaled, _mm_setzero_ps()), _mm_set1_ps(maxValue));
+                pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_cvttps_epi32(scaled),
+                    _mm_cvtsi32_si128(static_cast<int>(layout.shift[c]))));
+            }
+            storePixels(pixels, dst, layout.elemBytes, n);
+        }
+#endif
+
+        /** Convert between formats with packed integer channels and PF_FLOAT32_RGB(A)
+            through floats, which gives the same result as unpackColour and packColour.
+            The source must have all colour channels.
+        */
+        void convertPacked(const PixelBox &src, const PackedLayout& srcLayout,
+            const PixelBox &dst, const PackedLayout& dstLayout)
+        {
+            const size_t srcPixelSize = srcLayout.elemBytes;
+            const size_t dstPixelSize = dstLayout.elemBytes;
+            const size_t width = src.getWidth();
+            const uint8 *srcptr = static_cast<const uint8*>(src.getTopLeftFrontPixelPtr());
+            uint8 *dstptr = static_cast<uint8*>(dst.getTopLeftFrontPixelPtr());
+            const size_t srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
+            const size_t srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
+            const size_t dstRowSkipBytes = dst.getRowSkip()*dstPixelSize;
+            const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstPixelSize;
+#if __OGRE_HAVE_SSE2
+            // Four pixels at once, with the channels in separate vectors
+            const bool sse2 = useSSE2();
+#endif
+
+            float rgba[4];
+            for(size_t z=src.front; z<src.back; z++)
+            {
+                for(size_t y=src.top; y<src.bottom; y++)
+                {
+                    size_t x = 0;
+#if __OGRE_HAVE_SSE2
+                    if (sse2)
+                    {
+                        __m128 channels[4];
+                        for(; x<width; x+=4)
+                        {
+                            size_t n = std::min<size_t>(4, width - x);
+                            readPixels(srcptr, srcLayout, n, channels);
+                            writePixels(channels, dstLayout, n, dstptr);
+                            srcptr += n * srcPixelSize;
+                            dstptr += n * dstPixelSize;
+                        }
+                    }
+#endif
+                    for(; x<width; x++)
+                    {
+                        readPixel(srcptr, srcLayout, rgba);
+                        writePixel(rgba, dstLayout, dstptr);
+                        srcptr += srcPixelSize;
+                        dstptr += dstPixelSize;
+                    }
+                    srcptr += srcRowSkipBytes;
+                    dstptr += dstRowSkipBytes;
+                }
+                srcptr += srcSliceSkipBytes;
+                dstptr += dstSliceSkipBytes;
+            }
+        }
+
+        /// Convert pixels of different, uncompressed formats
+        void convertPixels(const PixelBox &src, const PixelBox &dst)
+        {
+// NB VC6 can't handle the templates required for optimised conversion, tough
+#if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
+            // Is there a specialized, inlined, conversion?
+            if(doOptimizedConversion(src, dst))
+            {
+                // If so, good
+                return;
+            }
+#endif
+
+            // Formats with a byte per channel only need their bytes rearranged
+            ByteChannelLayout srcBytes, dstBytes;
+            if(getByteChannelLayout(src.format, srcBytes) && getByteChannelLayout(dst.format, dstBytes))
+            {
+                switch(PixelUtil::getNumElemBytes(src.format))
+                {
+                case 1: convertByteChannels<1>(src, srcBytes, dst, dstBytes); return;
+                case 2: convertByteChannels<2>(src, srcBytes, dst, dstBytes); return;
+                case 3: convertByteChannels<3>(src, srcBytes, dst, dstBytes); return;
+                case 4: convertByteChannels<4>(src, srcBytes, dst, dstBytes); return;
+                }
+            }
+
+            // Other packed integer formats and 32 bit float RGB(A) are converted
+            // through floats without unpackColour and packColour
+            PackedLayout srcPacked, dstPacked;
+            if(getPackedLayout(src.format, srcPacked) && srcPacked.hasColour() &&
+                getPackedLayout(dst.format, dstPacked))
+            {
+                convertPacked(src, srcPacked, dst, dstPacked);
+                return;
+            }
+
+            const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
+            const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
+            uint8 *srcptr = static_cast<uint8*>(src.data)
+                + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcPixelSize;
+            uint8 *dstptr = static_cast<uint8*>(dst.data)
+                + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstPixelSize;
+
+            // Calculate pitches+skips in bytes
+            const size_t srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
+            const size_t srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
+            const size_t dstRowSkipBytes = dst.getRowSkip()*dstPixelSize;
+            const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstPixelSize;
+
+            // The brute force fallback
+            float r = 0, g = 0, b = 0, a = 1;
+            for(size_t z=src.front; z<src.back; z++)
+            {
+                for(size_t y=src.top; y<src.bottom; y++)
+                {
+                    for(size_t x=src.left; x<src.right; x++)
+                    {
+                        PixelUtil::unpackColour(&r, &g, &b, &a, src.format, srcptr);
+                        PixelUtil::packColour(r, g, b, a, dst.format, dstptr);
+                        srcptr += srcPixelSize;
+                        dstptr += dstPixelSize;
+                    }
+                    srcptr += srcRowSkipBytes;
+                    dstptr += dstRowSkipBytes;
+                }
+                srcptr += srcSliceSkipBytes;
+                dstptr += dstSliceSkipBytes;
+            }
+        }
+
+        /// Converts a range of rows of every slice, see PixelUtil::bulkPixelConversion
+        class RowConverter : public ParallelForBody
+        {
+            const PixelBox& mSrc;
+            const PixelBox& mDst;
+        public:
+            RowConverter(const PixelBox& src, const PixelBox& dst) : mSrc(src), mDst(dst) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                PixelBox src = mSrc, dst = mDst;
+                src.top = mSrc.top + begin;
+                src.bottom = mSrc.top + end;
+                dst.top = mDst.top + begin;
+                dst.bottom = mDst.top + end;
+                convertPixels(src, dst);
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
     /* Convert pixels from one format to another */
     void PixelUtil::bulkPixelConversion(void *srcp, PixelFormat srcFormat,
         void *destp, PixelFormat dstFormat, unsigned int count)
@@ -783,50 +1275,15 @@ namespace Ogre {
             return;
         }
 
-// NB VC6 can't handle the templates required for optimised conversion, tough
-#if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
-        // Is there a specialized, inlined, conversion?
-        if(doOptimizedConversion(src, dst))
+        TaskScheduler* scheduler = TaskScheduler::getSingletonPtr();
+        if (scheduler && src.getWidth() * src.getHeight() * src.getDepth() >= PARALLEL_CONVERSION_MIN_PIXELS)
         {
-            // If so, good
-            return;
+            RowConverter body(src, dst);
+            scheduler->parallelFor(0, src.getHeight(), PARALLEL_CONVERSION_GRAIN_SIZE, body);
         }
-#endif
-
-        const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
-        const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
-        uint8 *srcptr = static_cast<uint8*>(src.data)
-            + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcPixelSize;
-        uint8 *dstptr = static_cast<uint8*>(dst.data)
-            + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstPixelSize;
-        
-        // Old way, not taking into account box dimensions
-        //uint8 *srcptr = static_cast<uint8*>(src.data), *dstptr = static_cast<uint8*>(dst.data);
-
-        // Calculate pitches+skips in bytes
-        const size_t srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
-        const size_t srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
-        const size_t dstRowSkipBytes = dst.getRowSkip()*dstPixelSize;
-        const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstPixelSize;
-
-        // The brute force fallback
-        float r = 0, g = 0, b = 0, a = 1;
-        for(size_t z=src.front; z<src.back; z++)
+        else
         {
-            for(size_t y=src.top; y<src.bottom; y++)
-            {
-                for(size_t x=src.left; x<src.right; x++)
-                {
-                    unpackColour(&r, &g, &b, &a, src.format, srcptr);
-                    packColour(r, g, b, a, dst.format, dstptr);
-                    srcptr += srcPixelSize;
-                    dstptr += dstPixelSize;
-                }
-                srcptr += srcRowSkipBytes;
-                dstptr += dstRowSkipBytes;
-            }
-            srcptr += srcSliceSkipBytes;
-            dstptr += dstSliceSkipBytes;
+            convertPixels(src, dst);
         }
     }
     //-----------------------------------------------------------------------
@@ -675,10 +675,12 @@ namespace Ogre {
         return sIdentifier;
     }
     //---------------------------------------------------------------------
+    static uint sCpuFeatureMask = ~0u;
+    //---------------------------------------------------------------------
     uint PlatformInformation::getCpuFeatures(void)
     {
         static const uint sFeatures = _detectCpuFeatures();
-        return sFeatures;
+        return sFeatures & sCpuFeatureMask;
     }
     //---------------------------------------------------------------------
     bool PlatformInformation::hasCpuFeature(CpuFeatures feature)
@@ -686,6 +688,11 @@ namespace Ogre {
         return (getCpuFeatures() & feature) != 0;
     }
     //---------------------------------------------------------------------
+    void PlatformInformation::_setCpuFeatureMask(uint mask)
+    {
+        sCpuFeatureMask = mask;
+    }
+    //---------------------------------------------------------------------
     void PlatformInformation::log(Log* pLog)
     {
         pLog->logMessage("CPU Identifier & Features");
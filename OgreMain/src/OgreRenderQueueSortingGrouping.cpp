@@ -31,11 +31,6 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 
 namespace Ogre {
-    // Init statics
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
 
 
     //-----------------------------------------------------------------------
@@ -314,26 +309,37 @@ namespace Ogre {
         {
             
             // We can either use a stable_sort and the 'less' implementation,
-            // or a 2-pass radix sort (once by pass, then by distance, since
-            // radix sorting is inherently stable this will work)
-            // We use stable_sort if the number of items is 512 or less, since
-            // the complexity of the radix sort is approximately O(10N), since 
-            // each sort is O(5N) (1 pass histograms, 4 passes sort)
+            // or a radix sort on a key combining distance and pass (the same
+            // order as sorting by pass, then stable by distance)
+            // We use stable_sort if the number of items is 2000 or less, since
+            // the radix sort is O(9N) (1 pass histograms, up to 8 passes sort)
             // Since stable_sort has a worst-case performance of O(N(logN)^2)
             // the performance tipping point is from about 1500 items, but in
             // stable_sorts best-case scenario O(NlogN) it would be much higher.
             // Take a stab at 2000 items.
             
-            if (mSortedDescending.size() > 2000)
+            const size_t size = mSortedDescending.size();
+            if (size > 2000)
             {
-                // sort by pass
-                msRadixSorter1.sort(mSortedDescending, RadixSortFunctorPass());
-                // sort by depth
-                msRadixSorter2.sort(mSortedDescending, RadixSortFunctorDistance(cam));
+                // The sort storage belongs to this collection, so collections
+                // can be sorted in parallel
+                mSortEntries.resize(size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    const RenderablePass& rp = mSortedDescending[i];
+                    mSortEntries[i].key = _getSortKey(
+                        rp.renderable->getSquaredViewDepth(cam), rp.pass->getHash());
+                    mSortEntries[i].value = rp;
+                }
+                RenderablePassSort::sort(mSortEntries, mSortScratch);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    mSortedDescending[i] = mSortEntries[i].value;
+                }
             }
             else
             {
-                std::stable_sort(
+                frameStableSort(
                     mSortedDescending.begin(), mSortedDescending.end(), 
                     DepthSortDescendingLess(cam));
             }
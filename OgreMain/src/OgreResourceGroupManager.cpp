@@ -34,6 +34,10 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "OgreTaskScheduler.h"
+#include "OgreScriptCompiler.h"
+#include "OgreScriptLexer.h"
+#include "OgreScriptParser.h"
 
 namespace Ogre {
 
@@ -61,7 +65,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mParallelPrepare(false),
+          mParallelScriptParsing(false)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME, true); // the "General" group is synonymous to global pool
@@ -176,6 +181,9 @@ namespace Ogre {
                 "ResourceGroupManager::prepareResourceGroup");
         }
 
+        if (prepareMainResources && mParallelPrepare)
+            prepareResourcesParallel(grp);
+
         OGRE_LOCK_AUTO_MUTEX;
         OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
         // Set current group
@@ -271,6 +279,10 @@ namespace Ogre {
                 "ResourceGroupManager::loadResourceGroup");
         }
 
+        // do the I/O in parallel, then load in order below
+        if (loadMainResources && mParallelPrepare)
+            prepareResourcesParallel(grp);
+
         OGRE_LOCK_AUTO_MUTEX;
         OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
         // Set current group
@@ -354,6 +366,65 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Finished loading resource group " + name);
     }
     //-----------------------------------------------------------------------
+    namespace {
+        /// Prepares a range of resources
+        class PrepareResourcesBody : public ParallelForBody
+        {
+        public:
+            PrepareResourcesBody(const vector<ResourcePtr>::type& resources)
+                : mResources(resources)
+            {
+            }
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    try
+                    {
+                        mResources[i]->prepare();
+                    }
+                    catch (...)
+                    {
+                        // the resource is left unprepared and tried again by
+                        // the caller in order, which reports the error. Nothing
+                        // may escape to the worker thread running this.
+                    }
+                }
+            }
+
+        private:
+            const vector<ResourcePtr>::type& mResources;
+        };
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::prepareResourcesParallel(ResourceGroup* grp)
+    {
+#if OGRE_THREAD_SUPPORT == 1 || OGRE_THREAD_SUPPORT == 2
+        TaskScheduler* scheduler = TaskScheduler::getSingletonPtr();
+        if (!scheduler)
+            return;
+
+        // copy the lists, resources prepared in the meantime are skipped
+        vector<vector<ResourcePtr>::type>::type orders;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+            ResourceGroup::LoadResourceOrderMap::iterator oi;
+            for (oi = grp->loadResourceOrderMap.begin(); oi != grp->loadResourceOrderMap.end(); ++oi)
+            {
+                orders.push_back(vector<ResourcePtr>::type(oi->second.begin(), oi->second.end()));
+            }
+        }
+
+        for (size_t i = 0; i < orders.size(); ++i)
+        {
+            PrepareResourcesBody body(orders[i]);
+            scheduler->parallelFor(0, orders[i].size(), 1, body);
+        }
+#endif
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::unloadResourceGroup(const String& name, bool reloadableOnly)
     {
         LogManager::getSingleton().logMessage("Unloading resource group " + name);
@@ -959,6 +1030,49 @@ namespace Ogre {
         return 0; // No loader was found
     }
     //-----------------------------------------------------------------------
+    namespace {
+        typedef vector<ConcreteNodeListPtr>::type ParsedScripts;
+
+        /// Tokenizes and parses a range of scripts
+        class ParseScriptsBody : public ParallelForBody
+        {
+        public:
+            ParseScriptsBody(const vector<const FileInfo*>::type& files, ParsedScripts& parsed)
+                : mFiles(files), mParsed(parsed)
+            {
+            }
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const FileInfo* fi = mFiles[i];
+                    if (fi->archive->getType() != "FileSystem")
+                        continue;
+                    try
+                    {
+                        DataStreamPtr stream = fi->archive->open(fi->filename);
+                        if (stream)
+                        {
+                            mParsed[i] = ScriptParser::parse(
+                                ScriptLexer::tokenize(stream->getAsString(), stream->getName()));
+                        }
+                    }
+                    catch (...)
+                    {
+                        // left empty, the script is parsed again in order,
+                        // which reports the error. Nothing may escape to the
+                        // worker thread running this.
+                    }
+                }
+            }
+
+        private:
+            const vector<const FileInfo*>::type& mFiles;
+            ParsedScripts& mParsed;
+        };
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::parseResourceGroupScripts(ResourceGroup* grp) const
     {
 
@@ -997,15 +1111,36 @@ namespace Ogre {
 
         // Iterate over scripts and parse
         // Note we respect original ordering
+        ScriptCompilerManager* compilerMgr = ScriptCompilerManager::getSingletonPtr();
+        TaskScheduler* scheduler = TaskScheduler::getSingletonPtr();
         for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
             slfli != scriptLoaderFileList.end(); ++slfli)
         {
             ScriptLoader* su = slfli->first;
+
+            // Tokenize and parse the compiler scripts up front, they are
+            // only compiled below
+            ParsedScripts parsedScripts;
+            if (mParallelScriptParsing && su == compilerMgr && scheduler && !mLoadingListener &&
+                !compilerMgr->getScriptCacheEnabled())
+            {
+                vector<const FileInfo*>::type files;
+                for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
+                {
+                    for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
+                        files.push_back(&*fii);
+                }
+                parsedScripts.resize(files.size());
+                ParseScriptsBody body(files, parsedScripts);
+                scheduler->parallelFor(0, files.size(), 1, body);
+            }
+            size_t scriptIndex = 0;
+
             // Iterate over each list
             for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
             {
                 // Iterate over each item in the list
-                for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
+                for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii, ++scriptIndex)
                 {
                     bool skipScript = false;
                     fireScriptStarted(fii->filename, skipScript);
@@ -1014,6 +1149,14 @@ namespace Ogre {
                         LogManager::getSingleton().logMessage(
                             "Skipping script " + fii->filename);
                     }
+                    else if (scriptIndex < parsedScripts.size() && parsedScripts[scriptIndex])
+                    {
+                        LogManager::getSingleton().logMessage(
+                            "Compiling script " + fii->filename);
+                        compilerMgr->compileScript(parsedScripts[scriptIndex], grp->name);
+                        // free the nodes as we go
+                        parsedScripts[scriptIndex].reset();
+                    }
                     else
                     {
                         LogManager::getSingleton().logMessage(
@@ -63,7 +63,11 @@ THE SOFTWARE.
 #include "OgreTimer.h"
 #include "OgreFrameListener.h"
 #include "OgreLodStrategyManager.h"
+#include "OgreTaskScheduler.h"
 #include "Threading/OgreDefaultWorkQueue.h"
+#if OGRE_THREAD_PROVIDER != 3
+#include "Threading/OgreWorkStealingWorkQueue.h"
+#endif
 #include "OgreFileSystemLayer.h"
 
 #if OGRE_NO_FREEIMAGE == 0
@@ -166,17 +170,9 @@ namespace Ogre {
 
         // WorkQueue (note: users can replace this if they want)
         DefaultWorkQueue* defaultQ = OGRE_NEW DefaultWorkQueue("Root");
-        // never process responses in main thread for longer than 10ms by default
-        defaultQ->setResponseProcessingTimeLimit(10);
-        // match threads to hardware
-        unsigned threadCount = OGRE_THREAD_HARDWARE_CONCURRENCY;
-        if (!threadCount)
-            threadCount = 1;
-        defaultQ->setWorkerThreadCount(threadCount);
-
-        // only allow workers to access rendersystem if threadsupport is 1
-        defaultQ->setWorkersCanAccessRenderSystem(OGRE_THREAD_SUPPORT == 1);
+        configureDefaultWorkQueue(defaultQ);
         mWorkQueue = defaultQ;
+        mTaskScheduler = OGRE_NEW TaskScheduler(mWorkQueue);
 
         // ResourceBackgroundQueue
         mResourceBackgroundQueue = OGRE_NEW ResourceBackgroundQueue();
@@ -339,6 +335,7 @@ namespace Ogre {
         OGRE_DELETE mBillboardChainFactory;
         OGRE_DELETE mRibbonTrailFactory;
 
+        OGRE_DELETE mTaskScheduler;
         OGRE_DELETE mWorkQueue;
 
         OGRE_DELETE mTimer;
@@ -354,6 +351,8 @@ namespace Ogre {
 
         OGRE_DELETE mCompilerManager;
 
+        FrameAllocPolicy::_shutdown();
+
         mAutoWindow = 0;
         mFirstTimePostWindowInit = false;
 
@@ -876,6 +875,9 @@ namespace Ogre {
         if (HardwareBufferManager::getSingletonPtr())
             HardwareBufferManager::getSingleton()._releaseBufferCopies();
 
+        // Temporaries of this frame are released by now, their blocks get reused
+        FrameAllocPolicy::_frameEnded();
+
         // Tell the queue to process responses
         mWorkQueue->processResponses();
 
@@ -1624,10 +1626,49 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void Root::configureDefaultWorkQueue(DefaultWorkQueueBase* queue)
+    {
+        // never process responses in main thread for longer than 10ms by default
+        queue->setResponseProcessingTimeLimit(10);
+        // match threads to hardware
+        unsigned threadCount = OGRE_THREAD_HARDWARE_CONCURRENCY;
+        if (!threadCount)
+            threadCount = 1;
+        queue->setWorkerThreadCount(threadCount);
+
+        // only allow workers to access rendersystem if threadsupport is 1
+        queue->setWorkersCanAccessRenderSystem(OGRE_THREAD_SUPPORT == 1);
+    }
+    //---------------------------------------------------------------------
+    void Root::setUseWorkStealingQueue(bool enable)
+    {
+        DefaultWorkQueueBase* queue = 0;
+#if OGRE_THREAD_PROVIDER != 3
+        if (enable)
+        {
+            if (dynamic_cast<WorkStealingWorkQueue*>(mWorkQueue))
+                return;
+            queue = OGRE_NEW WorkStealingWorkQueue("Root");
+        }
+        else
+#endif
+        {
+            // keep the current queue and its handlers if it already matches
+            if (dynamic_cast<DefaultWorkQueue*>(mWorkQueue))
+                return;
+            queue = OGRE_NEW DefaultWorkQueue("Root");
+        }
+
+        configureDefaultWorkQueue(queue);
+        setWorkQueue(queue);
+    }
+    //---------------------------------------------------------------------
     void Root::setWorkQueue(WorkQueue* queue)
     {
         if (mWorkQueue != queue)
         {
+            mTaskScheduler->_setWorkQueue(queue);
+
             // delete old one (will shut down)
             OGRE_DELETE mWorkQueue;
 
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreControllerManager.h"
 #include "OgreMaterialManager.h"
 #include "OgreAnimation.h"
+#include "OgreSkeletonInstance.h"
 #include "OgreRenderObjectListener.h"
 #include "OgreBillboardSet.h"
 #include "OgreTechnique.h"
@@ -64,6 +65,11 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreTaskScheduler.h"
+#include "OgreNodeTransformStorage.h"
+#include "OgreSceneNodeCuller.h"
+#include "OgreSkinningBatch.h"
+#include "OgreLightGrid.h"
 
 // This class implements the most basic scene manager
 
@@ -115,10 +121,21 @@ mResetIdentityProj(false),
 mNormaliseNormalsOnScale(true),
 mFlipCullingOnNegativeScale(true),
 mLightsDirtyCounter(0),
+mLightGrid(0),
+mLightGridDirtyCounter(0),
 mMovableNameGenerator("Ogre/MO"),
 mShadowCasterPlainBlackPass(0),
 mShadowReceiverPass(0),
 mDisplayNodes(false),
+mParallelNodeUpdate(false),
+mParallelNodeUpdateThreshold(1024),
+mParallelNodeUpdater(0),
+mUpdatingNodesInParallel(false),
+mNodeTransformStorage(0),
+mSceneNodeCuller(0),
+mSkinningBatch(0),
+mSkinningBatchActive(false),
+mSkeletalAnimationUpdater(0),
 mShowBoundingBoxes(false),
 mActiveCompositorChain(0),
 mLateMaterialResolving(false),
@@ -212,12 +229,18 @@ SceneManager::~SceneManager()
     OGRE_DELETE mSkyBoxObj;
 
     OGRE_DELETE mShadowCasterQueryListener;
+    OGRE_DELETE mLightGrid;
     OGRE_DELETE mSceneRoot;
     OGRE_DELETE mFullScreenQuad;
     OGRE_DELETE mShadowCasterSphereQuery;
     OGRE_DELETE mShadowCasterAABBQuery;
     OGRE_DELETE mRenderQueue;
     OGRE_DELETE mAutoParamDataSource;
+    setParallelNodeUpdate(false);
+    setPackedNodeTransforms(false);
+    setBatchedCulling(false);
+    setBatchedSkinning(false);
+    setParallelSkeletalAnimation(false);
 }
 //-----------------------------------------------------------------------
 RenderQueue* SceneManager::getRenderQueue(void)
@@ -349,7 +372,8 @@ void SceneManager::destroyCamera(const String& name)
             mShadowCamLightMapping.erase( camLightIt );
 
         // Notify render system
-        mDestRenderSystem->_notifyCameraRemoved(i->second);
+        if (mDestRenderSystem)
+            mDestRenderSystem->_notifyCameraRemoved(i->second);
         OGRE_DELETE i->second;
         mCameras.erase(i);
     }
@@ -433,6 +457,36 @@ bool SceneManager::lightLess::operator()(const Light* a, const Light* b) const
     return a->tempSquareDist < b->tempSquareDist;
 }
 //-----------------------------------------------------------------------
+void SceneManager::updateLightGrid(void)
+{
+    const LightList& lights = _getLightsAffectingFrustum();
+    if (lights.size() < LightGrid::MIN_LIGHTS)
+        return;
+
+    if (!mLightGrid)
+        mLightGrid = OGRE_NEW LightGrid();
+    if (mLightGridDirtyCounter != mLightsDirtyCounter ||
+        mLightGrid->getNumLights() != lights.size())
+    {
+        mLightGrid->build(lights);
+        mLightGridDirtyCounter = mLightsDirtyCounter;
+    }
+}
+//-----------------------------------------------------------------------
+namespace {
+    /// A light along with its squared distance to the position of a light list
+    typedef std::pair<Real, Light*> LightDistance;
+    typedef std::vector<LightDistance, STLAllocator<LightDistance, FrameAllocPolicy> > LightDistanceList;
+
+    struct LightDistanceLess
+    {
+        bool operator()(const LightDistance& a, const LightDistance& b) const
+        {
+            return a.first < b.first;
+        }
+    };
+}
+//-----------------------------------------------------------------------
 void SceneManager::_populateLightList(const Vector3& position, Real radius, 
                                       LightList& destList, uint32 lightMask)
 {
@@ -441,34 +495,44 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
 
     // Pick up the lights that affecting frustum only, which should has been
     // cached, so better than take all lights in the scene into account.
-    const LightList& candidateLights = _getLightsAffectingFrustum();
+    const LightList& frustumLights = _getLightsAffectingFrustum();
+    Light* const* candidates = frustumLights.empty() ? 0 : &frustumLights[0];
+    size_t numCandidates = frustumLights.size();
 
-    // Pre-allocate memory
-    destList.clear();
-    destList.reserve(candidateLights.size());
+    // With many lights, only consider those near the position. Usually the grid
+    // is up to date already, the lights found are kept locally.
+    LightGrid::FoundLightList nearLights;
+    if (numCandidates >= LightGrid::MIN_LIGHTS)
+    {
+        updateLightGrid();
+        mLightGrid->findLights(Sphere(position, radius), nearLights);
+        candidates = nearLights.empty() ? 0 : &nearLights[0];
+        numCandidates = nearLights.size();
+    }
 
-    LightList::const_iterator it;
-    for (it = candidateLights.begin(); it != candidateLights.end(); ++it)
+    // The distances are kept along with the lights instead of in
+    // Light::tempSquareDist, which would be shared by concurrent calls
+    LightDistanceList inRange;
+    inRange.reserve(numCandidates);
+    for (size_t i = 0; i < numCandidates; ++i)
     {
-        Light* lt = *it;
+        Light* lt = candidates[i];
         // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
         if(!(lt->getLightMask() & lightMask))
             continue; //skip this light
 
-        // Calc squared distance
-        lt->_calcTempSquareDist(position);
-
         if (lt->getType() == Light::LT_DIRECTIONAL)
         {
             // Always included
-            destList.push_back(lt);
+            inRange.push_back(LightDistance(0, lt));
         }
         else
         {
             // only add in-range lights
             if (lt->isInLightRange(Sphere(position,radius)))
             {
-                destList.push_back(lt);
+                inRange.push_back(LightDistance(
+                    (position - lt->getDerivedPosition()).squaredLength(), lt));
             }
         }
     }
@@ -480,26 +544,25 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
         // the first few lights unchanged from the frustum list, matching the
         // texture shadows that were generated
         // Thus we only allow object-relative sorting on the remainder of the list
-        if (destList.size() > getShadowTextureCount())
+        if (inRange.size() > getShadowTextureCount())
         {
-            LightList::iterator start = destList.begin();
-            std::advance(start, getShadowTextureCount());
-            std::stable_sort(start, destList.end(), lightLess());
+            frameStableSort(inRange.begin() + getShadowTextureCount(), inRange.end(),
+                LightDistanceLess());
         }
     }
     else
     {
-        std::stable_sort(destList.begin(), destList.end(), lightLess());
+        frameStableSort(inRange.begin(), inRange.end(), LightDistanceLess());
     }
 
     // Now assign indexes in the list so they can be examined if needed
-    size_t lightIndex = 0;
-    for (LightList::iterator li = destList.begin(); li != destList.end(); ++li, ++lightIndex)
+    destList.clear();
+    destList.reserve(inRange.size());
+    for (LightDistanceList::const_iterator li = inRange.begin(); li != inRange.end(); ++li)
     {
-        (*li)->_notifyIndexInFrame(lightIndex);
+        li->second->_notifyIndexInFrame(destList.size());
+        destList.push_back(li->second);
     }
-
-
 }
 //-----------------------------------------------------------------------
 void SceneManager::_populateLightList(const SceneNode* sn, Real radius, LightList& destList, uint32 lightMask) 
@@ -1474,6 +1537,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Update controllers 
     ControllerManager::getSingleton().updateAllControllers();
+    // Particle systems deferred by their controllers when updating in parallel
+    ParticleSystemManager::getSingleton()._updateQueuedSystems();
 
     // Update the scene, only do this once per frame
     unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
@@ -1481,6 +1546,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     {
         // Update animations
         _applySceneAnimations();
+        mSkeletalAnimationStats = SkeletalAnimationStatistics();
+        _updateSkeletalAnimation(camera);
         updateDirtyInstanceManagers();
         mLastFrameNumber = thisFrameNumber;
     }
@@ -1509,6 +1576,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         {
             // Locate any lights which could be affecting the frustum
             findLightsAffectingFrustum(camera);
+            updateLightGrid();
 
             // Are we using any shadows at all?
             if (isShadowTechniqueInUse() && vp->getShadowsEnabled())
@@ -1597,8 +1665,14 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
             // Parse the scene and tag visibles
             firePreFindVisibleObjects(vp);
+            mSkinningBatchActive = mSkinningBatch != 0;
             _findVisibleObjects(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            if (mSkinningBatchActive)
+            {
+                mSkinningBatchActive = false;
+                mSkinningBatch->flush();
+            }
             firePostFindVisibleObjects(vp);
 
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
@@ -2349,6 +2423,296 @@ MeshPtr SceneManager::createSkydomePlane(
 }
 
 
+//-----------------------------------------------------------------------
+/** Splits the scene graph update into independent subtrees which are updated
+    in parallel by the TaskScheduler, see SceneManager::setParallelNodeUpdate.
+*/
+class SceneManager::ParallelNodeUpdater : public ParallelForBody, public SceneMgtAlloc
+{
+    /// Number of levels the calling thread expands at most before handing out tasks
+    static const size_t MAX_EXPAND_DEPTH = 8;
+
+    Node::ChildUpdateList mFrontier;
+    Node::ChildUpdateList mNextFrontier;
+    vector<SceneNode*>::type mExpanded;
+
+    /// Subtree roots to update along with their parentHasChanged flag
+    Node::ChildUpdateList mNodes;
+    /// Task i updates nodes [mTaskEnds[i-1], mTaskEnds[i])
+    vector<size_t>::type mTaskEnds;
+
+    /// Count the nodes of the subtree starting at n, giving up once limit is reached
+    static size_t countNodes(Node* n, size_t limit)
+    {
+        size_t count = 1;
+        Node::ChildNodeIterator it = n->getChildIterator();
+        while (count < limit && it.hasMoreElements())
+        {
+            count += countNodes(it.getNext(), limit - count);
+        }
+        return count;
+    }
+
+public:
+    void execute(size_t begin, size_t end)
+    {
+        for (size_t task = begin; task < end; ++task)
+        {
+            size_t nodesEnd = mTaskEnds[task];
+            for (size_t i = task ? mTaskEnds[task - 1] : 0; i < nodesEnd; ++i)
+            {
+                mNodes[i].first->_update(true, mNodes[i].second);
+            }
+        }
+    }
+
+    void update(SceneNode* root, size_t threshold)
+    {
+        TaskScheduler& scheduler = TaskScheduler::getSingleton();
+        const size_t numThreads = scheduler.getNumThreads();
+
+        // Expand the top of the graph on this thread until there are enough subtrees
+        // to share out. Parents are always done before their children this way.
+        mExpanded.clear();
+        mFrontier.clear();
+        mFrontier.push_back(std::make_pair(static_cast<Node*>(root), false));
+        for (size_t depth = 0; depth < MAX_EXPAND_DEPTH && mFrontier.size() < numThreads * 4; ++depth)
+        {
+            bool expanded = false;
+            mNextFrontier.clear();
+            for (Node::ChildUpdateList::iterator i = mFrontier.begin(); i != mFrontier.end(); ++i)
+            {
+                if (countNodes(i->first, threshold) >= threshold)
+                {
+                    i->first->_updateSelf(i->second, mNextFrontier);
+                    mExpanded.push_back(static_cast<SceneNode*>(i->first));
+                    expanded = true;
+                }
+                else
+                {
+                    mNextFrontier.push_back(*i);
+                }
+            }
+            mFrontier.swap(mNextFrontier);
+
+            if (!expanded)
+                break;
+        }
+
+        // Group neighbouring subtrees into tasks of at least 'threshold' nodes
+        mNodes.swap(mFrontier);
+        mTaskEnds.clear();
+        size_t taskSize = 0;
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            taskSize += countNodes(mNodes[i].first, threshold);
+            if (taskSize >= threshold)
+            {
+                mTaskEnds.push_back(i + 1);
+                taskSize = 0;
+            }
+        }
+        if (taskSize)
+            mTaskEnds.push_back(mNodes.size());
+
+        scheduler.parallelFor(0, mTaskEnds.size(), 1, *this);
+
+        // Now the subtrees are done, finish the expanded nodes bottom up
+        for (vector<SceneNode*>::type::reverse_iterator i = mExpanded.rbegin(); i != mExpanded.rend(); ++i)
+        {
+            (*i)->_updateBounds();
+        }
+    }
+};
+//-----------------------------------------------------------------------
+void SceneManager::setParallelNodeUpdate(bool enabled)
+{
+    if (enabled && !isParallelNodeUpdateSupported())
+    {
+        LogManager::getSingleton().logMessage("WARNING: Scene manager " + mName +
+            " does not support parallel node update, the option is ignored.", LML_CRITICAL);
+        enabled = false;
+    }
+
+    if (enabled && !mParallelNodeUpdater)
+    {
+        mParallelNodeUpdater = OGRE_NEW ParallelNodeUpdater();
+    }
+    else if (!enabled && mParallelNodeUpdater)
+    {
+        OGRE_DELETE mParallelNodeUpdater;
+        mParallelNodeUpdater = 0;
+    }
+    mParallelNodeUpdate = enabled;
+}
+//-----------------------------------------------------------------------
+void SceneManager::setPackedNodeTransforms(bool enabled)
+{
+    if (enabled && !mNodeTransformStorage)
+    {
+        mNodeTransformStorage = OGRE_NEW NodeTransformStorage();
+    }
+    else if (!enabled && mNodeTransformStorage)
+    {
+        OGRE_DELETE mNodeTransformStorage;
+        mNodeTransformStorage = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setBatchedCulling(bool enabled)
+{
+    if (enabled && !mSceneNodeCuller)
+    {
+        mSceneNodeCuller = OGRE_NEW SceneNodeCuller();
+    }
+    else if (!enabled && mSceneNodeCuller)
+    {
+        OGRE_DELETE mSceneNodeCuller;
+        mSceneNodeCuller = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setBatchedSkinning(bool enabled)
+{
+    if (enabled && !mSkinningBatch)
+    {
+        mSkinningBatch = OGRE_NEW SkinningBatch();
+    }
+    else if (!enabled && mSkinningBatch)
+    {
+        OGRE_DELETE mSkinningBatch;
+        mSkinningBatch = 0;
+        mSkinningBatchActive = false;
+    }
+}
+//-----------------------------------------------------------------------
+/** Evaluates the skeletons of animated entities on the TaskScheduler threads,
+    see SceneManager::setParallelSkeletalAnimation.
+*/
+class SceneManager::SkeletalAnimationUpdater : public ParallelForBody, public SceneMgtAlloc
+{
+    /// Number of entities evaluated by a task at least
+    static const size_t GRAIN_SIZE = 4;
+
+    vector<Entity*>::type mEntities;
+    /// Skeleton instances shared by entities which were already collected
+    set<SkeletonInstance*>::type mSharedSkeletons;
+    /// Animations prepared for being applied from several threads
+    set<Animation*>::type mAnimations;
+
+    /// Whether objects are attached to the bones of the skeleton of the entity
+    static bool hasTagPoints(Entity* e)
+    {
+        if (!e->sharesSkeletonInstance())
+            return e->getAttachedObjectIterator().hasMoreElements();
+
+        const Entity::EntitySet* entities = e->getSkeletonInstanceSharingSet();
+        for (Entity::EntitySet::const_iterator i = entities->begin(); i != entities->end(); ++i)
+        {
+            if ((*i)->getAttachedObjectIterator().hasMoreElements())
+                return true;
+        }
+        return false;
+    }
+
+public:
+    void execute(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            mEntities[i]->_updateSkeletonAnimation();
+        }
+    }
+
+    void update(SceneManager* sceneMgr, Camera* camera, SceneManager::MovableObjectIterator it)
+    {
+        // Collect one entity per skeleton instance. Animations are built lazily on
+        // their first use, and the animation LOD reads the lazily updated scene
+        // graph, so both are prepared here on the calling thread.
+        mEntities.clear();
+        mSharedSkeletons.clear();
+        mAnimations.clear();
+        while (it.hasMoreElements())
+        {
+            Entity* e = static_cast<Entity*>(it.getNext());
+            if (!e->isInitialised() || !e->hasSkeleton() || !e->isInScene() || !e->isVisible() ||
+                !e->_isSkeletonAnimated() || hasTagPoints(e))
+                continue;
+            if (camera)
+                e->_updateAnimationLod(camera);
+            if (e->sharesSkeletonInstance() && !mSharedSkeletons.insert(e->getSkeleton()).second)
+                continue;
+            mEntities.push_back(e);
+
+            SkeletonInstance* skel = e->getSkeleton();
+            const EnabledAnimationStateList& states = e->getAllAnimationStates()->getEnabledAnimationStates();
+            for (EnabledAnimationStateList::const_iterator i = states.begin(); i != states.end(); ++i)
+            {
+                Animation* anim = skel->_getAnimationImpl((*i)->getAnimationName());
+                if (anim && mAnimations.insert(anim).second)
+                    anim->_prepareForApply();
+            }
+        }
+
+        TaskScheduler::getSingleton().parallelFor(0, mEntities.size(), GRAIN_SIZE, *this);
+
+        for (vector<Entity*>::type::const_iterator i = mEntities.begin(); i != mEntities.end(); ++i)
+        {
+            sceneMgr->_notifySkeletonUpdated(*i);
+        }
+    }
+};
+//-----------------------------------------------------------------------
+void SceneManager::setParallelSkeletalAnimation(bool enabled)
+{
+    if (enabled && !mSkeletalAnimationUpdater)
+    {
+        mSkeletalAnimationUpdater = OGRE_NEW SkeletalAnimationUpdater();
+    }
+    else if (!enabled && mSkeletalAnimationUpdater)
+    {
+        OGRE_DELETE mSkeletalAnimationUpdater;
+        mSkeletalAnimationUpdater = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_updateSkeletalAnimation(Camera* camera)
+{
+    if (mSkeletalAnimationUpdater)
+    {
+        mSkeletalAnimationUpdater->update(this, camera,
+            getMovableObjectIterator(EntityFactory::FACTORY_TYPE_NAME));
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifySkeletonUpdated(const Entity* entity)
+{
+    switch (entity->_getLastSkeletonUpdate())
+    {
+    case Entity::SUR_EVALUATED:
+        ++mSkeletalAnimationStats.numEvaluated;
+        break;
+    case Entity::SUR_REDUCED:
+        ++mSkeletalAnimationStats.numReduced;
+        break;
+    case Entity::SUR_UNCHANGED:
+        ++mSkeletalAnimationStats.numUnchanged;
+        break;
+    case Entity::SUR_THROTTLED:
+        ++mSkeletalAnimationStats.numThrottled;
+        break;
+    default:
+        break;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifySceneGraphChanged(void)
+{
+    if (mNodeTransformStorage)
+        mNodeTransformStorage->_notifyHierarchyChanged();
+    if (mSceneNodeCuller)
+        mSceneNodeCuller->_notifyHierarchyChanged();
+}
 //-----------------------------------------------------------------------
 void SceneManager::_updateSceneGraph(Camera* cam)
 {
@@ -2361,7 +2725,41 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (mNodeTransformStorage)
+    {
+        mNodeTransformStorage->update(getRootSceneNode());
+
+        // Bounds are merged bottom up, so walk the nodes deepest first
+        const NodeTransformStorage::NodeList& nodes = mNodeTransformStorage->getUpdatedNodes();
+        NodeTransformStorage::NodeList::const_reverse_iterator it, itend;
+        itend = nodes.rend();
+        for (it = nodes.rbegin(); it != itend; ++it)
+        {
+            static_cast<SceneNode*>(*it)->_updateBounds();
+        }
+    }
+    else if (mParallelNodeUpdater)
+    {
+        mUpdatingNodesInParallel = true;
+        try
+        {
+            mParallelNodeUpdater->update(getRootSceneNode(), mParallelNodeUpdateThreshold);
+        }
+        catch (...)
+        {
+            mUpdatingNodesInParallel = false;
+            throw;
+        }
+        mUpdatingNodesInParallel = false;
+
+        // Instanced entities moved meanwhile only flagged their batches
+        for (InstanceManagerMap::iterator i = mInstanceManagerMap.begin(); i != mInstanceManagerMap.end(); ++i)
+        {
+            i->second->_applyDeferredBoundsDirty();
+        }
+    }
+    else
+        getRootSceneNode()->_update(true, false);
 
     firePostUpdateSceneGraph(cam);
 }
@@ -2369,6 +2767,13 @@ void SceneManager::_updateSceneGraph(Camera* cam)
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (mSceneNodeCuller)
+    {
+        mSceneNodeCuller->findVisibleObjects(getRootSceneNode(), cam, getRenderQueue(),
+            visibleBounds, mDisplayNodes, onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
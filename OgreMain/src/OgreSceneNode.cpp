@@ -92,6 +92,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void SceneNode::setParent(Node* parent)
     {
+        // Moving nodes in or out of the scene graph changes its layout
+        if (mCreator && (mIsInSceneGraph ||
+            (parent && static_cast<SceneNode*>(parent)->isInSceneGraph())))
+        {
+            mCreator->_notifySceneGraphChanged();
+        }
+
         Node::setParent(parent);
 
         if (parent)
@@ -354,6 +361,11 @@ namespace Ogre {
             }
         }
 
+        _addDebugRenderablesToQueue(queue, displayNodes);
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::_addDebugRenderablesToQueue(RenderQueue* queue, bool displayNodes)
+    {
         if (displayNodes)
         {
             // Include self in the render queue
@@ -367,8 +379,6 @@ namespace Ogre {
         { 
             _addBoundingBoxToQueue(queue);
         }
-
-
     }
 
     Node::DebugRenderable* SceneNode::getDebugRenderable()
@@ -404,6 +414,20 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void SceneNode::setDerivedTransformImpl(const Vector3& position,
+        const Quaternion& orientation, const Vector3& scale) const
+    {
+        Node::setDerivedTransformImpl(position, orientation, scale);
+
+        // Notify objects that it has been moved
+        ObjectMap::const_iterator i;
+        for (i = mObjectsByName.begin(); i != mObjectsByName.end(); ++i)
+        {
+            MovableObject* object = ITER_VAL(i);
+            object->_notifyMoved();
+        }
+    }
+    //-----------------------------------------------------------------------
     Node* SceneNode::createChildImpl(void)
     {
         assert(mCreator);
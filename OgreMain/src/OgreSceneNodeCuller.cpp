@@ -0,0 +1,204 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSceneNodeCuller.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    SceneNodeCuller::SceneNodeCuller()
+        : mBoxes(0)
+        , mStride(0)
+        , mNumPlanes(0)
+        , mRoot(0)
+        , mLayoutOutOfDate(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    SceneNodeCuller::~SceneNodeCuller()
+    {
+        freeBuffers();
+    }
+    //-----------------------------------------------------------------------
+    void SceneNodeCuller::freeBuffers(void)
+    {
+        OGRE_FREE_SIMD(mBoxes, MEMCATEGORY_SCENE_CONTROL);
+        mBoxes = 0;
+    }
+    //-----------------------------------------------------------------------
+    void SceneNodeCuller::addSubtree(SceneNode* node)
+    {
+        size_t index = mNodes.size();
+        mNodes.push_back(node);
+        mSubtreeEnds.push_back(0);
+
+        // Same order as SceneNode::_findVisibleObjects visits the children
+        Node::ChildNodeIterator it = node->getChildIterator();
+        while (it.hasMoreElements())
+            addSubtree(static_cast<SceneNode*>(it.getNext()));
+
+        mSubtreeEnds[index] = mNodes.size();
+    }
+    //-----------------------------------------------------------------------
+    void SceneNodeCuller::buildLayout(SceneNode* root)
+    {
+        mRoot = root;
+        mNodes.clear();
+        mSubtreeEnds.clear();
+        if (root)
+            addSubtree(root);
+
+        mVisible.assign(mNodes.size(), 0);
+
+        // Pad the component arrays to SIMD boundaries
+        size_t stride = (mNodes.size() + 3) & ~size_t(3);
+        if (stride != mStride)
+        {
+            freeBuffers();
+            mStride = stride;
+            if (mStride)
+            {
+                mBoxes = static_cast<Real*>(OGRE_MALLOC_SIMD(
+                    sizeof(Real) * NUM_COMPONENTS * mStride, MEMCATEGORY_SCENE_CONTROL));
+            }
+        }
+
+        mLayoutOutOfDate = false;
+    }
+    //-----------------------------------------------------------------------
+    void SceneNodeCuller::execute(size_t begin, size_t end)
+    {
+        const size_t stride = mStride;
+        size_t first = begin * NODES_PER_TASK;
+        size_t last = std::min(end * NODES_PER_TASK, mNodes.size());
+
+        // Gather the bounds, null and infinite boxes are dealt with afterwards
+        bool allFinite = true;
+        for (size_t i = first; i < last; ++i)
+        {
+            const AxisAlignedBox& box = mNodes[i]->_getWorldAABB();
+            Real* b = mBoxes + i;
+            if (box.isFinite())
+            {
+                Vector3 centre = box.getCenter();
+                Vector3 halfSize = box.getHalfSize();
+                b[0] = centre.x;
+                b[stride] = centre.y;
+                b[2*stride] = centre.z;
+                b[3*stride] = halfSize.x;
+                b[4*stride] = halfSize.y;
+                b[5*stride] = halfSize.z;
+            }
+            else
+            {
+                for (size_t c = 0; c < NUM_COMPONENTS; ++c)
+                    b[c*stride] = 0;
+                allFinite = false;
+            }
+        }
+
+        // Tasks start on multiples of NODES_PER_TASK, which keeps them SIMD aligned
+        OptimisedUtil::getImplementation()->cullAxisAlignedBoxes(
+            mPlanes, mNumPlanes, mBoxes + first, stride, last - first, &mVisible[first]);
+
+        if (!allFinite)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                const AxisAlignedBox& box = mNodes[i]->_getWorldAABB();
+                if (!box.isFinite())
+                    mVisible[i] = box.isInfinite();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneNodeCuller::findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes, bool onlyShadowCasters)
+    {
+        if (mLayoutOutOfDate || root != mRoot)
+            buildLayout(root);
+
+        const size_t numNodes = mNodes.size();
+        if (!numNodes)
+            return;
+
+        // Fetch the planes here, updating them is not thread safe
+        const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+        const Plane* planes = frustum->getFrustumPlanes();
+        mNumPlanes = 0;
+        for (int p = 0; p < 6; ++p)
+        {
+            // Skip far plane if infinite view frustum
+            if (p == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+                continue;
+            mPlanes[mNumPlanes++] = planes[p];
+        }
+
+        size_t numTasks = (numNodes + NODES_PER_TASK - 1) / NODES_PER_TASK;
+        TaskScheduler::getSingleton().parallelFor(0, numTasks, 1, *this);
+
+        // Queue the objects of nodes which are visible along with all their
+        // ancestors, adding debug renderables once a node's subtree is done
+        mOpenNodes.clear();
+        size_t i = 0;
+        while (i < numNodes)
+        {
+            while (!mOpenNodes.empty() && mSubtreeEnds[mOpenNodes.back()] <= i)
+            {
+                mNodes[mOpenNodes.back()]->_addDebugRenderablesToQueue(queue, displayNodes);
+                mOpenNodes.pop_back();
+            }
+
+            if (!mVisible[i])
+            {
+                // Skip the whole subtree
+                i = mSubtreeEnds[i];
+                continue;
+            }
+
+            SceneNode* node = mNodes[i];
+            SceneNode::ObjectIterator it = node->getAttachedObjectIterator();
+            while (it.hasMoreElements())
+            {
+                queue->processVisibleObject(it.getNext(), cam, onlyShadowCasters, visibleBounds);
+            }
+
+            mOpenNodes.push_back(i);
+            ++i;
+        }
+
+        while (!mOpenNodes.empty())
+        {
+            mNodes[mOpenNodes.back()]->_addDebugRenderablesToQueue(queue, displayNodes);
+            mOpenNodes.pop_back();
+        }
+    }
+}
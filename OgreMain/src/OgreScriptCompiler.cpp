@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreScriptCompiler.h"
 #include "OgreScriptParser.h"
+#include "OgreScriptLexer.h"
 #include "OgreScriptTranslator.h"
 #include "OgreLogManager.h"
 #include "OgreResourceGroupManager.h"
@@ -443,6 +444,46 @@ namespace Ogre
         return mErrors.empty();
     }
 
+    bool ScriptCompiler::_generateProcessedAST(const ConcreteNodeListPtr &nodes, const String &group,
+        AbstractNodeListPtr &ast, StringVector &imports)
+    {
+        // Set up the compilation context
+        mGroup = group;
+
+        // Clear the past errors
+        mErrors.clear();
+
+        // Clear the environment
+        mEnv.clear();
+
+        if(mListener)
+            mListener->preConversion(this, nodes);
+
+        ast = convertToAST(nodes);
+        processImports(ast);
+        processObjects(ast.get(), ast);
+        processVariables(ast.get());
+
+        // Nested imports end up here as well, including those which failed to load
+        for(ImportRequestMap::iterator i = mImportRequests.begin(); i != mImportRequests.end();
+            i = mImportRequests.upper_bound(i->first))
+        {
+            imports.push_back(i->first);
+        }
+
+        mImports.clear();
+        mImportRequests.clear();
+        mImportTable.clear();
+
+        return mErrors.empty();
+    }
+
+    uint32 ScriptCompiler::_getWordId(const String &word) const
+    {
+        IdMap::const_iterator i = mIds.find(word);
+        return i != mIds.end() ? i->second : 0;
+    }
+
     void ScriptCompiler::addError(uint32 code, const Ogre::String &file, int line, const String &msg)
     {
         ErrorPtr err(OGRE_NEW Error());
@@ -1568,6 +1609,260 @@ namespace Ogre
     }
     
 
+    // Script cache
+    namespace {
+        const uint32 SCRIPT_CACHE_ID = 0x4F534343; // OSCC
+        const uint32 SCRIPT_CACHE_VERSION = 1;
+
+        uint32 hashScript(const String& str)
+        {
+            return FastHash(str.data(), str.size(), static_cast<uint32>(str.size()));
+        }
+
+        /// Hash of an imported script as the compiler would find it, 0 if it is missing
+        uint32 hashImport(const String& name, const String& groupName)
+        {
+            try
+            {
+                return hashScript(ResourceGroupManager::getSingleton().openResource(name, groupName)->getAsString());
+            }
+            catch (FileNotFoundException&)
+            {
+                return 0;
+            }
+        }
+
+        /** Appends abstract nodes to a buffer.
+        @remarks
+            Word ids are not written but looked up again when reading, so the
+            cache stays valid if custom words are registered in another order.
+            The file names shared by most nodes are written once and referred
+            to by index after that.
+        */
+        class ScriptCacheWriter
+        {
+        public:
+            ScriptCacheWriter(String& buffer) : mBuffer(buffer) {}
+
+            void writeByte(uint8 value) { mBuffer.push_back(static_cast<char>(value)); }
+            void writeUInt(uint32 value) { mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+            void writeString(const String& str)
+            {
+                writeUInt(static_cast<uint32>(str.size()));
+                mBuffer.append(str);
+            }
+
+            void writeNodes(const AbstractNodeList& nodes)
+            {
+                writeUInt(static_cast<uint32>(nodes.size()));
+                for (AbstractNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+                    writeNode(i->get());
+            }
+
+            void writeNode(const AbstractNode* node)
+            {
+                writeByte(static_cast<uint8>(node->type));
+                map<String, uint32>::type::iterator file = mFiles.find(node->file);
+                if (file != mFiles.end())
+                    writeUInt(file->second);
+                else
+                {
+                    uint32 index = static_cast<uint32>(mFiles.size());
+                    mFiles[node->file] = index;
+                    writeUInt(index);
+                    writeString(node->file);
+                }
+                writeUInt(node->line);
+
+                switch (node->type)
+                {
+                case ANT_ATOM:
+                    writeString(static_cast<const AtomAbstractNode*>(node)->value);
+                    break;
+                case ANT_OBJECT:
+                    {
+                        const ObjectAbstractNode* obj = static_cast<const ObjectAbstractNode*>(node);
+                        writeString(obj->name);
+                        writeString(obj->cls);
+                        writeUInt(static_cast<uint32>(obj->bases.size()));
+                        for (size_t i = 0; i < obj->bases.size(); ++i)
+                            writeString(obj->bases[i]);
+                        writeByte(obj->abstract ? 1 : 0);
+                        const map<String, String>::type& vars = obj->getVariables();
+                        writeUInt(static_cast<uint32>(vars.size()));
+                        for (map<String, String>::type::const_iterator i = vars.begin(); i != vars.end(); ++i)
+                        {
+                            writeString(i->first);
+                            writeString(i->second);
+                        }
+                        // overrides are merged into the children by then
+                        writeNodes(obj->children);
+                        writeNodes(obj->values);
+                    }
+                    break;
+                case ANT_PROPERTY:
+                    {
+                        const PropertyAbstractNode* prop = static_cast<const PropertyAbstractNode*>(node);
+                        writeString(prop->name);
+                        writeNodes(prop->values);
+                    }
+                    break;
+                case ANT_IMPORT:
+                    writeString(static_cast<const ImportAbstractNode*>(node)->target);
+                    writeString(static_cast<const ImportAbstractNode*>(node)->source);
+                    break;
+                case ANT_VARIABLE_ACCESS:
+                    writeString(static_cast<const VariableAccessAbstractNode*>(node)->name);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+        private:
+            String& mBuffer;
+            map<String, uint32>::type mFiles;
+        };
+
+        /// Reads what ScriptCacheWriter wrote, throws if the data ends early
+        class ScriptCacheReader
+        {
+        public:
+            ScriptCacheReader(const String& buffer, const ScriptCompiler* compiler)
+                : mPos(buffer.data()), mEnd(buffer.data() + buffer.size()), mCompiler(compiler)
+            {
+            }
+
+            uint8 readByte(void)
+            {
+                require(1);
+                return static_cast<uint8>(*mPos++);
+            }
+            uint32 readUInt(void)
+            {
+                require(sizeof(uint32));
+                uint32 value;
+                memcpy(&value, mPos, sizeof(uint32));
+                mPos += sizeof(uint32);
+                return value;
+            }
+            String readString(void)
+            {
+                uint32 size = readUInt();
+                require(size);
+                String str(mPos, size);
+                mPos += size;
+                return str;
+            }
+
+            AbstractNodeListPtr readNodes(AbstractNode* parent)
+            {
+                AbstractNodeListPtr nodes(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+                readNodes(*nodes, parent);
+                return nodes;
+            }
+
+            void readNodes(AbstractNodeList& nodes, AbstractNode* parent)
+            {
+                uint32 count = readUInt();
+                for (uint32 i = 0; i < count; ++i)
+                    nodes.push_back(readNode(parent));
+            }
+
+            AbstractNodePtr readNode(AbstractNode* parent)
+            {
+                AbstractNodeType type = static_cast<AbstractNodeType>(readByte());
+                uint32 fileIndex = readUInt();
+                if (fileIndex == mFiles.size())
+                    mFiles.push_back(readString());
+                else if (fileIndex > mFiles.size())
+                    corrupt();
+                uint32 line = readUInt();
+
+                AbstractNodePtr node;
+                switch (type)
+                {
+                case ANT_ATOM:
+                    {
+                        AtomAbstractNode* atom = OGRE_NEW AtomAbstractNode(parent);
+                        node = AbstractNodePtr(atom);
+                        atom->value = readString();
+                        atom->id = mCompiler->_getWordId(atom->value);
+                    }
+                    break;
+                case ANT_OBJECT:
+                    {
+                        ObjectAbstractNode* obj = OGRE_NEW ObjectAbstractNode(parent);
+                        node = AbstractNodePtr(obj);
+                        obj->name = readString();
+                        obj->cls = readString();
+                        obj->id = mCompiler->_getWordId(obj->cls);
+                        uint32 numBases = readUInt();
+                        for (uint32 i = 0; i < numBases; ++i)
+                            obj->bases.push_back(readString());
+                        obj->abstract = readByte() != 0;
+                        uint32 numVars = readUInt();
+                        for (uint32 i = 0; i < numVars; ++i)
+                        {
+                            String name = readString();
+                            obj->setVariable(name, readString());
+                        }
+                        readNodes(obj->children, obj);
+                        readNodes(obj->values, obj);
+                    }
+                    break;
+                case ANT_PROPERTY:
+                    {
+                        PropertyAbstractNode* prop = OGRE_NEW PropertyAbstractNode(parent);
+                        node = AbstractNodePtr(prop);
+                        prop->name = readString();
+                        prop->id = mCompiler->_getWordId(prop->name);
+                        readNodes(prop->values, prop);
+                    }
+                    break;
+                case ANT_IMPORT:
+                    {
+                        ImportAbstractNode* import = OGRE_NEW ImportAbstractNode();
+                        node = AbstractNodePtr(import);
+                        import->parent = parent;
+                        import->target = readString();
+                        import->source = readString();
+                    }
+                    break;
+                case ANT_VARIABLE_ACCESS:
+                    {
+                        VariableAccessAbstractNode* var = OGRE_NEW VariableAccessAbstractNode(parent);
+                        node = AbstractNodePtr(var);
+                        var->name = readString();
+                    }
+                    break;
+                default:
+                    corrupt();
+                }
+                node->file = mFiles[fileIndex];
+                node->line = line;
+                return node;
+            }
+
+        private:
+            void require(size_t size)
+            {
+                if (static_cast<size_t>(mEnd - mPos) < size)
+                    corrupt();
+            }
+            void corrupt(void)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Script cache data is corrupt",
+                    "ScriptCacheReader");
+            }
+
+            const char* mPos;
+            const char* mEnd;
+            const ScriptCompiler* mCompiler;
+            StringVector mFiles;
+        };
+    }
+
     // ScriptCompilerManager
     template<> ScriptCompilerManager *Singleton<ScriptCompilerManager>::msSingleton = 0;
     
@@ -1583,6 +1878,8 @@ namespace Ogre
     //-----------------------------------------------------------------------
     ScriptCompilerManager::ScriptCompilerManager()
         :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler)
+        ,mScriptCacheEnabled(false), mScriptCacheDirty(false)
+        ,mScriptCacheHits(0), mScriptCacheMisses(0)
     {
             OGRE_LOCK_AUTO_MUTEX;
         mScriptPatterns.push_back("*.program");
@@ -1678,7 +1975,7 @@ namespace Ogre
         return 90.0f;
     }
     //-----------------------------------------------------------------------
-    void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
+    ScriptCompiler* ScriptCompilerManager::getThreadCompiler(void)
     {
 #if OGRE_THREAD_SUPPORT
         // check we have an instance for this thread (should always have one for main thread)
@@ -1694,7 +1991,190 @@ namespace Ogre
                     OGRE_LOCK_AUTO_MUTEX;
             OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
         }
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+        return OGRE_THREAD_POINTER_GET(mScriptCompiler);
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
+    {
+        ScriptCompiler* compiler = getThreadCompiler();
+        if (!mScriptCacheEnabled || compiler->getListener())
+        {
+            compiler->compile(stream->getAsString(), stream->getName(), groupName);
+            return;
+        }
+
+        String str = stream->getAsString();
+        const String& source = stream->getName();
+        uint32 hash = hashScript(str);
+
+        AbstractNodeListPtr ast = findCachedScript(source, hash, groupName, compiler);
+        if (!ast)
+        {
+            StringVector imports;
+            ConcreteNodeListPtr nodes = ScriptParser::parse(ScriptLexer::tokenize(str, source));
+            // scripts with errors are not cached, so the errors are reported every time
+            if (compiler->_generateProcessedAST(nodes, groupName, ast, imports))
+                addCachedScript(source, hash, groupName, imports, ast);
+        }
+        compiler->_compile(ast, groupName, false, false, false);
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::compileScript(const ConcreteNodeListPtr& nodes, const String& groupName)
+    {
+        getThreadCompiler()->compile(nodes, groupName);
+    }
+
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::setScriptCacheEnabled(bool enabled)
+    {
+        mScriptCacheEnabled = enabled;
+    }
+    //-----------------------------------------------------------------------
+    AbstractNodeListPtr ScriptCompilerManager::findCachedScript(const String& name, uint32 hash,
+        const String& groupName, ScriptCompiler* compiler)
+    {
+        // the entry is copied so the imports can be checked without the lock
+        CachedScript entry;
+        {
+                    OGRE_LOCK_AUTO_MUTEX;
+            ScriptCache::iterator i = mScriptCache.find(name);
+            if (i != mScriptCache.end() && i->second.hash == hash)
+                entry = i->second;
+            else
+                entry.hash = ~hash;
+        }
+
+        AbstractNodeListPtr ast;
+        if (entry.hash == hash)
+        {
+            bool upToDate = true;
+            for (size_t i = 0; i < entry.imports.size() && upToDate; ++i)
+                upToDate = hashImport(entry.imports[i].first, groupName) == entry.imports[i].second;
+
+            if (upToDate)
+            {
+                try
+                {
+                    ScriptCacheReader reader(entry.ast, compiler);
+                    ast = reader.readNodes(0);
+                }
+                catch (Exception& e)
+                {
+                    LogManager::getSingleton().logMessage("Ignoring cached script " + name +
+                        ": " + e.getDescription());
+                    ast.reset();
+                }
+            }
+        }
+
+            OGRE_LOCK_AUTO_MUTEX;
+        if (ast)
+            ++mScriptCacheHits;
+        else
+            ++mScriptCacheMisses;
+        return ast;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::addCachedScript(const String& name, uint32 hash, const String& groupName,
+        const StringVector& imports, const AbstractNodeListPtr& ast)
+    {
+        CachedScript entry;
+        entry.hash = hash;
+        for (StringVector::const_iterator i = imports.begin(); i != imports.end(); ++i)
+            entry.imports.push_back(std::make_pair(*i, hashImport(*i, groupName)));
+        ScriptCacheWriter writer(entry.ast);
+        writer.writeNodes(*ast);
+
+            OGRE_LOCK_AUTO_MUTEX;
+        mScriptCache[name] = entry;
+        mScriptCacheDirty = true;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::saveScriptCache(DataStreamPtr stream) const
+    {
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "ScriptCompilerManager::saveScriptCache");
+        }
+
+        String data;
+        ScriptCacheWriter writer(data);
+        writer.writeUInt(SCRIPT_CACHE_ID);
+        writer.writeUInt(SCRIPT_CACHE_VERSION);
+        {
+                    OGRE_LOCK_AUTO_MUTEX;
+            writer.writeUInt(static_cast<uint32>(mScriptCache.size()));
+            for (ScriptCache::const_iterator i = mScriptCache.begin(); i != mScriptCache.end(); ++i)
+            {
+                writer.writeString(i->first);
+                writer.writeUInt(i->second.hash);
+                writer.writeUInt(static_cast<uint32>(i->second.imports.size()));
+                for (size_t j = 0; j < i->second.imports.size(); ++j)
+                {
+                    writer.writeString(i->second.imports[j].first);
+                    writer.writeUInt(i->second.imports[j].second);
+                }
+                writer.writeString(i->second.ast);
+            }
+        }
+        stream->write(data.data(), data.size());
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::loadScriptCache(DataStreamPtr stream)
+    {
+        ScriptCache cache;
+        try
+        {
+            String data = stream->getAsString();
+            ScriptCacheReader reader(data, 0);
+            if (reader.readUInt() != SCRIPT_CACHE_ID || reader.readUInt() != SCRIPT_CACHE_VERSION)
+            {
+                LogManager::getSingleton().logMessage("Ignoring script cache " + stream->getName() +
+                    " written by another version");
+                return;
+            }
+
+            uint32 numScripts = reader.readUInt();
+            for (uint32 i = 0; i < numScripts; ++i)
+            {
+                String name = reader.readString();
+                CachedScript& entry = cache[name];
+                entry.hash = reader.readUInt();
+                uint32 numImports = reader.readUInt();
+                for (uint32 j = 0; j < numImports; ++j)
+                {
+                    String import = reader.readString();
+                    entry.imports.push_back(std::make_pair(import, reader.readUInt()));
+                }
+                entry.ast = reader.readString();
+            }
+        }
+        catch (Exception& e)
+        {
+            LogManager::getSingleton().logMessage("Ignoring script cache " + stream->getName() +
+                ": " + e.getDescription());
+            return;
+        }
+
+            OGRE_LOCK_AUTO_MUTEX;
+        mScriptCache.swap(cache);
+        mScriptCacheDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::clearScriptCache(void)
+    {
+            OGRE_LOCK_AUTO_MUTEX;
+        mScriptCacheDirty = mScriptCacheDirty || !mScriptCache.empty();
+        mScriptCache.clear();
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::resetScriptCacheStatistics(void)
+    {
+            OGRE_LOCK_AUTO_MUTEX;
+        mScriptCacheHits = 0;
+        mScriptCacheMisses = 0;
     }
 
     //-------------------------------------------------------------------------
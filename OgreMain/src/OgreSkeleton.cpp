@@ -36,6 +36,7 @@ THE SOFTWARE.
 // Just for logging
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
+#include "OgreCompressedNodeTracks.h"
 
 
 namespace Ogre {
@@ -45,14 +46,17 @@ namespace Ogre {
         : Resource(),
         mBlendState(ANIMBLEND_AVERAGE),
         mNextAutoHandle(0),
-        mManualBonesDirty(false)
+        mManualBonesDirty(false),
+        mBoneDepthMaskDepth(0),
+        mBoneDepthMaskUsed(false)
     {
     }
     //---------------------------------------------------------------------
     Skeleton::Skeleton(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group, bool isManual, ManualResourceLoader* loader) 
         : Resource(creator, name, handle, group, isManual, loader), 
-        mBlendState(ANIMBLEND_AVERAGE), mNextAutoHandle(0)
+        mBlendState(ANIMBLEND_AVERAGE), mNextAutoHandle(0), mBoneDepthMaskDepth(0),
+        mBoneDepthMaskUsed(false)
         // set animation blending to weighted, not cumulative
     {
         if (createParamDictionary("Skeleton"))
@@ -105,6 +109,7 @@ namespace Ogre {
         mRootBones.clear();
         mManualBones.clear();
         mManualBonesDirty = false;
+        mBoneDepthMask.clear();
 
         // Destroy animations
         AnimationList::iterator ai;
@@ -200,6 +205,12 @@ namespace Ogre {
 
     //---------------------------------------------------------------------
     void Skeleton::setAnimationState(const AnimationStateSet& animSet)
+    {
+        setAnimationState(animSet, std::numeric_limits<unsigned short>::max(), false);
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::setAnimationState(const AnimationStateSet& animSet,
+        unsigned short maxBoneDepth, bool snapToKeyFrames)
     {
         /* 
         Algorithm:
@@ -234,6 +245,11 @@ namespace Ogre {
             }
         }
 
+        // Bones left out by the level of detail
+        const AnimationState::BoneBlendMask* depthMask = 0;
+        if (maxBoneDepth != std::numeric_limits<unsigned short>::max())
+            depthMask = getBoneDepthMask(maxBoneDepth);
+
         // Per enabled animation state
         EnabledAnimationStateList::const_iterator animIt;
         for(animIt = animSet.getEnabledAnimationStates().begin(); animIt != animSet.getEnabledAnimationStates().end(); ++animIt)
@@ -244,20 +260,58 @@ namespace Ogre {
             // tolerate state entries for animations we're not aware of
             if (anim)
             {
-              if(animState->hasBlendMask())
+              Real timePos = animState->getTimePosition();
+              if (snapToKeyFrames)
+                timePos = anim->_getPrecedingKeyFrameTime(timePos);
+
+              const AnimationState::BoneBlendMask* blendMask =
+                animState->hasBlendMask() ? animState->getBlendMask() : 0;
+              if (depthMask && blendMask)
+              {
+                mCombinedBlendMask.resize(depthMask->size());
+                for (size_t i = 0; i < depthMask->size(); ++i)
+                  mCombinedBlendMask[i] = (*depthMask)[i] * (*blendMask)[i];
+                blendMask = &mCombinedBlendMask;
+              }
+              else if (depthMask)
               {
-                anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
+                blendMask = depthMask;
+              }
+
+              if(blendMask)
+              {
+                anim->apply(this, timePos, animState->getWeight() * weightFactor,
+                  blendMask, linked ? linked->scale : 1.0f);
               }
               else
               {
-                anim->apply(this, animState->getTimePosition(), 
+                anim->apply(this, timePos, 
                   animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
               }
             }
         }
 
 
+    }
+    //---------------------------------------------------------------------
+    const AnimationState::BoneBlendMask* Skeleton::getBoneDepthMask(unsigned short maxBoneDepth)
+    {
+        if (mBoneDepthMask.size() != mBoneList.size() || mBoneDepthMaskDepth != maxBoneDepth)
+        {
+            mBoneDepthMask.resize(mBoneList.size());
+            mBoneDepthMaskDepth = maxBoneDepth;
+            mBoneDepthMaskUsed = false;
+            for (size_t i = 0; i < mBoneList.size(); ++i)
+            {
+                unsigned short depth = 0;
+                for (Node* n = mBoneList[i]->getParent(); n && depth <= maxBoneDepth; n = n->getParent())
+                    ++depth;
+                mBoneDepthMask[i] = depth > maxBoneDepth ? 0.0f : 1.0f;
+                mBoneDepthMaskUsed |= depth > maxBoneDepth;
+            }
+        }
+
+        return mBoneDepthMaskUsed ? &mBoneDepthMask : 0;
     }
     //---------------------------------------------------------------------
     void Skeleton::setBindingPose(void)
@@ -925,6 +979,22 @@ namespace Ogre {
                 }
             }
 
+            // Compressed tracks can't be adjusted to another binding pose
+            const CompressedNodeTracks* srcCompressed = srcAnimation->getCompressedNodeTracks();
+            if (srcCompressed)
+            {
+                for (handle = 0; handle < numSrcBones; ++handle)
+                {
+                    if (!deltaTransforms[handle].isIdentity)
+                    {
+                        OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                            "Compressed animation " + srcAnimation->getName() +
+                            " can't be merged into a skeleton with a different binding pose",
+                            "Skeleton::_mergeSkeletonAnimations");
+                    }
+                }
+            }
+
             // Create target animation
             Animation* dstAnimation = this->createAnimation(srcAnimation->getName(), srcAnimation->getLength());
 
@@ -932,6 +1002,13 @@ namespace Ogre {
             dstAnimation->setInterpolationMode(srcAnimation->getInterpolationMode());
             dstAnimation->setRotationInterpolationMode(srcAnimation->getRotationInterpolationMode());
 
+            if (srcCompressed)
+            {
+                CompressedNodeTracks* dstCompressed = srcCompressed->_clone(dstAnimation);
+                dstCompressed->_remapHandles(boneHandleMap);
+                dstAnimation->_setCompressedNodeTracks(dstCompressed);
+            }
+
             // Copy track for each bone
             for (handle = 0; handle < numSrcBones; ++handle)
             {
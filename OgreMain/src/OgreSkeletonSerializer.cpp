@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreAnimation.h"
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
+#include "OgreCompressedNodeTracks.h"
 #include "OgreBone.h"
 #include "OgreLogManager.h"
 
@@ -64,6 +65,20 @@ namespace Ogre {
     void SkeletonSerializer::exportSkeleton(const Skeleton* pSkeleton, 
         DataStreamPtr stream, SkeletonVersion ver, Endian endianMode)
     {
+        // Only compressed node tracks need the 1.10 format, keep writing
+        // files older versions can read otherwise
+        if ((int)ver >= (int)SKELETON_VERSION_1_10)
+        {
+            ver = SKELETON_VERSION_1_8;
+            for (unsigned short i = 0; i < pSkeleton->getNumAnimations(); ++i)
+            {
+                if (pSkeleton->getAnimation(i)->getCompressedNodeTracks())
+                {
+                    ver = SKELETON_VERSION_1_10;
+                    break;
+                }
+            }
+        }
         setWorkingVersion(ver);
         // Decide on endian mode
         determineEndianness(endianMode);
@@ -161,7 +176,9 @@ namespace Ogre {
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.100]";
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -235,6 +252,14 @@ namespace Ogre {
     void SkeletonSerializer::writeAnimation(const Skeleton* pSkel, 
         const Animation* anim, SkeletonVersion ver)
     {
+        if (anim->getCompressedNodeTracks() && (int)ver < (int)SKELETON_VERSION_1_10)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Animation " + anim->getName() + " has compressed node tracks, "
+                "which need SKELETON_VERSION_1_10 or later",
+                "SkeletonSerializer::writeAnimation");
+        }
+
         writeChunkHeader(SKELETON_ANIMATION, calcAnimationSize(pSkel, anim, ver));
 
         // char* name                       : Name of the animation
@@ -265,6 +290,11 @@ namespace Ogre {
             }
         }
 
+        if (anim->getCompressedNodeTracks())
+        {
+            writeCompressedNodeTracks(anim->getCompressedNodeTracks());
+        }
+
         // Write all tracks
         Animation::NodeTrackIterator trackIt = anim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
@@ -314,6 +344,54 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedNodeTracks(const CompressedNodeTracks* tracks)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_COMPRESSED, calcCompressedNodeTracksSize(tracks));
+
+        // unsigned int numTimes
+        uint32 numTimes = static_cast<uint32>(tracks->mTimes.size());
+        writeInts(&numTimes, 1);
+        // float times[numTimes]            : Key times of all tracks
+        if (numTimes)
+            writeFloats(&tracks->mTimes[0], numTimes);
+
+        // unsigned short numTracks
+        uint16 numTracks = static_cast<uint16>(tracks->mTracks.size());
+        writeShorts(&numTracks, 1);
+        for (uint16 i = 0; i < numTracks; ++i)
+        {
+            const CompressedNodeTracks::Track& track = tracks->mTracks[i];
+            // unsigned short boneIndex     : Index of bone to apply to
+            writeShorts(&track.handle, 1);
+            // unsigned int first, count    : Keys of the rotation, translation and scale channels
+            for (int ch = 0; ch < CompressedNodeTracks::CH_COUNT; ++ch)
+            {
+                writeInts(&track.keys[ch].first, 1);
+                writeInts(&track.keys[ch].count, 1);
+            }
+            // Vector3 offset, step         : Decoding of translation and scale keys
+            for (int j = 0; j < 2; ++j)
+            {
+                writeObject(track.offset[j]);
+                writeObject(track.step[j]);
+            }
+        }
+
+        for (int ch = 0; ch < CompressedNodeTracks::CH_COUNT; ++ch)
+        {
+            // unsigned int numKeys
+            uint32 numKeys = static_cast<uint32>(tracks->mKeyTimes[ch].size());
+            writeInts(&numKeys, 1);
+            if (numKeys)
+            {
+                // unsigned short times[numKeys]        : Indices of the key times
+                writeShorts(&tracks->mKeyTimes[ch][0], numKeys);
+                // unsigned short values[numKeys * 3]   : Quantized key values
+                writeShorts(&tracks->mKeyValues[ch][0], numKeys * 3);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcBoneSize(const Skeleton* pSkel, 
         const Bone* pBone)
     {
@@ -383,6 +461,11 @@ namespace Ogre {
             }
         }
 
+        if (pAnim->getCompressedNodeTracks())
+        {
+            size += calcCompressedNodeTracksSize(pAnim->getCompressedNodeTracks());
+        }
+
         // Nested animation tracks
         Animation::NodeTrackIterator trackIt = pAnim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
@@ -439,6 +522,26 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedNodeTracksSize(const CompressedNodeTracks* tracks)
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // unsigned int numTimes, float times[numTimes]
+        size += sizeof(uint32) + sizeof(float) * tracks->mTimes.size();
+        // unsigned short numTracks
+        size += sizeof(uint16);
+        // boneIndex, first and count of each channel, offset and step of translation and scale
+        size += (sizeof(uint16) + sizeof(uint32) * 2 * CompressedNodeTracks::CH_COUNT +
+            sizeof(float) * 12) * tracks->mTracks.size();
+        // numKeys, times and values of each channel
+        for (int ch = 0; ch < CompressedNodeTracks::CH_COUNT; ++ch)
+        {
+            size += sizeof(uint32) + sizeof(uint16) * 4 * tracks->mKeyTimes[ch].size();
+        }
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::readFileHeader(DataStreamPtr& stream)
     {
         unsigned short headerID;
@@ -451,7 +554,8 @@ namespace Ogre {
             // Read version
             String ver = readString(stream);
             if ((ver != "[Serializer_v1.10]") &&
-                (ver != "[Serializer_v1.80]"))
+                (ver != "[Serializer_v1.80]") &&
+                (ver != "[Serializer_v1.100]"))
             {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
                     "Invalid file: version incompatible, file reports " + String(ver),
@@ -554,6 +658,17 @@ namespace Ogre {
                     streamID = readChunk(stream);
                 }
             }
+
+            if (streamID == SKELETON_ANIMATION_COMPRESSED)
+            {
+                readCompressedNodeTracks(stream, pAnim);
+
+                if (!stream->eof())
+                {
+                    // Get next stream
+                    streamID = readChunk(stream);
+                }
+            }
             
             while(streamID == SKELETON_ANIMATION_TRACK && !stream->eof())
             {
@@ -639,6 +754,86 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedNodeTracks(DataStreamPtr& stream, Animation* anim)
+    {
+        CompressedNodeTracks* tracks = OGRE_NEW CompressedNodeTracks(anim);
+        anim->_setCompressedNodeTracks(tracks);
+
+        // unsigned int numTimes
+        uint32 numTimes;
+        readInts(stream, &numTimes, 1);
+        if (numTimes > 0xFFFF)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Invalid compressed node tracks in animation " + anim->getName(),
+                "SkeletonSerializer::readCompressedNodeTracks");
+        }
+        // float times[numTimes]            : Key times of all tracks
+        tracks->mTimes.resize(numTimes);
+        if (numTimes)
+            readFloats(stream, &tracks->mTimes[0], numTimes);
+
+        // unsigned short numTracks
+        uint16 numTracks;
+        readShorts(stream, &numTracks, 1);
+        tracks->mTracks.resize(numTracks);
+        for (uint16 i = 0; i < numTracks; ++i)
+        {
+            CompressedNodeTracks::Track& track = tracks->mTracks[i];
+            // unsigned short boneIndex     : Index of bone to apply to
+            readShorts(stream, &track.handle, 1);
+            // unsigned int first, count    : Keys of the rotation, translation and scale channels
+            for (int ch = 0; ch < CompressedNodeTracks::CH_COUNT; ++ch)
+            {
+                readInts(stream, &track.keys[ch].first, 1);
+                readInts(stream, &track.keys[ch].count, 1);
+            }
+            // Vector3 offset, step         : Decoding of translation and scale keys
+            for (int j = 0; j < 2; ++j)
+            {
+                readObject(stream, track.offset[j]);
+                readObject(stream, track.step[j]);
+            }
+        }
+
+        for (int ch = 0; ch < CompressedNodeTracks::CH_COUNT; ++ch)
+        {
+            // unsigned int numKeys
+            uint32 numKeys;
+            readInts(stream, &numKeys, 1);
+            tracks->mKeyTimes[ch].resize(numKeys);
+            tracks->mKeyValues[ch].resize(numKeys * 3);
+            if (numKeys)
+            {
+                // unsigned short times[numKeys]        : Indices of the key times
+                readShorts(stream, &tracks->mKeyTimes[ch][0], numKeys);
+                // unsigned short values[numKeys * 3]   : Quantized key values
+                readShorts(stream, &tracks->mKeyValues[ch][0], numKeys * 3);
+            }
+
+            // Check the keys are within the arrays, sampling doesn't
+            for (uint16 i = 0; i < numTracks; ++i)
+            {
+                const CompressedNodeTracks::KeyRange& range = tracks->mTracks[i].keys[ch];
+                if (range.first > numKeys || range.count > numKeys - range.first)
+                {
+                    OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Invalid compressed node tracks in animation " + anim->getName(),
+                        "SkeletonSerializer::readCompressedNodeTracks");
+                }
+            }
+            for (uint32 k = 0; k < numKeys; ++k)
+            {
+                if (tracks->mKeyTimes[ch][k] >= numTimes)
+                {
+                    OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Invalid compressed node tracks in animation " + anim->getName(),
+                        "SkeletonSerializer::readCompressedNodeTracks");
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeletonAnimationLink(const Skeleton* pSkel, 
         const LinkedSkeletonAnimationSource& link)
     {
@@ -0,0 +1,204 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSkinningBatch.h"
+#include "OgreVertexIndexData.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    SkinningBatch::SkinningBatch()
+    {
+    }
+    //-----------------------------------------------------------------------
+    SkinningBatch::~SkinningBatch()
+    {
+        flush();
+    }
+    //-----------------------------------------------------------------------
+    void* SkinningBatch::lockBuffer(const HardwareVertexBufferSharedPtr& buffer,
+        HardwareBuffer::LockOptions options)
+    {
+        LockedBufferMap::iterator i = mLockedBuffers.find(buffer.get());
+        if (i != mLockedBuffers.end())
+            return i->second.data;
+
+        LockedBuffer& locked = mLockedBuffers[buffer.get()];
+        locked.buffer = buffer;
+        locked.data = buffer->lock(options);
+        return locked.data;
+    }
+    //-----------------------------------------------------------------------
+    void SkinningBatch::add(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+        const Matrix4* const* blendMatrices, size_t numMatrices, bool blendNormals)
+    {
+        Blend blend;
+
+        // Get elements for source
+        const VertexElement* srcElemPos =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* srcElemNorm =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+        const VertexElement* srcElemBlendIndices =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
+        const VertexElement* srcElemBlendWeights =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_WEIGHTS);
+        OgreAssert(srcElemPos && srcElemBlendIndices && srcElemBlendWeights,
+            "You must supply at least positions, blend indices and blend weights");
+        // Get elements for target
+        const VertexElement* destElemPos =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* destElemNorm =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+
+        // Do we have normals and want to blend them?
+        bool includeNormals = blendNormals && (srcElemNorm != NULL) && (destElemNorm != NULL);
+
+        // Get buffers for source
+        const VertexBufferBinding* srcBinding = sourceVertexData->vertexBufferBinding;
+        HardwareVertexBufferSharedPtr srcPosBuf = srcBinding->getBuffer(srcElemPos->getSource());
+        HardwareVertexBufferSharedPtr srcIdxBuf = srcBinding->getBuffer(srcElemBlendIndices->getSource());
+        HardwareVertexBufferSharedPtr srcWeightBuf = srcBinding->getBuffer(srcElemBlendWeights->getSource());
+        HardwareVertexBufferSharedPtr srcNormBuf;
+        if (includeNormals)
+            srcNormBuf = srcBinding->getBuffer(srcElemNorm->getSource());
+        // Get buffers for target
+        const VertexBufferBinding* destBinding = targetVertexData->vertexBufferBinding;
+        HardwareVertexBufferSharedPtr destPosBuf = destBinding->getBuffer(destElemPos->getSource());
+        HardwareVertexBufferSharedPtr destNormBuf;
+        if (includeNormals)
+            destNormBuf = destBinding->getBuffer(destElemNorm->getSource());
+
+        // Lock source buffers for reading
+        float* pFloat;
+        srcElemPos->baseVertexPointerToElement(lockBuffer(srcPosBuf, HardwareBuffer::HBL_READ_ONLY), &pFloat);
+        blend.srcPos = pFloat;
+        blend.srcPosStride = srcPosBuf->getVertexSize();
+        blend.srcNorm = 0;
+        blend.srcNormStride = 0;
+        if (includeNormals)
+        {
+            srcElemNorm->baseVertexPointerToElement(lockBuffer(srcNormBuf, HardwareBuffer::HBL_READ_ONLY), &pFloat);
+            blend.srcNorm = pFloat;
+            blend.srcNormStride = srcNormBuf->getVertexSize();
+        }
+
+        // Indices must be 4 bytes
+        assert(srcElemBlendIndices->getType() == VET_UBYTE4 &&
+               "Blend indices must be VET_UBYTE4");
+        unsigned char* pBlendIdx;
+        srcElemBlendIndices->baseVertexPointerToElement(
+            lockBuffer(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY), &pBlendIdx);
+        blend.blendIndex = pBlendIdx;
+        blend.blendIndexStride = srcIdxBuf->getVertexSize();
+        srcElemBlendWeights->baseVertexPointerToElement(
+            lockBuffer(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY), &pFloat);
+        blend.blendWeight = pFloat;
+        blend.blendWeightStride = srcWeightBuf->getVertexSize();
+        blend.numWeightsPerVertex = VertexElement::getTypeCount(srcElemBlendWeights->getType());
+
+        // Lock destination buffers for writing
+        HardwareBuffer::LockOptions destPosLock =
+            (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
+            (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
+            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL;
+        destElemPos->baseVertexPointerToElement(lockBuffer(destPosBuf, destPosLock), &pFloat);
+        blend.destPos = pFloat;
+        blend.destPosStride = destPosBuf->getVertexSize();
+        blend.destNorm = 0;
+        blend.destNormStride = 0;
+        if (includeNormals)
+        {
+            HardwareBuffer::LockOptions destNormLock =
+                destNormBuf->getVertexSize() == destElemNorm->getSize() ?
+                HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL;
+            destElemNorm->baseVertexPointerToElement(lockBuffer(destNormBuf, destNormLock), &pFloat);
+            blend.destNorm = pFloat;
+            blend.destNormStride = destNormBuf->getVertexSize();
+        }
+
+        // The matrix pointers usually live on the caller's stack
+        blend.firstMatrix = mBlendMatrices.size();
+        mBlendMatrices.insert(mBlendMatrices.end(), blendMatrices, blendMatrices + numMatrices);
+
+        blend.numVertices = targetVertexData->vertexCount;
+        for (size_t first = 0; first < blend.numVertices; first += VERTICES_PER_TASK)
+        {
+            Chunk chunk;
+            chunk.blend = mBlends.size();
+            chunk.firstVertex = first;
+            chunk.numVertices = std::min(VERTICES_PER_TASK, blend.numVertices - first);
+            mChunks.push_back(chunk);
+        }
+        mBlends.push_back(blend);
+    }
+    //-----------------------------------------------------------------------
+    void SkinningBatch::execute(size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            const Chunk& chunk = mChunks[c];
+            const Blend& b = mBlends[chunk.blend];
+            // Chunks start on multiples of 4 vertices, which keeps the
+            // alignment the SIMD implementations look for
+            size_t v = chunk.firstVertex;
+            OptimisedUtil::getImplementation()->softwareVertexSkinning(
+                reinterpret_cast<const float*>(reinterpret_cast<const char*>(b.srcPos) + v * b.srcPosStride),
+                reinterpret_cast<float*>(reinterpret_cast<char*>(b.destPos) + v * b.destPosStride),
+                b.srcNorm ? reinterpret_cast<const float*>(
+                    reinterpret_cast<const char*>(b.srcNorm) + v * b.srcNormStride) : 0,
+                b.destNorm ? reinterpret_cast<float*>(
+                    reinterpret_cast<char*>(b.destNorm) + v * b.destNormStride) : 0,
+                reinterpret_cast<const float*>(reinterpret_cast<const char*>(b.blendWeight) + v * b.blendWeightStride),
+                b.blendIndex + v * b.blendIndexStride,
+                mBlendMatrices.empty() ? 0 : &mBlendMatrices[0] + b.firstMatrix,
+                b.srcPosStride, b.destPosStride,
+                b.srcNormStride, b.destNormStride,
+                b.blendWeightStride, b.blendIndexStride,
+                b.numWeightsPerVertex,
+                chunk.numVertices);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SkinningBatch::flush(void)
+    {
+        if (TaskScheduler* scheduler = TaskScheduler::getSingletonPtr())
+            scheduler->parallelFor(0, mChunks.size(), 1, *this);
+        else
+            execute(0, mChunks.size());
+
+        LockedBufferMap::iterator i, iend = mLockedBuffers.end();
+        for (i = mLockedBuffers.begin(); i != iend; ++i)
+            i->second.buffer->unlock();
+
+        mLockedBuffers.clear();
+        mBlends.clear();
+        mChunks.clear();
+        mBlendMatrices.clear();
+    }
+}
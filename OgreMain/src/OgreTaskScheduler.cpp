@@ -0,0 +1,484 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreTaskScheduler.h"
+
+#if __cplusplus >= 201103L || OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER >= 1800
+#   define OGRE_TASK_EXCEPTION_PTR 1
+#   include <exception>
+#else
+#   define OGRE_TASK_EXCEPTION_PTR 0
+#endif
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    template<> TaskScheduler* Singleton<TaskScheduler>::msSingleton = 0;
+    TaskScheduler* TaskScheduler::getSingletonPtr(void)
+    {
+        return msSingleton;
+    }
+    TaskScheduler& TaskScheduler::getSingleton(void)
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    //-----------------------------------------------------------------------
+    class TaskScheduler::Job : public UtilityAlloc
+    {
+    public:
+        virtual ~Job() {}
+        /// Take part in the work, returns once there is nothing left to claim
+        virtual void work(void) = 0;
+    };
+
+    namespace {
+        /// Request data, keeps the job alive until every request posted for it is handled
+        struct JobRequest
+        {
+            SharedPtr<TaskScheduler::Job> job;
+
+            friend std::ostream& operator<<(std::ostream& o, const JobRequest& r)
+            { (void)r; return o; }
+        };
+
+        /** The first exception thrown by the work of a job.
+        @remarks
+            Exceptions must not escape on the worker threads, they are kept
+            here and thrown again on the thread owning the job once all
+            threads are done with it.
+        */
+        class JobError
+        {
+        public:
+            JobError() : mCaught(0)
+#if !OGRE_TASK_EXCEPTION_PTR
+                , mException(0)
+#endif
+            {
+            }
+
+            ~JobError()
+            {
+#if !OGRE_TASK_EXCEPTION_PTR
+                OGRE_DELETE_T(mException, Exception, MEMCATEGORY_GENERAL);
+#endif
+            }
+
+            /// Whether an exception was caught, the remaining work may be skipped
+            bool caught(void) const { return mCaught.load() != 0; }
+
+            /// Keep the exception being handled, must be called from a catch block
+            void capture(void)
+            {
+                size_t caught = 0;
+                if (!mCaught.compare_exchange_strong(caught, 1))
+                    return;
+#if OGRE_TASK_EXCEPTION_PTR
+                mException = std::current_exception();
+#else
+                try
+                {
+                    throw;
+                }
+                catch (Exception& e)
+                {
+                    mException = OGRE_NEW_T(Exception, MEMCATEGORY_GENERAL)(e);
+                }
+                catch (std::exception& e)
+                {
+                    mException = OGRE_NEW_T(Exception, MEMCATEGORY_GENERAL)(
+                        Exception::ERR_INTERNAL_ERROR, e.what(), "TaskScheduler");
+                }
+                catch (...)
+                {
+                    mException = OGRE_NEW_T(Exception, MEMCATEGORY_GENERAL)(
+                        Exception::ERR_INTERNAL_ERROR, "Unknown exception", "TaskScheduler");
+                }
+#endif
+            }
+
+            /// Throw the kept exception, if any
+            void rethrow(void)
+            {
+                if (!caught())
+                    return;
+#if OGRE_TASK_EXCEPTION_PTR
+                std::rethrow_exception(mException);
+#else
+                throw *mException;
+#endif
+            }
+
+        private:
+            AtomicScalar<size_t> mCaught;
+#if OGRE_TASK_EXCEPTION_PTR
+            std::exception_ptr mException;
+#else
+            Exception* mException;
+#endif
+        };
+
+        /// Chunks of an index range, claimed in order through an atomic counter
+        class ParallelForJob : public TaskScheduler::Job
+        {
+        public:
+            ParallelForJob(ParallelForBody& body, size_t begin, size_t end, size_t grainSize)
+                : mBody(body), mBegin(begin), mEnd(end), mGrainSize(grainSize)
+                , mNumChunks((end - begin + grainSize - 1) / grainSize)
+                , mNextChunk(0), mChunksDone(0)
+            {
+            }
+
+            void work(void)
+            {
+                size_t chunk;
+                while ((chunk = mNextChunk++) < mNumChunks)
+                {
+                    // chunks claimed after an exception are only counted
+                    if (!mError.caught())
+                    {
+                        size_t begin = mBegin + chunk * mGrainSize;
+                        try
+                        {
+                            mBody.execute(begin, std::min(begin + mGrainSize, mEnd));
+                        }
+                        catch (...)
+                        {
+                            mError.capture();
+                        }
+                    }
+
+                    if (++mChunksDone == mNumChunks)
+                    {
+#if OGRE_THREAD_SUPPORT && defined(OGRE_THREAD_WAIT)
+                        OGRE_WQ_LOCK_MUTEX(mDoneMutex);
+                        OGRE_THREAD_NOTIFY_ALL(mDoneSync);
+#endif
+                    }
+                }
+            }
+
+            /// Block until the chunks claimed by other threads are finished
+            void wait(void)
+            {
+#if OGRE_THREAD_SUPPORT
+#   ifdef OGRE_THREAD_WAIT
+                OGRE_WQ_LOCK_MUTEX_NAMED(mDoneMutex, doneLock);
+                while (mChunksDone.load() < mNumChunks)
+                    OGRE_THREAD_WAIT(mDoneSync, mDoneMutex, doneLock);
+#   else
+                while (mChunksDone.load() < mNumChunks)
+                {
+                    OGRE_THREAD_YIELD;
+                }
+#   endif
+#endif
+            }
+
+            /// Throw the first exception of the body on the calling thread, call after wait
+            void rethrow(void) { mError.rethrow(); }
+
+        private:
+            // the body is only used while chunks are left, so the caller
+            // may destroy it as soon as the job is done
+            ParallelForBody& mBody;
+            const size_t mBegin;
+            const size_t mEnd;
+            const size_t mGrainSize;
+            const size_t mNumChunks;
+            AtomicScalar<size_t> mNextChunk;
+            AtomicScalar<size_t> mChunksDone;
+            JobError mError;
+#if OGRE_THREAD_SUPPORT && defined(OGRE_THREAD_WAIT)
+            OGRE_WQ_MUTEX(mDoneMutex);
+            OGRE_WQ_THREAD_SYNCHRONISER(mDoneSync);
+#endif
+        };
+
+        /// Runs the tasks of a graph as soon as their prerequisites are done
+        class GraphJob : public TaskScheduler::Job
+        {
+        public:
+            typedef vector<size_t>::type CountList;
+
+            GraphJob(const TaskGraph::Entry* tasks, size_t numTasks)
+                : mTasks(tasks), mNumTasks(numTasks), mNumDone(0)
+            {
+                mPending.reserve(numTasks);
+                for (size_t i = 0; i < numTasks; ++i)
+                {
+                    mPending.push_back(tasks[i].numPrerequisites);
+                }
+                // the ready list is used as a stack, so push in reverse to
+                // start with the tasks added first
+                for (size_t i = numTasks; i--; )
+                {
+                    if (!mPending[i])
+                        mReady.push_back(i);
+                }
+            }
+
+            /// Helpers leave as soon as no task is ready, instead of blocking a worker
+            void work(void)
+            {
+                execute(false);
+            }
+
+            /// Run tasks until all of them are done, used by the thread owning the graph
+            void workUntilDone(void)
+            {
+                execute(true);
+            }
+
+            /// Throw the first exception of a task on the calling thread, call after workUntilDone
+            void rethrow(void) { mError.rethrow(); }
+
+        private:
+            void execute(bool waitForTasks)
+            {
+                TaskGraph::TaskID id;
+                while (claim(id, waitForTasks))
+                {
+                    // tasks claimed after an exception are only marked done
+                    if (!mError.caught())
+                    {
+                        try
+                        {
+                            mTasks[id].task->execute();
+                        }
+                        catch (...)
+                        {
+                            mError.capture();
+                        }
+                    }
+                    complete(id);
+                }
+            }
+
+            /** Take a task which is ready to run. If all of them are taken by other
+                threads, either waits for one or gives up. Returns false once all tasks
+                are done or when giving up.
+            */
+            bool claim(TaskGraph::TaskID& id, bool waitForTasks)
+            {
+                while (true)
+                {
+                    {
+                        OGRE_WQ_LOCK_MUTEX_NAMED(mMutex, lock);
+#if OGRE_THREAD_SUPPORT && defined(OGRE_THREAD_WAIT)
+                        while (waitForTasks && mReady.empty() && mNumDone < mNumTasks)
+                            OGRE_THREAD_WAIT(mSync, mMutex, lock);
+#endif
+                        if (!mReady.empty())
+                        {
+                            id = mReady.back();
+                            mReady.pop_back();
+                            return true;
+                        }
+                        if (mNumDone == mNumTasks || !waitForTasks)
+                            return false;
+                    }
+                    OGRE_THREAD_YIELD;
+                }
+            }
+
+            /// Release the tasks waiting for the given one
+            void complete(TaskGraph::TaskID id)
+            {
+                OGRE_WQ_LOCK_MUTEX(mMutex);
+                ++mNumDone;
+
+                bool wake = mNumDone == mNumTasks;
+                const TaskGraph::TaskIDList& successors = mTasks[id].successors;
+                for (TaskGraph::TaskIDList::const_iterator i = successors.begin(); i != successors.end(); ++i)
+                {
+                    if (!--mPending[*i])
+                    {
+                        mReady.push_back(*i);
+                        wake = true;
+                    }
+                }
+
+#if OGRE_THREAD_SUPPORT && defined(OGRE_THREAD_WAIT)
+                if (wake)
+                    OGRE_THREAD_NOTIFY_ALL(mSync);
+#else
+                (void)wake;
+#endif
+            }
+
+            // the tasks are only used while some are not done, so the graph
+            // may be destroyed as soon as the job is done
+            const TaskGraph::Entry* mTasks;
+            const size_t mNumTasks;
+            /// Number of prerequisites not done yet per task, guarded by mMutex
+            CountList mPending;
+            /// Tasks which may run, guarded by mMutex
+            TaskGraph::TaskIDList mReady;
+            size_t mNumDone;
+            JobError mError;
+            OGRE_WQ_MUTEX(mMutex);
+#if OGRE_THREAD_SUPPORT && defined(OGRE_THREAD_WAIT)
+            OGRE_WQ_THREAD_SYNCHRONISER(mSync);
+#endif
+        };
+    }
+    //-----------------------------------------------------------------------
+    TaskGraph::TaskID TaskGraph::addTask(Task* task)
+    {
+        Entry entry;
+        entry.task = task;
+        entry.numPrerequisites = 0;
+        mTasks.push_back(entry);
+        return mTasks.size() - 1;
+    }
+    //-----------------------------------------------------------------------
+    void TaskGraph::addDependency(TaskID task, TaskID prerequisite)
+    {
+        assert(task < mTasks.size() && prerequisite < mTasks.size() && task != prerequisite);
+        mTasks[prerequisite].successors.push_back(task);
+        ++mTasks[task].numPrerequisites;
+    }
+    //-----------------------------------------------------------------------
+    TaskScheduler::TaskScheduler(WorkQueue* queue)
+        : mWorkQueue(0)
+        , mWorkQueueChannel(0)
+    {
+        _setWorkQueue(queue);
+    }
+    //-----------------------------------------------------------------------
+    TaskScheduler::~TaskScheduler()
+    {
+        _setWorkQueue(0);
+    }
+    //-----------------------------------------------------------------------
+    void TaskScheduler::_setWorkQueue(WorkQueue* queue)
+    {
+        if (mWorkQueue)
+        {
+            // every job is finished by its caller, nothing pending is needed
+            mWorkQueue->abortPendingRequestsByChannel(mWorkQueueChannel);
+            mWorkQueue->removeRequestHandler(mWorkQueueChannel, this);
+        }
+
+        mWorkQueue = queue;
+
+        if (mWorkQueue)
+        {
+            mWorkQueueChannel = mWorkQueue->getChannel("Ogre/TaskScheduler");
+            mWorkQueue->addRequestHandler(mWorkQueueChannel, this);
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t TaskScheduler::getNumThreads(void) const
+    {
+#if OGRE_THREAD_SUPPORT
+        DefaultWorkQueueBase* defaultQ = dynamic_cast<DefaultWorkQueueBase*>(mWorkQueue);
+        size_t numWorkers = defaultQ ? defaultQ->getWorkerThreadCount() : OGRE_THREAD_HARDWARE_CONCURRENCY;
+        return numWorkers + 1;
+#else
+        return 1;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void TaskScheduler::requestHelp(const SharedPtr<Job>& job, size_t numHelpers)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (!mWorkQueue)
+            return;
+
+        JobRequest req;
+        req.job = job;
+        for (size_t i = 0; i < numHelpers; ++i)
+        {
+            mWorkQueue->addRequest(mWorkQueueChannel, 0, Any(req));
+        }
+#else
+        (void)job;
+        (void)numHelpers;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    WorkQueue::Response* TaskScheduler::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        any_cast<JobRequest>(req->getData()).job->work();
+        // the caller of the job waits for it, so nobody is interested in a
+        // response; mark the request so the queue drops it silently
+        req->abortRequest();
+        return 0;
+    }
+    //-----------------------------------------------------------------------
+    void TaskScheduler::parallelFor(size_t begin, size_t end, size_t grainSize, ParallelForBody& body)
+    {
+        if (end <= begin)
+            return;
+
+        const size_t numThreads = getNumThreads();
+        const size_t count = end - begin;
+        if (!grainSize)
+        {
+            // a few chunks per thread to even out uneven chunk costs
+            grainSize = std::max(count / (numThreads * 4), (size_t)1);
+        }
+
+        if (numThreads == 1 || count <= grainSize)
+        {
+            body.execute(begin, end);
+            return;
+        }
+
+        ParallelForJob* parallelFor = OGRE_NEW ParallelForJob(body, begin, end, grainSize);
+        SharedPtr<Job> job(parallelFor);
+
+        // This thread takes part as well, so one chunk less needs a worker
+        const size_t numChunks = (count + grainSize - 1) / grainSize;
+        requestHelp(job, std::min(numChunks - 1, numThreads - 1));
+
+        parallelFor->work();
+        parallelFor->wait();
+        parallelFor->rethrow();
+    }
+    //-----------------------------------------------------------------------
+    void TaskScheduler::run(const TaskGraph& graph)
+    {
+        const TaskGraph::EntryList& tasks = graph._getTasks();
+        if (tasks.empty())
+            return;
+
+        const size_t numTasks = tasks.size();
+        GraphJob* graphJob = OGRE_NEW GraphJob(&tasks[0], numTasks);
+        SharedPtr<Job> job(graphJob);
+
+        // Helpers leave once no task is ready to run, this thread stays until
+        // all tasks are done
+        requestHelp(job, std::min(numTasks - 1, getNumThreads() - 1));
+
+        graphJob->workUntilDone();
+        graphJob->rethrow();
+    }
+}
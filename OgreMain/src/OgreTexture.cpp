@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include "OgreTexture.h"
 #include "OgreException.h"
 #include "OgreTextureManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
 
 namespace Ogre {
     const char* Texture::CUBEMAP_SUFFIXES[] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
@@ -215,10 +217,31 @@ namespace Ogre {
 
         // The custom mipmaps in the image have priority over everything
         uint32 imageMips = images[0]->getNumMipmaps();
+        const Image* firstImage = images[0];
+
+        // Without hardware generation, filter the mipmaps once up front, which
+        // processes the faces and the rows of large levels in parallel
+        Image generatedMips;
+        RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
+        if(imageMips == 0 && mNumRequestedMipmaps > 0 && (mUsage & TU_AUTOMIPMAP) &&
+           images.size() == 1 && !PixelUtil::isCompressed(mSrcFormat) && renderSystem &&
+           !renderSystem->getCapabilities()->hasCapability(RSC_AUTOMIPMAP))
+        {
+            // the top level is copied, the source image is left untouched. The
+            // levels of sRGB textures are filtered in linear space, as the GPU
+            // samples them
+            generatedMips.loadDynamicImage(const_cast<uchar*>(firstImage->getData()),
+                firstImage->getWidth(), firstImage->getHeight(), firstImage->getDepth(),
+                firstImage->getFormat(), false, firstImage->getNumFaces());
+            generatedMips.generateMipmaps(Image::FILTER_BILINEAR,
+                mHwGamma && !PixelUtil::isFloatingPoint(mSrcFormat), mNumRequestedMipmaps);
+            firstImage = &generatedMips;
+            imageMips = generatedMips.getNumMipmaps();
+        }
 
         if(imageMips > 0)
         {
-            mNumMipmaps = mNumRequestedMipmaps = images[0]->getNumMipmaps();
+            mNumMipmaps = mNumRequestedMipmaps = imageMips;
             // Disable flag for auto mip generation
             mUsage &= ~TU_AUTOMIPMAP;
         }
@@ -298,7 +321,7 @@ namespace Ogre {
                 else
                 {
                     // Load from faces of images[0]
-                    src = images[0]->getPixelBox(i, mip);
+                    src = firstImage->getPixelBox(i, mip);
                 }
     
                 // Sets to treated format in case is difference
@@ -178,6 +178,8 @@ namespace Ogre
             _processNextRequest();
         }
 
+        FrameAllocPolicy::_threadEnded();
+
         LogManager::getSingleton().stream() << 
             "DefaultWorkQueue('" << getName() << "')::WorkerFunc - thread " 
             << OGRE_THREAD_CURRENT_ID << " stopped.";
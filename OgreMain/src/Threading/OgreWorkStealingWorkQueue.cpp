@@ -0,0 +1,624 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreWorkStealingWorkQueue.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreTimer.h"
+
+namespace Ogre
+{
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::WorkStealingWorkQueue(const String& name)
+    : DefaultWorkQueueBase(name)
+    , mNextRequestID(0)
+    , mNextDeque(0)
+    , mNumQueued(0)
+    , mNumIdleQueued(0)
+    , mNumSleeping(0)
+    , mNumThreadsRegisteredWithRS(0)
+    {
+        // requests may be added before startup, so there is always one deque
+        mDeques.push_back(OGRE_NEW WorkerDeque());
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::~WorkStealingWorkQueue()
+    {
+        shutdown();
+
+        clearDeques();
+        for (WorkerDequeList::iterator i = mDeques.begin(); i != mDeques.end(); ++i)
+            OGRE_DELETE *i;
+        mDeques.clear();
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::startup(bool forceRestart)
+    {
+        if (mIsRunning)
+        {
+            if (forceRestart)
+                shutdown();
+            else
+                return;
+        }
+
+        mShuttingDown = false;
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << mName << "') initialising on thread " <<
+            OGRE_THREAD_CURRENT_ID
+            << ".";
+
+        // one deque per worker, keeping the requests which were added already
+        RequestQueue pending;
+        for (WorkerDequeList::iterator i = mDeques.begin(); i != mDeques.end(); ++i)
+        {
+            pending.insert(pending.end(), (*i)->requests.begin(), (*i)->requests.end());
+            OGRE_DELETE *i;
+        }
+        mDeques.clear();
+        size_t numDeques = std::max(mWorkerThreadCount, (size_t)1);
+        for (size_t i = 0; i < numDeques; ++i)
+            mDeques.push_back(OGRE_NEW WorkerDeque());
+        mNumQueued = 0;
+        for (RequestQueue::iterator i = pending.begin(); i != pending.end(); ++i)
+            pushRequest(*i);
+
+#if OGRE_THREAD_SUPPORT
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
+
+        mNumThreadsRegisteredWithRS = 0;
+        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+        {
+            StealingWorkerFunc* func = OGRE_NEW_T(StealingWorkerFunc(this, i), MEMCATEGORY_GENERAL);
+            mWorkerFuncs.push_back(func);
+            OGRE_THREAD_CREATE(t, *func);
+            mWorkers.push_back(t);
+        }
+
+        if (mWorkerRenderSystemAccess)
+        {
+            OGRE_WQ_LOCK_MUTEX_NAMED(mInitMutex, initLock);
+            // have to wait until all threads are registered with the render system
+            while (mNumThreadsRegisteredWithRS < mWorkerThreadCount)
+                OGRE_THREAD_WAIT(mInitSync, mInitMutex, initLock);
+
+            Root::getSingleton().getRenderSystem()->postExtraThreadsStarted();
+        }
+#endif
+
+        mIsRunning = true;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::shutdown()
+    {
+        if( !mIsRunning )
+            return;
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << mName << "') shutting down on thread " <<
+            OGRE_THREAD_CURRENT_ID
+            << ".";
+
+        mShuttingDown = true;
+        abortAllRequests();
+#if OGRE_THREAD_SUPPORT
+        {
+            // workers check the shutdown flag with this mutex held before waiting
+            OGRE_WQ_LOCK_MUTEX(mWaitMutex);
+            OGRE_THREAD_NOTIFY_ALL(mWaitCondition);
+        }
+
+        for (WorkerThreadList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            (*i)->join();
+            OGRE_THREAD_DESTROY(*i);
+        }
+        mWorkers.clear();
+
+        for (WorkerFuncList::iterator i = mWorkerFuncs.begin(); i != mWorkerFuncs.end(); ++i)
+            OGRE_DELETE_T(*i, StealingWorkerFunc, MEMCATEGORY_GENERAL);
+        mWorkerFuncs.clear();
+#endif
+
+        // all remaining requests were aborted and nobody is left to process them
+        clearDeques();
+
+        mIsRunning = false;
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::RequestID WorkStealingWorkQueue::addRequest(uint16 channel, uint16 requestType,
+        const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread)
+    {
+        if (!mAcceptRequests || mShuttingDown)
+            return 0;
+
+        RequestID rid = ++mNextRequestID;
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+
+        LogManager::getSingleton().stream(LML_TRIVIAL) <<
+            "WorkStealingWorkQueue('" << mName << "') - QUEUED(thread:" <<
+            OGRE_THREAD_CURRENT_ID
+            << "): ID=" << rid
+            << " channel=" << channel << " requestType=" << requestType;
+
+        trackRequest(req);
+#if OGRE_THREAD_SUPPORT
+        if (!forceSynchronous)
+        {
+            if (idleThread)
+            {
+                {
+                    OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+                    mIdleRequestQueue.push_back(req);
+                }
+                ++mNumIdleQueued;
+            }
+            else
+            {
+                pushRequest(req);
+            }
+            notifyWorkers();
+            return rid;
+        }
+#endif
+
+        processTrackedRequest(req, true);
+        return rid;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortRequest(RequestID id)
+    {
+        RequestShard& shard = getShard(id);
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+
+        TrackedRequestMap::iterator i = shard.requests.find(id);
+        if (i != shard.requests.end())
+            i->second.request->abortRequest();
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortRequestsByChannel(uint16 channel)
+    {
+        for (size_t s = 0; s < NUM_SHARDS; ++s)
+        {
+            OGRE_WQ_LOCK_MUTEX(mShards[s].mutex);
+            TrackedRequestMap& requests = mShards[s].requests;
+            for (TrackedRequestMap::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (i->second.request->getChannel() == channel)
+                    i->second.request->abortRequest();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortPendingRequestsByChannel(uint16 channel)
+    {
+        for (size_t s = 0; s < NUM_SHARDS; ++s)
+        {
+            OGRE_WQ_LOCK_MUTEX(mShards[s].mutex);
+            TrackedRequestMap& requests = mShards[s].requests;
+            for (TrackedRequestMap::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (!i->second.started && i->second.request->getChannel() == channel)
+                    i->second.request->abortRequest();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortAllRequests()
+    {
+        for (size_t s = 0; s < NUM_SHARDS; ++s)
+        {
+            OGRE_WQ_LOCK_MUTEX(mShards[s].mutex);
+            TrackedRequestMap& requests = mShards[s].requests;
+            for (TrackedRequestMap::iterator i = requests.begin(); i != requests.end(); ++i)
+                i->second.request->abortRequest();
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::processResponses()
+    {
+        unsigned long msStart = Root::getSingleton().getTimer()->getMilliseconds();
+        unsigned long msCurrent = 0;
+
+        // keep going until we run out of responses or out of time
+        while(true)
+        {
+            Response* response = 0;
+            {
+                OGRE_WQ_LOCK_MUTEX(mResponseMutex);
+
+                if (mResponseQueue.empty())
+                    break; // exit loop
+                else
+                {
+                    response = mResponseQueue.front();
+                    mResponseQueue.pop_front();
+                }
+            }
+
+            if (response)
+            {
+                // the request can no longer be aborted once its response is handled
+                untrackRequest(response->getRequest()->getID());
+
+                processResponse(response);
+
+                OGRE_DELETE response;
+            }
+
+            // time limit
+            if (mResposeTimeLimitMS)
+            {
+                msCurrent = Root::getSingleton().getTimer()->getMilliseconds();
+                if (msCurrent - msStart > mResposeTimeLimitMS)
+                    break;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::trackRequest(Request* r)
+    {
+        RequestShard& shard = getShard(r->getID());
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+
+        TrackedRequest& tracked = shard.requests[r->getID()];
+        tracked.request = r;
+        tracked.started = false;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::untrackRequest(RequestID id)
+    {
+        RequestShard& shard = getShard(id);
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+
+        shard.requests.erase(id);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::markStarted(Request* r)
+    {
+        RequestShard& shard = getShard(r->getID());
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+
+        TrackedRequestMap::iterator i = shard.requests.find(r->getID());
+        if (i != shard.requests.end() && i->second.request == r)
+            i->second.started = true;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::pushRequest(Request* r)
+    {
+        WorkerDeque* d = mDeques[(mNextDeque++) % mDeques.size()];
+        {
+            OGRE_WQ_LOCK_MUTEX(d->mutex);
+            d->requests.push_back(r);
+            ++d->size;
+        }
+        // atomic increment, also orders the push before reading mNumSleeping
+        ++mNumQueued;
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Request* WorkStealingWorkQueue::popRequest(size_t workerIndex)
+    {
+        const size_t numDeques = mDeques.size();
+        for (size_t k = 0; k < numDeques; ++k)
+        {
+            WorkerDeque* d = mDeques[(workerIndex + k) % numDeques];
+            if (!d->size.load())
+                continue;
+
+            Request* r = 0;
+            {
+                OGRE_WQ_LOCK_MUTEX(d->mutex);
+                if (d->requests.empty())
+                    continue;
+
+                if (k == 0)
+                {
+                    // own deque, oldest request first
+                    r = d->requests.front();
+                    d->requests.pop_front();
+                }
+                else
+                {
+                    // steal from the other end to keep away from the owner
+                    r = d->requests.back();
+                    d->requests.pop_back();
+                }
+                --d->size;
+            }
+            --mNumQueued;
+            return r;
+        }
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Response* WorkStealingWorkQueue::handleRequest(Request* r)
+    {
+        // only copy the handlers of this channel, to keep the lock short
+        RequestHandlerList handlers;
+        {
+            OGRE_WQ_LOCK_RW_MUTEX_READ(mRequestHandlerMutex);
+
+            RequestHandlerListByChannel::const_iterator i = mRequestHandlers.find(r->getChannel());
+            if (i != mRequestHandlers.end())
+                handlers = i->second;
+        }
+
+        Response* response = 0;
+        for (RequestHandlerList::reverse_iterator j = handlers.rbegin(); j != handlers.rend(); ++j)
+        {
+            // threadsafe call which tests canHandleRequest and calls it if so
+            response = (*j)->handleRequest(r, this);
+
+            if (response)
+                break;
+        }
+        return response;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::processTrackedRequest(Request* r, bool synchronous)
+    {
+        markStarted(r);
+
+        Response* response = handleRequest(r);
+
+        if (response)
+        {
+            const Request* req = response->getRequest();
+            if (!response->succeeded() && req->getRetryCount() && !req->getAborted())
+            {
+                if (!mShuttingDown)
+                {
+                    // retry under the same ID, so it can still be aborted
+                    Request* retry = OGRE_NEW Request(req->getChannel(), req->getType(),
+                        req->getData(), req->getRetryCount() - 1, req->getID());
+                    trackRequest(retry);
+#if OGRE_THREAD_SUPPORT
+                    pushRequest(retry);
+                    notifyWorkers();
+#else
+                    processTrackedRequest(retry, true);
+#endif
+                }
+                else
+                {
+                    untrackRequest(req->getID());
+                }
+                OGRE_DELETE response;
+                return;
+            }
+
+            if (synchronous)
+            {
+                untrackRequest(req->getID());
+                processResponse(response);
+                OGRE_DELETE response;
+            }
+            else
+            {
+                if (req->getAborted())
+                {
+                    // destroy response user data
+                    response->abortRequest();
+                }
+                // Queue response
+                OGRE_WQ_LOCK_MUTEX(mResponseMutex);
+                mResponseQueue.push_back(response);
+                // no need to wake thread, this is processed by the main thread
+            }
+        }
+        else
+        {
+            // no response, delete request
+            if (!r->getAborted())
+            {
+                LogManager::getSingleton().stream() <<
+                    "WorkStealingWorkQueue('" << mName << "') warning: no handler processed request "
+                    << r->getID() << ", channel " << r->getChannel()
+                    << ", type " << r->getType();
+            }
+            untrackRequest(r->getID());
+            OGRE_DELETE r;
+        }
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingWorkQueue::processIdleRequests()
+    {
+        {
+            OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+            if (mIdleRequestQueue.empty() || mIdleThreadRunning)
+                return false;
+            mIdleThreadRunning = true;
+        }
+
+        Request* r = 0;
+        try
+        {
+            while (true)
+            {
+                {
+                    OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+                    if (mIdleRequestQueue.empty())
+                    {
+                        mIdleThreadRunning = false;
+                        return true;
+                    }
+                    r = mIdleRequestQueue.front();
+                    mIdleRequestQueue.pop_front();
+                }
+                --mNumIdleQueued;
+
+                processTrackedRequest(r, false);
+            }
+        }
+        catch (...)
+        {
+            // It is very important to clean up or the idle requests will be locked forever!
+            {
+                OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+                mIdleThreadRunning = false;
+            }
+            LogManager::getSingleton().stream() << "Exception caught in top of worker thread!";
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingWorkQueue::hasWork()
+    {
+        if (mNumQueued.load())
+            return true;
+        if (!mNumIdleQueued.load())
+            return false;
+
+        OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+        return !mIdleThreadRunning;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::waitForRequests()
+    {
+#if OGRE_THREAD_SUPPORT
+        OGRE_WQ_LOCK_MUTEX_NAMED(mWaitMutex, waitLock);
+        // producers only notify if they see a sleeping worker, so announce
+        // ourselves before checking for work
+        ++mNumSleeping;
+        while (!mShuttingDown && !hasWork())
+            OGRE_THREAD_WAIT(mWaitCondition, mWaitMutex, waitLock);
+        --mNumSleeping;
+#endif
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::notifyWorkers()
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mNumSleeping.load())
+        {
+            OGRE_WQ_LOCK_MUTEX(mWaitMutex);
+            OGRE_THREAD_NOTIFY_ONE(mWaitCondition);
+        }
+#endif
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::clearDeques()
+    {
+        for (WorkerDequeList::iterator i = mDeques.begin(); i != mDeques.end(); ++i)
+        {
+            OGRE_WQ_LOCK_MUTEX((*i)->mutex);
+            RequestQueue& requests = (*i)->requests;
+            for (RequestQueue::iterator r = requests.begin(); r != requests.end(); ++r)
+            {
+                untrackRequest((*r)->getID());
+                OGRE_DELETE *r;
+            }
+            requests.clear();
+            (*i)->size = 0;
+        }
+        mNumQueued = 0;
+
+        OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+        for (RequestQueue::iterator r = mIdleRequestQueue.begin(); r != mIdleRequestQueue.end(); ++r)
+        {
+            untrackRequest((*r)->getID());
+            OGRE_DELETE *r;
+        }
+        mIdleRequestQueue.clear();
+        mNumIdleQueued = 0;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::_processNextRequest()
+    {
+        if (processIdleRequests())
+            return;
+
+        Request* r = popRequest(0);
+        if (r)
+            processTrackedRequest(r, false);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::_threadMain()
+    {
+        _threadMain(0);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::_threadMain(size_t workerIndex)
+    {
+#if OGRE_THREAD_SUPPORT
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " starting.";
+
+        // Initialise the thread for RS if necessary
+        if (mWorkerRenderSystemAccess)
+        {
+            Root::getSingleton().getRenderSystem()->registerThread();
+
+            OGRE_WQ_LOCK_MUTEX(mInitMutex);
+            ++mNumThreadsRegisteredWithRS;
+            // wake up main thread
+            OGRE_THREAD_NOTIFY_ALL(mInitSync);
+        }
+
+        // Spin forever until we're told to shut down
+        while (!isShuttingDown())
+        {
+            if (processIdleRequests())
+                continue;
+
+            Request* r = popRequest(workerIndex);
+            if (r)
+                processTrackedRequest(r, false);
+            else
+                waitForRequests();
+        }
+
+        FrameAllocPolicy::_threadEnded();
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " stopped.";
+#else
+        (void)workerIndex;
+#endif
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::StealingWorkerFunc::operator()()
+    {
+        mQueue->_threadMain(mIndex);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::StealingWorkerFunc::operator()() const
+    {
+        mQueue->_threadMain(mIndex);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::StealingWorkerFunc::run()
+    {
+        mQueue->_threadMain(mIndex);
+    }
+}
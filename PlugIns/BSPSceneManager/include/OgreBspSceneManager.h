@@ -127,6 +127,11 @@ namespace Ogre {
         /// @copydoc SceneManager::getTypeName
         const String& getTypeName(void) const;
 
+        /** BSP nodes move their objects between the leaves of the level while
+            being updated, so parallel node update is not supported.
+        */
+        bool isParallelNodeUpdateSupported() const { return false; }
+
         /** Specialised from SceneManager to support Quake3 bsp files. */
         void setWorldGeometry(const String& filename);
 
@@ -84,6 +84,11 @@ public:
     /// @copydoc SceneManager::getTypeName
     const String& getTypeName(void) const;
 
+    /** Octree nodes move themselves within the octree while being updated,
+        so parallel node update is not supported.
+    */
+    bool isParallelNodeUpdateSupported() const { return false; }
+
     /** Initializes the manager to the given box and depth.
     */
     void init( AxisAlignedBox &box, int d );
@@ -76,6 +76,11 @@ namespace Ogre
         /// @copydoc SceneManager::getTypeName
         const String& getTypeName(void) const;
 
+        /** PCZ nodes move between zones while being updated, so parallel node
+            update is not supported.
+        */
+        bool isParallelNodeUpdateSupported() const { return false; }
+
         /** Initializes the manager 
         */
         void init(const String &defaultZoneTypeName,
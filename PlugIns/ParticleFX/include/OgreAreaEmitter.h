@@ -84,6 +84,9 @@ namespace Ogre {
         /** See ParticleEmitter. */
         unsigned short _getEmissionCount(Real timeElapsed);
 
+        /** See ParticleEmitter. */
+        bool _isParallelUpdateSupported(void) const { return true; }
+
         /** Overloaded to update the trans. matrix */
         void setDirection( const Vector3& direction );
 
@@ -86,7 +86,13 @@ namespace Ogre {
         ColourFaderAffector(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed);
+
+        /** See ParticleAffector. */
+        bool _isParticleRangeSupported(void) const { return true; }
+
+        /** See ParticleAffector. */
+        bool _isParallelUpdateSupported(void) const { return true; }
 
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
@@ -128,6 +128,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _isParallelUpdateSupported(void) const { return true; }
+
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
             Sets the adjustment to be made to each of the colour components per second. These
@@ -73,6 +73,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _isParallelUpdateSupported(void) const { return true; }
+
         void setColourAdjust(size_t index, ColourValue colour);
         ColourValue getColourAdjust(size_t index) const;
         
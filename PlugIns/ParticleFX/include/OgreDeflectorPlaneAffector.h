@@ -81,6 +81,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _isParallelUpdateSupported(void) const { return true; }
+
         /** Sets the plane point of the deflector plane. */
         void setPlanePoint(const Vector3& pos);
 
@@ -82,6 +82,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _isParallelUpdateSupported(void) const { return true; }
+
 
         /** Sets the randomness to apply to the particles in a system. */
         void setRandomness(Real force);
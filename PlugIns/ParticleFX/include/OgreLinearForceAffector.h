@@ -83,7 +83,13 @@ namespace Ogre {
         LinearForceAffector(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed);
+
+        /** See ParticleAffector. */
+        bool _isParticleRangeSupported(void) const { return true; }
+
+        /** See ParticleAffector. */
+        bool _isParallelUpdateSupported(void) const { return true; }
 
 
         /** Sets the force vector to apply to the particles in a system. */
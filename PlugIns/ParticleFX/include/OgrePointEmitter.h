@@ -57,6 +57,8 @@ namespace Ogre {
         /** See ParticleEmitter. */
         unsigned short _getEmissionCount(Real timeElapsed);
 
+        /** See ParticleEmitter. */
+        bool _isParallelUpdateSupported(void) const { return true; }
 
 
 
@@ -61,7 +61,13 @@ namespace Ogre {
         ScaleAffector(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed);
+
+        /** See ParticleAffector. */
+        bool _isParticleRangeSupported(void) const { return true; }
+
+        /** See ParticleAffector. */
+        bool _isParallelUpdateSupported(void) const { return true; }
 
         /** Sets the scale adjustment to be made per second to particles. 
         @param rate
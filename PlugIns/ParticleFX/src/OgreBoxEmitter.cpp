@@ -49,9 +49,9 @@ namespace Ogre {
         // Call superclass
         ParticleEmitter::_initParticle(pParticle);
 
-        xOff = Math::SymmetricRandom() * mXRange;
-        yOff = Math::SymmetricRandom() * mYRange;
-        zOff = Math::SymmetricRandom() * mZRange;
+        xOff = genRandomSymmetric() * mXRange;
+        yOff = genRandomSymmetric() * mYRange;
+        zOff = genRandomSymmetric() * mZRange;
 
         pParticle->mPosition = mPosition + xOff + yOff + zOff;
         
@@ -67,27 +67,23 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void ColourFaderAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void ColourFaderAffector::_affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        float dr, dg, db, da;
-
         // Scale adjustments by time
-        dr = mRedAdj * timeElapsed;
-        dg = mGreenAdj * timeElapsed;
-        db = mBlueAdj * timeElapsed;
-        da = mAlphaAdj * timeElapsed;
+        const float dr = mRedAdj * timeElapsed;
+        const float dg = mGreenAdj * timeElapsed;
+        const float db = mBlueAdj * timeElapsed;
+        const float da = mAlphaAdj * timeElapsed;
 
-        while (!pi.end())
+        for (size_t i = 0; i < count; ++i)
         {
-            p = pi.getNext();
-            applyAdjustWithClamp(&p->mColour.r, dr);
-            applyAdjustWithClamp(&p->mColour.g, dg);
-            applyAdjustWithClamp(&p->mColour.b, db);
-            applyAdjustWithClamp(&p->mColour.a, da);
+            // Branch free clamp, the four channels are adjusted alike
+            ColourValue& c = particles[i]->mColour;
+            c.r = std::min(std::max(c.r + dr, 0.0f), 1.0f);
+            c.g = std::min(std::max(c.g + dg, 0.0f), 1.0f);
+            c.b = std::min(std::max(c.b + db, 0.0f), 1.0f);
+            c.a = std::min(std::max(c.a + da, 0.0f), 1.0f);
         }
-
     }
     //-----------------------------------------------------------------------
     void ColourFaderAffector::setAdjust(float red, float green, float blue, float alpha)
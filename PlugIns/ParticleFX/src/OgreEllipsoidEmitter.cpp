@@ -66,9 +66,9 @@ namespace Ogre {
         {
             // three random values for one random point in 3D space
 
-            x = Math::SymmetricRandom();
-            y = Math::SymmetricRandom();
-            z = Math::SymmetricRandom();
+            x = genRandomSymmetric();
+            y = genRandomSymmetric();
+            z = genRandomSymmetric();
 
             // the distance of x,y,z from 0,0,0 is sqrt(x*x+y*y+z*z), but
             // as usual we can omit the sqrt(), since sqrt(1) == 1 and we
@@ -66,33 +66,27 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    void LinearForceAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void LinearForceAffector::_affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-
-        Vector3 scaledVector = Vector3::ZERO;
-
-        // Precalc scaled force for optimisation
+        // Choose the loop once rather than per particle
         if (mForceApplication == FA_ADD)
         {
-            // Scale force by time
-            scaledVector = mForceVector * timeElapsed;
-        }
+            // Precalc force scaled by time for optimisation
+            const Vector3 scaledVector = mForceVector * timeElapsed;
 
-        while (!pi.end())
-        {
-            p = pi.getNext();
-            if (mForceApplication == FA_ADD)
+            for (size_t i = 0; i < count; ++i)
             {
-                p->mDirection += scaledVector;
+                particles[i]->mDirection += scaledVector;
             }
-            else // FA_AVERAGE
+        }
+        else // FA_AVERAGE
+        {
+            for (size_t i = 0; i < count; ++i)
             {
-                p->mDirection = (p->mDirection + mForceVector) / 2;
+                Vector3& dir = particles[i]->mDirection;
+                dir = (dir + mForceVector) / 2;
             }
         }
-        
     }
     //-----------------------------------------------------------------------
     void LinearForceAffector::setForceVector(const Vector3& force)
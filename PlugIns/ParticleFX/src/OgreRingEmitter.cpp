@@ -65,11 +65,11 @@ namespace Ogre {
         // Call superclass
         AreaEmitter::_initParticle(pParticle);
         // create a random angle from 0 .. PI*2
-        Radian alpha ( Math::RangeRandom(0,Math::TWO_PI) );
+        Radian alpha ( genRandomRange(0,Math::TWO_PI) );
   
         // create two random radius values that are bigger than the inner size
-        a = Math::RangeRandom(mInnerSizex,1.0);
-        b = Math::RangeRandom(mInnerSizey,1.0);
+        a = genRandomRange(mInnerSizex,1.0);
+        b = genRandomRange(mInnerSizey,1.0);
 
         // with a and b we have defined a random ellipse inside the inner
         // ellipse and the outer circle (radius 1.0)
@@ -78,7 +78,7 @@ namespace Ogre {
         x = a * Math::Sin(alpha);
         y = b * Math::Cos(alpha);
         // the height is simple -1 to 1
-        z = Math::SymmetricRandom();     
+        z = genRandomSymmetric();     
 
         // scale the found point to the ring's size and move it
         // relatively to the center of the emitter point
@@ -77,11 +77,11 @@ namespace Ogre {
     {
         pParticle->setRotation(
             mRotationRangeStart + 
-            (Math::UnitRandom() * 
+            (mParent->_getRandomUnit() * 
                 (mRotationRangeEnd - mRotationRangeStart)));
         pParticle->mRotationSpeed =
             mRotationSpeedRangeStart + 
-            (Math::UnitRandom() * 
+            (mParent->_getRandomUnit() * 
                 (mRotationSpeedRangeEnd - mRotationSpeedRangeStart));
         
     }
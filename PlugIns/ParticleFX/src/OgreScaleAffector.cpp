@@ -54,35 +54,28 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void ScaleAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void ScaleAffector::_affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        Real ds;
-
         // Scale adjustments by time
-        ds = mScaleAdj * timeElapsed;
+        const Real ds = mScaleAdj * timeElapsed;
 
-        Real NewWide, NewHigh;
+        // Particles without own dimensions all get the same new size
+        const Real defaultWide = mParent->getDefaultWidth() + ds;
+        const Real defaultHigh = mParent->getDefaultHeight() + ds;
 
-        while (!pi.end())
+        for (size_t i = 0; i < count; ++i)
         {
-            p = pi.getNext();
+            Particle* p = particles[i];
 
             if( p->hasOwnDimensions() == false )
             {
-                NewWide = pSystem->getDefaultWidth() + ds;
-                NewHigh = pSystem->getDefaultHeight() + ds;
-
+                p->setDimensions( defaultWide, defaultHigh );
             }
             else
             {
-                NewWide = p->getOwnWidth()  + ds;
-                NewHigh = p->getOwnHeight() + ds;
+                p->setDimensions( p->getOwnWidth() + ds, p->getOwnHeight() + ds );
             }
-            p->setDimensions( NewWide, NewHigh ); 
         }
-
     }
     //-----------------------------------------------------------------------
     void ScaleAffector::setAdjust( Real rate )
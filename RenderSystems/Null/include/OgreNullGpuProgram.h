@@ -0,0 +1,109 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullGpuProgram_H__
+#define __NullGpuProgram_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreGpuProgram.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+
+namespace Ogre {
+
+    /** Assembler program which is never compiled or uploaded.
+    */
+    class _OgreNullExport NullGpuProgram : public GpuProgram
+    {
+    public:
+        NullGpuProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader);
+        ~NullGpuProgram();
+
+        /// Parameters not known to the program are ignored, there is no reflection
+        GpuProgramParametersSharedPtr createParameters(void);
+    protected:
+        /// @copydoc GpuProgram::loadFromSource
+        void loadFromSource(void);
+        /// @copydoc Resource::unloadImpl
+        void unloadImpl(void) {}
+    };
+
+    /** High-level program of any language, its source is kept but not compiled.
+    @remarks
+        The program binds itself, so the render system sees it when the pass is
+        set up. Since the source is not parsed the program has no named constants,
+        its parameters objects ignore all parameters set by name.
+    */
+    class _OgreNullExport NullHighLevelGpuProgram : public HighLevelGpuProgram
+    {
+    public:
+        NullHighLevelGpuProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader,
+            const String& language);
+        ~NullHighLevelGpuProgram();
+
+        /// @copydoc GpuProgram::getLanguage
+        const String& getLanguage(void) const { return mLanguage; }
+        /// @copydoc GpuProgram::_getBindingDelegate
+        GpuProgram* _getBindingDelegate(void) { return this; }
+        /// @copydoc HighLevelGpuProgram::createParameters
+        GpuProgramParametersSharedPtr createParameters(void);
+    protected:
+        /// @copydoc GpuProgram::loadFromSource
+        void loadFromSource(void);
+        /// @copydoc HighLevelGpuProgram::createLowLevelImpl
+        void createLowLevelImpl(void);
+        /// @copydoc HighLevelGpuProgram::unloadHighLevelImpl
+        void unloadHighLevelImpl(void);
+        /// @copydoc HighLevelGpuProgram::buildConstantDefinitions
+        void buildConstantDefinitions() const;
+
+        String mLanguage;
+    };
+
+    /** Factory for NullHighLevelGpuProgram, one is registered per language.
+    */
+    class _OgreNullExport NullHighLevelGpuProgramFactory : public HighLevelGpuProgramFactory
+    {
+    public:
+        NullHighLevelGpuProgramFactory(const String& language);
+        ~NullHighLevelGpuProgramFactory();
+        /// Get the name of the language this factory creates programs for
+        const String& getLanguage(void) const;
+        /// Create an instance of NullHighLevelGpuProgram
+        HighLevelGpuProgram* create(ResourceManager* creator,
+            const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader);
+        void destroy(HighLevelGpuProgram* prog);
+    protected:
+        String mLanguage;
+    };
+
+}
+
+#endif // __NullGpuProgram_H__
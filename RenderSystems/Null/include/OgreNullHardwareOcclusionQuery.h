@@ -0,0 +1,65 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullHardwareOcclusionQuery_H__
+#define __NullHardwareOcclusionQuery_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreHardwareOcclusionQuery.h"
+
+namespace Ogre {
+
+    /** Occlusion query which finishes immediately.
+    @remarks
+        Nothing is rasterised, so the result is the number of vertices the
+        NullRenderSystem was given between begin and end, i.e. everything drawn
+        counts as visible.
+    */
+    class _OgreNullExport NullHardwareOcclusionQuery : public HardwareOcclusionQuery
+    {
+    public:
+        NullHardwareOcclusionQuery(NullRenderSystem* renderSystem);
+        ~NullHardwareOcclusionQuery();
+
+        /// @copydoc HardwareOcclusionQuery::beginOcclusionQuery
+        void beginOcclusionQuery();
+        /// @copydoc HardwareOcclusionQuery::endOcclusionQuery
+        void endOcclusionQuery();
+        /// @copydoc HardwareOcclusionQuery::pullOcclusionQuery
+        bool pullOcclusionQuery(unsigned int* NumOfFragments);
+        /// @copydoc HardwareOcclusionQuery::isStillOutstanding
+        bool isStillOutstanding(void) { return false; }
+
+    protected:
+        NullRenderSystem* mRenderSystem;
+        /// Vertex count of the render system when the query began
+        size_t mBeginVertexCount;
+    };
+
+}
+
+#endif // __NullHardwareOcclusionQuery_H__
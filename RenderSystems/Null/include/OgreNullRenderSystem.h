@@ -0,0 +1,190 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderSystem_H__
+#define __NullRenderSystem_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreRenderSystem.h"
+#include "OgreHardwareBufferManager.h"
+
+namespace Ogre {
+
+    /** Render system which does not render anything.
+    @remarks
+        All calls are accepted and state is tracked as far as OgreMain needs
+        it, but nothing is drawn and no window or graphics context is created.
+        Textures and buffers live in system memory. This allows running the
+        complete frame loop, e.g. for automated tests, dedicated servers or
+        measuring CPU cost, on machines without a GPU or display.
+    @par
+        Draw calls, state changes and similar are counted, see getStatistics.
+    */
+    class _OgreNullExport NullRenderSystem : public RenderSystem
+    {
+    public:
+        /// Counters of the calls made to the render system
+        struct Statistics
+        {
+            size_t drawCalls;
+            /// Vertices (or indices, if indexed) submitted, including instances
+            size_t vertices;
+            size_t stateChanges;
+            size_t programBinds;
+            size_t parameterBinds;
+            size_t textureBinds;
+            size_t renderTargetChanges;
+            size_t clears;
+            size_t frames;
+        };
+
+        NullRenderSystem();
+        ~NullRenderSystem();
+
+        /** Returns the counters, they accumulate until resetStatistics is called.
+        */
+        const Statistics& getStatistics(void) const { return mStatistics; }
+
+        /// Sets all counters to zero
+        void resetStatistics(void);
+
+        const String& getName(void) const;
+        ConfigOptionMap& getConfigOptions(void) { return mOptions; }
+        void setConfigOption(const String &name, const String &value);
+        String validateConfigOptions(void) { return BLANKSTRING; }
+        HardwareOcclusionQuery* createHardwareOcclusionQuery(void);
+        RenderSystemCapabilities* createRenderSystemCapabilities() const;
+        RenderWindow* _initialise(bool autoCreateWindow, const String& windowTitle = "OGRE Render Window");
+        void reinitialise(void);
+        void shutdown(void);
+
+        RenderWindow* _createRenderWindow(const String &name, unsigned int width, unsigned int height,
+            bool fullScreen, const NameValuePairList *miscParams = 0);
+        MultiRenderTarget* createMultiRenderTarget(const String& name);
+        DepthBuffer* _createDepthBufferFor(RenderTarget* renderTarget);
+
+        void _setPointSpritesEnabled(bool enabled) { ++mStatistics.stateChanges; }
+        void _setPointParameters(Real size, bool attenuationEnabled,
+            Real constant, Real linear, Real quadratic, Real minSize, Real maxSize) { ++mStatistics.stateChanges; }
+        void _setTexture(size_t unit, bool enabled, const TexturePtr &texPtr);
+        void _setTextureCoordSet(size_t unit, size_t index) {}
+        void _setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions filter) {}
+        void _setTextureUnitCompareEnabled(size_t unit, bool compare) {}
+        void _setTextureUnitCompareFunction(size_t unit, CompareFunction function) {}
+        void _setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy) {}
+        void _setTextureAddressingMode(size_t unit, const TextureUnitState::UVWAddressingMode& uvw) {}
+        void _setTextureBorderColour(size_t unit, const ColourValue& colour) {}
+        void _setTextureMipmapBias(size_t unit, float bias) {}
+
+        void _setSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor,
+            SceneBlendOperation op = SBO_ADD) { ++mStatistics.stateChanges; }
+        void _setSeparateSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor,
+            SceneBlendFactor sourceFactorAlpha, SceneBlendFactor destFactorAlpha,
+            SceneBlendOperation op = SBO_ADD, SceneBlendOperation alphaOp = SBO_ADD) { ++mStatistics.stateChanges; }
+        void _setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage) { ++mStatistics.stateChanges; }
+        void _setCullingMode(CullingMode mode) { mCullingMode = mode; ++mStatistics.stateChanges; }
+        void _setDepthBufferParams(bool depthTest = true, bool depthWrite = true,
+            CompareFunction depthFunction = CMPF_LESS_EQUAL) { ++mStatistics.stateChanges; }
+        void _setDepthBufferCheckEnabled(bool enabled = true) { ++mStatistics.stateChanges; }
+        void _setDepthBufferWriteEnabled(bool enabled = true) { ++mStatistics.stateChanges; }
+        void _setDepthBufferFunction(CompareFunction func = CMPF_LESS_EQUAL) { ++mStatistics.stateChanges; }
+        void _setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha) { ++mStatistics.stateChanges; }
+        void _setDepthBias(float constantBias, float slopeScaleBias = 0.0f) { ++mStatistics.stateChanges; }
+        void _setPolygonMode(PolygonMode level) { ++mStatistics.stateChanges; }
+        void setStencilCheckEnabled(bool enabled) { ++mStatistics.stateChanges; }
+        void setStencilBufferParams(CompareFunction func = CMPF_ALWAYS_PASS,
+            uint32 refValue = 0, uint32 compareMask = 0xFFFFFFFF, uint32 writeMask = 0xFFFFFFFF,
+            StencilOperation stencilFailOp = SOP_KEEP,
+            StencilOperation depthFailOp = SOP_KEEP,
+            StencilOperation passOp = SOP_KEEP,
+            bool twoSidedOperation = false,
+            bool readBackAsTexture = false) { ++mStatistics.stateChanges; }
+        void setScissorTest(bool enabled, size_t left = 0, size_t top = 0,
+            size_t right = 800, size_t bottom = 600) { ++mStatistics.stateChanges; }
+
+        void _beginFrame(void) {}
+        void _endFrame(void) { ++mStatistics.frames; }
+        void _setViewport(Viewport *vp);
+        void _setRenderTarget(RenderTarget *target);
+        void clearFrameBuffer(unsigned int buffers, const ColourValue& colour = ColourValue::Black,
+            Real depth = 1.0f, unsigned short stencil = 0) { ++mStatistics.clears; }
+        void _render(const RenderOperation& op);
+
+        VertexElementType getColourVertexElementType(void) const { return VET_COLOUR_ABGR; }
+        void _convertProjectionMatrix(const Matrix4& matrix, Matrix4& dest, bool forGpuProgram = false)
+        {
+            dest = matrix;
+        }
+        void _makeProjectionMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+            Matrix4& dest, bool forGpuProgram = false);
+        void _makeProjectionMatrix(Real left, Real right, Real bottom, Real top,
+            Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram = false);
+        void _makeOrthoMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+            Matrix4& dest, bool forGpuProgram = false);
+        void _applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane, bool forGpuProgram);
+
+        void bindGpuProgram(GpuProgram* prg);
+        void unbindGpuProgram(GpuProgramType gptype);
+        void bindGpuProgramParameters(GpuProgramType gptype,
+            GpuProgramParametersSharedPtr params, uint16 variabilityMask) { ++mStatistics.parameterBinds; }
+        void bindGpuProgramPassIterationParameters(GpuProgramType gptype) { ++mStatistics.parameterBinds; }
+
+        Real getHorizontalTexelOffset(void) { return 0.0f; }
+        Real getVerticalTexelOffset(void) { return 0.0f; }
+        Real getMinimumDepthInputValue(void) { return -1.0f; }
+        Real getMaximumDepthInputValue(void) { return 1.0f; }
+
+        void preExtraThreadsStarted() {}
+        void postExtraThreadsStarted() {}
+        void registerThread() {}
+        void unregisterThread() {}
+        unsigned int getDisplayMonitorCount() const { return 1; }
+
+        void beginProfileEvent(const String &eventName) {}
+        void endProfileEvent(void) {}
+        void markProfileEvent(const String &event) {}
+
+        bool hasAnisotropicMipMapFilter() const { return true; }
+
+    protected:
+        void setClipPlanesImpl(const PlaneList& clipPlanes) {}
+        void initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary);
+
+        ConfigOptionMap mOptions;
+        Statistics mStatistics;
+        /// Whether the first window has been created
+        bool mInitialised;
+
+        HardwareBufferManager* mHardwareBufferManager;
+        NullGpuProgramManager* mGpuProgramManager;
+        NullHighLevelGpuProgramFactory* mGLSLProgramFactory;
+        NullHighLevelGpuProgramFactory* mHLSLProgramFactory;
+    };
+
+}
+
+#endif // __NullRenderSystem_H__
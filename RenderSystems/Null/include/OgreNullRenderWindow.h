@@ -0,0 +1,90 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderWindow_H__
+#define __NullRenderWindow_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreRenderWindow.h"
+
+namespace Ogre {
+
+    /** Render window without a native window or surface.
+    @remarks
+        It only keeps track of its size and state, so that viewports and
+        compositors can be set up on it as usual.
+    */
+    class _OgreNullExport NullRenderWindow : public RenderWindow
+    {
+    public:
+        NullRenderWindow();
+        ~NullRenderWindow();
+
+        /// @copydoc RenderWindow::create
+        void create(const String& name, unsigned int widthPt, unsigned int heightPt,
+            bool fullScreen, const NameValuePairList *miscParams);
+        /// @copydoc RenderWindow::setFullscreen
+        void setFullscreen(bool fullScreen, unsigned int widthPt, unsigned int heightPt);
+        /// @copydoc RenderWindow::destroy
+        void destroy(void);
+        /// @copydoc RenderWindow::resize
+        void resize(unsigned int widthPt, unsigned int heightPt);
+        /// @copydoc RenderWindow::reposition
+        void reposition(int leftPt, int topPt);
+        /// @copydoc RenderWindow::isClosed
+        bool isClosed(void) const { return mClosed; }
+        /// @copydoc RenderWindow::isVisible
+        bool isVisible(void) const { return mVisible; }
+        /// @copydoc RenderWindow::setVisible
+        void setVisible(bool visible) { mVisible = visible; }
+        /// @copydoc RenderWindow::isHidden
+        bool isHidden(void) const { return mHidden; }
+        /// @copydoc RenderWindow::setHidden
+        void setHidden(bool hidden) { mHidden = hidden; }
+        /// @copydoc RenderWindow::setVSyncEnabled
+        void setVSyncEnabled(bool vsync) { mVSync = vsync; }
+        /// @copydoc RenderWindow::isVSyncEnabled
+        bool isVSyncEnabled() const { return mVSync; }
+        /// @copydoc RenderTarget::copyContentsToMemory
+        void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer);
+        /// @copydoc RenderTarget::requiresTextureFlipping
+        bool requiresTextureFlipping() const { return false; }
+        /// @copydoc RenderWindow::_notifySurfaceDestroyed
+        void _notifySurfaceDestroyed() {}
+        /// @copydoc RenderWindow::_notifySurfaceCreated
+        void _notifySurfaceCreated(void* nativeWindow, void* config = NULL) {}
+
+    protected:
+        bool mClosed;
+        bool mVisible;
+        bool mHidden;
+        bool mVSync;
+    };
+
+}
+
+#endif // __NullRenderWindow_H__
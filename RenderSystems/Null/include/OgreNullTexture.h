@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullTexture_H__
+#define __NullTexture_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreTexture.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreRenderTexture.h"
+#include "OgreImage.h"
+
+namespace Ogre {
+
+    /** Pixel buffer kept in system memory.
+    @remarks
+        Blits convert and scale on the CPU, so the contents of a texture can
+        be read back after it was loaded.
+    */
+    class _OgreNullExport NullHardwarePixelBuffer : public HardwarePixelBuffer
+    {
+    public:
+        NullHardwarePixelBuffer(const String& baseName, uint32 width, uint32 height, uint32 depth,
+            PixelFormat format, HardwareBuffer::Usage usage);
+        ~NullHardwarePixelBuffer();
+
+        /// @copydoc HardwarePixelBuffer::blitFromMemory
+        void blitFromMemory(const PixelBox &src, const Box &dstBox);
+
+        /// @copydoc HardwarePixelBuffer::blitToMemory
+        void blitToMemory(const Box &srcBox, const PixelBox &dst);
+
+        /// @copydoc HardwarePixelBuffer::getRenderTarget
+        RenderTexture* getRenderTarget(size_t slice = 0);
+
+    protected:
+        /// @copydoc HardwarePixelBuffer::lockImpl
+        PixelBox lockImpl(const Box &lockBox, LockOptions options);
+        /// @copydoc HardwareBuffer::unlockImpl
+        void unlockImpl(void);
+
+        /// The whole surface
+        PixelBox mBuffer;
+
+        typedef vector<RenderTexture*>::type SliceTRT;
+        SliceTRT mSliceTRT;
+    };
+
+    /** Render target for a slice of a NullHardwarePixelBuffer, nothing is drawn to it.
+    */
+    class _OgreNullExport NullRenderTexture : public RenderTexture
+    {
+    public:
+        NullRenderTexture(const String& name, HardwarePixelBuffer* buffer, uint32 zoffset);
+
+        bool requiresTextureFlipping() const { return false; }
+    };
+
+    /** Multiple render target which only keeps track of its surfaces.
+    */
+    class _OgreNullExport NullMultiRenderTarget : public MultiRenderTarget
+    {
+    public:
+        NullMultiRenderTarget(const String& name) : MultiRenderTarget(name) {}
+
+        bool requiresTextureFlipping() const { return false; }
+
+    protected:
+        void bindSurfaceImpl(size_t attachment, RenderTexture* target) {}
+        void unbindSurfaceImpl(size_t attachment) {}
+    };
+
+    /** Texture whose surfaces are NullHardwarePixelBuffer instances.
+    @remarks
+        Images are loaded and converted to the texture format as usual, but
+        mipmaps marked for automatic generation are left empty.
+    */
+    class _OgreNullExport NullTexture : public Texture
+    {
+    public:
+        NullTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader);
+        ~NullTexture();
+
+        /// @copydoc Texture::getBuffer
+        HardwarePixelBufferSharedPtr getBuffer(size_t face = 0, size_t mipmap = 0);
+
+    protected:
+        /// @copydoc Resource::prepareImpl
+        void prepareImpl(void);
+        /// @copydoc Resource::unprepareImpl
+        void unprepareImpl(void);
+        /// @copydoc Resource::loadImpl
+        void loadImpl(void);
+        /// @copydoc Texture::createInternalResourcesImpl
+        void createInternalResourcesImpl(void);
+        /// @copydoc Texture::freeInternalResourcesImpl
+        void freeInternalResourcesImpl(void);
+
+        /// Load an image from the resource group of the texture
+        void readImage(const String& name, const String& ext);
+
+        typedef vector<Image>::type LoadedImages;
+        /// Images read by prepareImpl, consumed by loadImpl
+        LoadedImages mLoadedImages;
+
+        typedef vector<HardwarePixelBufferSharedPtr>::type SurfaceList;
+        SurfaceList mSurfaceList;
+    };
+
+}
+
+#endif // __NullTexture_H__
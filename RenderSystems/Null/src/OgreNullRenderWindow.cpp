@@ -0,0 +1,109 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreNullRenderWindow.h"
+#include "OgreStringConverter.h"
+#include "OgreViewport.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    NullRenderWindow::NullRenderWindow()
+        : mClosed(false), mVisible(true), mHidden(false), mVSync(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    NullRenderWindow::~NullRenderWindow()
+    {
+        destroy();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderWindow::create(const String& name, unsigned int widthPt, unsigned int heightPt,
+        bool fullScreen, const NameValuePairList *miscParams)
+    {
+        mName = name;
+        mWidth = widthPt;
+        mHeight = heightPt;
+        mIsFullScreen = fullScreen;
+        mColourDepth = 32;
+        mClosed = false;
+        mActive = true;
+
+        if (miscParams)
+        {
+            NameValuePairList::const_iterator opt;
+            if ((opt = miscParams->find("left")) != miscParams->end())
+                mLeft = StringConverter::parseInt(opt->second);
+            if ((opt = miscParams->find("top")) != miscParams->end())
+                mTop = StringConverter::parseInt(opt->second);
+            if ((opt = miscParams->find("vsync")) != miscParams->end())
+                mVSync = StringConverter::parseBool(opt->second);
+            if ((opt = miscParams->find("hidden")) != miscParams->end())
+                mHidden = StringConverter::parseBool(opt->second);
+            if ((opt = miscParams->find("FSAA")) != miscParams->end())
+                mFSAA = StringConverter::parseUnsignedInt(opt->second);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderWindow::setFullscreen(bool fullScreen, unsigned int widthPt, unsigned int heightPt)
+    {
+        mIsFullScreen = fullScreen;
+        resize(widthPt, heightPt);
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderWindow::destroy(void)
+    {
+        mClosed = true;
+        mActive = false;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderWindow::resize(unsigned int widthPt, unsigned int heightPt)
+    {
+        mWidth = widthPt;
+        mHeight = heightPt;
+
+        // Notify viewports of resize
+        ViewportList::iterator it = mViewportList.begin();
+        while (it != mViewportList.end())
+            (*it++).second->_updateDimensions();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderWindow::reposition(int leftPt, int topPt)
+    {
+        mLeft = leftPt;
+        mTop = topPt;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderWindow::copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer)
+    {
+        // nothing has been drawn, the contents are black
+        PixelBox black(src.getWidth(), src.getHeight(), src.getDepth(), PF_BYTE_RGBA);
+        vector<uint8>::type data(black.getConsecutiveSize(), 0);
+        black.data = &data[0];
+        PixelUtil::bulkPixelConversion(black, dst);
+    }
+}
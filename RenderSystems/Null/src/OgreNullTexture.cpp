@@ -0,0 +1,271 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreNullTexture.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreTextureManager.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    NullHardwarePixelBuffer::NullHardwarePixelBuffer(const String& baseName,
+        uint32 width, uint32 height, uint32 depth, PixelFormat format, HardwareBuffer::Usage usage)
+        : HardwarePixelBuffer(width, height, depth, format, usage, true, false),
+        mBuffer(width, height, depth, format)
+    {
+        mBuffer.data = OGRE_ALLOC_T(uint8, mSizeInBytes, MEMCATEGORY_RENDERSYS);
+        memset(mBuffer.data, 0, mSizeInBytes);
+
+        if (mUsage & TU_RENDERTARGET)
+        {
+            // Create render target for each slice
+            mSliceTRT.reserve(mDepth);
+            for (uint32 zoffset = 0; zoffset < mDepth; ++zoffset)
+            {
+                String name = "rtt/" + StringConverter::toString((size_t)this) + "/" + baseName;
+                if (mDepth > 1)
+                    name += "/" + StringConverter::toString(zoffset);
+                RenderTexture* trt = OGRE_NEW NullRenderTexture(name, this, zoffset);
+                mSliceTRT.push_back(trt);
+                Root::getSingleton().getRenderSystem()->attachRenderTarget(*trt);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    NullHardwarePixelBuffer::~NullHardwarePixelBuffer()
+    {
+        // Delete all render targets that are not yet deleted via _clearSliceRTT because the rendertarget
+        // was deleted by the user.
+        for (SliceTRT::const_iterator it = mSliceTRT.begin(); it != mSliceTRT.end(); ++it)
+        {
+            Root::getSingleton().getRenderSystem()->destroyRenderTarget((*it)->getName());
+        }
+
+        OGRE_FREE(mBuffer.data, MEMCATEGORY_RENDERSYS);
+    }
+    //-----------------------------------------------------------------------
+    PixelBox NullHardwarePixelBuffer::lockImpl(const Box &lockBox, LockOptions options)
+    {
+        return mBuffer.getSubVolume(lockBox);
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::unlockImpl(void)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitFromMemory(const PixelBox &src, const Box &dstBox)
+    {
+        if (!mBuffer.contains(dstBox))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Destination box out of range",
+                "NullHardwarePixelBuffer::blitFromMemory");
+        }
+
+        PixelBox dst = mBuffer.getSubVolume(dstBox);
+        if (src.getWidth() == dst.getWidth() && src.getHeight() == dst.getHeight() &&
+            src.getDepth() == dst.getDepth())
+        {
+            PixelUtil::bulkPixelConversion(src, dst);
+        }
+        else
+        {
+            Image::scale(src, dst);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitToMemory(const Box &srcBox, const PixelBox &dst)
+    {
+        if (!mBuffer.contains(srcBox))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Source box out of range",
+                "NullHardwarePixelBuffer::blitToMemory");
+        }
+
+        PixelBox src = mBuffer.getSubVolume(srcBox);
+        if (src.getWidth() == dst.getWidth() && src.getHeight() == dst.getHeight() &&
+            src.getDepth() == dst.getDepth())
+        {
+            PixelUtil::bulkPixelConversion(src, dst);
+        }
+        else
+        {
+            Image::scale(src, dst);
+        }
+    }
+    //-----------------------------------------------------------------------
+    RenderTexture* NullHardwarePixelBuffer::getRenderTarget(size_t zoffset)
+    {
+        assert(mUsage & TU_RENDERTARGET);
+        assert(zoffset < mDepth);
+        return mSliceTRT[zoffset];
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    NullRenderTexture::NullRenderTexture(const String& name, HardwarePixelBuffer* buffer,
+        uint32 zoffset)
+        : RenderTexture(buffer, zoffset)
+    {
+        mName = name;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    NullTexture::NullTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+        const String& group, bool isManual, ManualResourceLoader* loader)
+        : Texture(creator, name, handle, group, isManual, loader)
+    {
+    }
+    //-----------------------------------------------------------------------
+    NullTexture::~NullTexture()
+    {
+        // have to call this here rather than in Resource destructor
+        // since calling virtual methods in base destructors causes crash
+        if (isLoaded())
+        {
+            unload();
+        }
+        else
+        {
+            freeInternalResources();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::readImage(const String& name, const String& ext)
+    {
+        mLoadedImages.push_back(Image());
+        DataStreamPtr dstream = ResourceGroupManager::getSingleton().openResource(name, mGroup, this);
+        mLoadedImages.back().load(dstream, ext);
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::prepareImpl(void)
+    {
+        if (mUsage & TU_RENDERTARGET)
+            return;
+
+        String baseName, ext;
+        StringUtil::splitBaseFilename(mName, baseName, ext);
+
+        if (mTextureType == TEX_TYPE_CUBE_MAP && getSourceFileType() != "dds")
+        {
+            for (size_t i = 0; i < 6; i++)
+            {
+                String fullName = baseName + CUBEMAP_SUFFIXES[i];
+                if (!ext.empty())
+                    fullName = fullName + "." + ext;
+                readImage(fullName, ext);
+            }
+        }
+        else
+        {
+            readImage(mName, ext);
+
+            if (mLoadedImages[0].hasFlag(IF_CUBEMAP))
+                mTextureType = TEX_TYPE_CUBE_MAP;
+            if (mLoadedImages[0].getDepth() > 1 && mTextureType != TEX_TYPE_2D_ARRAY)
+                mTextureType = TEX_TYPE_3D;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::unprepareImpl(void)
+    {
+        mLoadedImages.clear();
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::loadImpl(void)
+    {
+        if (mUsage & TU_RENDERTARGET)
+        {
+            createInternalResources();
+            return;
+        }
+
+        // Now the only copy is on the stack and will be cleaned in case of
+        // exceptions being thrown from _loadImages
+        LoadedImages loadedImages;
+        std::swap(loadedImages, mLoadedImages);
+
+        ConstImagePtrList imagePtrs;
+        for (size_t i = 0; i < loadedImages.size(); ++i)
+        {
+            imagePtrs.push_back(&loadedImages[i]);
+        }
+
+        _loadImages(imagePtrs);
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::createInternalResourcesImpl(void)
+    {
+        mFormat = TextureManager::getSingleton().getNativeFormat(mTextureType, mFormat, mUsage);
+
+        // Clamp the number of mipmaps to what the size allows
+        uint32 maxMips = static_cast<uint32>(Math::Log2(static_cast<Real>(
+            std::max(mWidth, std::max(mHeight, mDepth)))));
+        mNumMipmaps = std::min(mNumRequestedMipmaps, maxMips);
+        // Mipmaps are "generated" by the device, i.e. left as they are
+        mMipmapsHardwareGenerated = true;
+
+        mSurfaceList.clear();
+        for (size_t face = 0; face < getNumFaces(); ++face)
+        {
+            uint32 width = mWidth, height = mHeight, depth = mDepth;
+            for (uint32 mip = 0; mip <= mNumMipmaps; ++mip)
+            {
+                mSurfaceList.push_back(HardwarePixelBufferSharedPtr(OGRE_NEW NullHardwarePixelBuffer(
+                    mName, width, height, depth, mFormat, static_cast<HardwareBuffer::Usage>(mUsage))));
+
+                if (width > 1) width /= 2;
+                if (height > 1) height /= 2;
+                if (depth > 1 && mTextureType != TEX_TYPE_2D_ARRAY) depth /= 2;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::freeInternalResourcesImpl(void)
+    {
+        mSurfaceList.clear();
+    }
+    //-----------------------------------------------------------------------
+    HardwarePixelBufferSharedPtr NullTexture::getBuffer(size_t face, size_t mipmap)
+    {
+        if (face >= getNumFaces())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Face index out of range",
+                "NullTexture::getBuffer");
+        }
+        if (mipmap > mNumMipmaps)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Mipmap index out of range",
+                "NullTexture::getBuffer");
+        }
+
+        size_t idx = face * (mNumMipmaps + 1) + mipmap;
+        assert(idx < mSurfaceList.size());
+        return mSurfaceList[idx];
+    }
+}
@@ -0,0 +1,401 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreNullPlugin.h"
+#include "OgreRoot.h"
+#include "OgreRenderWindow.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreTextureManager.h"
+#include "OgreTextureUnitState.h"
+#include "OgreTaskScheduler.h"
+#include "OgreStringConverter.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+#include "OgreConfigFile.h"
+#include "OgreArchiveManager.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreShaderGenerator.h"
+#include "OgreShaderProgramManager.h"
+
+#include <gtest/gtest.h>
+#include <fstream>
+
+using namespace Ogre;
+
+namespace {
+    /// The GPU programs generated for a pass
+    struct GeneratedPrograms
+    {
+        GpuProgram* vertexProgram;
+        GpuProgram* fragmentProgram;
+        String vertexName;
+        String fragmentName;
+        String vertexSource;
+        String fragmentSource;
+    };
+
+    class RTShaderSystemTests : public ::testing::Test
+    {
+    public:
+        void SetUp()
+        {
+            mFSLayer = OGRE_NEW_T(FileSystemLayer, MEMCATEGORY_GENERAL)(OGRE_VERSION_NAME);
+            mRoot = OGRE_NEW Root("");
+            mRoot->installPlugin(&mPlugin);
+            mRoot->setRenderSystem(mRoot->getRenderSystemByName("Null Rendering Subsystem"));
+            mRoot->initialise(true);
+
+            mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+            mSceneMgr->createLight("Light");
+
+            // The GLSL processor loads the shader library when binding the programs
+            ConfigFile cf;
+            cf.load(mFSLayer->getConfigFilePath("resources.cfg"));
+
+            ConfigFile::SettingsBySection_::const_iterator seci;
+            for (seci = cf.getSettingsBySection().begin(); seci != cf.getSettingsBySection().end(); ++seci)
+            {
+                ConfigFile::SettingsMultiMap::const_iterator i;
+                for (i = seci->second.begin(); i != seci->second.end(); ++i)
+                {
+                    if (mMediaPath.empty() && i->first == "FileSystem" && StringUtil::endsWith(i->second, "/media"))
+                        mMediaPath = i->second;
+                }
+            }
+            ResourceGroupManager::getSingleton().addResourceLocation(mMediaPath + "/RTShaderLib/GLSL", "FileSystem");
+            ResourceGroupManager::getSingleton().initialiseAllResourceGroups();
+
+            ASSERT_TRUE(RTShader::ShaderGenerator::initialize());
+            RTShader::ShaderGenerator::getSingleton().addSceneManager(mSceneMgr);
+        }
+
+        void TearDown()
+        {
+            RTShader::ShaderGenerator::destroy();
+            OGRE_DELETE mRoot;
+            OGRE_DELETE_T(mFSLayer, FileSystemLayer, MEMCATEGORY_GENERAL);
+        }
+
+        /// Destroy the generator and create a new one, which starts with an empty program cache
+        void restartGenerator()
+        {
+            RTShader::ShaderGenerator::destroy();
+            ASSERT_TRUE(RTShader::ShaderGenerator::initialize());
+            RTShader::ShaderGenerator::getSingleton().addSceneManager(mSceneMgr);
+        }
+
+        /// Create an empty shader cache directory, returns its path
+        String createShaderCache()
+        {
+            String cachePath = "RTShaderSystemTestCache/";
+            FileSystemLayer::createDirectory(cachePath);
+            clearShaderCache(cachePath);
+            return cachePath;
+        }
+
+        void clearShaderCache(const String& cachePath)
+        {
+            Archive* arch = ArchiveManager::getSingleton().load(cachePath, "FileSystem", false);
+            StringVectorPtr files = arch->list(false);
+            for (StringVector::iterator i = files->begin(); i != files->end(); ++i)
+                FileSystemLayer::removeFile(cachePath + *i);
+            ArchiveManager::getSingleton().unload(arch);
+        }
+
+        void destroyShaderCache(const String& cachePath)
+        {
+            // The generator writes the index when it is destroyed
+            RTShader::ShaderGenerator::destroy();
+            clearShaderCache(cachePath);
+            FileSystemLayer::removeDirectory(cachePath);
+        }
+
+        /// A single pass material, materials with the same arguments only differ in colour
+        MaterialPtr createMaterial(const String& name, bool lighting, const ColourValue& colour)
+        {
+            MaterialPtr mat = MaterialManager::getSingleton().create(name,
+                ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+            Pass* pass = mat->getTechnique(0)->getPass(0);
+            pass->setLightingEnabled(lighting);
+            pass->setDiffuse(colour);
+            pass->setAmbient(colour);
+            return mat;
+        }
+
+        /// Generate the programs of the default scheme for the given materials
+        void generatePrograms(const vector<MaterialPtr>::type& materials,
+            vector<GeneratedPrograms>::type& programs)
+        {
+            RTShader::ShaderGenerator& generator = RTShader::ShaderGenerator::getSingleton();
+
+            for (size_t i = 0; i < materials.size(); ++i)
+            {
+                ASSERT_TRUE(generator.createShaderBasedTechnique(*materials[i],
+                    MaterialManager::DEFAULT_SCHEME_NAME, RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME));
+            }
+            ASSERT_TRUE(generator.validateScheme(RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME));
+
+            programs.clear();
+            for (size_t i = 0; i < materials.size(); ++i)
+            {
+                Pass* pass = NULL;
+                for (unsigned short t = 0; t < materials[i]->getNumTechniques(); ++t)
+                {
+                    Technique* tech = materials[i]->getTechnique(t);
+                    if (tech->getSchemeName() == RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME)
+                        pass = tech->getPass(0);
+                }
+                ASSERT_TRUE(pass && pass->hasVertexProgram() && pass->hasFragmentProgram());
+
+                GeneratedPrograms generated;
+                generated.vertexProgram = pass->getVertexProgram().get();
+                generated.fragmentProgram = pass->getFragmentProgram().get();
+                generated.vertexName = generated.vertexProgram->getName();
+                generated.fragmentName = generated.fragmentProgram->getName();
+                generated.vertexSource = generated.vertexProgram->getSource();
+                generated.fragmentSource = generated.fragmentProgram->getSource();
+                programs.push_back(generated);
+            }
+        }
+
+        FileSystemLayer* mFSLayer;
+        NullPlugin mPlugin;
+        Root* mRoot;
+        SceneManager* mSceneMgr;
+        String mMediaPath;
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, ProgramsBySignature)
+{
+    vector<MaterialPtr>::type materials;
+    materials.push_back(createMaterial("LitRed", true, ColourValue::Red));
+    materials.push_back(createMaterial("LitBlue", true, ColourValue::Blue));
+    materials.push_back(createMaterial("Unlit", false, ColourValue::Red));
+
+    RTShader::ProgramManager& programMgr = RTShader::ProgramManager::getSingleton();
+    programMgr.resetProgramCacheStatistics();
+
+    vector<GeneratedPrograms>::type programs;
+    generatePrograms(materials, programs);
+    ASSERT_EQ(materials.size(), programs.size());
+
+    // Equal fixed function states share their programs, the source is only generated once
+    const RTShader::ProgramManager::ProgramCacheStatistics& stats = programMgr.getProgramCacheStatistics();
+    EXPECT_EQ(1u, stats.numHits);
+    EXPECT_EQ(2u, stats.numMisses);
+    EXPECT_EQ(0u, stats.numShaderCacheHits);
+    EXPECT_EQ(0u, stats.numUncacheable);
+
+    EXPECT_EQ(programs[0].vertexProgram, programs[1].vertexProgram);
+    EXPECT_EQ(programs[0].fragmentProgram, programs[1].fragmentProgram);
+    EXPECT_NE(programs[0].vertexProgram, programs[2].vertexProgram);
+    EXPECT_NE(programs[0].vertexSource, programs[2].vertexSource);
+    EXPECT_EQ(2u, RTShader::ShaderGenerator::getSingleton().getVertexShaderCount());
+
+    // Regenerating an invalidated scheme finds the programs by their signature
+    RTShader::ShaderGenerator& generator = RTShader::ShaderGenerator::getSingleton();
+    generator.invalidateScheme(RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME);
+    programMgr.resetProgramCacheStatistics();
+    vector<GeneratedPrograms>::type regenerated;
+    generatePrograms(materials, regenerated);
+
+    EXPECT_EQ(3u, stats.numHits);
+    EXPECT_EQ(0u, stats.numMisses);
+    for (size_t i = 0; i < programs.size(); ++i)
+    {
+        EXPECT_EQ(programs[i].vertexProgram, regenerated[i].vertexProgram);
+        EXPECT_EQ(programs[i].fragmentProgram, regenerated[i].fragmentProgram);
+    }
+
+    // Removing the techniques destroys the programs, their signatures must not be found anymore
+    generator.removeAllShaderBasedTechniques();
+    EXPECT_EQ(0u, generator.getVertexShaderCount());
+    programMgr.resetProgramCacheStatistics();
+    generatePrograms(materials, regenerated);
+
+    EXPECT_EQ(1u, stats.numHits);
+    EXPECT_EQ(2u, stats.numMisses);
+    for (size_t i = 0; i < programs.size(); ++i)
+    {
+        EXPECT_EQ(programs[i].vertexSource, regenerated[i].vertexSource);
+        EXPECT_EQ(programs[i].fragmentSource, regenerated[i].fragmentSource);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, BatchedMatchesSerial)
+{
+    TextureManager::getSingleton().createManual("RTSSTexture", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+        TEX_TYPE_2D, 4, 4, 0, PF_R8G8B8A8);
+
+    // Some states repeat, so the batch holds hits as well as misses
+    vector<MaterialPtr>::type materials;
+    for (int i = 0; i < 16; ++i)
+    {
+        MaterialPtr mat = createMaterial("Batched" + StringConverter::toString(i), i % 2 == 0,
+            ColourValue(i / 16.0f, 0, 0));
+        Pass* pass = mat->getTechnique(0)->getPass(0);
+        for (int t = 0; t < i % 3; ++t)
+            pass->createTextureUnitState("RTSSTexture")->setEnvironmentMap(i >= 8);
+        if (i % 4 == 1)
+            pass->setVertexColourTracking(TVC_DIFFUSE);
+        if (i % 5 == 3)
+            pass->setFog(true, FOG_LINEAR);
+        materials.push_back(mat);
+    }
+
+    RTShader::ProgramManager::ProgramCacheStatistics stats[2];
+    vector<GeneratedPrograms>::type programs[2];
+    DefaultWorkQueueBase* wq = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+
+    for (int batched = 0; batched < 2; ++batched)
+    {
+        // Without worker threads the render states are acquired one after the other
+        wq->setWorkerThreadCount(batched ? 3 : 0);
+        wq->startup(true);
+        ASSERT_EQ(batched ? 4u : 1u, TaskScheduler::getSingleton().getNumThreads());
+
+        // Start from scratch
+        RTShader::ShaderGenerator::destroy();
+        ASSERT_TRUE(RTShader::ShaderGenerator::initialize());
+        RTShader::ShaderGenerator::getSingleton().addSceneManager(mSceneMgr);
+
+        generatePrograms(materials, programs[batched]);
+        stats[batched] = RTShader::ProgramManager::getSingleton().getProgramCacheStatistics();
+    }
+
+    EXPECT_EQ(stats[0].numHits, stats[1].numHits);
+    EXPECT_EQ(stats[0].numMisses, stats[1].numMisses);
+    EXPECT_EQ(stats[0].numUncacheable, stats[1].numUncacheable);
+    EXPECT_LT(0u, stats[1].numHits);
+
+    ASSERT_EQ(programs[0].size(), programs[1].size());
+    for (size_t i = 0; i < programs[0].size(); ++i)
+    {
+        EXPECT_EQ(programs[0][i].vertexName, programs[1][i].vertexName);
+        EXPECT_EQ(programs[0][i].fragmentName, programs[1][i].fragmentName);
+        EXPECT_EQ(programs[0][i].vertexSource, programs[1][i].vertexSource);
+        EXPECT_EQ(programs[0][i].fragmentSource, programs[1][i].fragmentSource);
+    }
+    wq->shutdown();
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, ShaderCacheIndex)
+{
+    vector<MaterialPtr>::type materials;
+    materials.push_back(createMaterial("LitRed", true, ColourValue::Red));
+    materials.push_back(createMaterial("LitBlue", true, ColourValue::Blue));
+    materials.push_back(createMaterial("Unlit", false, ColourValue::Red));
+    const String cachePath = createShaderCache();
+
+    RTShader::ShaderGenerator::getSingleton().setShaderCachePath(cachePath);
+    vector<GeneratedPrograms>::type programs;
+    generatePrograms(materials, programs);
+    EXPECT_EQ(2u, RTShader::ProgramManager::getSingleton().getProgramCacheStatistics().numMisses);
+
+    // The index is written when the generator is destroyed, the next one reads the
+    // source of the known render states from the cache
+    restartGenerator();
+    RTShader::ShaderGenerator::getSingleton().setShaderCachePath(cachePath);
+    vector<GeneratedPrograms>::type cached;
+    generatePrograms(materials, cached);
+
+    const RTShader::ProgramManager::ProgramCacheStatistics& stats =
+        RTShader::ProgramManager::getSingleton().getProgramCacheStatistics();
+    EXPECT_EQ(2u, stats.numShaderCacheHits);
+    EXPECT_EQ(1u, stats.numHits);
+    EXPECT_EQ(0u, stats.numMisses);
+
+    ASSERT_EQ(programs.size(), cached.size());
+    for (size_t i = 0; i < programs.size(); ++i)
+    {
+        EXPECT_EQ(programs[i].vertexName, cached[i].vertexName);
+        EXPECT_EQ(programs[i].fragmentName, cached[i].fragmentName);
+        EXPECT_EQ(programs[i].vertexSource, cached[i].vertexSource);
+        EXPECT_EQ(programs[i].fragmentSource, cached[i].fragmentSource);
+    }
+
+    destroyShaderCache(cachePath);
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, ShaderCacheInvalidation)
+{
+    vector<MaterialPtr>::type materials;
+    materials.push_back(createMaterial("Lit", true, ColourValue::Red));
+    materials.push_back(createMaterial("Unlit", false, ColourValue::Red));
+    const String cachePath = createShaderCache();
+
+    RTShader::ShaderGenerator::getSingleton().setShaderCachePath(cachePath);
+    vector<GeneratedPrograms>::type programs;
+    generatePrograms(materials, programs);
+
+    // Source generated for other profiles is not used
+    restartGenerator();
+    RTShader::ShaderGenerator& generator = RTShader::ShaderGenerator::getSingleton();
+    const String vertexProfiles = generator.getVertexShaderProfiles();
+    generator.setVertexShaderProfiles("vs_3_0");
+    generator.setShaderCachePath(cachePath);
+    generatePrograms(materials, programs);
+
+    const RTShader::ProgramManager::ProgramCacheStatistics& stats =
+        RTShader::ProgramManager::getSingleton().getProgramCacheStatistics();
+    EXPECT_EQ(0u, stats.numShaderCacheHits);
+    EXPECT_EQ(2u, stats.numMisses);
+
+    // Changing the profiles on the fly starts a new index, which the next run reads
+    generator.setVertexShaderProfiles(vertexProfiles);
+    generator.removeAllShaderBasedTechniques();
+    RTShader::ProgramManager::getSingleton().resetProgramCacheStatistics();
+    generatePrograms(materials, programs);
+    EXPECT_EQ(0u, stats.numShaderCacheHits);
+    EXPECT_EQ(2u, stats.numMisses);
+
+    restartGenerator();
+    RTShader::ShaderGenerator::getSingleton().setShaderCachePath(cachePath);
+    generatePrograms(materials, programs);
+    EXPECT_EQ(2u, RTShader::ProgramManager::getSingleton().getProgramCacheStatistics().numShaderCacheHits);
+
+    // Edited source does not match the program name, it is generated again
+    std::ofstream edited((cachePath + programs[1].fragmentName + ".glsl").c_str());
+    edited << "// edited\n" << programs[1].fragmentSource;
+    edited.close();
+
+    restartGenerator();
+    RTShader::ShaderGenerator::getSingleton().setShaderCachePath(cachePath);
+    generatePrograms(materials, programs);
+    EXPECT_EQ(1u, RTShader::ProgramManager::getSingleton().getProgramCacheStatistics().numShaderCacheHits);
+    EXPECT_EQ(1u, RTShader::ProgramManager::getSingleton().getProgramCacheStatistics().numMisses);
+
+    destroyShaderCache(cachePath);
+}
+//--------------------------------------------------------------------------
@@ -41,6 +41,7 @@ protected:
     String mTestPath;
     size_t mFileSizeRoot1;
     size_t mFileSizeRoot2;
+    bool mMemoryMapping;
 
 public:
     void SetUp();
@@ -47,6 +47,7 @@ protected:
     SkeletonPtr mSkeleton;
     Real mErrorFactor;
     FileSystemLayer* mFSLayer;
+    bool mMemoryMapping;
 
 public:
     void SetUp();
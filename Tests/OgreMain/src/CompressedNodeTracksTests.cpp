@@ -0,0 +1,285 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <fstream>
+
+#include "OgreRoot.h"
+#include "OgreSkeleton.h"
+#include "OgreSkeletonManager.h"
+#include "OgreSkeletonSerializer.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreBone.h"
+#include "OgreCompressedNodeTracks.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+using namespace Ogre;
+
+namespace {
+    const unsigned short NUM_BONES = 50;
+    const unsigned short NUM_KEYS = 100;
+    const Real LENGTH = 4;
+
+    /** Creates a skeleton with a chain of bones and a looping animation
+        made of smooth curves, some tracks leaving channels at identity.
+    */
+    SkeletonPtr createSkeleton(const String& name)
+    {
+        SkeletonPtr skel = SkeletonManager::getSingleton().create(name,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            Bone* bone = skel->createBone(b);
+            bone->setPosition(0, 1, 0);
+            if (b)
+                skel->getBone(b - 1)->addChild(bone);
+        }
+        skel->setBindingPose();
+
+        Animation* anim = skel->createAnimation("Walk", LENGTH);
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            NodeAnimationTrack* track = anim->createNodeTrack(b, skel->getBone(b));
+            Real phase = b * 0.37f;
+            for (unsigned short k = 0; k < NUM_KEYS; ++k)
+            {
+                Real t = LENGTH * k / NUM_KEYS;
+                TransformKeyFrame* kf = track->createNodeKeyFrame(t);
+                Real s = Math::Sin(Radian(Math::TWO_PI * t / LENGTH + phase));
+                kf->setRotation(Quaternion(Radian(s * (1 + b % 3)),
+                    Vector3(s, 1, Math::Cos(Radian(phase))).normalisedCopy()));
+                if (b % 4)
+                    kf->setTranslate(Vector3(s * 0.1f, b * 0.01f, 0.5f));
+                if (b % 5 == 0)
+                    kf->setScale(Vector3(1 + s * 0.2f, 1, 1));
+            }
+        }
+        return skel;
+    }
+
+    struct Pose
+    {
+        vector<Quaternion>::type rotations;
+        vector<Vector3>::type positions;
+        vector<Vector3>::type scales;
+    };
+
+    Pose samplePose(Skeleton* skel, Animation* anim, Real time, Real weight,
+        const AnimationState::BoneBlendMask* mask = 0)
+    {
+        skel->reset();
+        if (mask)
+            anim->apply(skel, time, weight, mask, 1.0f);
+        else
+            anim->apply(skel, time, weight);
+
+        Pose pose;
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            pose.rotations.push_back(skel->getBone(b)->getOrientation());
+            pose.positions.push_back(skel->getBone(b)->getPosition());
+            pose.scales.push_back(skel->getBone(b)->getScale());
+        }
+        return pose;
+    }
+
+    void expectNear(const Pose& expected, const Pose& actual, Real time)
+    {
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            EXPECT_TRUE(expected.rotations[b].equals(actual.rotations[b], Degree(0.1f)))
+                << "bone " << b << " at " << time;
+            EXPECT_TRUE(expected.positions[b].positionEquals(actual.positions[b], 2e-3f))
+                << "bone " << b << " at " << time;
+            EXPECT_TRUE(expected.scales[b].positionEquals(actual.scales[b], 2e-3f))
+                << "bone " << b << " at " << time;
+        }
+    }
+
+    size_t keyFrameMemory(Animation* anim)
+    {
+        size_t memSize = 0;
+        Animation::NodeTrackIterator it = anim->getNodeTrackIterator();
+        while (it.hasMoreElements())
+        {
+            NodeAnimationTrack* track = it.getNext();
+            memSize += sizeof(NodeAnimationTrack) +
+                track->getNumKeyFrames() * (sizeof(TransformKeyFrame) + sizeof(KeyFrame*));
+        }
+        return memSize;
+    }
+}
+
+class CompressedNodeTracksTests : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        mRoot = OGRE_NEW Root("");
+        mSkeleton = createSkeleton("Compressed");
+        mReference = mSkeleton->getAnimation("Walk")->clone("Reference");
+    }
+
+    void TearDown()
+    {
+        OGRE_DELETE mReference;
+        mSkeleton.reset();
+        OGRE_DELETE mRoot;
+    }
+
+    Root* mRoot;
+    SkeletonPtr mSkeleton;
+    /// Copy of the animation before compression
+    Animation* mReference;
+};
+
+TEST_F(CompressedNodeTracksTests, MatchesKeyFrames)
+{
+    Animation* anim = mSkeleton->getAnimation("Walk");
+    size_t originalSize = keyFrameMemory(anim);
+    anim->compressNodeTracks();
+
+    const CompressedNodeTracks* tracks = anim->getCompressedNodeTracks();
+    ASSERT_TRUE(tracks != 0);
+    EXPECT_EQ(size_t(NUM_BONES), tracks->getNumTracks());
+    EXPECT_EQ(0u, anim->getNumNodeTracks());
+    EXPECT_LT(tracks->getMemoryUsage() * 3, originalSize);
+
+    AnimationState::BoneBlendMask mask(NUM_BONES);
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+        mask[b] = b % 2 ? 0.25f : 1.0f;
+
+    // on keys, between keys, around the wrap and past the end
+    const Real times[] = { 0, 0.04f, 0.05f, 1.234f, 2, 3.97f, 3.99f, 4, 5.5f, 9.01f };
+    for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); ++i)
+    {
+        expectNear(samplePose(mSkeleton.get(), mReference, times[i], 1),
+            samplePose(mSkeleton.get(), anim, times[i], 1), times[i]);
+        expectNear(samplePose(mSkeleton.get(), mReference, times[i], 0.5f),
+            samplePose(mSkeleton.get(), anim, times[i], 0.5f), times[i]);
+        expectNear(samplePose(mSkeleton.get(), mReference, times[i], 1, &mask),
+            samplePose(mSkeleton.get(), anim, times[i], 1, &mask), times[i]);
+    }
+
+    // clones keep the compressed tracks
+    Animation* copy = anim->clone("Copy");
+    ASSERT_TRUE(copy->getCompressedNodeTracks() != 0);
+    expectNear(samplePose(mSkeleton.get(), mReference, 1.5f, 1),
+        samplePose(mSkeleton.get(), copy, 1.5f, 1), 1.5f);
+    OGRE_DELETE copy;
+}
+
+TEST_F(CompressedNodeTracksTests, Serialization)
+{
+    mSkeleton->getAnimation("Walk")->compressNodeTracks();
+
+    const char* fileName = "CompressedNodeTracksTests.skeleton";
+    SkeletonSerializer serializer;
+    EXPECT_THROW(serializer.exportSkeleton(mSkeleton.get(), fileName, SKELETON_VERSION_1_8),
+        InvalidParametersException);
+    serializer.exportSkeleton(mSkeleton.get(), fileName);
+
+    SkeletonPtr loaded = SkeletonManager::getSingleton().create("Loaded",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        DataStreamPtr stream(OGRE_NEW FileStreamDataStream(&file, false));
+        serializer.importSkeleton(stream, loaded.get());
+    }
+    remove(fileName);
+
+    Animation* anim = loaded->getAnimation("Walk");
+    ASSERT_TRUE(anim->getCompressedNodeTracks() != 0);
+    for (Real t = 0; t < LENGTH; t += 0.3f)
+    {
+        expectNear(samplePose(mSkeleton.get(), mReference, t, 1),
+            samplePose(loaded.get(), anim, t, 1), t);
+    }
+}
+
+TEST_F(CompressedNodeTracksTests, SerializerVersion)
+{
+    // the header names the version, 1.10 is only needed for compressed tracks
+    SkeletonSerializer serializer;
+    for (int compressed = 0; compressed < 2; ++compressed)
+    {
+        if (compressed)
+            mSkeleton->getAnimation("Walk")->compressNodeTracks();
+
+        MemoryDataStream* memStream = OGRE_NEW MemoryDataStream(1 << 20, true);
+        DataStreamPtr stream(memStream);
+        serializer.exportSkeleton(mSkeleton.get(), stream);
+        String contents(reinterpret_cast<const char*>(memStream->getPtr()), memStream->tell());
+        EXPECT_EQ(compressed ? String::npos : 2, contents.find("[Serializer_v1.80]"));
+        EXPECT_EQ(compressed ? 2 : String::npos, contents.find("[Serializer_v1.100]"));
+    }
+}
+
+TEST_F(CompressedNodeTracksTests, SamplingPerformance)
+{
+    Animation* anim = mSkeleton->getAnimation("Walk");
+    anim->compressNodeTracks();
+
+    const int numSamples = 2000;
+    Timer timer;
+    for (int i = 0; i < numSamples; ++i)
+        mReference->apply(mSkeleton.get(), i * 0.013f);
+    unsigned long keyFrameTime = timer.getMicroseconds();
+
+    timer.reset();
+    for (int i = 0; i < numSamples; ++i)
+        anim->apply(mSkeleton.get(), i * 0.013f);
+    unsigned long compressedTime = timer.getMicroseconds();
+
+    // sampling alone, without updating the bones
+    timer.reset();
+    TransformKeyFrame kf(0, 0);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        TimeIndex timeIndex = mReference->_getTimeIndex(i * 0.013f);
+        Animation::NodeTrackIterator it = mReference->getNodeTrackIterator();
+        while (it.hasMoreElements())
+            it.getNext()->getInterpolatedKeyFrame(timeIndex, &kf);
+    }
+    unsigned long keyFrameSampleTime = timer.getMicroseconds();
+
+    vector<Quaternion>::type rotations(NUM_BONES);
+    vector<Vector3>::type translates(NUM_BONES), scales(NUM_BONES);
+    timer.reset();
+    for (int i = 0; i < numSamples; ++i)
+        anim->getCompressedNodeTracks()->sample(i * 0.013f, &rotations[0], &translates[0], &scales[0]);
+    unsigned long compressedSampleTime = timer.getMicroseconds();
+
+    LogManager::getSingleton().stream() << "Applying " << numSamples << " x " << NUM_BONES
+        << " node tracks: key frames " << keyFrameTime << " us, compressed "
+        << compressedTime << " us; sampling only: key frames " << keyFrameSampleTime
+        << " us, compressed " << compressedSampleTime << " us; "
+        << keyFrameMemory(mReference) << " bytes vs "
+        << anim->getCompressedNodeTracks()->getMemoryUsage();
+}
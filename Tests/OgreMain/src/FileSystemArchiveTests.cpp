@@ -49,10 +49,13 @@ void FileSystemArchiveTests::SetUp()
     Ogre::ConfigFile cf;
     cf.load(Ogre::FileSystemLayer(OGRE_VERSION_NAME).getConfigFilePath("resources.cfg"));
     mTestPath = cf.getSettings("Tests").begin()->second+"/misc/ArchiveTest";
+    mMemoryMapping = FileSystemArchive::getMemoryMappingEnabled();
 }
 //--------------------------------------------------------------------------
 void FileSystemArchiveTests::TearDown()
 {
+    // tests may change it and fail before resetting it
+    FileSystemArchive::setMemoryMappingEnabled(mMemoryMapping);
 }
 //--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,ListNonRecursive)
@@ -309,6 +312,39 @@ TEST_F(FileSystemArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MemoryMappedRead)
+{
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+
+    FileSystemArchive::setMemoryMappingEnabled(true);
+    DataStreamPtr stream = arch.open("rootfile.txt");
+    FileSystemArchive::setMemoryMappingEnabled(false);
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+    OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+    ASSERT_TRUE(memStream);
+    EXPECT_EQ(memStream->getCurrentPtr(), memStream->getPtr());
+    EXPECT_EQ(0, memcmp(memStream->getPtr(), "this is line 1 in file 1", 24));
+#endif
+
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), stream->getLine());
+    stream->seek(0);
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    stream->skip(25);
+    EXPECT_EQ(String("this is line 3 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 4 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 5 in file 1"), stream->getLine());
+    EXPECT_EQ(BLANKSTRING, stream->getLine()); // blank at end of file
+    EXPECT_TRUE(stream->eof());
+
+    // writing is refused
+    EXPECT_EQ(size_t(0), stream->write("x", 1));
+    stream->close();
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,CreateAndRemoveFile)
 {
     FileSystemArchive arch("./", "FileSystem", false);
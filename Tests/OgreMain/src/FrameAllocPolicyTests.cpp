@@ -0,0 +1,257 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreLogManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMaterialManager.h"
+
+using namespace Ogre;
+
+namespace {
+    typedef std::vector<int, STLAllocator<int, FrameAllocPolicy> > FrameIntVector;
+
+    /// Orders by key only, so equal keys show whether the sort is stable
+    struct KeyLess
+    {
+        bool operator()(const std::pair<int, int>& a, const std::pair<int, int>& b) const
+        {
+            return a.first < b.first;
+        }
+    };
+
+    /// Gives access to the frustum light list _populateLightList starts from
+    class LightListSceneManager : public DefaultSceneManager
+    {
+    public:
+        LightListSceneManager(const String& name) : DefaultSceneManager(name) {}
+
+        using SceneManager::findLightsAffectingFrustum;
+    };
+
+    class LightListSceneManagerFactory : public SceneManagerFactory
+    {
+    protected:
+        void initMetaData(void) const
+        {
+            mMetaData.typeName = "LightListSceneManager";
+            mMetaData.sceneTypeMask = ST_GENERIC;
+            mMetaData.worldGeometrySupported = false;
+        }
+    public:
+        SceneManager* createInstance(const String& instanceName)
+        {
+            return OGRE_NEW LightListSceneManager(instanceName);
+        }
+        void destroyInstance(SceneManager* instance)
+        {
+            OGRE_DELETE instance;
+        }
+    };
+
+    /// Leaves its arena behind without calling FrameAllocPolicy::_threadEnded
+    struct AllocatingWorker
+    {
+        void operator()() const
+        {
+            OGRE_FREE(OGRE_MALLOC(100, MEMCATEGORY_FRAME), MEMCATEGORY_FRAME);
+        }
+    };
+}
+
+TEST(FrameAllocPolicy,reusesMemoryOnceReleased)
+{
+    void* first = OGRE_MALLOC(100, MEMCATEGORY_FRAME);
+    void* second = OGRE_MALLOC(3, MEMCATEGORY_FRAME);
+    EXPECT_EQ(0U, (size_t)first % 16);
+    EXPECT_EQ(0U, (size_t)second % 16);
+    EXPECT_NE(first, second);
+
+    // memory is only reused once everything is released
+    OGRE_FREE(first, MEMCATEGORY_FRAME);
+    void* third = OGRE_MALLOC(100, MEMCATEGORY_FRAME);
+    EXPECT_NE(first, third);
+    OGRE_FREE(second, MEMCATEGORY_FRAME);
+    OGRE_FREE(third, MEMCATEGORY_FRAME);
+
+    void* fourth = OGRE_MALLOC(100, MEMCATEGORY_FRAME);
+    EXPECT_EQ(first, fourth);
+    OGRE_FREE(fourth, MEMCATEGORY_FRAME);
+    OGRE_FREE(0, MEMCATEGORY_FRAME);
+
+    // containers growing over several blocks and then beyond the block size
+    {
+        FrameIntVector values;
+        for (int i = 0; i < 100000; ++i)
+            values.push_back(i);
+        FrameIntVector copy(values);
+        for (int i = 0; i < 100000; ++i)
+            ASSERT_EQ(i, copy[i]);
+    }
+    EXPECT_GT(FrameAllocPolicy::getReservedBytes(), 0U);
+}
+
+#if OGRE_THREAD_SUPPORT
+TEST(FrameAllocPolicy,threadExitReleasesArena)
+{
+    AllocatingWorker worker;
+    OGRE_THREAD_CREATE(first, worker);
+    first->join();
+    OGRE_THREAD_DESTROY(first);
+    const size_t reserved = FrameAllocPolicy::getReservedBytes();
+
+    // each thread takes over the blocks of the previous one
+    for (int i = 0; i < 10; ++i)
+    {
+        OGRE_THREAD_CREATE(t, worker);
+        t->join();
+        OGRE_THREAD_DESTROY(t);
+    }
+    EXPECT_EQ(reserved, FrameAllocPolicy::getReservedBytes());
+}
+#endif
+
+TEST(FrameAllocPolicy,shutdownFreesBlocks)
+{
+    Root* root = OGRE_NEW Root("");
+    OGRE_FREE(OGRE_MALLOC(100, MEMCATEGORY_FRAME), MEMCATEGORY_FRAME);
+    EXPECT_GT(FrameAllocPolicy::getReservedBytes(), 0U);
+
+    // blocks still in use are kept
+    void* live = OGRE_MALLOC(100, MEMCATEGORY_FRAME);
+    OGRE_DELETE root;
+    EXPECT_GT(FrameAllocPolicy::getReservedBytes(), 0U);
+    OGRE_FREE(live, MEMCATEGORY_FRAME);
+
+    FrameAllocPolicy::_shutdown();
+    EXPECT_EQ(0U, FrameAllocPolicy::getReservedBytes());
+
+    // the allocator is usable again afterwards
+    void* ptr = OGRE_MALLOC(100, MEMCATEGORY_FRAME);
+    EXPECT_EQ(0U, (size_t)ptr % 16);
+    OGRE_FREE(ptr, MEMCATEGORY_FRAME);
+    FrameAllocPolicy::_shutdown();
+}
+
+TEST(FrameAllocPolicy,frameStatistics)
+{
+    Root root("");
+    root._fireFrameEnded();
+
+    for (int i = 0; i < 10; ++i)
+        OGRE_FREE(OGRE_MALLOC(64, MEMCATEGORY_FRAME), MEMCATEGORY_FRAME);
+    // too large for the blocks
+    OGRE_FREE(OGRE_MALLOC(1024 * 1024, MEMCATEGORY_FRAME), MEMCATEGORY_FRAME);
+    root._fireFrameEnded();
+
+    FrameAllocPolicy::Statistics stats = FrameAllocPolicy::getLastFrameStatistics();
+    EXPECT_EQ(10U, stats.numAllocations);
+    EXPECT_EQ(10U * 80, stats.numBytes);
+    EXPECT_EQ(1U, stats.numHeapAllocations);
+
+    root._fireFrameEnded();
+    stats = FrameAllocPolicy::getLastFrameStatistics();
+    EXPECT_EQ(0U, stats.numAllocations);
+    EXPECT_EQ(0U, stats.numHeapAllocations);
+}
+
+TEST(FrameAllocPolicy,frameStableSortMatchesStableSort)
+{
+    srand(42);
+    const size_t sizes[] = { 0, 1, 2, 15, 16, 17, 33, 100, 1000, 5000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        vector<std::pair<int, int> >::type values;
+        for (size_t i = 0; i < sizes[s]; ++i)
+            values.push_back(std::make_pair(rand() % 20, (int)i));
+
+        vector<std::pair<int, int> >::type expected(values);
+        std::stable_sort(expected.begin(), expected.end(), KeyLess());
+        frameStableSort(values.begin(), values.end(), KeyLess());
+        ASSERT_TRUE(values == expected) << "size " << sizes[s];
+    }
+}
+
+TEST(FrameAllocPolicy,populateLightListAllocations)
+{
+    Root root("");
+    // cameras need a buffer manager
+    DefaultHardwareBufferManager bufMgr;
+    MaterialManager::getSingleton().initialise();
+    LightListSceneManagerFactory factory;
+    root.addSceneManagerFactory(&factory);
+    LightListSceneManager& sm = static_cast<LightListSceneManager&>(
+        *root.createSceneManager("LightListSceneManager"));
+    Camera* cam = sm.createCamera("cam");
+    // looking down -Z, at the origin
+    sm.getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 500))->attachObject(cam);
+
+    // lights covering the whole scene
+    for (int i = 0; i < 64; ++i)
+    {
+        Light* l = sm.createLight();
+        l->setAttenuation(5000, 1, 0, 0);
+        sm.getRootSceneNode()->createChildSceneNode(Vector3(i * 2.0f, 0, 0))->attachObject(l);
+    }
+    sm.getRootSceneNode()->_update(true, false);
+    sm.findLightsAffectingFrustum(cam);
+    ASSERT_EQ(64U, sm._getLightsAffectingFrustum().size());
+
+    const int numObjects = 1000;
+    LightList lights;
+    root._fireFrameEnded();
+    for (int i = 0; i < numObjects; ++i)
+    {
+        Vector3 pos(Real(i % 100), 0, 0);
+        sm._populateLightList(pos, 10, lights);
+        ASSERT_EQ(64U, lights.size());
+        for (size_t j = 1; j < lights.size(); ++j)
+        {
+            ASSERT_LE(pos.squaredDistance(lights[j - 1]->getDerivedPosition()),
+                      pos.squaredDistance(lights[j]->getDerivedPosition()));
+        }
+    }
+    root._fireFrameEnded();
+
+    // the candidates, their distances and the sort buffer of each list,
+    // none of them from the heap
+    FrameAllocPolicy::Statistics stats = FrameAllocPolicy::getLastFrameStatistics();
+    EXPECT_LE(size_t(numObjects) * 3, stats.numAllocations);
+    EXPECT_EQ(0U, stats.numHeapAllocations);
+    LogManager::getSingleton().stream() << "Populating " << numObjects << " light lists of "
+        << lights.size() << " lights: " << stats.numAllocations << " frame allocations, "
+        << stats.numBytes << " bytes, " << stats.numHeapAllocations << " heap allocations";
+
+    root.destroySceneManager(&sm);
+    root.removeSceneManagerFactory(&factory);
+}
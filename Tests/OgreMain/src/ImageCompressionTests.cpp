@@ -0,0 +1,474 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "OgreRoot.h"
+#include "OgreImage.h"
+#include "OgrePixelFormat.h"
+#include "OgreColourValue.h"
+#include "OgreBitwise.h"
+#include "OgrePlatformInformation.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Decodes a BC4 block the way DDSCodec decodes the DXT5 alpha block
+    void decodeChannelBlock(const uint8* block, float (&values)[16])
+    {
+        float palette[8];
+        palette[0] = block[0];
+        palette[1] = block[1];
+        if (block[0] > block[1])
+        {
+            for (size_t i = 1; i < 7; ++i)
+                palette[i + 1] = (palette[0] * (7 - i) + palette[1] * i) / 7;
+        }
+        else
+        {
+            for (size_t i = 1; i < 5; ++i)
+                palette[i + 1] = (palette[0] * (5 - i) + palette[1] * i) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64 bits = 0;
+        for (size_t i = 0; i < 6; ++i)
+            bits |= uint64(block[2 + i]) << (8 * i);
+        for (size_t i = 0; i < 16; ++i)
+            values[i] = palette[(bits >> (3 * i)) & 0x7];
+    }
+
+    /// Reads the 64 bits of an ETC block, which are big endian
+    uint64 readBigEndian(const uint8* block)
+    {
+        uint64 bits = 0;
+        for (size_t i = 0; i < 8; ++i)
+            bits = (bits << 8) | block[i];
+        return bits;
+    }
+
+    /** Decodes an ETC1 block, which ETC2 decodes the same way unless a
+        differential base colour overflows. Returns false for those T, H and
+        planar mode blocks, the encoder does not write them.
+    */
+    bool decodeETCBlock(const uint8* block, uint8 (&rgb)[16][3])
+    {
+        static const int modifiers[8][4] = {
+            { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 },
+            { 18, 60, -18, -60 }, { 24, 80, -24, -80 }, { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+        };
+        uint64 bits = readBigEndian(block);
+        bool differential = (bits >> 33) & 1;
+        bool flip = (bits >> 32) & 1;
+        int base[2][3];
+        for (int c = 0; c < 3; ++c)
+        {
+            if (differential)
+            {
+                int first = (bits >> (59 - 8 * c)) & 0x1F;
+                int delta = (bits >> (56 - 8 * c)) & 0x7;
+                int second = first + (delta >= 4 ? delta - 8 : delta);
+                if (second < 0 || second > 31)
+                    return false;
+                base[0][c] = (first << 3) | (first >> 2);
+                base[1][c] = (second << 3) | (second >> 2);
+            }
+            else
+            {
+                base[0][c] = ((bits >> (60 - 8 * c)) & 0xF) * 17;
+                base[1][c] = ((bits >> (56 - 8 * c)) & 0xF) * 17;
+            }
+        }
+        int tables[2] = { int((bits >> 37) & 0x7), int((bits >> 34) & 0x7) };
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                int half = flip ? y / 2 : x / 2;
+                int position = x * 4 + y;
+                int index = int(((bits >> (16 + position)) & 1) << 1 | ((bits >> position) & 1));
+                for (int c = 0; c < 3; ++c)
+                {
+                    int value = base[half][c] + modifiers[tables[half]][index];
+                    rgb[y * 4 + x][c] = uint8(std::min(std::max(value, 0), 255));
+                }
+            }
+        }
+        return true;
+    }
+
+    /// Decodes the EAC alpha block of ETC2 RGBA8
+    void decodeEACBlock(const uint8* block, uint8 (&alpha)[16])
+    {
+        static const int modifiers[16][8] = {
+            { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+            { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+            { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+            { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+            { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+            { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+            { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+            { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 }
+        };
+        uint64 bits = readBigEndian(block);
+        int base = int(bits >> 56);
+        int multiplier = int((bits >> 52) & 0xF);
+        int table = int((bits >> 48) & 0xF);
+        for (int x = 0; x < 4; ++x)
+        {
+            for (int y = 0; y < 4; ++y)
+            {
+                int index = int((bits >> (45 - 3 * (x * 4 + y))) & 0x7);
+                int value = base + modifiers[table][index] * multiplier;
+                alpha[y * 4 + x] = uint8(std::min(std::max(value, 0), 255));
+            }
+        }
+    }
+}
+
+class ImageCompressionTests : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        mRoot = OGRE_NEW Root("");
+    }
+
+    void TearDown()
+    {
+        OGRE_DELETE mRoot;
+    }
+
+    void loadImage(Image& image, const String& name)
+    {
+        DataStreamPtr stream = Root::openFileStream("../../Tests/Media/" + name);
+        String baseName, extension;
+        StringUtil::splitBaseFilename(name, baseName, extension);
+        image.load(stream, extension);
+    }
+
+    /// Root mean square error of the given channels of all levels and faces, in 8 bit units
+    float rmsError(const Image& expected, const Image& actual, bool withAlpha)
+    {
+        double sum = 0;
+        size_t count = 0;
+        for (size_t face = 0; face < expected.getNumFaces(); ++face)
+        {
+            for (size_t mip = 0; mip <= expected.getNumMipmaps(); ++mip)
+            {
+                PixelBox e = expected.getPixelBox(face, mip);
+                PixelBox a = actual.getPixelBox(face, mip);
+                for (size_t y = 0; y < e.getHeight(); ++y)
+                {
+                    for (size_t x = 0; x < e.getWidth(); ++x)
+                    {
+                        ColourValue ce = e.getColourAt(x, y, 0) * 255;
+                        ColourValue ca = a.getColourAt(x, y, 0) * 255;
+                        sum += (ce.r - ca.r) * (ce.r - ca.r) + (ce.g - ca.g) * (ce.g - ca.g) +
+                            (ce.b - ca.b) * (ce.b - ca.b);
+                        count += 3;
+                        if (withAlpha)
+                        {
+                            sum += (ce.a - ca.a) * (ce.a - ca.a);
+                            count++;
+                        }
+                    }
+                }
+            }
+        }
+        return float(std::sqrt(sum / count));
+    }
+
+    /// Compresses image, saves it as DDS and loads it again, decompressed as there is no render system
+    void roundtrip(const Image& image, PixelFormat format, Image& result)
+    {
+        Image compressed(image);
+        compressed.compress(format);
+        EXPECT_TRUE(compressed.hasFlag(IF_COMPRESSED));
+        EXPECT_EQ(image.getNumMipmaps(), compressed.getNumMipmaps());
+
+        const char* fileName = "ImageCompressionTests.dds";
+        compressed.save(fileName);
+        DataStreamPtr stream = Root::openFileStream(fileName);
+        result.load(stream, "dds");
+        stream->close();
+        std::remove(fileName);
+    }
+
+    Root* mRoot;
+};
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, MipmapChain)
+{
+    const char* images[] = { "decal0.png", "grace_cube.dds" };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        Image image;
+        loadImage(image, images[i]);
+        Image original(image);
+        image.generateMipmaps();
+
+        EXPECT_EQ(original.getNumFaces(), image.getNumFaces());
+        EXPECT_EQ(Bitwise::mostSignificantBitSet(image.getWidth()), image.getNumMipmaps());
+        EXPECT_EQ(Image::calculateSize(image.getNumMipmaps(), image.getNumFaces(), image.getWidth(),
+            image.getHeight(), 1, image.getFormat()), image.getSize());
+
+        for (size_t face = 0; face < image.getNumFaces(); ++face)
+        {
+            // the top level is unchanged, every other level is filtered from the previous one
+            PixelBox top = image.getPixelBox(face, 0);
+            EXPECT_EQ(0, memcmp(original.getPixelBox(face, 0).data, top.data, top.getConsecutiveSize()));
+
+            for (size_t mip = 1; mip <= image.getNumMipmaps(); ++mip)
+            {
+                PixelBox level = image.getPixelBox(face, mip);
+                EXPECT_EQ(std::max<uint32>(image.getWidth() >> mip, 1), level.getWidth());
+                EXPECT_EQ(std::max<uint32>(image.getHeight() >> mip, 1), level.getHeight());
+
+                MemoryDataStream expected(level.getConsecutiveSize());
+                PixelBox expectedBox(level.getWidth(), level.getHeight(), 1, level.format, expected.getPtr());
+                Image::scale(image.getPixelBox(face, mip - 1), expectedBox);
+                EXPECT_EQ(0, memcmp(expectedBox.data, level.data, level.getConsecutiveSize()))
+                    << images[i] << " face " << face << " mip " << mip;
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, DXT)
+{
+    Image image;
+    loadImage(image, "decal0.png");
+    image.generateMipmaps();
+
+    Image dxt1;
+    roundtrip(image, PF_DXT1, dxt1);
+    // only 4 colour blocks, otherwise the texture would be decoded with alpha
+    EXPECT_EQ(PF_BYTE_RGB, dxt1.getFormat());
+    EXPECT_EQ(image.getNumMipmaps(), dxt1.getNumMipmaps());
+    EXPECT_LT(rmsError(image, dxt1, false), 8.0f);
+
+    Image dxt5;
+    roundtrip(image, PF_DXT5, dxt5);
+    EXPECT_EQ(PF_BYTE_RGBA, dxt5.getFormat());
+    EXPECT_EQ(image.getNumMipmaps(), dxt5.getNumMipmaps());
+    EXPECT_LT(rmsError(image, dxt5, true), 8.0f);
+
+    // solid colours, including black, are encoded exactly where 565 allows it
+    Image solid(image);
+    memset(solid.getData(), 0, solid.getSize());
+    Image solidDxt1;
+    roundtrip(solid, PF_DXT1, solidDxt1);
+    EXPECT_EQ(PF_BYTE_RGB, solidDxt1.getFormat());
+    EXPECT_EQ(0.0f, rmsError(solid, solidDxt1, false));
+}
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, Channels)
+{
+    Image image;
+    loadImage(image, "decal3.png");
+
+    PixelFormat formats[] = { PF_BC4_UNORM, PF_BC5_UNORM };
+    for (size_t f = 0; f < 2; ++f)
+    {
+        Image compressed(image);
+        compressed.compress(formats[f]);
+        size_t channels = f + 1;
+        size_t blocksPerRow = (image.getWidth() + 3) / 4;
+        const uint8* block = compressed.getData();
+        for (size_t by = 0; by < (image.getHeight() + 3) / 4; ++by)
+        {
+            for (size_t bx = 0; bx < blocksPerRow; ++bx)
+            {
+                for (size_t c = 0; c < channels; ++c, block += 8)
+                {
+                    float values[16];
+                    decodeChannelBlock(block, values);
+                    // the 8 value mode is accurate to half of a 7th of the block range
+                    float tolerance = (block[0] - block[1]) / 14.0f + 0.5f;
+                    for (size_t i = 0; i < 16; ++i)
+                    {
+                        ColourValue col = image.getColourAt(bx * 4 + i % 4, by * 4 + i / 4, 0);
+                        float expected = (c == 0 ? col.r : col.g) * 255;
+                        EXPECT_NEAR(expected, values[i], tolerance);
+                    }
+                }
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, LimitedMipmaps)
+{
+    Image image;
+    loadImage(image, "decal0.png");
+    Image full(image);
+    full.generateMipmaps();
+
+    image.generateMipmaps(Image::FILTER_BILINEAR, false, 3);
+    EXPECT_EQ(3u, image.getNumMipmaps());
+    EXPECT_EQ(Image::calculateSize(3, 1, image.getWidth(), image.getHeight(), 1, image.getFormat()),
+        image.getSize());
+    for (size_t mip = 0; mip <= 3; ++mip)
+    {
+        PixelBox level = image.getPixelBox(0, mip);
+        EXPECT_EQ(0, memcmp(full.getPixelBox(0, mip).data, level.data, level.getConsecutiveSize()));
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, GammaCorrectMipmaps)
+{
+    Image image;
+    loadImage(image, "decal0.png");
+    Image linear(image);
+    linear.generateMipmaps(Image::FILTER_BOX, true);
+
+    // the levels average the linear colours of the level above, alpha as it is
+    for (size_t mip = 1; mip <= linear.getNumMipmaps(); ++mip)
+    {
+        PixelBox upper = linear.getPixelBox(0, mip - 1);
+        PixelBox level = linear.getPixelBox(0, mip);
+        for (size_t y = 0; y < level.getHeight(); ++y)
+        {
+            for (size_t x = 0; x < level.getWidth(); ++x)
+            {
+                ColourValue sum(0, 0, 0, 0);
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    ColourValue c = upper.getColourAt(x * 2 + i % 2, y * 2 + i / 2, 0);
+                    for (int ch = 0; ch < 3; ++ch)
+                        c[ch] = c[ch] <= 0.04045f ? c[ch] / 12.92f : std::pow((c[ch] + 0.055f) / 1.055f, 2.4f);
+                    sum += c * 0.25f;
+                }
+                ColourValue c = level.getColourAt(x, y, 0);
+                for (int ch = 0; ch < 4; ++ch)
+                {
+                    float expected = sum[ch];
+                    if (ch < 3)
+                        expected = expected <= 0.0031308f ? expected * 12.92f : 1.055f * std::pow(expected, 1 / 2.4f) - 0.055f;
+                    // the upper level was rounded to bytes
+                    ASSERT_NEAR(expected, c[ch], 3.0f / 255) << "mip " << mip << " at " << x << ", " << y;
+                }
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, ETC)
+{
+    const char* images[] = { "decal0.png", "decal3.png" };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        Image image;
+        loadImage(image, images[i]);
+        image.generateMipmaps();
+
+        PixelFormat formats[] = { PF_ETC1_RGB8, PF_ETC2_RGB8, PF_ETC2_RGBA8 };
+        for (size_t f = 0; f < 3; ++f)
+        {
+            Image compressed(image);
+            compressed.compress(formats[f]);
+            EXPECT_EQ(image.getNumMipmaps(), compressed.getNumMipmaps());
+            EXPECT_EQ(Image::calculateSize(image.getNumMipmaps(), 1, image.getWidth(), image.getHeight(), 1,
+                formats[f]), compressed.getSize());
+
+            bool hasAlpha = formats[f] == PF_ETC2_RGBA8;
+            const uint8* block = compressed.getData();
+            double colourError = 0, alphaError = 0;
+            size_t count = 0;
+            for (size_t mip = 0; mip <= image.getNumMipmaps(); ++mip)
+            {
+                PixelBox level = image.getPixelBox(0, mip);
+                for (size_t by = 0; by < (level.getHeight() + 3) / 4; ++by)
+                {
+                    for (size_t bx = 0; bx < (level.getWidth() + 3) / 4; ++bx)
+                    {
+                        uint8 alpha[16], rgb[16][3];
+                        if (hasAlpha)
+                        {
+                            decodeEACBlock(block, alpha);
+                            block += 8;
+                        }
+                        ASSERT_TRUE(decodeETCBlock(block, rgb));
+                        block += 8;
+
+                        for (size_t t = 0; t < 16; ++t)
+                        {
+                            size_t x = bx * 4 + t % 4, y = by * 4 + t / 4;
+                            if (x >= level.getWidth() || y >= level.getHeight())
+                                continue;
+                            ColourValue c = level.getColourAt(x, y, 0) * 255;
+                            for (int ch = 0; ch < 3; ++ch)
+                                colourError += (c[ch] - rgb[t][ch]) * (c[ch] - rgb[t][ch]);
+                            if (hasAlpha)
+                                alphaError += (c.a - alpha[t]) * (c.a - alpha[t]);
+                            ++count;
+                        }
+                    }
+                }
+            }
+            EXPECT_EQ(compressed.getData() + compressed.getSize(), block);
+            EXPECT_LT(std::sqrt(colourError / (count * 3)), 10.0) << images[i] << " " << PixelUtil::getFormatName(formats[f]);
+            EXPECT_LT(std::sqrt(alphaError / count), 4.0) << images[i] << " " << PixelUtil::getFormatName(formats[f]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, CompressWithoutSimd)
+{
+    Image image;
+    loadImage(image, "decal3.png");
+    image.generateMipmaps();
+
+    // the SIMD palette search must choose the same indices and endpoints as the scalar one
+    PixelFormat formats[] = { PF_DXT1, PF_DXT5, PF_ETC2_RGB8, PF_ETC2_RGBA8 };
+    for (size_t f = 0; f < 4; ++f)
+    {
+        Image scalar(image), simd(image);
+        PlatformInformation::_setCpuFeatureMask(0);
+        scalar.compress(formats[f]);
+        PlatformInformation::_setCpuFeatureMask(~0u);
+        simd.compress(formats[f]);
+        ASSERT_EQ(scalar.getSize(), simd.getSize());
+        EXPECT_EQ(0, memcmp(scalar.getData(), simd.getData(), scalar.getSize()))
+            << PixelUtil::getFormatName(formats[f]);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ImageCompressionTests, Errors)
+{
+    Image image;
+    loadImage(image, "decal0.png");
+    EXPECT_THROW(image.compress(PF_DXT3), Exception);
+
+    image.compress(PF_DXT1);
+    EXPECT_THROW(image.compress(PF_DXT5), Exception);
+    EXPECT_THROW(image.generateMipmaps(), Exception);
+}
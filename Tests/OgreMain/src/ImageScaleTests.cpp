@@ -0,0 +1,450 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreImage.h"
+#include "OgrePixelFormat.h"
+#include "OgreColourValue.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "OgrePlatformInformation.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Images of the test media used for checking and timing scaling and conversion
+    const char* TEST_IMAGES[] = {
+        "decal0.png", "decal3.png", "ogreborderUp_float64.dds", "ogreborderUp_float128.dds"
+    };
+    const size_t NUM_TEST_IMAGES = sizeof(TEST_IMAGES) / sizeof(TEST_IMAGES[0]);
+
+    /// Nearest source position of a destination pixel, as used by Image::scale
+    size_t nearestSource(size_t x, size_t srcSize, size_t dstSize)
+    {
+        uint64 step = ((uint64)srcSize << 48) / dstSize;
+        return (size_t)(((step >> 1) - 1 + x * step) >> 48);
+    }
+}
+
+class ImageScaleTests : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        mRoot = OGRE_NEW Root("");
+    }
+
+    void TearDown()
+    {
+        OGRE_DELETE mRoot;
+    }
+
+    void loadImage(Image& image, const String& name)
+    {
+        DataStreamPtr stream = Root::openFileStream("../../Tests/Media/" + name);
+        String baseName, extension;
+        StringUtil::splitBaseFilename(name, baseName, extension);
+        image.load(stream, extension);
+    }
+
+    /// Straightforward bilinear filter with the pixel centre mapping of Image::scale
+    ColourValue bilinear(const Image& src, size_t width, size_t height, size_t x, size_t y)
+    {
+        float sx = std::max((x + 0.5f) * src.getWidth() / width - 0.5f, 0.0f);
+        float sy = std::max((y + 0.5f) * src.getHeight() / height - 0.5f, 0.0f);
+        size_t x1 = (size_t)sx, y1 = (size_t)sy;
+        size_t x2 = std::min(x1 + 1, size_t(src.getWidth() - 1));
+        size_t y2 = std::min(y1 + 1, size_t(src.getHeight() - 1));
+        float fx = sx - x1, fy = sy - y1;
+        return src.getColourAt(x1, y1, 0) * ((1 - fx) * (1 - fy)) + src.getColourAt(x2, y1, 0) * (fx * (1 - fy)) +
+            src.getColourAt(x1, y2, 0) * ((1 - fx) * fy) + src.getColourAt(x2, y2, 0) * (fx * fy);
+    }
+
+    /// Catmull-Rom interpolation of the 4x4 source pixels around a destination pixel when enlarging
+    ColourValue bicubic(const Image& src, size_t width, size_t height, size_t x, size_t y)
+    {
+        float sx = (x + 0.5f) * src.getWidth() / width - 0.5f;
+        float sy = (y + 0.5f) * src.getHeight() / height - 0.5f;
+        long x0 = (long)floor(sx), y0 = (long)floor(sy);
+        float wx[4], wy[4];
+        catmullRom(sx - x0, wx);
+        catmullRom(sy - y0, wy);
+        ColourValue c(0, 0, 0, 0);
+        for (long j = 0; j < 4; ++j)
+        {
+            size_t py = std::min(std::max(y0 - 1 + j, 0L), long(src.getHeight()) - 1);
+            for (long i = 0; i < 4; ++i)
+            {
+                size_t px = std::min(std::max(x0 - 1 + i, 0L), long(src.getWidth()) - 1);
+                c += src.getColourAt(px, py, 0) * (wx[i] * wy[j]);
+            }
+        }
+        if (!PixelUtil::isFloatingPoint(src.getFormat()))
+            c.saturate();
+        return c;
+    }
+
+    /// Weights of the pixels at -1, 0, 1 and 2 for a position t in [0, 1)
+    void catmullRom(float t, float* w)
+    {
+        w[0] = ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+        w[1] = (1.5f * t - 2.5f) * t * t + 1.0f;
+        w[2] = ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+        w[3] = (0.5f * t - 0.5f) * t * t;
+    }
+
+    /// Scale with the SIMD code disabled and enabled, which must give the same pixels
+    void expectSameWithoutSimd(const PixelBox& src, size_t width, size_t height,
+        Image::Filter filter, const String& name)
+    {
+        size_t size = PixelUtil::getMemorySize(width, height, 1, src.format);
+        vector<uchar>::type scalar(size), simd(size);
+        PlatformInformation::_setCpuFeatureMask(0);
+        Image::scale(src, PixelBox(width, height, 1, src.format, &scalar[0]), filter);
+        PlatformInformation::_setCpuFeatureMask(~0u);
+        Image::scale(src, PixelBox(width, height, 1, src.format, &simd[0]), filter);
+        EXPECT_TRUE(scalar == simd) << name << " scaled to " << width << "x" << height;
+    }
+
+    void expectColour(const ColourValue& expected, const ColourValue& c, float tolerance,
+        const String& name, size_t x, size_t y)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            ASSERT_NEAR(expected[i], c[i], tolerance) << name << " channel " << i << " at " << x << ", " << y;
+        }
+    }
+
+    Root* mRoot;
+};
+
+namespace {
+    const Image::Filter FILTERS[] = { Image::FILTER_NEAREST, Image::FILTER_BILINEAR,
+        Image::FILTER_BOX, Image::FILTER_TRIANGLE, Image::FILTER_BICUBIC };
+    const char* FILTER_NAMES[] = { "nearest", "bilinear", "box", "triangle", "bicubic" };
+    const size_t NUM_FILTERS = sizeof(FILTERS) / sizeof(FILTERS[0]);
+
+    /// Formats converted to and from, with all kinds of byte, packed and float channels
+    const PixelFormat CONVERSION_FORMATS[] = { PF_R8G8B8, PF_B8G8R8, PF_B8G8R8A8, PF_X8R8G8B8, PF_L8, PF_A8,
+        PF_BYTE_LA, PF_R5G6B5, PF_A4R4G4B4, PF_A1R5G5B5, PF_A2R10G10B10, PF_L16, PF_FLOAT32_RGB, PF_FLOAT32_RGBA };
+    const size_t NUM_CONVERSION_FORMATS = sizeof(CONVERSION_FORMATS) / sizeof(CONVERSION_FORMATS[0]);
+}
+
+TEST_F(ImageScaleTests, Nearest)
+{
+    for (size_t i = 0; i < NUM_TEST_IMAGES; ++i)
+    {
+        Image src;
+        loadImage(src, TEST_IMAGES[i]);
+
+        // large enough to be split between threads, with rows not a multiple of the grain size
+        const size_t width = 301, height = 517;
+        Image dst(src);
+        dst.resize(width, height, Image::FILTER_NEAREST);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                expectColour(src.getColourAt(nearestSource(x, src.getWidth(), width),
+                    nearestSource(y, src.getHeight(), height), 0), dst.getColourAt(x, y, 0), 0,
+                    TEST_IMAGES[i], x, y);
+            }
+        }
+    }
+}
+
+TEST_F(ImageScaleTests, Bilinear)
+{
+    for (size_t i = 0; i < NUM_TEST_IMAGES; ++i)
+    {
+        Image src;
+        loadImage(src, TEST_IMAGES[i]);
+        // the byte resampler uses 12 bit weights
+        float tolerance = PixelUtil::isFloatingPoint(src.getFormat()) ? 2e-3f : 1.5f / 255;
+
+        const size_t sizes[][2] = { { 301, 517 }, { 97, 61 } };
+        for (size_t s = 0; s < 2; ++s)
+        {
+            const size_t width = sizes[s][0], height = sizes[s][1];
+            Image dst(src);
+            dst.resize(width, height, Image::FILTER_BILINEAR);
+            for (size_t y = 0; y < height; ++y)
+            {
+                for (size_t x = 0; x < width; ++x)
+                {
+                    expectColour(bilinear(src, width, height, x, y), dst.getColourAt(x, y, 0), tolerance,
+                        TEST_IMAGES[i], x, y);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(ImageScaleTests, Box)
+{
+    for (size_t i = 0; i < NUM_TEST_IMAGES; ++i)
+    {
+        Image src;
+        loadImage(src, TEST_IMAGES[i]);
+        float tolerance = PixelUtil::isFloatingPoint(src.getFormat()) ? 2e-3f : 1.5f / 255;
+
+        // halving averages 2x2 blocks
+        const size_t width = src.getWidth() / 2, height = src.getHeight() / 2;
+        Image dst(src);
+        dst.resize(width, height, Image::FILTER_BOX);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                ColourValue expected = (src.getColourAt(x * 2, y * 2, 0) + src.getColourAt(x * 2 + 1, y * 2, 0) +
+                    src.getColourAt(x * 2, y * 2 + 1, 0) + src.getColourAt(x * 2 + 1, y * 2 + 1, 0)) * 0.25f;
+                expectColour(expected, dst.getColourAt(x, y, 0), tolerance, TEST_IMAGES[i], x, y);
+            }
+        }
+    }
+}
+
+TEST_F(ImageScaleTests, Triangle)
+{
+    for (size_t i = 0; i < NUM_TEST_IMAGES; ++i)
+    {
+        Image src;
+        loadImage(src, TEST_IMAGES[i]);
+        float tolerance = PixelUtil::isFloatingPoint(src.getFormat()) ? 2e-3f : 1.5f / 255;
+
+        // enlarging with a triangle filter is bilinear interpolation
+        const size_t width = src.getWidth() * 2 + 3, height = src.getHeight() * 3 / 2;
+        Image dst(src);
+        dst.resize(width, height, Image::FILTER_TRIANGLE);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                expectColour(bilinear(src, width, height, x, y), dst.getColourAt(x, y, 0), tolerance,
+                    TEST_IMAGES[i], x, y);
+            }
+        }
+    }
+}
+
+TEST_F(ImageScaleTests, Bicubic)
+{
+    for (size_t i = 0; i < NUM_TEST_IMAGES; ++i)
+    {
+        Image src;
+        loadImage(src, TEST_IMAGES[i]);
+        float tolerance = PixelUtil::isFloatingPoint(src.getFormat()) ? 2e-3f : 1.5f / 255;
+
+        // keeping the size gives back the source
+        Image same(src);
+        same.resize(src.getWidth(), src.getHeight(), Image::FILTER_BICUBIC);
+        for (size_t y = 0; y < src.getHeight(); ++y)
+        {
+            for (size_t x = 0; x < src.getWidth(); ++x)
+            {
+                expectColour(src.getColourAt(x, y, 0), same.getColourAt(x, y, 0), tolerance,
+                    TEST_IMAGES[i], x, y);
+            }
+        }
+
+        const size_t width = src.getWidth() * 2 + 3, height = src.getHeight() * 3 / 2;
+        Image dst(src);
+        dst.resize(width, height, Image::FILTER_BICUBIC);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                expectColour(bicubic(src, width, height, x, y), dst.getColourAt(x, y, 0), tolerance,
+                    TEST_IMAGES[i], x, y);
+            }
+        }
+    }
+}
+
+TEST_F(ImageScaleTests, Conversion)
+{
+    Image src;
+    loadImage(src, "decal0.png");
+    const PixelFormat formats[] = { PF_R8G8B8, PF_B8G8R8A8, PF_L8, PF_A8, PF_R5G6B5, PF_A4R4G4B4,
+        PF_A2R10G10B10, PF_L16, PF_FLOAT32_RGB, PF_FLOAT32_RGBA };
+
+    // convert a sub box, so that rows are not consecutive and end within a group of SIMD pixels
+    Box box(3, 5, src.getWidth() - 6, src.getHeight() - 2);
+    PixelBox srcBox = src.getPixelBox().getSubVolume(box, false);
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+    {
+        size_t size = PixelUtil::getMemorySize(src.getWidth(), src.getHeight(), 1, formats[f]);
+        vector<uchar>::type converted(size, 0x55), expected(size, 0x55);
+
+        PixelBox dstBox(src.getWidth(), src.getHeight(), 1, formats[f], &converted[0]);
+        PixelUtil::bulkPixelConversion(srcBox, dstBox.getSubVolume(box, false));
+
+        size_t srcSize = PixelUtil::getNumElemBytes(src.getFormat());
+        size_t dstSize = PixelUtil::getNumElemBytes(formats[f]);
+        for (size_t y = box.top; y < box.bottom; ++y)
+        {
+            for (size_t x = box.left; x < box.right; ++x)
+            {
+                float r, g, b, a;
+                PixelUtil::unpackColour(&r, &g, &b, &a, src.getFormat(),
+                    src.getData() + (y * src.getWidth() + x) * srcSize);
+                PixelUtil::packColour(r, g, b, a, formats[f], &expected[(y * src.getWidth() + x) * dstSize]);
+            }
+        }
+        EXPECT_TRUE(converted == expected) << PixelUtil::getFormatName(formats[f]);
+    }
+}
+
+TEST_F(ImageScaleTests, ConversionWithoutSimd)
+{
+    Image src;
+    loadImage(src, "decal0.png");
+    const size_t width = src.getWidth() - 3, height = src.getHeight();
+    Box box(0, 0, width, height);
+
+    // every format is converted to every other one through the ones it was converted to
+    vector<vector<uchar>::type>::type converted(NUM_CONVERSION_FORMATS);
+    for (size_t f = 0; f < NUM_CONVERSION_FORMATS; ++f)
+    {
+        converted[f].resize(PixelUtil::getMemorySize(width, height, 1, CONVERSION_FORMATS[f]));
+        PixelUtil::bulkPixelConversion(src.getPixelBox().getSubVolume(box, false),
+            PixelBox(width, height, 1, CONVERSION_FORMATS[f], &converted[f][0]));
+    }
+    for (size_t s = 0; s < NUM_CONVERSION_FORMATS; ++s)
+    {
+        PixelBox srcBox(width, height, 1, CONVERSION_FORMATS[s], &converted[s][0]);
+        for (size_t d = 0; d < NUM_CONVERSION_FORMATS; ++d)
+        {
+            size_t size = PixelUtil::getMemorySize(width, height, 1, CONVERSION_FORMATS[d]);
+            vector<uchar>::type scalar(size), simd(size);
+            PlatformInformation::_setCpuFeatureMask(0);
+            PixelUtil::bulkPixelConversion(srcBox, PixelBox(width, height, 1, CONVERSION_FORMATS[d], &scalar[0]));
+            PlatformInformation::_setCpuFeatureMask(~0u);
+            PixelUtil::bulkPixelConversion(srcBox, PixelBox(width, height, 1, CONVERSION_FORMATS[d], &simd[0]));
+            EXPECT_TRUE(scalar == simd) << PixelUtil::getFormatName(CONVERSION_FORMATS[s]) << " to "
+                << PixelUtil::getFormatName(CONVERSION_FORMATS[d]);
+        }
+    }
+}
+
+TEST_F(ImageScaleTests, ScaleWithoutSimd)
+{
+    for (size_t i = 0; i < NUM_TEST_IMAGES; ++i)
+    {
+        Image src;
+        loadImage(src, TEST_IMAGES[i]);
+        // an odd width so that rows end within a group of SIMD pixels
+        const size_t sizes[][2] = { { src.getWidth() * 2 + 1, src.getHeight() * 2 },
+            { src.getWidth() / 2 + 1, src.getHeight() / 3 } };
+        for (size_t f = 0; f < NUM_FILTERS; ++f)
+        {
+            for (size_t s = 0; s < 2; ++s)
+            {
+                expectSameWithoutSimd(src.getPixelBox(), sizes[s][0], sizes[s][1], FILTERS[f],
+                    String(TEST_IMAGES[i]) + " " + FILTER_NAMES[f]);
+            }
+        }
+
+        // the byte resampler handles 1 to 4 channels
+        const PixelFormat byteFormats[] = { PF_L8, PF_BYTE_LA, PF_R8G8B8 };
+        for (size_t f = 0; f < 3; ++f)
+        {
+            vector<uchar>::type data(PixelUtil::getMemorySize(src.getWidth(), src.getHeight(), 1, byteFormats[f]));
+            PixelBox box(src.getWidth(), src.getHeight(), 1, byteFormats[f], &data[0]);
+            PixelUtil::bulkPixelConversion(src.getPixelBox(), box);
+            expectSameWithoutSimd(box, 97, 61, Image::FILTER_BILINEAR,
+                String(TEST_IMAGES[i]) + " " + PixelUtil::getFormatName(byteFormats[f]));
+        }
+    }
+}
+
+TEST_F(ImageScaleTests, Performance)
+{
+    // time the SIMD code against the fallbacks it has to match
+    const int NUM_RUNS = 4;
+    const PixelFormat formats[] = { PF_R8G8B8, PF_L8, PF_R5G6B5, PF_A2R10G10B10, PF_FLOAT32_RGBA };
+    const uint masks[] = { 0, ~0u };
+    const char* maskNames[] = { "scalar", "SIMD" };
+    for (size_t i = 0; i < NUM_TEST_IMAGES; ++i)
+    {
+        Image src;
+        loadImage(src, TEST_IMAGES[i]);
+        size_t width = src.getWidth(), height = src.getHeight();
+        LogManager::getSingleton().stream() << "Image " << TEST_IMAGES[i] << " " << width << "x" << height
+            << " " << PixelUtil::getFormatName(src.getFormat());
+
+        for (size_t f = 0; f < NUM_FILTERS; ++f)
+        {
+            vector<uchar>::type up[2], down[2];
+            for (size_t m = 0; m < 2; ++m)
+            {
+                up[m].resize(PixelUtil::getMemorySize(width * 2, height * 2, 1, src.getFormat()));
+                down[m].resize(PixelUtil::getMemorySize(width / 2, height / 2, 1, src.getFormat()));
+                PixelBox upBox(width * 2, height * 2, 1, src.getFormat(), &up[m][0]);
+                PixelBox downBox(width / 2, height / 2, 1, src.getFormat(), &down[m][0]);
+
+                PlatformInformation::_setCpuFeatureMask(masks[m]);
+                Timer timer;
+                for (int r = 0; r < NUM_RUNS; ++r)
+                    Image::scale(src.getPixelBox(), upBox, FILTERS[f]);
+                unsigned long upTime = timer.getMicroseconds() / NUM_RUNS;
+                timer.reset();
+                for (int r = 0; r < NUM_RUNS; ++r)
+                    Image::scale(src.getPixelBox(), downBox, FILTERS[f]);
+                unsigned long downTime = timer.getMicroseconds() / NUM_RUNS;
+                LogManager::getSingleton().stream() << "  " << FILTER_NAMES[f] << " " << maskNames[m]
+                    << " scale x2 " << upTime << " us, x0.5 " << downTime << " us";
+            }
+            PlatformInformation::_setCpuFeatureMask(~0u);
+            EXPECT_TRUE(up[0] == up[1]) << TEST_IMAGES[i] << " " << FILTER_NAMES[f];
+            EXPECT_TRUE(down[0] == down[1]) << TEST_IMAGES[i] << " " << FILTER_NAMES[f];
+        }
+
+        for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+        {
+            if (formats[f] == src.getFormat())
+                continue;
+            vector<uchar>::type converted[2];
+            for (size_t m = 0; m < 2; ++m)
+            {
+                converted[m].resize(PixelUtil::getMemorySize(width, height, 1, formats[f]));
+                PixelBox dst(width, height, 1, formats[f], &converted[m][0]);
+                PlatformInformation::_setCpuFeatureMask(masks[m]);
+                Timer timer;
+                for (int r = 0; r < NUM_RUNS; ++r)
+                    PixelUtil::bulkPixelConversion(src.getPixelBox(), dst);
+                LogManager::getSingleton().stream() << "  conversion to " << PixelUtil::getFormatName(formats[f])
+                    << " " << maskNames[m] << " " << timer.getMicroseconds() / NUM_RUNS << " us";
+            }
+            PlatformInformation::_setCpuFeatureMask(~0u);
+            EXPECT_TRUE(converted[0] == converted[1]) << TEST_IMAGES[i] << " to "
+                << PixelUtil::getFormatName(formats[f]);
+        }
+    }
+}
@@ -0,0 +1,298 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreLight.h"
+#include "OgreLightGrid.h"
+#include "OgreCamera.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTaskScheduler.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+using namespace Ogre;
+
+namespace {
+    /// numLights point and spot lights scattered over a 1000 unit cube, plus some which
+    /// cover everything
+    void createLights(SceneManager* sm, size_t numLights, LightList& lights)
+    {
+        srand(1234);
+        for (size_t i = 0; i < numLights; ++i)
+        {
+            Light* l = sm->createLight();
+            l->setType(i % 5 == 0 ? Light::LT_SPOTLIGHT : Light::LT_POINT);
+            l->setDirection(Vector3::NEGATIVE_UNIT_Y);
+            l->setAttenuation(Math::RangeRandom(20, 80), 1, 0, 0);
+            sm->getRootSceneNode()->createChildSceneNode(Vector3(Math::RangeRandom(0, 1000),
+                Math::RangeRandom(0, 1000), Math::RangeRandom(0, 1000)))->attachObject(l);
+            lights.push_back(l);
+
+            if (i % 50 == 25)
+            {
+                // a directional light and one with the default range
+                Light* dl = sm->createLight();
+                dl->setType(Light::LT_DIRECTIONAL);
+                lights.push_back(dl);
+                Light* hl = sm->createLight();
+                sm->getRootSceneNode()->createChildSceneNode(Vector3(500, 500, 500))->attachObject(hl);
+                lights.push_back(hl);
+            }
+        }
+        sm->getRootSceneNode()->_update(true, false);
+
+        // isInLightRange relies on the derived position being up to date
+        for (size_t i = 0; i < lights.size(); ++i)
+            lights[i]->getDerivedPosition();
+    }
+
+    template <class List>
+    bool sameLights(const LightList& a, const List& b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    /// The lights within range, in list order
+    template <class List>
+    void filterInRange(const List& lights, const Sphere& sphere, LightList& dest)
+    {
+        dest.clear();
+        for (size_t i = 0; i < lights.size(); ++i)
+        {
+            if (lights[i]->isInLightRange(sphere))
+                dest.push_back(lights[i]);
+        }
+    }
+}
+
+namespace {
+    /// Lets the test find the frustum lights and build the grid like _renderScene
+    class LightGridSceneManager : public DefaultSceneManager
+    {
+    public:
+        LightGridSceneManager(const String& name) : DefaultSceneManager(name) {}
+
+        using SceneManager::findLightsAffectingFrustum;
+        using SceneManager::updateLightGrid;
+    };
+
+    class LightGridSceneManagerFactory : public SceneManagerFactory
+    {
+    protected:
+        void initMetaData(void) const
+        {
+            mMetaData.typeName = "LightGridSceneManager";
+            mMetaData.sceneTypeMask = ST_GENERIC;
+            mMetaData.worldGeometrySupported = false;
+        }
+    public:
+        SceneManager* createInstance(const String& instanceName)
+        {
+            return OGRE_NEW LightGridSceneManager(instanceName);
+        }
+        void destroyInstance(SceneManager* instance)
+        {
+            OGRE_DELETE instance;
+        }
+    };
+
+    /// Populates the light lists of a range of positions
+    class PopulateBody : public ParallelForBody
+    {
+    public:
+        SceneManager* sm;
+        const vector<Vector3>::type* positions;
+        vector<LightList>::type* lists;
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                sm->_populateLightList((*positions)[i], 10, (*lists)[i]);
+        }
+    };
+}
+
+TEST(LightGrid,findLightsMatchesLinearSearch)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    LightList lights;
+    createLights(sm, 300, lights);
+
+    LightGrid grid;
+    grid.build(lights);
+    EXPECT_EQ(lights.size(), grid.getNumLights());
+
+    LightGrid::FoundLightList found;
+    LightList expected, actual;
+    size_t numCandidates = 0;
+    const int numQueries = 1000;
+    for (int q = 0; q < numQueries; ++q)
+    {
+        // mostly small objects, some large ones and some outside of the grid
+        Real radius = q % 10 == 0 ? Math::RangeRandom(100, 600) : Math::RangeRandom(0, 20);
+        Sphere sphere(Vector3(Math::RangeRandom(-200, 1200), Math::RangeRandom(-200, 1200),
+            Math::RangeRandom(-200, 1200)), radius);
+
+        grid.findLights(sphere, found);
+        numCandidates += found.size();
+
+        filterInRange(lights, sphere, expected);
+        filterInRange(found, sphere, actual);
+        ASSERT_TRUE(sameLights(expected, actual)) << "query " << q;
+    }
+
+    // the grid has to actually reduce the number of lights to test
+    EXPECT_LT(numCandidates, lights.size() * numQueries / 4);
+}
+
+TEST(LightGrid,directionalLightsOnly)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    LightList lights;
+    LightGrid::FoundLightList found;
+    for (int i = 0; i < 3; ++i)
+    {
+        Light* l = sm->createLight();
+        l->setType(Light::LT_DIRECTIONAL);
+        lights.push_back(l);
+    }
+
+    LightGrid grid;
+    grid.build(lights);
+    grid.findLights(Sphere(Vector3::ZERO, 1), found);
+    EXPECT_TRUE(sameLights(lights, found));
+}
+
+TEST(LightGrid,findLightsPerformance)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    LightList lights;
+    createLights(sm, 250, lights);
+
+    const int numQueries = 20000;
+    vector<Sphere>::type spheres;
+    for (int q = 0; q < numQueries; ++q)
+    {
+        spheres.push_back(Sphere(Vector3(Math::RangeRandom(0, 1000), Math::RangeRandom(0, 1000),
+            Math::RangeRandom(0, 1000)), Math::RangeRandom(1, 10)));
+    }
+
+    LightGrid::FoundLightList found;
+    LightList inRange;
+    size_t numFound = 0;
+    Timer timer;
+    for (int q = 0; q < numQueries; ++q)
+    {
+        filterInRange(lights, spheres[q], inRange);
+        numFound += inRange.size();
+    }
+    unsigned long linearTime = timer.getMicroseconds();
+
+    timer.reset();
+    LightGrid grid;
+    grid.build(lights);
+    size_t numFoundGrid = 0;
+    for (int q = 0; q < numQueries; ++q)
+    {
+        grid.findLights(spheres[q], found);
+        filterInRange(found, spheres[q], inRange);
+        numFoundGrid += inRange.size();
+    }
+    unsigned long gridTime = timer.getMicroseconds();
+
+    EXPECT_EQ(numFound, numFoundGrid);
+    LogManager::getSingleton().stream() << "Light lookup for " << numQueries << " objects, "
+        << lights.size() << " lights: linear " << linearTime << " us, grid " << gridTime << " us";
+}
+
+TEST(LightGrid,populateLightListConcurrently)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+    // cameras need a buffer manager
+    DefaultHardwareBufferManager bufMgr;
+    MaterialManager::getSingleton().initialise();
+    LightGridSceneManagerFactory factory;
+    root.addSceneManagerFactory(&factory);
+    LightGridSceneManager* sm = static_cast<LightGridSceneManager*>(
+        root.createSceneManager("LightGridSceneManager"));
+
+    LightList lights;
+    createLights(sm, 300, lights);
+    Camera* cam = sm->createCamera("cam");
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode(Vector3(500, 500, 3000));
+    camNode->attachObject(cam);
+    camNode->lookAt(Vector3(500, 500, 500), Node::TS_WORLD);
+    sm->findLightsAffectingFrustum(cam);
+    sm->updateLightGrid();
+    ASSERT_LE(size_t(LightGrid::MIN_LIGHTS), sm->_getLightsAffectingFrustum().size());
+
+    const size_t numPositions = 2000;
+    vector<Vector3>::type positions;
+    for (size_t i = 0; i < numPositions; ++i)
+    {
+        positions.push_back(Vector3(Math::RangeRandom(0, 1000), Math::RangeRandom(0, 1000),
+            Math::RangeRandom(0, 1000)));
+    }
+
+    vector<LightList>::type serial(numPositions), parallel(numPositions);
+    PopulateBody body;
+    body.sm = sm;
+    body.positions = &positions;
+    body.lists = &serial;
+    body.execute(0, numPositions);
+    body.lists = &parallel;
+    TaskScheduler::getSingleton().parallelFor(0, numPositions, 16, body);
+
+    size_t numFound = 0;
+    for (size_t i = 0; i < numPositions; ++i)
+    {
+        ASSERT_TRUE(sameLights(serial[i], parallel[i])) << "position " << i;
+        numFound += serial[i].size();
+        for (size_t j = 1; j < serial[i].size(); ++j)
+        {
+            // directional lights come first, regardless of their position
+            if (serial[i][j - 1]->getType() == Light::LT_DIRECTIONAL)
+                continue;
+            ASSERT_LE(positions[i].squaredDistance(serial[i][j - 1]->getDerivedPosition()),
+                      positions[i].squaredDistance(serial[i][j]->getDerivedPosition()));
+        }
+    }
+    EXPECT_LT(0U, numFound);
+
+    root.destroySceneManager(sm);
+    root.removeSceneManagerFactory(&factory);
+}
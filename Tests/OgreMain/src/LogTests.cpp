@@ -0,0 +1,267 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreLogManager.h"
+#include "OgreTaskScheduler.h"
+#include "OgreTimer.h"
+#include "OgreStringConverter.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace Ogre;
+
+namespace {
+    /// Every chunk logs a numbered sequence of messages of its own
+    class LoggingBody : public ParallelForBody
+    {
+    public:
+        Log* log;
+        int numMessages;
+
+        LoggingBody(Log* l, int n) : log(l), numMessages(n) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t p = begin; p < end; ++p)
+                for (int i = 0; i < numMessages; ++i)
+                    log->logMessage(StringConverter::toString(p) + " " + StringConverter::toString(i));
+        }
+    };
+
+    /// Counts the messages passed to it and remembers the last one
+    class CountingListener : public LogListener
+    {
+    public:
+        size_t count;
+        String last;
+
+        CountingListener() : count(0) {}
+
+        void messageLogged(const String& message, LogMessageLevel lml, bool maskDebug,
+                           const String& logName, bool& skipThisMessage)
+        {
+            ++count;
+            last = message;
+        }
+    };
+
+    /// Answers critical messages through the LogManager
+    class ReplyingListener : public LogListener
+    {
+    public:
+        void messageLogged(const String& message, LogMessageLevel lml, bool maskDebug,
+                           const String& logName, bool& skipThisMessage)
+        {
+            if (lml == LML_CRITICAL)
+                LogManager::getSingleton().logMessage("reply to " + message);
+        }
+    };
+
+    Log* createLog(const String& name)
+    {
+        Log* log = OGRE_NEW Log(name, false, false);
+        log->setTimeStampEnabled(false);
+        return log;
+    }
+
+    vector<String>::type readLines(const String& name)
+    {
+        vector<String>::type lines;
+        std::ifstream file(name.c_str());
+        String line;
+        while (std::getline(file, line))
+            lines.push_back(line);
+        return lines;
+    }
+}
+
+TEST(Log,asynchronousKeepsOrderPerThread)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+
+    const String name = "LogTests_async.log";
+    const size_t numProducers = 8;
+    const int numMessages = 2000;
+
+    Log* log = createLog(name);
+    log->setAsynchronous(true, 64);
+    EXPECT_TRUE(log->isAsynchronous() || !OGRE_THREAD_SUPPORT);
+
+    LoggingBody body(log, numMessages);
+    TaskScheduler::getSingleton().parallelFor(0, numProducers, 1, body);
+    log->flush();
+
+    vector<String>::type lines = readLines(name);
+    ASSERT_EQ(numProducers * numMessages, lines.size());
+
+    vector<int>::type next(numProducers, 0);
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        StringVector parts = StringUtil::split(lines[i], " ");
+        ASSERT_EQ(2U, parts.size()) << lines[i];
+        size_t p = StringConverter::parseSizeT(parts[0]);
+        ASSERT_LT(p, numProducers);
+        ASSERT_EQ(next[p], StringConverter::parseInt(parts[1])) << "producer " << p;
+        ++next[p];
+    }
+
+    OGRE_DELETE log;
+    std::remove(name.c_str());
+}
+
+TEST(Log,asynchronousListenersAndCriticalMessages)
+{
+    const String name = "LogTests_critical.log";
+    Log* log = createLog(name);
+    CountingListener listener;
+    log->addListener(&listener);
+    log->setAsynchronous(true);
+
+    for (int i = 0; i < 100; ++i)
+        log->logMessage("message " + StringConverter::toString(i));
+
+    // critical messages are written before logMessage returns
+    log->logMessage("failure", LML_CRITICAL);
+    vector<String>::type lines = readLines(name);
+    ASSERT_EQ(101U, lines.size());
+    EXPECT_EQ("failure", lines.back());
+    EXPECT_EQ(101U, listener.count);
+    EXPECT_EQ("failure", listener.last);
+
+    // switching back writes the queued messages
+    log->logMessage("last");
+    log->setAsynchronous(false);
+    EXPECT_FALSE(log->isAsynchronous());
+    EXPECT_EQ(102U, listener.count);
+    EXPECT_EQ("last", listener.last);
+
+    log->removeListener(&listener);
+    OGRE_DELETE log;
+    EXPECT_EQ(102U, readLines(name).size());
+    std::remove(name.c_str());
+}
+
+TEST(Log,asynchronousListenerChanges)
+{
+    const String name = "LogTests_listeners.log";
+    Log* log = createLog(name);
+    log->setAsynchronous(true, 16);
+
+    // the writer thread calls the listeners while they are added and
+    // removed, a removed listener must not be called anymore
+    CountingListener listeners[2];
+    for (int i = 0; i < 200; ++i)
+    {
+        CountingListener& listener = listeners[i % 2];
+        log->addListener(&listener);
+        for (int j = 0; j < 20; ++j)
+            log->logMessage("message");
+        log->setLogDetail(i % 3 ? LL_NORMAL : LL_BOREME);
+        log->removeListener(&listener);
+
+        size_t count = listener.count;
+        log->flush();
+        EXPECT_EQ(count, listener.count);
+    }
+
+    OGRE_DELETE log;
+    EXPECT_EQ(4000U, readLines(name).size());
+    std::remove(name.c_str());
+}
+
+TEST(Log,asynchronousListenerLogsThroughManager)
+{
+    const String name = "LogTests_reentrant.log";
+    LogManager& mgr = LogManager::getSingleton();
+    Log* defaultLog = mgr.getDefaultLog();
+    Log* log = mgr.createLog(name, true, false, false);
+    log->setTimeStampEnabled(false);
+    ReplyingListener listener;
+    log->addListener(&listener);
+    log->setAsynchronous(true, 4);
+
+    // the writer thread calls the listener while this thread waits for the
+    // critical messages or for room in the small queue
+    for (int i = 0; i < 50; ++i)
+    {
+        mgr.logMessage("message " + StringConverter::toString(i));
+        if (i % 10 == 9)
+            mgr.logMessage("failure " + StringConverter::toString(i), LML_CRITICAL);
+    }
+    log->flush();
+
+    vector<String>::type lines = readLines(name);
+    ASSERT_EQ(60U, lines.size());
+    // the reply is written right away, before the message it answers
+    EXPECT_EQ("reply to failure 49", lines[58]);
+    EXPECT_EQ("failure 49", lines[59]);
+
+    log->removeListener(&listener);
+    mgr.setDefaultLog(defaultLog);
+    mgr.destroyLog(log);
+    std::remove(name.c_str());
+}
+
+TEST(Log,asynchronousPerformance)
+{
+    Root root("");
+
+    const String name = "LogTests_perf.log";
+    const size_t numProducers = 4;
+    const int numMessages = 5000;
+    const size_t total = numProducers * numMessages;
+
+    Log* log = createLog(name);
+    log->setTimeStampEnabled(true);
+    LoggingBody body(log, numMessages);
+
+    // from the calling thread only, synchronous logging is not thread safe
+    // with every threading configuration
+    Timer timer;
+    body.execute(0, numProducers);
+    unsigned long syncTime = timer.getMicroseconds();
+
+    log->setAsynchronous(true);
+    timer.reset();
+    body.execute(0, numProducers);
+    unsigned long asyncTime = timer.getMicroseconds();
+    log->flush();
+    unsigned long asyncFlushedTime = timer.getMicroseconds();
+
+    OGRE_DELETE log;
+    EXPECT_EQ(total * 2, readLines(name).size());
+    std::remove(name.c_str());
+
+    LogManager::getSingleton().stream() << "Logging " << total << " messages: synchronous " << syncTime << " us ("
+        << float(syncTime) / total << " us per message), asynchronous " << asyncTime
+        << " us (" << float(asyncTime) / total << " us per message), "
+        << asyncFlushedTime << " us until written";
+}
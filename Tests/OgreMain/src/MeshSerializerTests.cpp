@@ -73,6 +73,7 @@ THE SOFTWARE.
 void MeshSerializerTests::SetUp()
 {
     mErrorFactor = 0.05;
+    mMemoryMapping = FileSystemArchive::getMemoryMappingEnabled();
 
     mFSLayer = OGRE_NEW_T(Ogre::FileSystemLayer, Ogre::MEMCATEGORY_GENERAL)(OGRE_VERSION_NAME);
 
@@ -138,6 +139,9 @@ void MeshSerializerTests::SetUp()
 //--------------------------------------------------------------------------
 void MeshSerializerTests::TearDown()
 {
+    // tests may change it and fail before resetting it
+    FileSystemArchive::setMemoryMappingEnabled(mMemoryMapping);
+
     // Copy back original file.
     if (!mMeshFullPath.empty()) {
         copyFile(mMeshFullPath + ".bak", mMeshFullPath);
@@ -225,6 +229,21 @@ TEST_F(MeshSerializerTests,Mesh_Version_1_3)
     testMesh(MESH_VERSION_1_0);
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_MemoryMapped)
+{
+    FileSystemArchive::setMemoryMappingEnabled(true);
+
+    // buffers are filled straight from the mapped file
+    testMesh(MESH_VERSION_LATEST);
+
+    // flipped data still has to be copied and converted
+    MeshSerializer serializer;
+    serializer.exportMesh(mOrigMesh.get(), mMeshFullPath,
+        OGRE_ENDIAN == OGRE_ENDIAN_BIG ? Serializer::ENDIAN_LITTLE : Serializer::ENDIAN_BIG);
+    mMesh->reload();
+    assertMeshClone(mOrigMesh.get(), mMesh.get());
+}
+//--------------------------------------------------------------------------
 #ifdef I_HAVE_LOT_OF_FREE_TIME
 TEST_F(MeshSerializerTests,Mesh_Version_1_2)
 {
@@ -0,0 +1,335 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreSceneNode.h"
+#include "OgreEntity.h"
+#include "OgreCamera.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreBone.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationState.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreConfigFile.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t NUM_ENTITIES = 12;
+}
+
+class ParallelSkeletalAnimationTests : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        mFSLayer = OGRE_NEW_T(FileSystemLayer, MEMCATEGORY_GENERAL)(OGRE_VERSION_NAME);
+        mRoot = OGRE_NEW Root("");
+        mHBM = OGRE_NEW DefaultHardwareBufferManager;
+        MaterialManager::getSingleton().initialise();
+
+        ConfigFile cf;
+        cf.load(mFSLayer->getConfigFilePath("resources.cfg"));
+
+        ConfigFile::SettingsBySection_::const_iterator seci;
+        for (seci = cf.getSettingsBySection().begin(); seci != cf.getSettingsBySection().end(); ++seci)
+        {
+            ConfigFile::SettingsMultiMap::const_iterator i;
+            for (i = seci->second.begin(); i != seci->second.end(); ++i)
+            {
+                if (i->first == "FileSystem" && StringUtil::endsWith(i->second, "/models"))
+                    ResourceGroupManager::getSingleton().addResourceLocation(i->second, "FileSystem");
+            }
+        }
+        ResourceGroupManager::getSingleton().initialiseAllResourceGroups();
+
+        mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+        mSceneMgr->setParallelSkeletalAnimation(true);
+        for (size_t i = 0; i < NUM_ENTITIES; ++i)
+        {
+            Entity* entity = mSceneMgr->createEntity("robot.mesh");
+            mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(entity);
+            mEntities.push_back(entity);
+
+            // The same entity outside of the scene is animated as before
+            mReferences.push_back(mSceneMgr->createEntity("robot.mesh"));
+        }
+
+        // Entities sharing a skeleton are evaluated once
+        mEntities[1]->shareSkeletonInstanceWith(mEntities[0]);
+        mReferences[1]->shareSkeletonInstanceWith(mReferences[0]);
+
+        mAnimationName = mEntities[0]->getSkeleton()->getAnimation(0)->getName();
+        for (size_t i = 0; i < NUM_ENTITIES; ++i)
+        {
+            if (i == 1)
+                continue;
+            setTime(i, i * 0.1f);
+            mEntities[i]->getAnimationState(mAnimationName)->setEnabled(true);
+            mReferences[i]->getAnimationState(mAnimationName)->setEnabled(true);
+        }
+    }
+
+    void TearDown()
+    {
+        OGRE_DELETE mRoot;
+        OGRE_DELETE mHBM;
+        OGRE_DELETE_T(mFSLayer, FileSystemLayer, MEMCATEGORY_GENERAL);
+    }
+
+    void setTime(size_t i, Real time)
+    {
+        mEntities[i]->getAnimationState(mAnimationName)->setTimePosition(time);
+        mReferences[i]->getAnimationState(mAnimationName)->setTimePosition(time);
+    }
+
+    /// Run the skeletal animation stage of a new frame, returns what it did
+    SceneManager::SkeletalAnimationStatistics updateFrame(Camera* cam = 0)
+    {
+        mRoot->_fireFrameRenderingQueued();
+
+        // the statistics are only reset by rendering the scene
+        SceneManager::SkeletalAnimationStatistics before = mSceneMgr->getSkeletalAnimationStatistics();
+        mSceneMgr->_updateSkeletalAnimation(cam);
+        SceneManager::SkeletalAnimationStatistics stats = mSceneMgr->getSkeletalAnimationStatistics();
+        stats.numEvaluated -= before.numEvaluated;
+        stats.numReduced -= before.numReduced;
+        stats.numUnchanged -= before.numUnchanged;
+        stats.numThrottled -= before.numThrottled;
+        return stats;
+    }
+
+    void expectMatrices(const Matrix4* expected, const Matrix4* matrices, unsigned short count, size_t entity)
+    {
+        for (unsigned short b = 0; b < count; ++b)
+        {
+            for (size_t e = 0; e < 16; ++e)
+            {
+                ASSERT_NEAR(expected[b][e / 4][e % 4], matrices[b][e / 4][e % 4], 1e-4f)
+                    << "entity " << entity << " bone " << b;
+            }
+        }
+    }
+
+    /// Update the skeletons for a new frame and compare them with the serial update
+    void update(size_t expectedEvaluated)
+    {
+        SceneManager::SkeletalAnimationStatistics stats = updateFrame();
+        EXPECT_EQ(expectedEvaluated, stats.numEvaluated);
+        EXPECT_EQ(NUM_ENTITIES - 1 - expectedEvaluated, stats.numUnchanged);
+
+        for (size_t i = 0; i < NUM_ENTITIES; ++i)
+        {
+            // already evaluated this frame, so this must not change anything
+            mEntities[i]->_updateAnimation();
+            mReferences[i]->_updateAnimation();
+
+            expectMatrices(mReferences[i]->_getBoneMatrices(), mEntities[i]->_getBoneMatrices(),
+                mEntities[i]->_getNumBoneMatrices(), i);
+        }
+    }
+
+    Root* mRoot;
+    HardwareBufferManager* mHBM;
+    FileSystemLayer* mFSLayer;
+    SceneManager* mSceneMgr;
+    vector<Entity*>::type mEntities;
+    vector<Entity*>::type mReferences;
+    String mAnimationName;
+};
+
+TEST_F(ParallelSkeletalAnimationTests, MatchesSerialUpdate)
+{
+    update(NUM_ENTITIES - 1);
+
+    // nothing changed
+    update(0);
+
+    // only the entities whose animation moved are evaluated again
+    setTime(2, 0.5f);
+    setTime(5, 0.7f);
+    mEntities[3]->getAnimationState(mAnimationName)->setWeight(0.5f);
+    mReferences[3]->getAnimationState(mAnimationName)->setWeight(0.5f);
+    update(3);
+
+    // manual bones are picked up as well
+    Bone* bone = mEntities[4]->getSkeleton()->getBone(1);
+    bone->setManuallyControlled(true);
+    bone->yaw(Degree(30));
+    bone = mReferences[4]->getSkeleton()->getBone(1);
+    bone->setManuallyControlled(true);
+    bone->yaw(Degree(30));
+    update(1);
+
+    // invisible entities are left to the render queue update
+    mEntities[6]->setVisible(false);
+    setTime(6, 1.0f);
+    setTime(7, 1.0f);
+    SceneManager::SkeletalAnimationStatistics stats = updateFrame();
+    EXPECT_EQ(size_t(1), stats.numEvaluated);
+    EXPECT_EQ(size_t(NUM_ENTITIES - 3), stats.numUnchanged);
+    mEntities[6]->setVisible(true);
+    update(1);
+}
+
+TEST_F(ParallelSkeletalAnimationTests, AnimationLod)
+{
+    update(NUM_ENTITIES - 1);
+
+    // Beyond 1000 units entity 2 is evaluated every 3rd frame, at key frames and
+    // for the two top levels of its bone hierarchy only
+    Entity::AnimationLodLevelList levels;
+    levels.push_back(Entity::AnimationLodLevel(1000, 3, 1, true));
+    mEntities[2]->setAnimationLodLevels(levels);
+    EXPECT_EQ(0, mEntities[2]->getAnimationLodIndex());
+
+    Camera* cam = mSceneMgr->createCamera("LodCamera");
+    SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 5000));
+    camNode->attachObject(cam);
+
+    Entity* entity = mEntities[2];
+    SkeletonInstance* reference = mReferences[2]->getSkeleton();
+    AnimationStateSet* referenceStates = mReferences[2]->getAllAnimationStates();
+    unsigned short numBones = entity->_getNumBoneMatrices();
+    vector<Matrix4>::type expected(numBones), full(numBones);
+
+    // the skeleton was just evaluated, so the coarser level waits for the update interval
+    // although the animation moves on
+    for (int f = 0; f < 2; ++f)
+    {
+        reference->_getBoneMatrices(&expected[0]);
+        setTime(2, 0.25f + f * 0.1f);
+        SceneManager::SkeletalAnimationStatistics stats = updateFrame(cam);
+        EXPECT_EQ(1, entity->getAnimationLodIndex());
+        EXPECT_EQ(size_t(1), stats.numThrottled);
+        EXPECT_EQ(size_t(0), stats.numReduced);
+        EXPECT_EQ(size_t(0), stats.numEvaluated);
+        EXPECT_EQ(size_t(NUM_ENTITIES - 2), stats.numUnchanged);
+        expectMatrices(&expected[0], entity->_getBoneMatrices(), numBones, 2);
+    }
+
+    // then it is evaluated at key frames for the top of the hierarchy only
+    setTime(2, 0.45f);
+    SceneManager::SkeletalAnimationStatistics stats = updateFrame(cam);
+    EXPECT_EQ(size_t(1), stats.numReduced);
+    EXPECT_EQ(size_t(0), stats.numThrottled);
+
+    reference->setAnimationState(*referenceStates, 1, true);
+    reference->_getBoneMatrices(&expected[0]);
+    expectMatrices(&expected[0], entity->_getBoneMatrices(), numBones, 2);
+    reference->setAnimationState(*referenceStates);
+    reference->_getBoneMatrices(&full[0]);
+    bool reduced = false;
+    for (unsigned short b = 0; b < numBones; ++b)
+    {
+        for (size_t e = 0; e < 16; ++e)
+            reduced |= !Math::RealEqual(full[b][e / 4][e % 4], expected[b][e / 4][e % 4], 1e-4f);
+    }
+    EXPECT_TRUE(reduced);
+
+    for (int f = 0; f < 2; ++f)
+    {
+        setTime(2, 0.55f + f * 0.1f);
+        stats = updateFrame(cam);
+        EXPECT_EQ(size_t(1), stats.numThrottled);
+        expectMatrices(&expected[0], entity->_getBoneMatrices(), numBones, 2);
+    }
+    setTime(2, 0.8f);
+    stats = updateFrame(cam);
+    EXPECT_EQ(size_t(1), stats.numReduced);
+    reference->setAnimationState(*referenceStates, 1, true);
+    reference->_getBoneMatrices(&expected[0]);
+    expectMatrices(&expected[0], entity->_getBoneMatrices(), numBones, 2);
+
+    // without a camera the level is kept
+    setTime(2, 0.9f);
+    stats = updateFrame();
+    EXPECT_EQ(1, entity->getAnimationLodIndex());
+    EXPECT_EQ(size_t(1), stats.numThrottled);
+
+    // close to the camera it gets full detail in the same frame
+    camNode->setPosition(0, 0, 200);
+    stats = updateFrame(cam);
+    EXPECT_EQ(0, entity->getAnimationLodIndex());
+    EXPECT_EQ(size_t(1), stats.numEvaluated);
+    EXPECT_EQ(size_t(NUM_ENTITIES - 2), stats.numUnchanged);
+    reference->setAnimationState(*referenceStates);
+    reference->_getBoneMatrices(&expected[0]);
+    expectMatrices(&expected[0], entity->_getBoneMatrices(), numBones, 2);
+
+    // levels must be in order of decreasing detail
+    levels.push_back(Entity::AnimationLodLevel(500));
+    EXPECT_THROW(mEntities[3]->setAnimationLodLevels(levels), InvalidParametersException);
+}
+
+TEST_F(ParallelSkeletalAnimationTests, Performance)
+{
+    const int NUM_FRAMES = 200;
+    Matrix4 matrices[256];
+    Timer timer;
+    for (int f = 0; f < NUM_FRAMES; ++f)
+    {
+        for (size_t i = 0; i < NUM_ENTITIES; ++i)
+        {
+            AnimationStateSet* states = mReferences[i]->getAllAnimationStates();
+            states->getAnimationState(mAnimationName)->addTime(0.01f);
+            mReferences[i]->getSkeleton()->setAnimationState(*states);
+            mReferences[i]->getSkeleton()->_getBoneMatrices(matrices);
+        }
+    }
+    unsigned long serialTime = timer.getMicroseconds();
+
+    timer.reset();
+    for (int f = 0; f < NUM_FRAMES; ++f)
+    {
+        mRoot->_fireFrameRenderingQueued();
+        for (size_t i = 0; i < NUM_ENTITIES; ++i)
+            mEntities[i]->getAnimationState(mAnimationName)->addTime(0.01f);
+        mSceneMgr->_updateSkeletalAnimation();
+    }
+    unsigned long parallelTime = timer.getMicroseconds();
+
+    timer.reset();
+    for (int f = 0; f < NUM_FRAMES; ++f)
+    {
+        mRoot->_fireFrameRenderingQueued();
+        mSceneMgr->_updateSkeletalAnimation();
+    }
+    unsigned long unchangedTime = timer.getMicroseconds();
+
+    LogManager::getSingleton().stream() << "Evaluating " << NUM_FRAMES << " x " << NUM_ENTITIES
+        << " skeletons: serial " << serialTime << " us, parallel " << parallelTime
+        << " us, parallel without changes " << unchangedTime << " us";
+}
@@ -0,0 +1,617 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticleAffector.h"
+#include "OgreParticleAffectorFactory.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticle.h"
+#include "OgreMaterialManager.h"
+#include "OgreControllerManager.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "OgreTaskScheduler.h"
+#include "OgreAtomicScalar.h"
+#include "OgreBillboardParticleRenderer.h"
+#include "OgreConfigFile.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Accelerates and fades particles, one particle at a time
+    class RangeAffector : public ParticleAffector
+    {
+    public:
+        RangeAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "TestRange"; }
+
+        void _affectParticleRange(Particle* const* particles, size_t count, Real timeElapsed)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                particles[i]->mDirection.y -= 9.81f * timeElapsed;
+                particles[i]->mColour.a -= 0.5f * timeElapsed;
+            }
+        }
+
+        bool _isParticleRangeSupported(void) const { return true; }
+
+        bool _isParallelUpdateSupported(void) const { return true; }
+    };
+
+    /// The same as RangeAffector, using the interface older affectors implement
+    class SystemAffector : public ParticleAffector
+    {
+    public:
+        SystemAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "TestSystem"; }
+
+        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+        {
+            ParticleIterator pi = pSystem->_getIterator();
+            while (!pi.end())
+            {
+                Particle* p = pi.getNext();
+                p->mDirection.y -= 9.81f * timeElapsed;
+                p->mColour.a -= 0.5f * timeElapsed;
+            }
+        }
+    };
+
+    /// Implements neither _affectParticles nor _affectParticleRange
+    class IncompleteAffector : public ParticleAffector
+    {
+    public:
+        IncompleteAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "TestIncomplete"; }
+    };
+
+#if OGRE_THREAD_SUPPORT
+    /// Counts the systems being updated at the same time
+    AtomicScalar<size_t> numUpdating(0);
+    AtomicScalar<size_t> maxUpdating(0);
+
+    /// Waits a while for another system to be updated concurrently, which only a worker can do
+    class ConcurrencyAffector : public ParticleAffector
+    {
+    public:
+        ConcurrencyAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "TestConcurrency"; }
+
+        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+        {
+            size_t n = ++numUpdating;
+            size_t max = maxUpdating.load();
+            while (n > max && !maxUpdating.compare_exchange_strong(max, n))
+                max = maxUpdating.load();
+
+            Timer timer;
+            while (maxUpdating.load() < 2 && timer.getMilliseconds() < 100)
+                ;
+            --numUpdating;
+        }
+
+        bool _isParallelUpdateSupported(void) const { return true; }
+    };
+#endif
+
+    /// Overrides the particle callbacks taking a list, like renderers written for older versions
+    class ListRenderer : public BillboardParticleRenderer
+    {
+    public:
+        size_t numMoved;
+        size_t numCleared;
+        size_t numParticles;
+
+        ListRenderer() : numMoved(0), numCleared(0), numParticles(0) {}
+
+        const String& getType(void) const
+        {
+            static const String type = "TestList";
+            return type;
+        }
+
+        void _notifyParticleMoved(list<Particle*>::type& currentParticles)
+        {
+            ++numMoved;
+            numParticles = currentParticles.size();
+        }
+
+        void _notifyParticleCleared(list<Particle*>::type& currentParticles)
+        {
+            ++numCleared;
+        }
+    };
+
+    class ListRendererFactory : public ParticleSystemRendererFactory
+    {
+    public:
+        const String& getType() const
+        {
+            static const String type = "TestList";
+            return type;
+        }
+
+        ParticleSystemRenderer* createInstance(const String& name) { return OGRE_NEW ListRenderer(); }
+
+        void destroyInstance(ParticleSystemRenderer* inst) { OGRE_DELETE inst; }
+    };
+
+    template <class T>
+    class TestAffectorFactory : public ParticleAffectorFactory
+    {
+        String mName;
+    public:
+        TestAffectorFactory(const String& name) : mName(name) {}
+
+        String getName() const { return mName; }
+
+        ParticleAffector* createAffector(ParticleSystem* psys)
+        {
+            ParticleAffector* a = OGRE_NEW T(psys);
+            mAffectors.push_back(a);
+            return a;
+        }
+    };
+
+    /// Manually emit particles with varying lifetimes, mTotalTimeToLive identifies them
+    void emitParticles(ParticleSystem* ps, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Particle* p = ps->createParticle();
+            ASSERT_TRUE(p != 0);
+            p->mPosition = Vector3(Real(i), 0, 0);
+            p->mDirection = Vector3(0, Real(i % 7), 1);
+            p->mColour = ColourValue::White;
+            p->mTimeToLive = Real(i % 53) * 0.01f + 0.005f;
+            p->mTotalTimeToLive = Real(i);
+        }
+    }
+
+    typedef map<Real, Particle*>::type ParticleMap;
+
+    ParticleMap getParticles(ParticleSystem* ps)
+    {
+        ParticleMap ret;
+        for (size_t i = 0; i < ps->getNumParticles(); ++i)
+        {
+            Particle* p = ps->getParticle(i);
+            EXPECT_TRUE(ret.insert(std::make_pair(p->mTotalTimeToLive, p)).second);
+        }
+        return ret;
+    }
+
+    class ParticleSystemTests : public ::testing::Test
+    {
+    protected:
+        Root* mRoot;
+        SceneManager* mSceneMgr;
+        ControllerManager* mControllerMgr;
+        TestAffectorFactory<RangeAffector>* mRangeFactory;
+        TestAffectorFactory<SystemAffector>* mSystemFactory;
+        TestAffectorFactory<IncompleteAffector>* mIncompleteFactory;
+        ListRendererFactory* mListRendererFactory;
+#if OGRE_THREAD_SUPPORT
+        TestAffectorFactory<ConcurrencyAffector>* mConcurrencyFactory;
+#endif
+
+        void SetUp()
+        {
+            mRoot = OGRE_NEW Root("");
+            // what Root::initialise would do, without needing a render system
+            MaterialManager::getSingleton().initialise();
+            ParticleSystemManager::getSingleton()._initialise();
+            mControllerMgr = OGRE_NEW ControllerManager();
+            mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+            mRangeFactory = OGRE_NEW TestAffectorFactory<RangeAffector>("TestRange");
+            mSystemFactory = OGRE_NEW TestAffectorFactory<SystemAffector>("TestSystem");
+            ParticleSystemManager::getSingleton().addAffectorFactory(mRangeFactory);
+            ParticleSystemManager::getSingleton().addAffectorFactory(mSystemFactory);
+            mIncompleteFactory = OGRE_NEW TestAffectorFactory<IncompleteAffector>("TestIncomplete");
+            ParticleSystemManager::getSingleton().addAffectorFactory(mIncompleteFactory);
+            mListRendererFactory = OGRE_NEW ListRendererFactory();
+            ParticleSystemManager::getSingleton().addRendererFactory(mListRendererFactory);
+#if OGRE_THREAD_SUPPORT
+            mConcurrencyFactory = OGRE_NEW TestAffectorFactory<ConcurrencyAffector>("TestConcurrency");
+            ParticleSystemManager::getSingleton().addAffectorFactory(mConcurrencyFactory);
+#endif
+        }
+
+        /// Loads the ParticleFX plugin listed in plugins.cfg, returns false if there is none
+        bool loadParticleFX(void)
+        {
+#ifndef OGRE_STATIC_LIB
+            try
+            {
+                ConfigFile cfg;
+                cfg.load("plugins.cfg");
+                StringVector plugins = cfg.getMultiSetting("Plugin");
+                for (StringVector::iterator i = plugins.begin(); i != plugins.end(); ++i)
+                {
+                    if (StringUtil::startsWith(*i, "Plugin_ParticleFX", false))
+                        mRoot->loadPlugin(cfg.getSetting("PluginFolder") + "/" + *i);
+                }
+            }
+            catch (Exception&)
+            {
+            }
+#endif
+            return ParticleSystemManager::getSingleton().getEmitterFactoryIterator().hasMoreElements();
+        }
+
+        /// Systems are only updated while attached
+        ParticleSystem* createSystem(const String& name, size_t quota)
+        {
+            ParticleSystem* ps = mSceneMgr->createParticleSystem(name, quota);
+            mSceneMgr->getRootSceneNode()->attachObject(ps);
+            return ps;
+        }
+
+        void TearDown()
+        {
+            mSceneMgr->destroyAllParticleSystems();
+            OGRE_DELETE mControllerMgr;
+            OGRE_DELETE mRoot;
+            OGRE_DELETE mRangeFactory;
+            OGRE_DELETE mSystemFactory;
+            OGRE_DELETE mIncompleteFactory;
+            OGRE_DELETE mListRendererFactory;
+#if OGRE_THREAD_SUPPORT
+            OGRE_DELETE mConcurrencyFactory;
+#endif
+        }
+    };
+}
+
+TEST_F(ParticleSystemTests,expireKeepsLiveParticles)
+{
+    ParticleSystem* ps = createSystem("ps", 1000);
+    ps->_update(0);
+    emitParticles(ps, 1000);
+
+    const Real dt = 0.1f;
+    ps->_update(dt);
+
+    // every particle either expired or lost dt of its life, nothing got lost or duplicated
+    ParticleMap alive = getParticles(ps);
+    size_t expected = 0;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        Real ttl = Real(i % 53) * 0.01f + 0.005f;
+        if (ttl < dt)
+            continue;
+
+        ++expected;
+        ParticleMap::iterator it = alive.find(Real(i));
+        ASSERT_TRUE(it != alive.end()) << "particle " << i;
+        EXPECT_FLOAT_EQ(ttl - dt, it->second->mTimeToLive);
+        EXPECT_EQ(Vector3(Real(i), Real(i % 7) * dt, dt), it->second->mPosition);
+    }
+    EXPECT_EQ(expected, alive.size());
+
+    // expired particles are reused
+    emitParticles(ps, 1000 - expected);
+    EXPECT_EQ(1000U, ps->getNumParticles());
+    EXPECT_TRUE(ps->createParticle() == 0);
+
+    ps->clear();
+    EXPECT_EQ(0U, ps->getNumParticles());
+    emitParticles(ps, 1000);
+    EXPECT_EQ(1000U, ps->getNumParticles());
+}
+
+TEST_F(ParticleSystemTests,expireKeepsParticleOrder)
+{
+    // unsorted systems are drawn in the order of the active particles
+    ParticleSystem* range = createSystem("range", 1000);
+    range->addAffector("TestRange");
+    ParticleSystem* system = createSystem("system", 1000);
+    system->addAffector("TestSystem");
+
+    ParticleSystem* systems[] = { range, system };
+    for (int s = 0; s < 2; ++s)
+    {
+        systems[s]->_update(0);
+        emitParticles(systems[s], 1000);
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            systems[s]->_update(0.1f);
+            ASSERT_LT(0U, systems[s]->getNumParticles());
+            for (size_t i = 1; i < systems[s]->getNumParticles(); ++i)
+            {
+                ASSERT_LT(systems[s]->getParticle(i - 1)->mTotalTimeToLive,
+                          systems[s]->getParticle(i)->mTotalTimeToLive);
+            }
+        }
+    }
+}
+
+TEST_F(ParticleSystemTests,listRendererCallbacks)
+{
+    ParticleSystem* ps = createSystem("ps", 100);
+    ps->setRenderer("TestList");
+    ListRenderer* renderer = static_cast<ListRenderer*>(ps->getRenderer());
+    ps->_update(0);
+    emitParticles(ps, 100);
+
+    size_t numMoved = renderer->numMoved;
+    ps->_update(0.1f);
+    EXPECT_EQ(numMoved + 1, renderer->numMoved);
+    EXPECT_EQ(ps->getNumParticles(), renderer->numParticles);
+
+    ps->clear();
+    EXPECT_EQ(1U, renderer->numCleared);
+}
+
+TEST_F(ParticleSystemTests,incompleteAffectorThrows)
+{
+    ParticleSystem* ps = createSystem("ps", 10);
+    ps->addAffector("TestIncomplete");
+    ps->_update(0);
+    emitParticles(ps, 10);
+    EXPECT_THROW(ps->_update(0.001f), Exception);
+}
+
+TEST_F(ParticleSystemTests,rangeAffectorsMatchSystemAffectors)
+{
+    ParticleSystem* range = createSystem("range", 2000);
+    range->addAffector("TestRange");
+    ParticleSystem* system = createSystem("system", 2000);
+    system->addAffector("TestSystem");
+    // one affector without range support makes the whole system use separate passes
+    ParticleSystem* mixed = createSystem("mixed", 2000);
+    mixed->addAffector("TestRange");
+    mixed->addAffector("TestSystem");
+    ParticleSystem* twice = createSystem("twice", 2000);
+    twice->addAffector("TestRange");
+    twice->addAffector("TestRange");
+
+    range->_update(0);
+    system->_update(0);
+    mixed->_update(0);
+    twice->_update(0);
+    emitParticles(range, 2000);
+    emitParticles(system, 2000);
+    emitParticles(mixed, 2000);
+    emitParticles(twice, 2000);
+
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        range->_update(0.03f);
+        system->_update(0.03f);
+        mixed->_update(0.03f);
+        twice->_update(0.03f);
+
+        ParticleMap a = getParticles(range);
+        ParticleMap b = getParticles(system);
+        ParticleMap c = getParticles(mixed);
+        ParticleMap d = getParticles(twice);
+        ASSERT_EQ(a.size(), b.size());
+        ASSERT_EQ(c.size(), d.size());
+        ASSERT_EQ(a.size(), c.size());
+
+        ParticleMap::iterator ia = a.begin(), ib = b.begin(), ic = c.begin(), id = d.begin();
+        for (; ia != a.end(); ++ia, ++ib, ++ic, ++id)
+        {
+            ASSERT_EQ(ia->first, ib->first);
+            ASSERT_EQ(ic->first, id->first);
+            ASSERT_EQ(ia->first, ic->first);
+            EXPECT_EQ(ia->second->mPosition, ib->second->mPosition);
+            EXPECT_EQ(ia->second->mDirection, ib->second->mDirection);
+            EXPECT_EQ(ia->second->mColour, ib->second->mColour);
+            EXPECT_EQ(ic->second->mPosition, id->second->mPosition);
+            EXPECT_EQ(ic->second->mDirection, id->second->mDirection);
+            EXPECT_EQ(ic->second->mColour, id->second->mColour);
+        }
+    }
+}
+
+TEST_F(ParticleSystemTests,updatePerformance)
+{
+    const size_t numParticles = 100000;
+    ParticleSystem* range = createSystem("range", numParticles);
+    range->addAffector("TestRange");
+    ParticleSystem* system = createSystem("system", numParticles);
+    system->addAffector("TestSystem");
+
+    ParticleSystem* systems[] = { system, range };
+    const char* names[] = { "separate passes", "blocks" };
+    Timer timer;
+    for (int s = 0; s < 2; ++s)
+    {
+        systems[s]->_update(0);
+        unsigned long total = 0;
+        for (int run = 0; run < 5; ++run)
+        {
+            systems[s]->clear();
+            emitParticles(systems[s], numParticles);
+            timer.reset();
+            for (int frame = 0; frame < 10; ++frame)
+                systems[s]->_update(0.001f);
+            total += timer.getMicroseconds();
+        }
+        LogManager::getSingleton().logMessage("Particle update of " +
+            StringConverter::toString(numParticles) + " particles using " + names[s] + ": " +
+            StringConverter::toString(total / 50) + " us per frame");
+    }
+}
+
+TEST_F(ParticleSystemTests,parallelUpdateMatchesSerial)
+{
+    const size_t numSystems = 8;
+    ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+    ParticleSystem* serial[numSystems];
+    ParticleSystem* parallel[numSystems];
+    for (size_t s = 0; s < numSystems; ++s)
+    {
+        serial[s] = createSystem("serial" + StringConverter::toString(s), 1000);
+        serial[s]->addAffector("TestRange");
+        parallel[s] = createSystem("parallel" + StringConverter::toString(s), 1000);
+        parallel[s]->addAffector("TestRange");
+        serial[s]->_update(0);
+        parallel[s]->_update(0);
+        emitParticles(serial[s], 1000);
+        emitParticles(parallel[s], 1000);
+    }
+
+    // the default renderer and the range affector support it, older affectors don't
+    EXPECT_TRUE(parallel[0]->_isParallelUpdateSupported());
+    ParticleSystem* system = createSystem("system", 10);
+    system->addAffector("TestSystem");
+    EXPECT_FALSE(system->_isParallelUpdateSupported());
+
+    mgr.setParallelUpdate(true);
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        for (size_t s = 0; s < numSystems; ++s)
+        {
+            serial[s]->_update(0.03f);
+            mgr._queueUpdate(parallel[s], 0.03f);
+        }
+        mgr._updateQueuedSystems();
+
+        for (size_t s = 0; s < numSystems; ++s)
+        {
+            ParticleMap a = getParticles(serial[s]);
+            ParticleMap b = getParticles(parallel[s]);
+            ASSERT_EQ(a.size(), b.size());
+            for (ParticleMap::iterator ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib)
+            {
+                ASSERT_EQ(ia->first, ib->first);
+                EXPECT_EQ(ia->second->mPosition, ib->second->mPosition);
+                EXPECT_EQ(ia->second->mColour, ib->second->mColour);
+            }
+            EXPECT_EQ(serial[s]->getBoundingBox(), parallel[s]->getBoundingBox());
+        }
+    }
+
+    // detached systems are dropped from the queue
+    mgr._queueUpdate(parallel[0], 0.03f);
+    mSceneMgr->destroyParticleSystem(parallel[0]);
+    mgr._updateQueuedSystems();
+
+    mgr.setParallelUpdate(false);
+}
+
+#if OGRE_THREAD_SUPPORT
+TEST_F(ParticleSystemTests,parallelUpdateWithParticleFXEmitters)
+{
+    if (!loadParticleFX())
+    {
+        // This test is irrelevant without the ParticleFX plugin
+        return;
+    }
+    mRoot->getWorkQueue()->startup();
+
+    const size_t numSystems = 16;
+    const char* emitters[] = { "Point", "Box", "Cylinder", "Ellipsoid", "HollowEllipsoid", "Ring" };
+    ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+    ParticleSystem* systems[numSystems];
+    for (size_t s = 0; s < numSystems; ++s)
+    {
+        systems[s] = createSystem("ps" + StringConverter::toString(s), 500);
+        ParticleEmitter* emitter = systems[s]->addEmitter(emitters[s % 6]);
+        emitter->setEmissionRate(1000);
+        emitter->setAngle(Degree(30));
+        emitter->setTimeToLive(1, 2);
+        systems[s]->_update(0);
+        systems[s]->addAffector("TestConcurrency");
+        EXPECT_TRUE(systems[s]->_isParallelUpdateSupported()) << emitters[s % 6];
+    }
+    numUpdating.store(0);
+    maxUpdating.store(0);
+
+    mgr.setParallelUpdate(true);
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        for (size_t s = 0; s < numSystems; ++s)
+            mgr._queueUpdate(systems[s], 0.03f);
+        mgr._updateQueuedSystems();
+    }
+    mgr.setParallelUpdate(false);
+
+    for (size_t s = 0; s < numSystems; ++s)
+        EXPECT_LT(0U, systems[s]->getNumParticles());
+    // the calling thread takes part as well, but workers updated systems next to it
+    if (TaskScheduler::getSingleton().getNumThreads() > 1)
+    {
+        EXPECT_LE(2U, maxUpdating.load());
+    }
+}
+#endif
+
+TEST_F(ParticleSystemTests,parallelUpdatePerformance)
+{
+    const size_t numSystems = 64;
+    const size_t numParticles = 5000;
+    ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+    ParticleSystem* systems[numSystems];
+    for (size_t s = 0; s < numSystems; ++s)
+    {
+        systems[s] = createSystem("ps" + StringConverter::toString(s), numParticles);
+        systems[s]->addAffector("TestRange");
+        systems[s]->_update(0);
+    }
+
+    const char* names[] = { "serially", "in parallel" };
+    Timer timer;
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+        mgr.setParallelUpdate(parallel != 0);
+        unsigned long total = 0;
+        for (int run = 0; run < 5; ++run)
+        {
+            for (size_t s = 0; s < numSystems; ++s)
+            {
+                systems[s]->clear();
+                emitParticles(systems[s], numParticles);
+            }
+            timer.reset();
+            for (int frame = 0; frame < 10; ++frame)
+            {
+                for (size_t s = 0; s < numSystems; ++s)
+                {
+                    if (parallel)
+                        mgr._queueUpdate(systems[s], 0.001f);
+                    else
+                        systems[s]->_update(0.001f);
+                }
+                mgr._updateQueuedSystems();
+            }
+            total += timer.getMicroseconds();
+        }
+        LogManager::getSingleton().logMessage("Update of " + StringConverter::toString(numSystems) +
+            " particle systems " + names[parallel] + " using " +
+            StringConverter::toString(TaskScheduler::getSingleton().getNumThreads()) + " threads: " +
+            StringConverter::toString(total / 50) + " us per frame");
+    }
+    mgr.setParallelUpdate(false);
+}
@@ -222,4 +222,24 @@ TEST_F(PixelFormatTests,BulkConversion)
     testCase(PF_X8B8G8R8, PF_R8G8B8A8);
 }
 //--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,BulkConversionByteChannels)
+{
+    // Formats storing each channel in a byte are converted by copying bytes,
+    // or with fixed point math from and to 32 bit floats
+    const PixelFormat formats[] = {
+        PF_L8, PF_A8, PF_R8, PF_R8G8B8, PF_B8G8R8, PF_A8R8G8B8, PF_A8B8G8R8,
+        PF_B8G8R8A8, PF_R8G8B8A8, PF_X8R8G8B8, PF_X8B8G8R8, PF_FLOAT32_RGB, PF_FLOAT32_RGBA
+    };
+    const size_t numFormats = sizeof(formats) / sizeof(formats[0]);
+    for (size_t s = 0; s < numFormats; ++s)
+    {
+        for (size_t d = 0; d < numFormats; ++d)
+        {
+            // Converting to X8 formats writes alpha on purpose
+            if (formats[d] != PF_X8R8G8B8 && formats[d] != PF_X8B8G8R8)
+                testCase(formats[s], formats[d]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
 
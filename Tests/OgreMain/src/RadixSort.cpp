@@ -28,6 +28,10 @@ THE SOFTWARE.
 #include "RadixSortTests.h"
 #include "OgreRadixSort.h"
 #include "OgreMath.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreRoot.h"
+#include "OgreLogManager.h"
+#include "OgreTimer.h"
 #include <climits>
 
 using namespace Ogre;
@@ -205,3 +209,132 @@ TEST_F(RadixSortTests,IntVector)
 //--------------------------------------------------------------------------
 
 
+TEST_F(RadixSortTests,KeyedSortIsStable)
+{
+    typedef KeyedRadixSort<int> Sorter;
+    Sorter::EntryList entries, scratch;
+    for (int i = 0; i < 5000; ++i)
+    {
+        // few distinct keys, spread over all bytes
+        Sorter::Entry e;
+        e.key = uint64(Math::RangeRandom(0, 16)) << (8 * (i % 8));
+        e.value = i;
+        entries.push_back(e);
+    }
+
+    Sorter::sort(entries, scratch);
+
+    for (size_t i = 1; i < entries.size(); ++i)
+    {
+        ASSERT_LE(entries[i-1].key, entries[i].key);
+        if (entries[i-1].key == entries[i].key)
+        {
+            ASSERT_LT(entries[i-1].value, entries[i].value);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+namespace {
+    struct QueuedItem
+    {
+        float depth;
+        uint32 passHash;
+        uint32 id;
+    };
+    typedef std::vector<QueuedItem> QueuedItemList;
+
+    // Sort values of the former two pass render queue sort
+    struct PassHashFunctor
+    {
+        uint32 operator()(const QueuedItem& i) const { return i.passHash; }
+    };
+    struct NegativeDepthFunctor
+    {
+        float operator()(const QueuedItem& i) const { return -i.depth; }
+    };
+
+    struct QueuedItemLess
+    {
+        bool operator()(const QueuedItem& a, const QueuedItem& b) const
+        {
+            if (a.depth != b.depth)
+                return a.depth > b.depth;
+            return a.passHash < b.passHash;
+        }
+    };
+
+    void createQueuedItems(QueuedItemList& items, size_t count)
+    {
+        items.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            QueuedItem item;
+            // plenty of equal depths and passes
+            item.depth = i % 7 == 0 ? 0.0f : Math::Floor(Math::RangeRandom(0, 5000));
+            item.passHash = static_cast<uint32>(Math::RangeRandom(0, 50)) * 0x01000193;
+            item.id = static_cast<uint32>(i);
+            items.push_back(item);
+        }
+    }
+
+    void sortTwoPass(QueuedItemList& items)
+    {
+        static RadixSort<QueuedItemList, QueuedItem, uint32> passSorter;
+        static RadixSort<QueuedItemList, QueuedItem, float> depthSorter;
+        passSorter.sort(items, PassHashFunctor());
+        depthSorter.sort(items, NegativeDepthFunctor());
+    }
+
+    void sortKeyed(const QueuedItemList& items, KeyedRadixSort<uint32>::EntryList& entries,
+        KeyedRadixSort<uint32>::EntryList& scratch)
+    {
+        entries.resize(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            entries[i].key = QueuedRenderableCollection::_getSortKey(items[i].depth, items[i].passHash);
+            entries[i].value = items[i].id;
+        }
+        KeyedRadixSort<uint32>::sort(entries, scratch);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(RadixSortTests,RenderQueueSortKeyOrder)
+{
+    QueuedItemList items;
+    createQueuedItems(items, 10000);
+    KeyedRadixSort<uint32>::EntryList entries, scratch;
+    sortKeyed(items, entries, scratch);
+    // far to near, then by pass, ties keep their queued order
+    std::stable_sort(items.begin(), items.end(), QueuedItemLess());
+
+    ASSERT_EQ(items.size(), entries.size());
+    for (size_t i = 0; i < items.size(); ++i)
+        ASSERT_EQ(items[i].id, entries[i].value) << "item " << i;
+}
+//--------------------------------------------------------------------------
+TEST_F(RadixSortTests,RenderQueueSortPerformance)
+{
+    Root root("");
+    const size_t numItems = 100000;
+    const int numRuns = 10;
+    QueuedItemList original, items;
+    createQueuedItems(original, numItems);
+    KeyedRadixSort<uint32>::EntryList entries, scratch;
+
+    Timer timer;
+    unsigned long twoPassTime = 0, keyedTime = 0;
+    for (int r = 0; r < numRuns; ++r)
+    {
+        items = original;
+        timer.reset();
+        sortTwoPass(items);
+        twoPassTime += timer.getMicroseconds();
+
+        timer.reset();
+        sortKeyed(original, entries, scratch);
+        keyedTime += timer.getMicroseconds();
+    }
+    LogManager::getSingleton().stream() << "Render queue sort of " << numItems << " items: two pass "
+        << twoPassTime / numRuns << " us, keyed " << keyedTime / numRuns << " us";
+}
+//--------------------------------------------------------------------------
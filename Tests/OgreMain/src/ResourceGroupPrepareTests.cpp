@@ -0,0 +1,205 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreMesh.h"
+#include "OgreMeshManager.h"
+#include "OgreSubMesh.h"
+#include "OgreVertexIndexData.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreConfigFile.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+using namespace Ogre;
+
+namespace {
+    const char* GROUP = "ParallelPrepare";
+
+    /// Counts the resources which are already prepared when their loading starts
+    class PreparedCounter : public ResourceGroupListener
+    {
+    public:
+        size_t numLoaded;
+        size_t numPrepared;
+
+        PreparedCounter() : numLoaded(0), numPrepared(0) {}
+
+        void resourceLoadStarted(const ResourcePtr& resource)
+        {
+            ++numLoaded;
+            if (resource->getLoadingState() == Resource::LOADSTATE_PREPARED)
+                ++numPrepared;
+        }
+    };
+}
+
+class ResourceGroupPrepareTests : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        mFSLayer = OGRE_NEW_T(FileSystemLayer, MEMCATEGORY_GENERAL)(OGRE_VERSION_NAME);
+        mRoot = OGRE_NEW Root("");
+        mHBM = OGRE_NEW DefaultHardwareBufferManager;
+
+        ConfigFile cf;
+        cf.load(mFSLayer->getConfigFilePath("resources.cfg"));
+
+        ConfigFile::SettingsBySection_::const_iterator seci;
+        for (seci = cf.getSettingsBySection().begin(); seci != cf.getSettingsBySection().end(); ++seci)
+        {
+            ConfigFile::SettingsMultiMap::const_iterator i;
+            for (i = seci->second.begin(); i != seci->second.end(); ++i)
+            {
+                if (i->first == "FileSystem" && StringUtil::endsWith(i->second, "/models"))
+                    mModelsPath = i->second;
+            }
+        }
+
+        // Only the models, so that the group has a decent number of meshes
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        rgm.addResourceLocation(mModelsPath, "FileSystem", GROUP);
+        StringVectorPtr meshes = rgm.findResourceNames(GROUP, "*.mesh");
+        for (StringVector::iterator i = meshes->begin(); i != meshes->end(); ++i)
+            rgm.declareResource(*i, "Mesh", GROUP);
+        rgm.initialiseResourceGroup(GROUP);
+        mNumMeshes = meshes->size();
+    }
+
+    void TearDown()
+    {
+        ResourceGroupManager::getSingleton().setParallelPrepare(false);
+        // The meshes hold buffers of mHBM
+        MeshManager::getSingleton().removeAll();
+        OGRE_DELETE mHBM;
+        OGRE_DELETE mRoot;
+        OGRE_DELETE_T(mFSLayer, FileSystemLayer, MEMCATEGORY_GENERAL);
+    }
+
+    typedef map<String, size_t>::type VertexCounts;
+
+    /// Load the group, returning the number of vertices of each mesh
+    VertexCounts loadGroup(unsigned long& time)
+    {
+        Timer timer;
+        ResourceGroupManager::getSingleton().loadResourceGroup(GROUP);
+        time = timer.getMilliseconds();
+
+        VertexCounts counts;
+        ResourceManager::ResourceMapIterator it = MeshManager::getSingleton().getResourceIterator();
+        while (it.hasMoreElements())
+        {
+            MeshPtr mesh = static_pointer_cast<Mesh>(it.getNext());
+            if (mesh->getGroup() != GROUP)
+                continue;
+            EXPECT_TRUE(mesh->isLoaded()) << mesh->getName();
+            size_t vertices = mesh->sharedVertexData ? mesh->sharedVertexData->vertexCount : 0;
+            for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+            {
+                if (!mesh->getSubMesh(s)->useSharedVertices)
+                    vertices += mesh->getSubMesh(s)->vertexData->vertexCount;
+            }
+            counts[mesh->getName()] = vertices;
+        }
+        return counts;
+    }
+
+    Root* mRoot;
+    HardwareBufferManager* mHBM;
+    FileSystemLayer* mFSLayer;
+    String mModelsPath;
+    size_t mNumMeshes;
+};
+
+// the option has no effect without a thread safe resource system
+#if OGRE_THREAD_SUPPORT == 1 || OGRE_THREAD_SUPPORT == 2
+TEST_F(ResourceGroupPrepareTests, LoadMatchesSerial)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    ASSERT_GT(mNumMeshes, 1u);
+
+    PreparedCounter counter;
+    rgm.addResourceGroupListener(&counter);
+
+    unsigned long serialTime, parallelTime;
+    VertexCounts serial = loadGroup(serialTime);
+    EXPECT_EQ(mNumMeshes, serial.size());
+    EXPECT_EQ(mNumMeshes, counter.numLoaded);
+    EXPECT_EQ(0u, counter.numPrepared);
+
+    rgm.unloadResourceGroup(GROUP);
+    rgm.setParallelPrepare(true);
+    counter = PreparedCounter();
+    VertexCounts parallel = loadGroup(parallelTime);
+    EXPECT_TRUE(serial == parallel);
+    // all meshes went through the parallel prepare pass first
+    EXPECT_EQ(mNumMeshes, counter.numLoaded);
+    EXPECT_EQ(mNumMeshes, counter.numPrepared);
+    rgm.removeResourceGroupListener(&counter);
+
+    LogManager::getSingleton().stream() << "Loading " << mNumMeshes << " meshes: serial "
+        << serialTime << " ms, parallel prepare " << parallelTime << " ms";
+}
+
+TEST_F(ResourceGroupPrepareTests, PrepareOnly)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    rgm.setParallelPrepare(true);
+    rgm.prepareResourceGroup(GROUP);
+
+    size_t prepared = 0;
+    ResourceManager::ResourceMapIterator it = MeshManager::getSingleton().getResourceIterator();
+    while (it.hasMoreElements())
+    {
+        ResourcePtr res = it.getNext();
+        if (res->getGroup() == GROUP)
+        {
+            EXPECT_EQ(Resource::LOADSTATE_PREPARED, res->getLoadingState()) << res->getName();
+            ++prepared;
+        }
+    }
+    EXPECT_EQ(mNumMeshes, prepared);
+}
+#endif
+
+TEST_F(ResourceGroupPrepareTests, MissingResourceThrows)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    rgm.destroyResourceGroup(GROUP);
+    rgm.addResourceLocation(mModelsPath, "FileSystem", "Missing");
+    rgm.declareResource("ogrehead.mesh", "Mesh", "Missing");
+    rgm.declareResource("does_not_exist.mesh", "Mesh", "Missing");
+    rgm.initialiseResourceGroup("Missing");
+    rgm.setParallelPrepare(true);
+    EXPECT_THROW(rgm.loadResourceGroup("Missing"), FileNotFoundException);
+}
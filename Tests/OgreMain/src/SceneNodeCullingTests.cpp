@@ -0,0 +1,201 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreMovableObject.h"
+#include "OgreCamera.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+namespace {
+    typedef vector<MovableObject*>::type ObjectList;
+
+    /// A box which records when it's queued
+    class BoxObject : public MovableObject
+    {
+        AxisAlignedBox mBox;
+        ObjectList* mQueued;
+    public:
+        BoxObject(const String& name, const AxisAlignedBox& box, ObjectList* queued)
+            : MovableObject(name), mBox(box), mQueued(queued) {}
+
+        const String& getMovableType(void) const
+        {
+            static String type = "TestBox";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return mBox.isFinite() ? mBox.getHalfSize().length() : 0; }
+        void _updateRenderQueue(RenderQueue* queue) { mQueued->push_back(this); }
+        void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables) {}
+    };
+
+    /// numGroups groups of numBoxes unit boxes, on a plane in front of the camera
+    void createBoxes(SceneManager* sm, size_t numGroups, size_t numBoxes, ObjectList& objects,
+        ObjectList* queued)
+    {
+        AxisAlignedBox unitBox(-0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f);
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+            SceneNode* group = sm->getRootSceneNode()->createChildSceneNode(
+                "g" + StringConverter::toString(g), Vector3(Real(g % 10) * 100, 0, -Real(g / 10) * 100));
+            for (size_t b = 0; b < numBoxes; ++b)
+            {
+                SceneNode* n = group->createChildSceneNode(
+                    Vector3(Real(b % 32) * 3, Real(b / 32) * 3, 0));
+                BoxObject* o = OGRE_NEW BoxObject(group->getName() + "_" + StringConverter::toString(b),
+                    unitBox, queued);
+                n->attachObject(o);
+                objects.push_back(o);
+            }
+        }
+    }
+
+    void destroyObjects(ObjectList& objects)
+    {
+        for (ObjectList::iterator i = objects.begin(); i != objects.end(); ++i)
+            OGRE_DELETE *i;
+        objects.clear();
+    }
+
+    ObjectList findVisibleObjects(SceneManager* sm, Camera* cam, ObjectList& queued, bool batched)
+    {
+        sm->setBatchedCulling(batched);
+        queued.clear();
+        sm->_findVisibleObjects(cam, 0, false);
+        return queued;
+    }
+}
+
+TEST(SceneManager,batchedCullingMatchesRecursive)
+{
+    Root root("");
+    // cameras need a buffer manager
+    DefaultHardwareBufferManager bufMgr;
+    MaterialManager::getSingleton().initialise();
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    ObjectList objects, queued;
+    createBoxes(sm, 20, 100, objects, &queued);
+
+    // objects with null and infinite bounds
+    AxisAlignedBox infinite;
+    infinite.setInfinite();
+    BoxObject* sky = OGRE_NEW BoxObject("sky", infinite, &queued);
+    sm->getSceneNode("g7")->createChildSceneNode()->attachObject(sky);
+    objects.push_back(sky);
+    BoxObject* empty = OGRE_NEW BoxObject("empty", AxisAlignedBox::BOX_NULL, &queued);
+    sm->getSceneNode("g3")->createChildSceneNode()->attachObject(empty);
+    objects.push_back(empty);
+
+    Camera* cam = sm->createCamera("cam");
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+    camNode->setFixedYawAxis(true);
+    camNode->setPosition(150, 20, 100);
+    camNode->lookAt(Vector3(250, 0, -300), Node::TS_WORLD);
+    cam->setNearClipDistance(1);
+    cam->setFarClipDistance(600);
+
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        if (frame == 1)
+        {
+            // the cached layout has to follow changes of the graph
+            SceneNode* n = sm->getSceneNode("g12");
+            n->getParent()->removeChild(n);
+            sm->getSceneNode("g2")->addChild(n);
+            sm->destroySceneNode("g15");
+        }
+        else if (frame == 2)
+        {
+            cam->setFarClipDistance(0);
+        }
+        else if (frame == 3)
+        {
+            camNode->yaw(Degree(60));
+        }
+        sm->_updateSceneGraph(cam);
+
+        ObjectList recursive = findVisibleObjects(sm, cam, queued, false);
+        ObjectList batched = findVisibleObjects(sm, cam, queued, true);
+        EXPECT_FALSE(recursive.empty());
+        EXPECT_LT(recursive.size(), objects.size());
+        EXPECT_TRUE(recursive == batched) << "frame " << frame;
+    }
+
+    destroyObjects(objects);
+    root.destroySceneManager(sm);
+}
+
+TEST(SceneManager,DISABLED_batchedCullingPerformance)
+{
+    Root root("");
+    DefaultHardwareBufferManager bufMgr;
+    MaterialManager::getSingleton().initialise();
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    ObjectList objects, queued;
+    // 100k static boxes
+    createBoxes(sm, 100, 1000, objects, &queued);
+
+    Camera* cam = sm->createCamera("cam");
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+    camNode->setPosition(450, 50, 200);
+    camNode->lookAt(Vector3(450, 0, -500), Node::TS_WORLD);
+    cam->setNearClipDistance(1);
+    cam->setFarClipDistance(2000);
+    sm->_updateSceneGraph(cam);
+
+    const char* names[] = { "recursive", "batched" };
+    Timer timer;
+    for (int batched = 0; batched < 2; ++batched)
+    {
+        sm->setBatchedCulling(batched != 0);
+        // first run builds the layout
+        findVisibleObjects(sm, cam, queued, batched != 0);
+
+        const int numFrames = 20;
+        timer.reset();
+        for (int frame = 0; frame < numFrames; ++frame)
+            findVisibleObjects(sm, cam, queued, batched != 0);
+        LogManager::getSingleton().stream() << "Culling " << objects.size() << " boxes "
+            << names[batched] << ": " << timer.getMicroseconds() / numFrames << " us/frame, "
+            << queued.size() << " visible";
+    }
+
+    destroyObjects(objects);
+    root.destroySceneManager(sm);
+}
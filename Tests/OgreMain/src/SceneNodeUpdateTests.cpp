@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Groups of short chains below the root, a typical layout for large scenes
+    void createNodes(SceneManager* sm, size_t numGroups, size_t chainsPerGroup, size_t chainLength)
+    {
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+            SceneNode* group = sm->getRootSceneNode()->createChildSceneNode(
+                "g" + StringConverter::toString(g), Vector3(Real(g), 0, 0));
+            for (size_t c = 0; c < chainsPerGroup; ++c)
+            {
+                SceneNode* n = group;
+                for (size_t l = 0; l < chainLength; ++l)
+                {
+                    n = n->createChildSceneNode(group->getName() + "_" + StringConverter::toString(c) +
+                        "_" + StringConverter::toString(l),
+                        Vector3(Real(c), Real(l), 1), Quaternion(Degree(Real(c + l)), Vector3::UNIT_Y));
+                    n->setScale(1, 1 + Real(l) / 10, 1);
+                }
+            }
+        }
+    }
+
+    /// Move every group node, so that all nodes need updating
+    void moveGroups(SceneManager* sm, size_t numGroups, Real t)
+    {
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+            SceneNode* group = sm->getSceneNode("g" + StringConverter::toString(g));
+            group->setOrientation(Quaternion(Radian(t + Real(g)), Vector3::UNIT_Z));
+        }
+    }
+
+    void expectSameTransforms(SceneNode* a, SceneNode* b)
+    {
+        ASSERT_EQ(a->numChildren(), b->numChildren());
+        EXPECT_EQ(a->_getDerivedPosition(), b->_getDerivedPosition());
+        EXPECT_EQ(a->_getDerivedOrientation(), b->_getDerivedOrientation());
+        EXPECT_EQ(a->_getDerivedScale(), b->_getDerivedScale());
+        EXPECT_EQ(a->_getWorldAABB(), b->_getWorldAABB());
+
+        Node::ChildNodeIterator it = a->getChildIterator();
+        while (it.hasMoreElements())
+        {
+            SceneNode* child = static_cast<SceneNode*>(it.getNext());
+            expectSameTransforms(child, b->getCreator()->getSceneNode(child->getName()));
+        }
+    }
+}
+
+TEST(SceneManager,parallelNodeUpdateMatchesSerial)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+
+    SceneManager* serial = root.createSceneManager(ST_GENERIC);
+    SceneManager* parallel = root.createSceneManager(ST_GENERIC);
+    parallel->setParallelNodeUpdate(true);
+    parallel->setParallelNodeUpdateThreshold(16);
+
+    createNodes(serial, 8, 20, 5);
+    createNodes(parallel, 8, 20, 5);
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        SceneManager* sms[] = {serial, parallel};
+        for (int i = 0; i < 2; ++i)
+        {
+            if (frame == 0)
+            {
+                moveGroups(sms[i], 8, Real(frame));
+            }
+            else
+            {
+                // only a part of the graph is dirty in the later frames
+                sms[i]->getSceneNode("g" + StringConverter::toString(frame * 2))->roll(Degree(10));
+                sms[i]->getSceneNode("g3_1_4")->translate(0, 1, 0);
+            }
+        }
+
+        serial->_updateSceneGraph(0);
+        parallel->_updateSceneGraph(0);
+
+        expectSameTransforms(serial->getRootSceneNode(), parallel->getRootSceneNode());
+    }
+}
+
+TEST(SceneManager,parallelNodeUpdateUnsupported)
+{
+    /// Stands in for the octree, BSP and PCZ scene managers
+    class SerialSceneManager : public DefaultSceneManager
+    {
+    public:
+        SerialSceneManager() : DefaultSceneManager("Serial") {}
+        bool isParallelNodeUpdateSupported() const { return false; }
+    };
+
+    Root root("");
+    SerialSceneManager sm;
+    sm.setParallelNodeUpdate(true);
+    EXPECT_FALSE(sm.getParallelNodeUpdate());
+
+    SceneManager* generic = root.createSceneManager(ST_GENERIC);
+    generic->setParallelNodeUpdate(true);
+    EXPECT_TRUE(generic->getParallelNodeUpdate());
+}
+
+TEST(SceneManager,DISABLED_parallelNodeUpdateScaling)
+{
+    Root root("");
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(root.getWorkQueue());
+
+    // 50k nodes in 50 groups
+    const size_t numGroups = 50;
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    createNodes(sm, numGroups, 100, 10);
+
+    const int numFrames = 20;
+    Timer timer;
+
+    sm->setParallelNodeUpdate(false);
+    timer.reset();
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        moveGroups(sm, numGroups, Real(frame));
+        sm->_updateSceneGraph(0);
+    }
+    LogManager::getSingleton().stream() << "parallelNodeUpdateScaling: serial "
+        << timer.getMicroseconds() / numFrames << " us/frame";
+
+    sm->setParallelNodeUpdate(true);
+    size_t maxThreads = std::max((size_t)OGRE_THREAD_HARDWARE_CONCURRENCY, (size_t)1);
+    for (size_t threads = 1; threads <= maxThreads; ++threads)
+    {
+        wq->setWorkerThreadCount(threads);
+        wq->startup(true);
+
+        timer.reset();
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            moveGroups(sm, numGroups, Real(frame));
+            sm->_updateSceneGraph(0);
+        }
+        LogManager::getSingleton().stream() << "parallelNodeUpdateScaling: " << threads
+            << " worker(s) " << timer.getMicroseconds() / numFrames << " us/frame";
+    }
+    wq->shutdown();
+}
+
+TEST(SceneManager,packedNodeTransformsMatchesSerial)
+{
+    Root root("");
+
+    SceneManager* serial = root.createSceneManager(ST_GENERIC);
+    SceneManager* packed = root.createSceneManager(ST_GENERIC);
+    packed->setPackedNodeTransforms(true);
+
+    SceneManager* sms[] = {serial, packed};
+    for (int i = 0; i < 2; ++i)
+    {
+        createNodes(sms[i], 8, 7, 5);
+        sms[i]->getSceneNode("g2_3_0")->setInheritOrientation(false);
+        sms[i]->getSceneNode("g5_2_1")->setInheritScale(false);
+    }
+
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            SceneManager* sm = sms[i];
+            moveGroups(sm, 8, Real(frame));
+            sm->getSceneNode("g3_1_4")->translate(0, 1, 0);
+
+            // change the layout between frames
+            if (frame == 1)
+            {
+                SceneNode* n = sm->getSceneNode("g4_6_0");
+                n->getParent()->removeChild(n);
+                sm->getSceneNode("g6")->addChild(n);
+            }
+            else if (frame == 2)
+            {
+                sm->destroySceneNode("g1_3_2");
+            }
+
+            sm->_updateSceneGraph(0);
+        }
+
+        expectSameTransforms(serial->getRootSceneNode(), packed->getRootSceneNode());
+    }
+}
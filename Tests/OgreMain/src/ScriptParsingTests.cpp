@@ -0,0 +1,218 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreMaterialManager.h"
+#include "OgreScriptCompiler.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreFileSystem.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreWorkQueue.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+namespace {
+    const char* GROUP = "ScriptParsing";
+    const char* SCRIPT_DIR = "./ScriptParsingTest";
+    const int NUM_SCRIPTS = 40;
+}
+
+class ScriptParsingTests : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        mRoot = OGRE_NEW Root("");
+        mRoot->getWorkQueue()->startup();
+
+        FileSystemLayer::createDirectory(SCRIPT_DIR);
+        mArchive = OGRE_NEW FileSystemArchive(SCRIPT_DIR, "FileSystem", false);
+        mArchive->load();
+
+        // An abstract pass used by all scripts and a chain of materials
+        // inheriting from the previous script
+        writeScript("base.material",
+            "abstract pass BasePass\n{\n    diffuse 1 0 0\n    specular 0 0 1 $shininess\n}\n"
+            "material Base\n{\n    technique\n    {\n        pass : BasePass\n"
+            "        {\n            set $shininess 10\n        }\n    }\n}\n");
+        for (int i = 0; i < NUM_SCRIPTS; ++i)
+            writeMaterialScript(i, i * 0.01f);
+
+        ResourceGroupManager::getSingleton().addResourceLocation(SCRIPT_DIR, "FileSystem", GROUP);
+    }
+
+    void TearDown()
+    {
+        ResourceGroupManager::getSingleton().setParallelScriptParsing(false);
+        OGRE_DELETE mRoot;
+
+        StringVectorPtr files = mArchive->list(false);
+        for (StringVector::iterator i = files->begin(); i != files->end(); ++i)
+            mArchive->remove(*i);
+        OGRE_DELETE mArchive;
+        FileSystemLayer::removeDirectory(SCRIPT_DIR);
+    }
+
+    void writeScript(const String& name, const String& text)
+    {
+        DataStreamPtr stream = mArchive->create(name);
+        stream->write(text.c_str(), text.size());
+    }
+
+    void writeMaterialScript(int i, Real ambient)
+    {
+        String name = "Material" + StringConverter::toString(i);
+        String parent = i ? "Material" + StringConverter::toString(i - 1) : "Base";
+        String parentScript = i ? parent + ".material" : "base.material";
+        writeScript(name + ".material",
+            "import BasePass from \"base.material\"\n"
+            "import " + parent + " from \"" + parentScript + "\"\n"
+            "material " + name + " : " + parent + "\n{\n"
+            "    set $shininess " + StringConverter::toString(i) + "\n"
+            "    technique\n    {\n        pass : BasePass\n        {\n"
+            "            ambient " + StringConverter::toString(ambient) + " 0 0\n"
+            "        }\n    }\n}\n");
+    }
+
+    /// Initialise the group and describe the materials it created
+    String initialiseGroup(void)
+    {
+        ResourceGroupManager::getSingleton().initialiseResourceGroup(GROUP);
+
+        StringVector descriptions;
+        ResourceManager::ResourceMapIterator it = MaterialManager::getSingleton().getResourceIterator();
+        while (it.hasMoreElements())
+        {
+            MaterialPtr mat = static_pointer_cast<Material>(it.getNext());
+            if (mat->getGroup() != GROUP)
+                continue;
+            String desc = mat->getName();
+            for (unsigned short t = 0; t < mat->getNumTechniques(); ++t)
+            {
+                Technique* tech = mat->getTechnique(t);
+                for (unsigned short p = 0; p < tech->getNumPasses(); ++p)
+                {
+                    Pass* pass = tech->getPass(p);
+                    desc += " [" + StringConverter::toString(pass->getAmbient()) +
+                        " " + StringConverter::toString(pass->getDiffuse()) +
+                        " " + StringConverter::toString(pass->getShininess()) + "]";
+                }
+            }
+            descriptions.push_back(desc);
+        }
+        std::sort(descriptions.begin(), descriptions.end());
+
+        String result;
+        for (StringVector::iterator i = descriptions.begin(); i != descriptions.end(); ++i)
+            result += *i + "\n";
+        return result;
+    }
+
+    Root* mRoot;
+    FileSystemArchive* mArchive;
+};
+
+TEST_F(ScriptParsingTests, ParallelMatchesSerial)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    String serial = initialiseGroup();
+    EXPECT_EQ(size_t(NUM_SCRIPTS + 1), StringUtil::split(serial, "\n").size());
+
+    rgm.clearResourceGroup(GROUP);
+    rgm.setParallelScriptParsing(true);
+    String parallel = initialiseGroup();
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST_F(ScriptParsingTests, ParseErrorThrows)
+{
+    writeScript("broken.material", "material Broken\n{\n    technique \"unterminated\n}\n");
+    ResourceGroupManager::getSingleton().setParallelScriptParsing(true);
+    EXPECT_THROW(initialiseGroup(), InvalidStateException);
+}
+
+TEST_F(ScriptParsingTests, ScriptCache)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    ScriptCompilerManager& compilerMgr = ScriptCompilerManager::getSingleton();
+    String uncached = initialiseGroup();
+
+    rgm.clearResourceGroup(GROUP);
+    compilerMgr.setScriptCacheEnabled(true);
+    EXPECT_EQ(uncached, initialiseGroup());
+    EXPECT_EQ(size_t(0), compilerMgr.getScriptCacheHits());
+    EXPECT_EQ(size_t(NUM_SCRIPTS + 1), compilerMgr.getScriptCacheMisses());
+    EXPECT_TRUE(compilerMgr.isScriptCacheDirty());
+
+    // round trip through a file, as on the next run
+    compilerMgr.saveScriptCache(mArchive->create("scripts.cache"));
+    compilerMgr.clearScriptCache();
+    compilerMgr.loadScriptCache(mArchive->open("scripts.cache"));
+    EXPECT_FALSE(compilerMgr.isScriptCacheDirty());
+
+    compilerMgr.resetScriptCacheStatistics();
+    rgm.clearResourceGroup(GROUP);
+    EXPECT_EQ(uncached, initialiseGroup());
+    EXPECT_EQ(size_t(NUM_SCRIPTS + 1), compilerMgr.getScriptCacheHits());
+    EXPECT_EQ(size_t(0), compilerMgr.getScriptCacheMisses());
+
+    // a changed script invalidates itself and the script importing it
+    writeMaterialScript(NUM_SCRIPTS - 2, 0.5f);
+    compilerMgr.resetScriptCacheStatistics();
+    rgm.clearResourceGroup(GROUP);
+    String changed = initialiseGroup();
+    EXPECT_EQ(size_t(NUM_SCRIPTS - 1), compilerMgr.getScriptCacheHits());
+    EXPECT_EQ(size_t(2), compilerMgr.getScriptCacheMisses());
+    EXPECT_NE(uncached, changed);
+
+    MaterialPtr mat = MaterialManager::getSingleton().getByName(
+        "Material" + StringConverter::toString(NUM_SCRIPTS - 2), GROUP);
+    ASSERT_TRUE(mat);
+    EXPECT_EQ(ColourValue(0.5f, 0, 0), mat->getTechnique(0)->getPass(0)->getAmbient());
+}
+
+TEST_F(ScriptParsingTests, ScriptCacheVersion)
+{
+    ScriptCompilerManager& compilerMgr = ScriptCompilerManager::getSingleton();
+    compilerMgr.setScriptCacheEnabled(true);
+    initialiseGroup();
+
+    // anything which is not a cache is ignored
+    writeScript("scripts.cache", "not a cache");
+    compilerMgr.loadScriptCache(mArchive->open("scripts.cache"));
+    EXPECT_TRUE(compilerMgr.isScriptCacheDirty());
+
+    compilerMgr.resetScriptCacheStatistics();
+    ResourceGroupManager::getSingleton().clearResourceGroup(GROUP);
+    initialiseGroup();
+    EXPECT_EQ(size_t(NUM_SCRIPTS + 1), compilerMgr.getScriptCacheHits());
+}
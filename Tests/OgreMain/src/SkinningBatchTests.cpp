@@ -0,0 +1,233 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreMesh.h"
+#include "OgreSkinningBatch.h"
+#include "OgreVertexIndexData.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+using namespace Ogre;
+
+namespace {
+    const size_t NUM_BONES = 8;
+
+    /// Interleaved positions, normals, blend indices and two blend weights
+    VertexData* createSourceData(size_t numVertices)
+    {
+        VertexData* data = OGRE_NEW VertexData();
+        data->vertexCount = numVertices;
+        VertexDeclaration* decl = data->vertexDeclaration;
+        size_t offset = 0;
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_POSITION).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_NORMAL).getSize();
+        offset += decl->addElement(0, offset, VET_UBYTE4, VES_BLEND_INDICES).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT2, VES_BLEND_WEIGHTS).getSize();
+
+        HardwareVertexBufferSharedPtr buf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            offset, numVertices, HardwareBuffer::HBU_STATIC);
+        data->vertexBufferBinding->setBinding(0, buf);
+
+        unsigned char* p = static_cast<unsigned char*>(buf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            float* f = reinterpret_cast<float*>(p);
+            Vector3 normal(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 1);
+            normal.normalise();
+            f[0] = Math::RangeRandom(-10, 10);
+            f[1] = Math::RangeRandom(-10, 10);
+            f[2] = Math::RangeRandom(-10, 10);
+            f[3] = normal.x;
+            f[4] = normal.y;
+            f[5] = normal.z;
+            unsigned char* idx = p + 6 * sizeof(float);
+            idx[0] = static_cast<unsigned char>(v % NUM_BONES);
+            idx[1] = static_cast<unsigned char>((v * 3 + 1) % NUM_BONES);
+            idx[2] = idx[3] = 0;
+            float* weights = reinterpret_cast<float*>(idx + 4);
+            weights[0] = Math::UnitRandom();
+            weights[1] = 1 - weights[0];
+            p += offset;
+        }
+        buf->unlock();
+        return data;
+    }
+
+    /// Separate position and normal buffers
+    VertexData* createTargetData(size_t numVertices)
+    {
+        VertexData* data = OGRE_NEW VertexData();
+        data->vertexCount = numVertices;
+        data->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        data->vertexDeclaration->addElement(1, 0, VET_FLOAT3, VES_NORMAL);
+        for (unsigned short s = 0; s < 2; ++s)
+        {
+            data->vertexBufferBinding->setBinding(s,
+                HardwareBufferManager::getSingleton().createVertexBuffer(
+                    3 * sizeof(float), numVertices, HardwareBuffer::HBU_DYNAMIC));
+        }
+        return data;
+    }
+
+    void createMatrices(Matrix4* matrices, const Matrix4** pointers)
+    {
+        for (size_t i = 0; i < NUM_BONES; ++i)
+        {
+            Quaternion q(Radian(Math::RangeRandom(0, Math::TWO_PI)),
+                Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 1).normalisedCopy());
+            matrices[i].makeTransform(Vector3(Math::RangeRandom(-5, 5), Math::RangeRandom(-5, 5),
+                Math::RangeRandom(-5, 5)), Vector3::UNIT_SCALE, q);
+            pointers[i] = &matrices[i];
+        }
+    }
+
+    /// Compare the blended target with a straightforward evaluation of the source
+    void checkBlend(const VertexData* source, const VertexData* target, const Matrix4* const* matrices)
+    {
+        HardwareVertexBufferSharedPtr srcBuf = source->vertexBufferBinding->getBuffer(0);
+        HardwareVertexBufferSharedPtr posBuf = target->vertexBufferBinding->getBuffer(0);
+        HardwareVertexBufferSharedPtr normBuf = target->vertexBufferBinding->getBuffer(1);
+        const unsigned char* p = static_cast<const unsigned char*>(srcBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        const float* pos = static_cast<const float*>(posBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        const float* norm = static_cast<const float*>(normBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+
+        for (size_t v = 0; v < source->vertexCount; ++v)
+        {
+            const float* f = reinterpret_cast<const float*>(p);
+            const unsigned char* idx = p + 6 * sizeof(float);
+            const float* weights = reinterpret_cast<const float*>(idx + 4);
+            Vector3 srcPos(f[0], f[1], f[2]), srcNorm(f[3], f[4], f[5]);
+            Vector3 expectedPos = Vector3::ZERO, expectedNorm = Vector3::ZERO;
+            for (size_t w = 0; w < 2; ++w)
+            {
+                const Matrix4& m = *matrices[idx[w]];
+                expectedPos += m.transformAffine(srcPos) * weights[w];
+                Matrix3 rotation;
+                m.extract3x3Matrix(rotation);
+                expectedNorm += rotation * srcNorm * weights[w];
+            }
+            expectedNorm.normalise();
+
+            ASSERT_TRUE(expectedPos.positionEquals(Vector3(pos + v * 3), 1e-3f)) << "vertex " << v;
+            ASSERT_TRUE(expectedNorm.positionEquals(Vector3(norm + v * 3), 1e-3f)) << "vertex " << v;
+            p += srcBuf->getVertexSize();
+        }
+
+        srcBuf->unlock();
+        posBuf->unlock();
+        normBuf->unlock();
+    }
+}
+
+TEST(SkinningBatch,blendsMatchReference)
+{
+    Root root("");
+    DefaultHardwareBufferManager bufMgr;
+    srand(1234);
+
+    // two meshes shared by many targets, one of them spanning several tasks
+    const size_t numVertices[2] = { 100, SkinningBatch::VERTICES_PER_TASK * 2 + 37 };
+    VertexData* sources[2];
+    for (int s = 0; s < 2; ++s)
+        sources[s] = createSourceData(numVertices[s]);
+
+    const size_t numTargets = 20;
+    VertexData* targets[numTargets];
+    Matrix4 matrices[numTargets][NUM_BONES];
+    const Matrix4* pointers[numTargets][NUM_BONES];
+
+    SkinningBatch batch;
+    for (size_t t = 0; t < numTargets; ++t)
+    {
+        targets[t] = createTargetData(numVertices[t % 2]);
+        createMatrices(matrices[t], pointers[t]);
+        // the batch copies the pointer array
+        const Matrix4* temp[NUM_BONES];
+        std::copy(pointers[t], pointers[t] + NUM_BONES, temp);
+        batch.add(sources[t % 2], targets[t], temp, NUM_BONES, true);
+        std::fill(temp, temp + NUM_BONES, static_cast<const Matrix4*>(0));
+    }
+    EXPECT_EQ(numTargets, batch.getNumBlends());
+    batch.flush();
+    EXPECT_EQ(0u, batch.getNumBlends());
+
+    for (size_t t = 0; t < numTargets; ++t)
+    {
+        checkBlend(sources[t % 2], targets[t], pointers[t]);
+        OGRE_DELETE targets[t];
+    }
+
+    // a single blend through the Mesh interface
+    VertexData* target = createTargetData(numVertices[0]);
+    Mesh::softwareVertexBlend(sources[0], target, pointers[0], NUM_BONES, true);
+    checkBlend(sources[0], target, pointers[0]);
+    OGRE_DELETE target;
+
+    for (int s = 0; s < 2; ++s)
+        OGRE_DELETE sources[s];
+}
+
+TEST(SkinningBatch,blendPerformance)
+{
+    Root root("");
+    DefaultHardwareBufferManager bufMgr;
+    srand(1234);
+
+    const size_t numTargets = 500;
+    VertexData* source = createSourceData(1500);
+    vector<VertexData*>::type targets;
+    Matrix4 matrices[NUM_BONES];
+    const Matrix4* pointers[NUM_BONES];
+    createMatrices(matrices, pointers);
+    for (size_t t = 0; t < numTargets; ++t)
+        targets.push_back(createTargetData(source->vertexCount));
+
+    Timer timer;
+    for (size_t t = 0; t < numTargets; ++t)
+        Mesh::softwareVertexBlend(source, targets[t], pointers, NUM_BONES, true);
+    unsigned long singleTime = timer.getMicroseconds();
+
+    timer.reset();
+    SkinningBatch batch;
+    for (size_t t = 0; t < numTargets; ++t)
+        batch.add(source, targets[t], pointers, NUM_BONES, true);
+    batch.flush();
+    unsigned long batchTime = timer.getMicroseconds();
+
+    checkBlend(source, targets.back(), pointers);
+    LogManager::getSingleton().stream() << "Software skinning of " << numTargets << " x "
+        << source->vertexCount << " vertices: one at a time " << singleTime
+        << " us, batched " << batchTime << " us";
+
+    for (size_t t = 0; t < numTargets; ++t)
+        OGRE_DELETE targets[t];
+    OGRE_DELETE source;
+}
@@ -0,0 +1,285 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreTaskScheduler.h"
+#include "OgreAtomicScalar.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Counts how often every index was visited
+    class CountingBody : public ParallelForBody
+    {
+    public:
+        vector<int>::type visits;
+        AtomicScalar<size_t> numChunks;
+
+        CountingBody(size_t size) : visits(size, 0), numChunks(0) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            ++numChunks;
+            for (size_t i = begin; i < end; ++i)
+                ++visits[i];
+        }
+    };
+
+    /// Runs a parallel loop per index of the outer loop
+    class NestedBody : public ParallelForBody
+    {
+    public:
+        vector<CountingBody*>::type inner;
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                TaskScheduler::getSingleton().parallelFor(0, inner[i]->visits.size(), 7, *inner[i]);
+        }
+    };
+
+    /// Records when it ran relative to the other tasks
+    class StampTask : public Task
+    {
+    public:
+        AtomicScalar<size_t>* clock;
+        size_t stamp;
+
+        StampTask() : clock(0), stamp(0) {}
+
+        void execute(void)
+        {
+            stamp = ++(*clock);
+        }
+    };
+}
+
+TEST(TaskScheduler,parallelForVisitsEveryIndexOnce)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+
+    CountingBody body(10000);
+    TaskScheduler::getSingleton().parallelFor(0, 10000, 64, body);
+    for (size_t i = 0; i < body.visits.size(); ++i)
+        ASSERT_EQ(1, body.visits[i]) << "index " << i;
+    EXPECT_EQ((10000U + 63) / 64, body.numChunks.load());
+
+    // sub range with automatic grain size
+    CountingBody partial(100);
+    TaskScheduler::getSingleton().parallelFor(10, 90, 0, partial);
+    for (size_t i = 0; i < partial.visits.size(); ++i)
+        EXPECT_EQ(i >= 10 && i < 90 ? 1 : 0, partial.visits[i]) << "index " << i;
+
+    // empty range
+    CountingBody empty(1);
+    TaskScheduler::getSingleton().parallelFor(5, 5, 1, empty);
+    EXPECT_EQ(0U, empty.numChunks.load());
+}
+
+TEST(TaskScheduler,nestedParallelFor)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+
+    NestedBody outer;
+    for (int i = 0; i < 16; ++i)
+        outer.inner.push_back(OGRE_NEW_T(CountingBody, MEMCATEGORY_GENERAL)(100 + i));
+
+    TaskScheduler::getSingleton().parallelFor(0, outer.inner.size(), 1, outer);
+
+    for (size_t i = 0; i < outer.inner.size(); ++i)
+    {
+        const vector<int>::type& visits = outer.inner[i]->visits;
+        for (size_t j = 0; j < visits.size(); ++j)
+            ASSERT_EQ(1, visits[j]);
+        OGRE_DELETE_T(outer.inner[i], CountingBody, MEMCATEGORY_GENERAL);
+    }
+}
+
+TEST(TaskScheduler,taskGraphRespectsDependencies)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+
+    // a diamond per row, top -> left and right -> bottom,
+    // every row depends on the previous one
+    const size_t numRows = 20;
+    AtomicScalar<size_t> clock(0);
+    StampTask tasks[numRows * 4];
+    TaskGraph graph;
+    for (size_t i = 0; i < numRows * 4; ++i)
+    {
+        tasks[i].clock = &clock;
+        graph.addTask(&tasks[i]);
+    }
+    for (size_t row = 0; row < numRows; ++row)
+    {
+        size_t top = row * 4;
+        graph.addDependency(top + 1, top);
+        graph.addDependency(top + 2, top);
+        graph.addDependency(top + 3, top + 1);
+        graph.addDependency(top + 3, top + 2);
+        if (row)
+            graph.addDependency(top, top - 1);
+    }
+
+    // graphs can be run repeatedly
+    for (int run = 0; run < 3; ++run)
+    {
+        TaskScheduler::getSingleton().run(graph);
+
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            size_t top = row * 4;
+            EXPECT_LT(tasks[top].stamp, tasks[top + 1].stamp);
+            EXPECT_LT(tasks[top].stamp, tasks[top + 2].stamp);
+            EXPECT_LT(tasks[top + 1].stamp, tasks[top + 3].stamp);
+            EXPECT_LT(tasks[top + 2].stamp, tasks[top + 3].stamp);
+            if (row)
+            {
+                EXPECT_LT(tasks[top - 1].stamp, tasks[top].stamp);
+            }
+        }
+    }
+    EXPECT_EQ(numRows * 4 * 3, clock.load());
+}
+
+namespace {
+    /// Throws for one index, counts the others
+    class ThrowingBody : public CountingBody
+    {
+    public:
+        size_t throwAt;
+
+        ThrowingBody(size_t size, size_t at) : CountingBody(size), throwAt(at) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            if (throwAt >= begin && throwAt < end)
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "index", "ThrowingBody::execute");
+            CountingBody::execute(begin, end);
+        }
+    };
+
+    class ThrowingTask : public Task
+    {
+    public:
+        void execute(void)
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "task", "ThrowingTask::execute");
+        }
+    };
+}
+
+TEST(TaskScheduler,exceptionsReachTheCaller)
+{
+    Root root("");
+    root.getWorkQueue()->startup();
+
+    // thrown by a chunk on a worker or on the calling thread
+    for (size_t at = 0; at < 1000; at += 111)
+    {
+        ThrowingBody body(1000, at);
+        EXPECT_THROW(TaskScheduler::getSingleton().parallelFor(0, 1000, 10, body), Exception);
+        EXPECT_GT(1000U / 10, body.numChunks.load());
+    }
+
+    // the tasks depending on a failed one are skipped
+    AtomicScalar<size_t> clock(0);
+    StampTask tasks[8];
+    ThrowingTask throwing;
+    TaskGraph graph;
+    TaskGraph::TaskID failing = graph.addTask(&throwing);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        tasks[i].clock = &clock;
+        graph.addDependency(graph.addTask(&tasks[i]), failing);
+    }
+    EXPECT_THROW(TaskScheduler::getSingleton().run(graph), Exception);
+    EXPECT_EQ(0U, clock.load());
+
+    // the scheduler is still usable
+    CountingBody body(1000);
+    TaskScheduler::getSingleton().parallelFor(0, 1000, 10, body);
+    EXPECT_EQ(100U, body.numChunks.load());
+}
+
+namespace {
+    /// Counts the responses arriving on a channel
+    class ResponseCounter : public WorkQueue::ResponseHandler
+    {
+    public:
+        size_t count;
+
+        ResponseCounter() : count(0) {}
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            ++count;
+        }
+    };
+}
+
+TEST(TaskScheduler,helpersLeaveNoResponses)
+{
+    Root root("");
+    WorkQueue* wq = root.getWorkQueue();
+    wq->startup();
+
+    ResponseCounter counter;
+    uint16 channel = wq->getChannel("Ogre/TaskScheduler");
+    wq->addResponseHandler(channel, &counter);
+
+    AtomicScalar<size_t> clock(0);
+    StampTask tasks[8];
+    TaskGraph graph;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        tasks[i].clock = &clock;
+        graph.addTask(&tasks[i]);
+    }
+
+    for (int i = 0; i < 20; ++i)
+    {
+        CountingBody body(1000);
+        TaskScheduler::getSingleton().parallelFor(0, 1000, 10, body);
+        TaskScheduler::getSingleton().run(graph);
+    }
+
+    // give the helpers which were not needed any more time to run
+    Timer timer;
+    while (timer.getMilliseconds() < 200)
+        wq->processResponses();
+
+    EXPECT_EQ(0U, counter.count);
+    EXPECT_EQ(8U * 20, clock.load());
+    wq->removeResponseHandler(channel, &counter);
+}
@@ -0,0 +1,215 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+#if OGRE_THREAD_PROVIDER != 3
+#include "Threading/OgreWorkStealingWorkQueue.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Answers every request, failing while the request still has retries left
+    /// if asked to
+    class CountingHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+    {
+    public:
+        AtomicScalar<size_t> handled;
+        size_t responses;
+        size_t succeeded;
+        bool failUntilLastRetry;
+
+        CountingHandler() : handled(0), responses(0), succeeded(0), failUntilLastRetry(false) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            ++handled;
+            bool success = !failUntilLastRetry || req->getRetryCount() == 0;
+            return OGRE_NEW WorkQueue::Response(req, success, Any());
+        }
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            ++responses;
+            if (res->succeeded())
+                ++succeeded;
+        }
+    };
+
+    /// Process responses until the expected number arrived or a few seconds passed
+    void waitForResponses(WorkQueue* wq, CountingHandler& handler, size_t expected)
+    {
+        Timer timer;
+        while (handler.responses < expected && timer.getMilliseconds() < 10000)
+        {
+            wq->processResponses();
+        }
+    }
+
+    unsigned long measureThroughput(DefaultWorkQueueBase* wq, size_t numRequests)
+    {
+        CountingHandler handler;
+        uint16 channel = wq->getChannel("Benchmark");
+        wq->addRequestHandler(channel, &handler);
+        wq->addResponseHandler(channel, &handler);
+        wq->setResponseProcessingTimeLimit(0);
+        wq->setWorkerThreadCount(std::max((size_t)OGRE_THREAD_HARDWARE_CONCURRENCY, (size_t)1));
+        wq->startup();
+
+        Timer timer;
+        for (size_t i = 0; i < numRequests; ++i)
+            wq->addRequest(channel, 0, Any());
+        waitForResponses(wq, handler, numRequests);
+        unsigned long us = timer.getMicroseconds();
+
+        EXPECT_EQ(numRequests, handler.responses);
+
+        wq->shutdown();
+        wq->removeRequestHandler(channel, &handler);
+        wq->removeResponseHandler(channel, &handler);
+        return us;
+    }
+}
+
+TEST(WorkStealingWorkQueue,processesAllRequests)
+{
+    Root root("");
+    WorkStealingWorkQueue wq("Test");
+    wq.setWorkerThreadCount(4);
+    wq.startup();
+
+    CountingHandler handler;
+    uint16 channel = wq.getChannel("Test");
+    wq.addRequestHandler(channel, &handler);
+    wq.addResponseHandler(channel, &handler);
+
+    const size_t numRequests = 2000;
+    for (size_t i = 0; i < numRequests; ++i)
+        wq.addRequest(channel, 0, Any(), 0, false, i % 10 == 0);
+    waitForResponses(&wq, handler, numRequests);
+
+    EXPECT_EQ(numRequests, handler.handled.load());
+    EXPECT_EQ(numRequests, handler.responses);
+    EXPECT_EQ(numRequests, handler.succeeded);
+}
+
+TEST(WorkStealingWorkQueue,retriesFailedRequests)
+{
+    Root root("");
+    WorkStealingWorkQueue wq("Test");
+    wq.setWorkerThreadCount(2);
+    wq.startup();
+
+    CountingHandler handler;
+    handler.failUntilLastRetry = true;
+    uint16 channel = wq.getChannel("Test");
+    wq.addRequestHandler(channel, &handler);
+    wq.addResponseHandler(channel, &handler);
+
+    const size_t numRequests = 100;
+    for (size_t i = 0; i < numRequests; ++i)
+        wq.addRequest(channel, 0, Any(), 2);
+    waitForResponses(&wq, handler, numRequests);
+
+    EXPECT_EQ(numRequests * 3, handler.handled.load());
+    EXPECT_EQ(numRequests, handler.succeeded);
+}
+
+#if OGRE_THREAD_SUPPORT
+TEST(WorkStealingWorkQueue,abortRequests)
+{
+    Root root("");
+    // no workers, requests are only processed by _processNextRequest
+    WorkStealingWorkQueue wq("Test");
+    wq.setWorkerThreadCount(0);
+    wq.startup();
+
+    CountingHandler handler;
+    uint16 channel = wq.getChannel("Test");
+    uint16 otherChannel = wq.getChannel("Other");
+    wq.addRequestHandler(channel, &handler);
+    wq.addResponseHandler(channel, &handler);
+    wq.addRequestHandler(otherChannel, &handler);
+    wq.addResponseHandler(otherChannel, &handler);
+
+    WorkQueue::RequestID ids[10];
+    for (int i = 0; i < 10; ++i)
+        ids[i] = wq.addRequest(i < 6 ? channel : otherChannel, 0, Any());
+
+    wq.abortRequest(ids[2]);
+    wq.abortRequestsByChannel(otherChannel);
+
+    for (int i = 0; i < 10; ++i)
+        wq._processNextRequest();
+    wq.processResponses();
+
+    EXPECT_EQ(5U, handler.handled.load());
+    EXPECT_EQ(5U, handler.responses);
+}
+#endif
+
+TEST(WorkStealingWorkQueue,rootKeepsMatchingQueue)
+{
+    Root root("");
+    WorkQueue* defaultQueue = root.getWorkQueue();
+    root.setUseWorkStealingQueue(false);
+    EXPECT_EQ(defaultQueue, root.getWorkQueue());
+
+    root.setUseWorkStealingQueue(true);
+    WorkQueue* stealingQueue = root.getWorkQueue();
+    EXPECT_TRUE(dynamic_cast<WorkStealingWorkQueue*>(stealingQueue) != 0);
+
+    // the handlers registered with the current queue must survive
+    CountingHandler handler;
+    uint16 channel = stealingQueue->getChannel("Test");
+    stealingQueue->addRequestHandler(channel, &handler);
+    root.setUseWorkStealingQueue(true);
+    EXPECT_EQ(stealingQueue, root.getWorkQueue());
+    stealingQueue->removeRequestHandler(channel, &handler);
+}
+
+TEST(WorkStealingWorkQueue,DISABLED_throughput)
+{
+    Root root("");
+    const size_t numRequests = 100000;
+
+    DefaultWorkQueue defaultQueue("Default");
+    unsigned long defaultUs = measureThroughput(&defaultQueue, numRequests);
+
+    WorkStealingWorkQueue stealingQueue("Stealing");
+    unsigned long stealingUs = measureThroughput(&stealingQueue, numRequests);
+
+    LogManager::getSingleton().stream() << "WorkQueue throughput, " << numRequests
+        << " requests: DefaultWorkQueue " << defaultUs << " us, WorkStealingWorkQueue "
+        << stealingUs << " us";
+}
+#endif
@@ -0,0 +1,480 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreNullPlugin.h"
+#include "OgreNullRenderSystem.h"
+#include "OgreRoot.h"
+#include "OgreRenderWindow.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreManualObject.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreRenderTexture.h"
+#include "OgreHardwareOcclusionQuery.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticle.h"
+#include "OgreBillboardParticleRenderer.h"
+#include "OgreBillboardSet.h"
+#include "OgreMeshManager.h"
+#include "OgreMesh.h"
+#include "OgreSkeleton.h"
+#include "OgreSubMesh.h"
+#include "OgreSkeletonManager.h"
+#include "OgreBone.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreEntity.h"
+#include "OgreSkinningBatch.h"
+#include "OgreRenderSystemCapabilities.h"
+
+#include <gtest/gtest.h>
+
+using namespace Ogre;
+
+namespace {
+    class NullRenderSystemTests : public ::testing::Test
+    {
+    public:
+        void SetUp()
+        {
+            mRoot = OGRE_NEW Root("");
+            mRoot->installPlugin(&mPlugin);
+
+            mRenderSystem = static_cast<NullRenderSystem*>(
+                mRoot->getRenderSystemByName("Null Rendering Subsystem"));
+            ASSERT_TRUE(mRenderSystem);
+            mRoot->setRenderSystem(mRenderSystem);
+            mWindow = mRoot->initialise(true);
+
+            mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+            mCamera = mSceneMgr->createCamera("Camera");
+            mCamera->setNearClipDistance(1);
+            // looking down -Z, at the origin
+            mCameraNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 100));
+            mCameraNode->attachObject(mCamera);
+            mWindow->addViewport(mCamera);
+        }
+
+        void TearDown()
+        {
+            OGRE_DELETE mRoot;
+        }
+
+        /// A quad of size 2 * halfSize facing the camera
+        ManualObject* createQuad(const String& name, Real halfSize)
+        {
+            ManualObject* quad = mSceneMgr->createManualObject(name);
+            quad->begin("BaseWhiteNoLighting");
+            quad->position(-halfSize, -halfSize, 0);
+            quad->position(halfSize, -halfSize, 0);
+            quad->position(halfSize, halfSize, 0);
+            quad->position(-halfSize, halfSize, 0);
+            quad->quad(0, 1, 2, 3);
+            quad->end();
+            return quad;
+        }
+
+        NullPlugin mPlugin;
+        Root* mRoot;
+        NullRenderSystem* mRenderSystem;
+        RenderWindow* mWindow;
+        SceneManager* mSceneMgr;
+        Camera* mCamera;
+        SceneNode* mCameraNode;
+    };
+
+    /** A column of numVertices vertices along the y axis, skinned to a chain
+        of two bones. The second bone bends by 90 degrees over its animation.
+    */
+    MeshPtr createSkinnedMesh(const String& name, size_t numVertices)
+    {
+        SkeletonPtr skel = SkeletonManager::getSingleton().create(name,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+        Bone* root = skel->createBone(0);
+        Bone* tip = skel->createBone(1);
+        tip->setPosition(0, 2, 0);
+        root->addChild(tip);
+        skel->setBindingPose();
+        NodeAnimationTrack* track = skel->createAnimation("Bend", 1)->createNodeTrack(1, tip);
+        track->createNodeKeyFrame(0);
+        track->createNodeKeyFrame(1)->setRotation(Quaternion(Degree(90), Vector3::UNIT_Z));
+
+        MeshPtr mesh = MeshManager::getSingleton().createManual(name,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        mesh->sharedVertexData = OGRE_NEW VertexData();
+        mesh->sharedVertexData->vertexCount = numVertices;
+        VertexDeclaration* decl = mesh->sharedVertexData->vertexDeclaration;
+        decl->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        decl->addElement(0, 12, VET_FLOAT3, VES_NORMAL);
+        HardwareVertexBufferSharedPtr buf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(0), numVertices, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mesh->sharedVertexData->vertexBufferBinding->setBinding(0, buf);
+
+        float* p = static_cast<float*>(buf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            Real y = Real(4 * v) / numVertices;
+            *p++ = Real(v % 7) / 10;
+            *p++ = y;
+            *p++ = 0;
+            *p++ = 1;
+            *p++ = 0;
+            *p++ = 0;
+
+            VertexBoneAssignment vba;
+            vba.vertexIndex = static_cast<unsigned int>(v);
+            vba.boneIndex = 0;
+            vba.weight = 1 - y / 4;
+            mesh->addBoneAssignment(vba);
+            vba.boneIndex = 1;
+            vba.weight = y / 4;
+            mesh->addBoneAssignment(vba);
+        }
+        buf->unlock();
+
+        SubMesh* sub = mesh->createSubMesh();
+        sub->useSharedVertices = true;
+        sub->operationType = RenderOperation::OT_POINT_LIST;
+        sub->setMaterialName("BaseWhiteNoLighting");
+
+        mesh->_notifySkeleton(skel);
+        mesh->_compileBoneAssignments();
+        mesh->_setBounds(AxisAlignedBox(-5, -5, -5, 5, 5, 5));
+        mesh->_setBoundingSphereRadius(10);
+        mesh->load();
+        return mesh;
+    }
+
+    /// The software skinned positions of an entity
+    vector<float>::type getSkinnedPositions(Entity* ent)
+    {
+        VertexData* data = ent->_getSkelAnimVertexData();
+        const VertexElement* posElem = data->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        HardwareVertexBufferSharedPtr buf = data->vertexBufferBinding->getBuffer(posElem->getSource());
+        EXPECT_FALSE(buf->isLocked());
+
+        vector<float>::type positions;
+        const unsigned char* p = static_cast<const unsigned char*>(buf->lock(HardwareBuffer::HBL_READ_ONLY));
+        for (size_t v = 0; v < data->vertexCount; ++v, p += buf->getVertexSize())
+        {
+            float* pos;
+            posElem->baseVertexPointerToElement(const_cast<unsigned char*>(p), &pos);
+            positions.insert(positions.end(), pos, pos + 3);
+        }
+        buf->unlock();
+        return positions;
+    }
+
+    /// Records whether blends were being batched while an object was found visible
+    class SkinningBatchListener : public MovableObject::Listener
+    {
+    public:
+        SkinningBatchListener() : batchActive(false) {}
+
+        bool objectRendering(const MovableObject* obj, const Camera*)
+        {
+            batchActive = obj->_getManager()->_getSkinningBatch() != 0;
+            return true;
+        }
+
+        bool batchActive;
+    };
+}
+
+TEST_F(NullRenderSystemTests, RenderFrame)
+{
+    EXPECT_EQ(mWindow->getWidth(), 800u);
+    EXPECT_EQ(mWindow->getHeight(), 600u);
+
+    // a node of its own, the bounds of the root node include the camera
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(createQuad("Quad", 10));
+
+    mRenderSystem->resetStatistics();
+    ASSERT_TRUE(mRoot->renderOneFrame());
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    EXPECT_EQ(stats.frames, 1u);
+    EXPECT_EQ(stats.drawCalls, 1u);
+    EXPECT_EQ(stats.vertices, 6u);
+    EXPECT_GE(stats.clears, 1u);
+    EXPECT_GT(stats.stateChanges, 0u);
+    EXPECT_EQ(mWindow->getStatistics().batchCount, 1u);
+    EXPECT_EQ(mWindow->getStatistics().triangleCount, 2u);
+
+    // nothing visible when looking away
+    mCameraNode->lookAt(Vector3(0, 0, 200), Node::TS_WORLD);
+    mRenderSystem->resetStatistics();
+    mRoot->renderOneFrame();
+    EXPECT_EQ(mRenderSystem->getStatistics().drawCalls, 0u);
+}
+
+TEST_F(NullRenderSystemTests, TextureReadback)
+{
+    TexturePtr tex = TextureManager::getSingleton().createManual("Tex",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, TEX_TYPE_2D, 4, 4, 0, PF_A8R8G8B8);
+    ASSERT_TRUE(tex);
+    ASSERT_EQ(tex->getFormat(), PF_A8R8G8B8);
+
+    uint32 src[16];
+    for (int i = 0; i < 16; ++i)
+        src[i] = 0xFF000000 | (i << 16) | (i * 3 << 8) | (i * 7);
+    tex->getBuffer()->blitFromMemory(PixelBox(4, 4, 1, PF_A8R8G8B8, src));
+
+    uint32 dst[16] = {0};
+    tex->getBuffer()->blitToMemory(PixelBox(4, 4, 1, PF_A8R8G8B8, dst));
+    for (int i = 0; i < 16; ++i)
+        EXPECT_EQ(src[i], dst[i]);
+
+    // read back with conversion
+    uint8 rgb[16 * 3];
+    tex->getBuffer()->blitToMemory(PixelBox(4, 4, 1, PF_BYTE_RGB, rgb));
+    for (int i = 0; i < 16; ++i)
+    {
+        EXPECT_EQ(rgb[i * 3], i);
+        EXPECT_EQ(rgb[i * 3 + 1], i * 3);
+        EXPECT_EQ(rgb[i * 3 + 2], i * 7);
+    }
+
+    // and scaling
+    uint32 half[2 * 2];
+    tex->getBuffer()->blitToMemory(PixelBox(2, 2, 1, PF_A8R8G8B8, half));
+    EXPECT_EQ(half[0] >> 24, 0xFFu);
+}
+
+TEST_F(NullRenderSystemTests, SoftwareMipmaps)
+{
+    // without hardware generation the texture filters the levels from the image
+    mRenderSystem->getMutableCapabilities()->unsetCapability(RSC_AUTOMIPMAP);
+
+    // a checkerboard, which averages to mid grey in linear space
+    const uint32 size = 64;
+    Image image;
+    image.loadDynamicImage(OGRE_ALLOC_T(uchar, size * size * 4, MEMCATEGORY_GENERAL),
+        size, size, 1, PF_BYTE_RGBA, true);
+    for (uint32 y = 0; y < size; ++y)
+    {
+        for (uint32 x = 0; x < size; ++x)
+            image.setColourAt((x + y) % 2 ? ColourValue::White : ColourValue::Black, x, y, 0);
+    }
+
+    for (int hwGamma = 0; hwGamma < 2; ++hwGamma)
+    {
+        String name = hwGamma ? "SRGB" : "Linear";
+        TexturePtr tex = TextureManager::getSingleton().loadImage(name,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, image, TEX_TYPE_2D, 3, 1.0f, false,
+            PF_BYTE_RGBA, hwGamma != 0);
+        // only the requested levels
+        ASSERT_EQ(3u, tex->getNumMipmaps());
+
+        Image expected(image);
+        expected.generateMipmaps(Image::FILTER_BILINEAR, hwGamma != 0, 3);
+        ASSERT_EQ(3u, expected.getNumMipmaps());
+        for (uint32 mip = 0; mip <= 3; ++mip)
+        {
+            PixelBox level = expected.getPixelBox(0, mip);
+            vector<uchar>::type pixels(level.getConsecutiveSize());
+            tex->getBuffer(0, mip)->blitToMemory(PixelBox(level.getWidth(), level.getHeight(), 1,
+                PF_BYTE_RGBA, &pixels[0]));
+            EXPECT_EQ(0, memcmp(level.data, &pixels[0], pixels.size())) << name << " mip " << mip;
+        }
+
+        // 0.5 in linear space is 188 in sRGB
+        uchar grey = expected.getPixelBox(0, 1).getColourAt(0, 0, 0).r * 255 + 0.5f;
+        EXPECT_NEAR(hwGamma ? 188 : 128, grey, 1) << name;
+    }
+}
+
+TEST_F(NullRenderSystemTests, RenderToTexture)
+{
+    mSceneMgr->getRootSceneNode()->attachObject(createQuad("Quad", 10));
+
+    TexturePtr tex = TextureManager::getSingleton().createManual("RTT",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, TEX_TYPE_2D, 64, 64, 0,
+        PF_A8R8G8B8, TU_RENDERTARGET);
+    RenderTexture* rt = tex->getBuffer()->getRenderTarget();
+    ASSERT_TRUE(rt);
+    rt->addViewport(mCamera);
+    rt->setAutoUpdated(true);
+
+    mRenderSystem->resetStatistics();
+    mRoot->renderOneFrame();
+
+    const NullRenderSystem::Statistics& stats = mRenderSystem->getStatistics();
+    EXPECT_EQ(stats.drawCalls, 2u);
+    EXPECT_GE(stats.renderTargetChanges, 2u);
+    EXPECT_TRUE(rt->getDepthBuffer());
+
+    TextureManager::getSingleton().remove(tex);
+}
+
+TEST_F(NullRenderSystemTests, OcclusionQuery)
+{
+    mSceneMgr->getRootSceneNode()->attachObject(createQuad("Quad", 10));
+
+    HardwareOcclusionQuery* query = mRenderSystem->createHardwareOcclusionQuery();
+    query->beginOcclusionQuery();
+    mRoot->renderOneFrame();
+    query->endOcclusionQuery();
+
+    unsigned int count = 0;
+    EXPECT_FALSE(query->isStillOutstanding());
+    EXPECT_TRUE(query->pullOcclusionQuery(&count));
+    EXPECT_EQ(count, 6u);
+    mRenderSystem->destroyHardwareOcclusionQuery(query);
+}
+
+TEST_F(NullRenderSystemTests, ParallelBillboards)
+{
+    // a few chunks for the parallel path, the last one only partially filled
+    const size_t numParticles = BillboardParticleRenderer::PARALLEL_CHUNK_SIZE * 3 + 100;
+    ParticleSystem* ps = mSceneMgr->createParticleSystem("ps", numParticles);
+    mSceneMgr->getRootSceneNode()->attachObject(ps);
+    ps->_update(0);
+    for (size_t i = 0; i < numParticles; ++i)
+    {
+        Particle* p = ps->createParticle();
+        p->mPosition = Vector3(Real(i % 100) - 50, Real(i / 100) - 50, -Real(i % 7));
+        p->mDirection = Vector3::ZERO;
+        p->mColour = ColourValue(Real(i % 3) / 2, 1, 0, 1);
+        p->mTimeToLive = p->mTotalTimeToLive = 1000;
+        if (i % 5 == 0)
+            p->setDimensions(2, 3);
+    }
+
+    BillboardSet* bset = static_cast<BillboardParticleRenderer*>(ps->getRenderer())->getBillboardSet();
+    vector<uint8>::type vertices[2];
+    AxisAlignedBox bounds[2];
+    ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+        mgr.setParallelUpdate(parallel != 0);
+        ps->_notifyCurrentCamera(mCamera);
+        ps->_updateRenderQueue(mSceneMgr->getRenderQueue());
+
+        RenderOperation op;
+        bset->getRenderOperation(op);
+        ASSERT_EQ(numParticles * 4, op.vertexData->vertexCount);
+        HardwareVertexBufferSharedPtr buf = op.vertexData->vertexBufferBinding->getBuffer(0);
+        vertices[parallel].resize(op.vertexData->vertexCount * buf->getVertexSize());
+        buf->readData(op.vertexData->vertexStart * buf->getVertexSize(),
+            vertices[parallel].size(), &vertices[parallel][0]);
+        bounds[parallel] = bset->getBoundingBox();
+    }
+    mgr.setParallelUpdate(false);
+
+    EXPECT_TRUE(vertices[0] == vertices[1]);
+    EXPECT_EQ(bounds[0], bounds[1]);
+    EXPECT_EQ(Vector3(-50, -50, -6), bounds[0].getMinimum());
+}
+
+TEST_F(NullRenderSystemTests, FramePerformance)
+{
+    const int numObjects = 2000;
+    const int numFrames = 50;
+
+    for (int i = 0; i < numObjects; ++i)
+    {
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            Vector3(Real(i % 50 - 25), Real(i / 50 - 20), 0));
+        node->attachObject(createQuad("Quad" + StringConverter::toString(i), 0.4));
+    }
+
+    mRoot->renderOneFrame();
+    mRenderSystem->resetStatistics();
+
+    Timer timer;
+    for (int i = 0; i < numFrames; ++i)
+        mRoot->renderOneFrame();
+    unsigned long time = timer.getMicroseconds();
+
+    EXPECT_EQ(mRenderSystem->getStatistics().frames, size_t(numFrames));
+    EXPECT_EQ(mRenderSystem->getStatistics().drawCalls, size_t(numObjects * numFrames));
+
+    LogManager::getSingleton().stream() << "NullRenderSystem: " << numObjects << " objects, "
+        << time / numFrames << " us per frame";
+}
+
+TEST_F(NullRenderSystemTests, BatchedSkinning)
+{
+    // more vertices than one task skins
+    MeshPtr mesh = createSkinnedMesh("Skinned", SkinningBatch::VERTICES_PER_TASK + 100);
+    const size_t numEntities = 3;
+    Entity* ents[numEntities];
+    for (size_t i = 0; i < numEntities; ++i)
+    {
+        ents[i] = mSceneMgr->createEntity(mesh);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            Vector3(Real(i) * 10 - 10, 0, 0))->attachObject(ents[i]);
+        ents[i]->getAnimationState("Bend")->setEnabled(true);
+    }
+    SkinningBatchListener listener;
+    ents[0]->setListener(&listener);
+
+    // reference poses, each entity blended on its own
+    vector<float>::type expected[numEntities];
+    for (size_t i = 0; i < numEntities; ++i)
+        ents[i]->getAnimationState("Bend")->setTimePosition(Real(i + 1) / 4);
+    mRoot->renderOneFrame();
+    EXPECT_FALSE(listener.batchActive);
+    for (size_t i = 0; i < numEntities; ++i)
+        expected[i] = getSkinnedPositions(ents[i]);
+
+    // move away from them, then back with the blends batched, the source
+    // buffer being shared by all of them
+    for (size_t i = 0; i < numEntities; ++i)
+        ents[i]->getAnimationState("Bend")->setTimePosition(0);
+    mRoot->renderOneFrame();
+
+    mSceneMgr->setBatchedSkinning(true);
+    for (size_t i = 0; i < numEntities; ++i)
+        ents[i]->getAnimationState("Bend")->setTimePosition(Real(i + 1) / 4);
+    mRoot->renderOneFrame();
+    EXPECT_TRUE(listener.batchActive);
+    EXPECT_FALSE(mSceneMgr->_getSkinningBatch());
+    EXPECT_FALSE(mesh->sharedVertexData->vertexBufferBinding->getBuffer(0)->isLocked());
+
+    for (size_t i = 0; i < numEntities; ++i)
+    {
+        vector<float>::type positions = getSkinnedPositions(ents[i]);
+        ASSERT_EQ(expected[i].size(), positions.size());
+        for (size_t j = 0; j < positions.size(); ++j)
+            ASSERT_NEAR(expected[i][j], positions[j], 1e-5f) << "entity " << i << ", float " << j;
+    }
+    // the tip bends further with time
+    size_t tipX = expected[0].size() - 3;
+    EXPECT_GT(std::abs(expected[2][tipX] - expected[0][tipX]), 0.1f);
+
+    ents[0]->setListener(0);
+}
@@ -9,7 +9,8 @@ set(RENDERSYSTEMS
     # tests only run with the legacy GL rendersystem as MESA is too old on buildbot
     -DOGRE_BUILD_RENDERSYSTEM_GL=TRUE
     -DOGRE_BUILD_RENDERSYSTEM_GL3PLUS=TRUE
-    -DOGRE_BUILD_RENDERSYSTEM_GLES2=TRUE)
+    -DOGRE_BUILD_RENDERSYSTEM_GLES2=TRUE
+    -DOGRE_BUILD_RENDERSYSTEM_NULL=TRUE)
 
 if(DEFINED ENV{IOS})
     set(GENERATOR -G Xcode)